@@ -30,12 +30,30 @@
 #include "gemstone/managers/input/InputManager.hpp"
 #include "gemstone/renderer/context/logger.hpp"
 #include "gemstone/renderer/context/Context.hpp"
+#include "gemstone/renderer/culling/logger.hpp"
+#include "gemstone/renderer/culling/FrustumCuller.hpp"
+#include "gemstone/renderer/culling/OcclusionCuller.hpp"
+#include "gemstone/renderer/instancing/logger.hpp"
+#include "gemstone/renderer/instancing/InstancedRenderer.hpp"
 #include "gemstone/renderer/mesh/logger.hpp"
 #include "gemstone/renderer/mesh/Mesh.hpp"
+#include "gemstone/renderer/queue/logger.hpp"
+#include "gemstone/renderer/queue/PipelineWarmer.hpp"
+#include "gemstone/renderer/queue/RenderQueue.hpp"
 #include "gemstone/renderer/shader/logger.hpp"
+#include "gemstone/renderer/shader/FrameUniformBuffer.hpp"
+#include "gemstone/renderer/shader/ProgramBinaryCache.hpp"
+#include "gemstone/renderer/shader/ShaderPreprocessor.hpp"
 #include "gemstone/renderer/shader/ShaderProgram.hpp"
+#include "gemstone/renderer/state/logger.hpp"
+#include "gemstone/renderer/state/StateCache.hpp"
+#include "gemstone/renderer/streaming/logger.hpp"
+#include "gemstone/renderer/streaming/TextureStreamer.hpp"
 #include "gemstone/renderer/texture/logger.hpp"
 #include "gemstone/renderer/texture/Texture.hpp"
+#include "gemstone/renderer/texture/TextureDecoder.hpp"
+#include "gemstone/renderer/upload/logger.hpp"
+#include "gemstone/renderer/upload/UploadQueue.hpp"
 
 #include "application/core.hpp"
 #include "application/shaders.hpp"
@@ -51,7 +69,15 @@ void processInput(GLFWwindow* p_glfwWindow);
 void render(
     const std::shared_ptr<const GEM::Camera> p_camera,
     const std::vector<std::shared_ptr<GEM::Object>>& objectPtrs,
-    const std::vector<std::shared_ptr<GEM::Renderer::ShaderProgram>>& shaderProgramPtrs
+    const std::shared_ptr<GEM::Renderer::ShaderProgram> p_instancedShaderProgram,
+    const std::shared_ptr<GEM::Renderer::ShaderProgram> p_instancedTextureArraysShaderProgram,
+    const std::shared_ptr<GEM::Renderer::FrustumCuller> p_frustumCuller,
+    const std::shared_ptr<GEM::Renderer::OcclusionCuller> p_occlusionCuller,
+    const std::shared_ptr<GEM::Renderer::TextureStreamer> p_textureStreamer,
+    const std::shared_ptr<GEM::Renderer::InstancedRenderer> p_instancedRenderer,
+    const std::shared_ptr<GEM::Renderer::RenderQueue> p_renderQueue,
+    const std::shared_ptr<GEM::Renderer::FrameUniformBuffer> p_frameUniformBuffer,
+    const float time
 );
 
 int main(int argc, char* argv[]) {
@@ -65,13 +91,19 @@ int main(int argc, char* argv[]) {
         {GENERAL_LOGGER_NAME, GEM::util::Logger::Level::error},
         {CAMERA_LOGGER_NAME, GEM::util::Logger::Level::error},
         {CONTEXT_LOGGER_NAME, GEM::util::Logger::Level::error},
+        {CULLING_LOGGER_NAME, GEM::util::Logger::Level::error},
         {INPUT_MANAGER_LOGGER_NAME, GEM::util::Logger::Level::error},
+        {INSTANCING_LOGGER_NAME, GEM::util::Logger::Level::error},
         {IO_LOGGER_NAME, GEM::util::Logger::Level::error},
         {MESH_LOGGER_NAME, GEM::util::Logger::Level::error},
         {OBJECT_LOGGER_NAME, GEM::util::Logger::Level::error},
+        {RENDER_QUEUE_LOGGER_NAME, GEM::util::Logger::Level::error},
         {SCENE_LOGGER_NAME, GEM::util::Logger::Level::error},
         {SHADER_LOGGER_NAME, GEM::util::Logger::Level::error},
-        {TEXTURE_LOGGER_NAME, GEM::util::Logger::Level::error}
+        {STATE_LOGGER_NAME, GEM::util::Logger::Level::error},
+        {STREAMING_LOGGER_NAME, GEM::util::Logger::Level::error},
+        {TEXTURE_LOGGER_NAME, GEM::util::Logger::Level::error},
+        {UPLOAD_LOGGER_NAME, GEM::util::Logger::Level::error}
     });
 
     /* ------------------------------------ initialization ------------------------------------ */
@@ -80,14 +112,32 @@ int main(int argc, char* argv[]) {
 
     std::shared_ptr<GEM::Managers::InputManager> p_inputManager = GEM::Managers::InputManager::createPtr(p_context->getGLFWWindowPtr().get());
 
+    // The program binary functions aren't part of gl 3.3 so glad doesn't load them for us
+    GEM::Renderer::ProgramBinaryCache::initialize((GLADloadproc)glfwGetProcAddress);
+
+    // Stage texture and buffer uploads so a burst of new assets is spread over several frames
+    GEM::Renderer::UploadQueue::initialize();
+
     /* ------------------------------------ shader stuff ------------------------------------ */
 
     LOG_INFO("Creating shaders");
 
-    std::vector<std::shared_ptr<GEM::Renderer::ShaderProgram>> shaderProgramPtrs;
+    std::shared_ptr<GEM::Renderer::ShaderProgram> p_instancedShaderProgram;
+    std::shared_ptr<GEM::Renderer::ShaderProgram> p_instancedTextureArraysShaderProgram;
     try {
-        shaderProgramPtrs.push_back(std::make_shared<GEM::Renderer::ShaderProgram>(vertexShaderSource, fragmentShaderSource));
-        shaderProgramPtrs.push_back(std::make_shared<GEM::Renderer::ShaderProgram>(vertexShaderSource, fragmentShader2Source));
+        GEM::Renderer::ShaderPreprocessor::addIncludeSource("frame_data.glsl", frameDataShaderSource);
+
+        const char* p_vertexInstancedShaderVariant = GEM::Renderer::ShaderPreprocessor::getVariant(vertexInstancedShaderSource);
+        const char* p_fragmentShaderVariant = GEM::Renderer::ShaderPreprocessor::getVariant(fragmentShaderSource);
+        const char* p_fragmentShaderTextureArraysVariant = GEM::Renderer::ShaderPreprocessor::getVariant(fragmentShaderSource, {"TEXTURE_ARRAYS"});
+
+        // Create all of the shader programs together so the driver can link them in parallel
+        const std::vector<std::shared_ptr<GEM::Renderer::ShaderProgram>> shaderProgramPtrs = GEM::Renderer::ShaderProgram::createPtrs({
+            {p_vertexInstancedShaderVariant, p_fragmentShaderVariant},
+            {p_vertexInstancedShaderVariant, p_fragmentShaderTextureArraysVariant}
+        });
+        p_instancedShaderProgram = shaderProgramPtrs[0];
+        p_instancedTextureArraysShaderProgram = shaderProgramPtrs[1];
     } catch (const std::exception& ex) {
         LOG_CRITICAL("Caught exception when trying to create shaders:\n" + std::string(ex.what()));
         return 1;
@@ -95,8 +145,32 @@ int main(int argc, char* argv[]) {
 
     /* ------------------------------------ create the scene ------------------------------------ */
 
+    // Decode the scene's textures on worker threads, drawing with the placeholder until each is uploaded
+    GEM::Renderer::Texture::startAsyncLoading();
+
     std::shared_ptr<GEM::Scene> p_scene = std::make_shared<GEM::Scene>(p_context, p_inputManager, "some_scene_file.json");
 
+    std::shared_ptr<GEM::Renderer::FrustumCuller> p_frustumCuller = std::make_shared<GEM::Renderer::FrustumCuller>();
+    std::shared_ptr<GEM::Renderer::OcclusionCuller> p_occlusionCuller = std::make_shared<GEM::Renderer::OcclusionCuller>();
+    for (const std::shared_ptr<GEM::Object>& p_occluder : p_scene->getOccluderPtrs()) {
+        p_occlusionCuller->addOccluder(p_occluder);
+    }
+    std::shared_ptr<GEM::Renderer::TextureStreamer> p_textureStreamer = std::make_shared<GEM::Renderer::TextureStreamer>();
+    std::shared_ptr<GEM::Renderer::InstancedRenderer> p_instancedRenderer = std::make_shared<GEM::Renderer::InstancedRenderer>();
+    std::shared_ptr<GEM::Renderer::RenderQueue> p_renderQueue = std::make_shared<GEM::Renderer::RenderQueue>();
+    std::shared_ptr<GEM::Renderer::FrameUniformBuffer> p_frameUniformBuffer = std::make_shared<GEM::Renderer::FrameUniformBuffer>();
+
+    // Draw everything the scene will be drawn with once now, so the driver's deferred shader work happens during
+    // load instead of as hitches the first time each object is seen
+    {
+        GEM::Renderer::PipelineWarmer pipelineWarmer;
+        for (const std::shared_ptr<GEM::Object>& p_object : p_scene->getObjectPtrs()) {
+            pipelineWarmer.add(p_instancedShaderProgram, p_object->getMesh(), GEM::Renderer::RenderQueue::Pass::opaque);
+            pipelineWarmer.add(p_instancedTextureArraysShaderProgram, p_object->getMesh(), GEM::Renderer::RenderQueue::Pass::opaque);
+        }
+        pipelineWarmer.warmUp();
+    }
+
     /* ------------------------------------ actually drawing! yay :D ------------------------------------ */
 
     // For frame rate
@@ -125,15 +199,33 @@ int main(int argc, char* argv[]) {
 
         p_scene->update();
 
+        // ----- Upload whatever textures finished decoding, without uploading more than the frame's budget ----- //
+
+        GEM::Renderer::UploadQueue::beginFrame();
+        GEM::Renderer::Texture::uploadDecodedTextures();
+
+        // ----- Pack new textures into arrays once they're all uploaded, so objects with different textures share draws ----- //
+
+        if (
+            GEM::Renderer::Texture::hasUnpackedTextures() &&
+            GEM::Renderer::TextureDecoder::getPendingCount() == 0 &&
+            GEM::Renderer::UploadQueue::getPendingCount() == 0
+        ) {
+            GEM::Renderer::Texture::packTextureArrays(GEM::Renderer::UploadQueue::getFrameBudgetBytes());
+        }
+
         // ----- Rendering ----- //
         
-        render(p_scene->getCameraPtr(), p_scene->getObjectPtrs(), shaderProgramPtrs);
+        render(p_scene->getCameraPtr(), p_scene->getObjectPtrs(), p_instancedShaderProgram, p_instancedTextureArraysShaderProgram, p_frustumCuller, p_occlusionCuller, p_textureStreamer, p_instancedRenderer, p_renderQueue, p_frameUniformBuffer, currentFrameStartTime);
 
         // ----- Check and call events and swap buffers before next pass ----- //
 
         glfwSwapBuffers(p_context->getGLFWWindowPtr().get());
     }
 
+    GEM::Renderer::Texture::stopAsyncLoading();
+    GEM::Renderer::UploadQueue::shutdown();
+
     GEM::Managers::InputManager::clean();
     GEM::Renderer::Context::clean();
     return 0;
@@ -166,30 +258,43 @@ void processInput(GLFWwindow* p_glfwWindow) {
 void render(
     const std::shared_ptr<const GEM::Camera> p_camera,
     const std::vector<std::shared_ptr<GEM::Object>>& objectPtrs,
-    const std::vector<std::shared_ptr<GEM::Renderer::ShaderProgram>>& shaderProgramPtrs
+    const std::shared_ptr<GEM::Renderer::ShaderProgram> p_instancedShaderProgram,
+    const std::shared_ptr<GEM::Renderer::ShaderProgram> p_instancedTextureArraysShaderProgram,
+    const std::shared_ptr<GEM::Renderer::FrustumCuller> p_frustumCuller,
+    const std::shared_ptr<GEM::Renderer::OcclusionCuller> p_occlusionCuller,
+    const std::shared_ptr<GEM::Renderer::TextureStreamer> p_textureStreamer,
+    const std::shared_ptr<GEM::Renderer::InstancedRenderer> p_instancedRenderer,
+    const std::shared_ptr<GEM::Renderer::RenderQueue> p_renderQueue,
+    const std::shared_ptr<GEM::Renderer::FrameUniformBuffer> p_frameUniformBuffer,
+    const float time
 ) {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        
-    // Set the active shader program
-    shaderProgramPtrs[0]->use();
-
-    // Render each of the meshes
-    for (uint32_t i = 0; i < objectPtrs.size(); ++i) {
-
-        // Activate and bind textures the current object is using then tell the shader to use them
-        objectPtrs[i]->getTexture()->activate();
-        objectPtrs[i]->getTexture2()->activate();
-        shaderProgramPtrs[0]->setUniformTextureSampler("ourTexture", objectPtrs[i]->getTexture());
-        shaderProgramPtrs[0]->setUniformTextureSampler("ourTexture2", objectPtrs[i]->getTexture2());
-
-        // Set the uniform matrices for where the camera is oriented
-        shaderProgramPtrs[0]->setUniformMat4("viewMatrix", p_camera->getViewMatrix());
-        shaderProgramPtrs[0]->setUniformMat4("projectionMatrix", p_camera->getProjectionMatrix());
-
-        // Create the matrix for moving the mesh in world space and assign it to the shader
-        shaderProgramPtrs[0]->setUniformMat4("modelMatrix", objectPtrs[i]->getModelMatrix());
-    
-        // Draw the object
-        objectPtrs[i]->draw();
-    }
+
+    // Count the gl state changes made and skipped over this frame only
+    GEM::Renderer::StateCache::resetStatistics();
+
+    // Throw away everything the camera can't see before doing any work to draw it
+    p_frustumCuller->cull(*p_camera, objectPtrs);
+
+    // Then throw away everything hidden behind the occluders
+    p_occlusionCuller->cull(*p_camera, p_frustumCuller->getVisibleObjectPtrs());
+
+    // Keep only the texture levels the visible objects need on the gpu, before anything reads the textures' ids
+    p_textureStreamer->update(*p_camera, p_occlusionCuller->getVisibleObjectPtrs());
+
+    // Group the objects sharing a mesh, level of detail, and textures into a single draw each. Textures packed into
+    // the same texture arrays count as the same textures
+    p_renderQueue->clear();
+    p_instancedRenderer->submit(p_instancedShaderProgram, p_instancedTextureArraysShaderProgram, p_camera, p_occlusionCuller->getVisibleObjectPtrs(), *p_renderQueue);
+
+    // Write the camera's matrices once for every shader program to read, then draw everything in the order that
+    // changes the least state
+    p_frameUniformBuffer->update(*p_camera, time);
+    p_renderQueue->execute();
+
+    LOG_TRACE(
+        "Made {} gl state changes , skipped {} redundant gl state changes",
+        GEM::Renderer::StateCache::getStatistics().issuedCount,
+        GEM::Renderer::StateCache::getStatistics().elidedCount
+    );
 }
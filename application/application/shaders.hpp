@@ -1,5 +1,14 @@
 #pragma once
 
+#include <cstddef> // offsetof
+
+#include "gemstone/renderer/shader/FrameUniformBuffer.hpp"
+
+#include "assets/shaders/reflection/vertex.vert.hpp"
+#include "assets/shaders/reflection/vertex_instanced.vert.hpp"
+#include "assets/shaders/reflection/fragment.frag.hpp"
+#include "assets/shaders/reflection/frame_data.glsl.hpp"
+
 /**
  * @brief This file contains string literals of shaders
  */
@@ -8,10 +17,22 @@ const char* vertexShaderSource =
 #include "assets/shaders/literals/vertex.vert"
 ;
 
+const char* vertexInstancedShaderSource =
+#include "assets/shaders/literals/vertex_instanced.vert"
+;
+
 const char* fragmentShaderSource = 
 #include "assets/shaders/literals/fragment.frag"
 ;
 
-const char* fragmentShader2Source = 
-#include "assets/shaders/literals/fragment2.frag"
-;
\ No newline at end of file
+const char* frameDataShaderSource =
+#include "assets/shaders/literals/frame_data.glsl"
+;
+
+// The renderer writes the FrameData block from its own struct, so make sure the shaders still agree with it
+static_assert(sizeof(Shaders::frame_data_glsl::FrameData) == sizeof(GEM::Renderer::FrameUniformBuffer::FrameData), "frame_data.glsl's FrameData block doesn't match the renderer's");
+static_assert(offsetof(Shaders::frame_data_glsl::FrameData, viewMatrix) == offsetof(GEM::Renderer::FrameUniformBuffer::FrameData, viewMatrix), "frame_data.glsl's FrameData block doesn't match the renderer's");
+static_assert(offsetof(Shaders::frame_data_glsl::FrameData, projectionMatrix) == offsetof(GEM::Renderer::FrameUniformBuffer::FrameData, projectionMatrix), "frame_data.glsl's FrameData block doesn't match the renderer's");
+static_assert(offsetof(Shaders::frame_data_glsl::FrameData, viewProjectionMatrix) == offsetof(GEM::Renderer::FrameUniformBuffer::FrameData, viewProjectionMatrix), "frame_data.glsl's FrameData block doesn't match the renderer's");
+static_assert(offsetof(Shaders::frame_data_glsl::FrameData, cameraPosition) == offsetof(GEM::Renderer::FrameUniformBuffer::FrameData, cameraPosition), "frame_data.glsl's FrameData block doesn't match the renderer's");
+static_assert(offsetof(Shaders::frame_data_glsl::FrameData, time) == offsetof(GEM::Renderer::FrameUniformBuffer::FrameData, time), "frame_data.glsl's FrameData block doesn't match the renderer's");
\ No newline at end of file
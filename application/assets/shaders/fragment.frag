@@ -1,5 +1,23 @@
 #version 330 core
 
+// SOLID_COLOR draws with a color set from opengl instead of the textures
+// TEXTURE_ARRAYS samples textures packed into texture arrays, at the layers given per instance by
+// vertex_instanced.vert
+#pragma keywords SOLID_COLOR TEXTURE_ARRAYS
+
+#ifdef SOLID_COLOR
+// Color set from opengl
+uniform vec4 ourColor;
+#elif defined(TEXTURE_ARRAYS)
+// The input texture arrays
+uniform sampler2DArray ourTexture;
+uniform sampler2DArray ourTexture2;
+
+// The input from the vertex shader, with the layer of each texture array to sample
+in vec4 vertexColor;
+in vec2 textureCoord;
+flat in vec2 textureLayers;
+#else
 // The input texture
 uniform sampler2D ourTexture;
 uniform sampler2D ourTexture2;
@@ -7,14 +25,23 @@ uniform sampler2D ourTexture2;
 // The input from the vertex shader (same type and name)
 in vec4 vertexColor;
 in vec2 textureCoord;
+#endif
 
 // The output color
 out vec4 fragmentColor;
 
 void main() {
+#ifdef SOLID_COLOR
+    fragmentColor = ourColor;
+#elif defined(TEXTURE_ARRAYS)
+    vec4 textureColor = texture(ourTexture, vec3(textureCoord, textureLayers.x));
+    vec4 textureColor2 = texture(ourTexture2, vec3(textureCoord, textureLayers.y));
+    fragmentColor = mix(textureColor, textureColor2, 0.2) * vertexColor;
+#else
     vec4 textureColor = texture(ourTexture, textureCoord);
     vec4 textureColor2 = texture(ourTexture2, textureCoord);
     fragmentColor = mix(textureColor, textureColor2, 0.2) * vertexColor;
     // fragmentColor = textureColor * vertexColor;
     // fragmentColor = textureColor;
+#endif
 }
@@ -1,11 +0,0 @@
-#version 330 core
-
-// Color set from opengl
-uniform vec4 ourColor;
-
-// The output color
-out vec4 fragmentColor;
-
-void main() {
-    fragmentColor = ourColor;
-}
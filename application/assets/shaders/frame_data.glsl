@@ -0,0 +1,8 @@
+// Everything that changes once per frame, written by the renderer into a buffer every shader program shares
+layout (std140) uniform FrameData {
+    mat4 viewMatrix;
+    mat4 projectionMatrix;
+    mat4 viewProjectionMatrix;
+    vec3 cameraPosition;
+    float time;
+};
@@ -11,12 +11,12 @@ out vec2 textureCoord;
 
 // Input transformation matrix
 uniform mat4 modelMatrix;
-uniform mat4 viewMatrix;
-uniform mat4 projectionMatrix;
+
+#include "frame_data.glsl"
 
 void main() {
     // Giving all of aPosition to the constructor saves us from manually writing x, y, and z
-    gl_Position = projectionMatrix * viewMatrix * modelMatrix * vec4(i_position, 1.0f);
+    gl_Position = viewProjectionMatrix * modelMatrix * vec4(i_position, 1.0f);
 
     // Set the output
     vertexColor = vec4(i_color, 1.0);
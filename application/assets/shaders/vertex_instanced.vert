@@ -0,0 +1,29 @@
+#version 330 core
+
+// Position variable has attribute position 0 and color has attribute position 1
+layout (location = 0) in vec3 i_position;
+layout (location = 1) in vec3 i_color;
+layout (location = 2) in vec2 i_textureCoord;
+
+// The per instance model matrix (takes up locations 3, 4, 5, and 6, one for each column)
+layout (location = 3) in mat4 i_modelMatrix;
+
+// The per instance layers of the two textures within their texture arrays, 0 for textures which aren't packed
+layout (location = 7) in vec2 i_textureLayers;
+
+// Specify a color output to give the fragment shader
+out vec4 vertexColor;
+out vec2 textureCoord;
+flat out vec2 textureLayers;
+
+#include "frame_data.glsl"
+
+void main() {
+    // Giving all of aPosition to the constructor saves us from manually writing x, y, and z
+    gl_Position = viewProjectionMatrix * i_modelMatrix * vec4(i_position, 1.0f);
+
+    // Set the output
+    vertexColor = vec4(i_color, 1.0);
+    textureCoord = i_textureCoord;
+    textureLayers = i_textureLayers;
+}
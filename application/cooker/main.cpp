@@ -0,0 +1,104 @@
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "util/macros.hpp"
+#include "util/io/logger.hpp"
+#include "util/logger/Logger.hpp"
+
+#include "gemstone/core.hpp"
+#include "gemstone/renderer/mesh/logger.hpp"
+#include "gemstone/renderer/mesh/CookedMesh.hpp"
+#include "gemstone/renderer/mesh/IndexedGeometry.hpp"
+#include "gemstone/renderer/mesh/Mesh.hpp"
+#include "gemstone/renderer/mesh/MeshLod.hpp"
+#include "gemstone/renderer/mesh/ObjLoader.hpp"
+#include "gemstone/renderer/texture/logger.hpp"
+#include "gemstone/renderer/texture/CookedTexture.hpp"
+#include "gemstone/renderer/texture/TextureCompressor.hpp"
+#include "gemstone/renderer/texture/TextureDecoder.hpp"
+
+/**
+ * @brief The name of the logger for the cooker. A general logger
+ */
+#define GENERAL_LOGGER_NAME "GENERAL"
+const std::string LOGGER_NAME = GENERAL_LOGGER_NAME;
+
+void printUsage(const std::string& executableName);
+void cookMesh(const std::string& sourceFilename, const std::string& cookedFilename);
+void cookTexture(const std::string& sourceFilename, const std::string& cookedFilename, const std::string& formatName);
+
+/**
+ * @brief The offline asset cooker. Converts source assets into the binary formats the engine loads at
+ * runtime, so the application never has to parse text formats
+ * 
+ * @example Cooker mesh assets/meshes/cube.obj assets/meshes/cube.gmesh
+ * @example Cooker texture assets/textures/brick_wall.jpg assets/textures/brick_wall.gtex bc1
+ */
+int main(int argc, char* argv[]) {
+    ASSERT_GEM_VERSION();
+
+    GEM::util::Logger::registerLoggers({
+        {GENERAL_LOGGER_NAME, GEM::util::Logger::Level::info},
+        {IO_LOGGER_NAME, GEM::util::Logger::Level::error},
+        {MESH_LOGGER_NAME, GEM::util::Logger::Level::info},
+        {TEXTURE_LOGGER_NAME, GEM::util::Logger::Level::info}
+    });
+
+    if (argc != 4 && argc != 5) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    const std::string assetType = argv[1];
+    try {
+        if (assetType == "mesh" && argc == 4) {
+            cookMesh(argv[2], argv[3]);
+        } else if (assetType == "texture") {
+            cookTexture(argv[2], argv[3], argc == 5 ? argv[4] : "");
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    } catch (const std::exception& ex) {
+        LOG_CRITICAL("Caught exception when trying to cook " + std::string(argv[2]) + ":\n" + std::string(ex.what()));
+        return 1;
+    }
+
+    return 0;
+}
+
+void printUsage(const std::string& executableName) {
+    std::cerr << "Usage: " << executableName << " mesh <source.obj> <cooked.gmesh>" << std::endl;
+    std::cerr << "       " << executableName << " texture <source.png|jpg> <cooked.gtex> [bc1|bc3|bc5]" << std::endl;
+}
+
+void cookMesh(const std::string& sourceFilename, const std::string& cookedFilename) {
+    LOG_INFO("Cooking mesh " + sourceFilename + " into " + cookedFilename);
+
+    // Do all of the expensive work here, including generating the levels of detail, so loading the cooked
+    // mesh is nothing but I/O
+    GEM::Renderer::IndexedGeometry geometry = GEM::Renderer::ObjLoader::load(sourceFilename);
+    const std::vector<GEM::Renderer::MeshLod> lods = GEM::Renderer::Mesh::optimizeGeometry(geometry);
+
+    GEM::Renderer::CookedMesh::cook(geometry, lods, cookedFilename);
+}
+
+void cookTexture(const std::string& sourceFilename, const std::string& cookedFilename, const std::string& formatName) {
+    LOG_INFO("Cooking texture " + sourceFilename + " into " + cookedFilename);
+
+    const GEM::Renderer::TextureDecoder::Image image = GEM::Renderer::TextureDecoder::decode(0, sourceFilename);
+    if (!image.p_pixels) {
+        throw std::runtime_error(image.errorMessage);
+    }
+
+    // Keep the alpha of images which have one unless we are told otherwise
+    const bool hasAlpha = image.channelCount == 2 || image.channelCount == 4;
+    const GEM::Renderer::TextureCompressor::Format format = !formatName.empty() ?
+        GEM::Renderer::TextureCompressor::getFormatFromName(formatName) :
+        hasAlpha ? GEM::Renderer::TextureCompressor::Format::bc3 : GEM::Renderer::TextureCompressor::Format::bc1;
+
+    GEM::Renderer::CookedTexture::cook(image, format, cookedFilename);
+}
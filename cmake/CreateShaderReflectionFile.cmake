@@ -0,0 +1,193 @@
+#======================================================================
+# A function to get the c++ type, std140 alignment, and std140 size of a glsl type
+#======================================================================
+function(get_std140_type glsl_type cpp_type_var alignment_var size_var)
+    if(glsl_type MATCHES "^(float|int|uint|bool)$")
+        # glsl bools are 4 bytes in a uniform block, and can be set as uints
+        set(cpp_types_float "float")
+        set(cpp_types_int "int32_t")
+        set(cpp_types_uint "uint32_t")
+        set(cpp_types_bool "uint32_t")
+        set(cpp_type ${cpp_types_${glsl_type}})
+        set(alignment 4)
+        set(size 4)
+    elseif(glsl_type MATCHES "^([iub]?)vec([234])$")
+        set(component_count ${CMAKE_MATCH_2})
+        set(cpp_type "glm::${glsl_type}")
+        if(CMAKE_MATCH_1 STREQUAL "b")
+            set(cpp_type "glm::uvec${component_count}")
+        endif()
+        math(EXPR size "4 * ${component_count}")
+        # vec3s are aligned like vec4s
+        if(component_count EQUAL 2)
+            set(alignment 8)
+        else()
+            set(alignment 16)
+        endif()
+    elseif(glsl_type MATCHES "^mat([234])$")
+        # Each column of a matrix is padded out to a vec4, which glm's matNx4 matches
+        set(column_count ${CMAKE_MATCH_1})
+        set(cpp_type "glm::mat${column_count}x4")
+        if(column_count EQUAL 4)
+            set(cpp_type "glm::mat4")
+        endif()
+        math(EXPR size "16 * ${column_count}")
+        set(alignment 16)
+    elseif(glsl_type MATCHES "^sampler")
+        # Samplers can't be in uniform blocks, but plain sampler uniforms are set from a texture
+        set(cpp_type "GEM::Renderer::Texture")
+        set(alignment 0)
+        set(size 0)
+    else()
+        set(cpp_type "")
+        set(alignment 0)
+        set(size 0)
+    endif()
+
+    set(${cpp_type_var} ${cpp_type} PARENT_SCOPE)
+    set(${alignment_var} ${alignment} PARENT_SCOPE)
+    set(${size_var} ${size} PARENT_SCOPE)
+endfunction()
+
+#======================================================================
+# A function to generate a header reflecting the uniforms of a shader
+#======================================================================
+function(create_shader_reflection_file input_file)
+    # Get the directory and name of the input file so we can use the "reflection" subdirectory
+    get_filename_component(input_file_directory ${input_file} DIRECTORY)
+    get_filename_component(input_file_name ${input_file} NAME)
+    string(MAKE_C_IDENTIFIER ${input_file_name} shader_identifier)
+    set(output_file ${input_file_directory}/reflection/${input_file_name}.hpp)
+    message(STATUS "Reflecting the uniforms of ${input_file} into ${output_file}")
+
+    # Read in the contents of the file without its comments. Semicolons separate cmake list elements, so
+    # swap them for @ which glsl never uses
+    file(READ ${input_file} input_contents)
+    string(REGEX REPLACE "/\\*([^*]|\\*+[^*/])*\\*+/" "" input_contents "${input_contents}")
+    string(REGEX REPLACE "//[^\n]*" "" input_contents "${input_contents}")
+    string(REPLACE ";" "@" input_contents "${input_contents}")
+
+    set(uniform_ids "")
+    set(uniform_blocks "")
+
+    # Lay each uniform block out as a struct matching std140
+    string(REGEX MATCHALL "(layout[ \t\r\n]*\\([^)]*\\)[ \t\r\n]*)?uniform[ \t\r\n]+[A-Za-z_][A-Za-z0-9_]*[ \t\r\n]*{[^}]*}[^@]*@" blocks "${input_contents}")
+    foreach(block ${blocks})
+        string(REPLACE "${block}" "" input_contents "${input_contents}")
+
+        string(REGEX MATCH "uniform[ \t\r\n]+([A-Za-z_][A-Za-z0-9_]*)[ \t\r\n]*{([^}]*)}" block_match "${block}")
+        set(block_name ${CMAKE_MATCH_1})
+        set(block_body ${CMAKE_MATCH_2})
+        if(NOT block MATCHES "std140")
+            message(WARNING "Uniform block ${block_name} in ${input_file} is not std140 so no struct is generated for it")
+            continue()
+        endif()
+
+        set(members "")
+        set(offset_checks "")
+        set(offset 0)
+        set(padding_count 0)
+        string(REPLACE "@" ";" block_members "${block_body}")
+        foreach(block_member ${block_members})
+            string(STRIP "${block_member}" block_member)
+            if(block_member STREQUAL "")
+                continue()
+            endif()
+            if(NOT block_member MATCHES "^([A-Za-z0-9_]+)[ \t\r\n]+([A-Za-z_][A-Za-z0-9_]*)$")
+                message(FATAL_ERROR "Unsupported member \"${block_member}\" in uniform block ${block_name} of ${input_file}")
+            endif()
+            set(member_type ${CMAKE_MATCH_1})
+            set(member_name ${CMAKE_MATCH_2})
+
+            get_std140_type(${member_type} cpp_type alignment size)
+            if(size EQUAL 0)
+                message(FATAL_ERROR "Unsupported type ${member_type} of ${member_name} in uniform block ${block_name} of ${input_file}")
+            endif()
+
+            # Pad up to the member's alignment
+            math(EXPR aligned_offset "(${offset} + ${alignment} - 1) / ${alignment} * ${alignment}")
+            if(aligned_offset GREATER offset)
+                math(EXPR padding_size "${aligned_offset} - ${offset}")
+                string(APPEND members "        uint8_t padding${padding_count}[${padding_size}];\n")
+                math(EXPR padding_count "${padding_count} + 1")
+            endif()
+
+            string(APPEND members "        ${cpp_type} ${member_name}; // offset ${aligned_offset}\n")
+            string(APPEND offset_checks "    static_assert(offsetof(${block_name}, ${member_name}) == ${aligned_offset}, \"${block_name} does not match std140\");\n")
+            math(EXPR offset "${aligned_offset} + ${size}")
+        endforeach()
+
+        # The block's size is rounded up to a multiple of a vec4
+        math(EXPR block_size "(${offset} + 15) / 16 * 16")
+        if(block_size GREATER offset)
+            math(EXPR padding_size "${block_size} - ${offset}")
+            string(APPEND members "        uint8_t padding${padding_count}[${padding_size}];\n")
+        endif()
+
+        if(NOT uniform_blocks STREQUAL "")
+            string(APPEND uniform_blocks "\n")
+        endif()
+        string(APPEND uniform_blocks "    struct ${block_name} {\n${members}    };\n")
+        string(APPEND uniform_blocks "${offset_checks}")
+        string(APPEND uniform_blocks "    static_assert(sizeof(${block_name}) == ${block_size}, \"${block_name} does not match std140\");\n")
+    endforeach()
+
+    # Give every uniform outside of a block a typed id
+    string(REGEX MATCHALL "uniform[ \t\r\n]+[A-Za-z0-9_]+[ \t\r\n]+[A-Za-z_][A-Za-z0-9_]*[ \t\r\n]*(\\[[0-9A-Za-z_ ]*\\])?[ \t\r\n]*@" uniforms "${input_contents}")
+    foreach(uniform ${uniforms})
+        string(REGEX MATCH "uniform[ \t\r\n]+([A-Za-z0-9_]+)[ \t\r\n]+([A-Za-z_][A-Za-z0-9_]*)[ \t\r\n]*(\\[[0-9A-Za-z_ ]*\\])?" uniform_match "${uniform}")
+        set(uniform_type ${CMAKE_MATCH_1})
+        set(uniform_name ${CMAKE_MATCH_2})
+        if(NOT "${CMAKE_MATCH_3}" STREQUAL "")
+            message(WARNING "Uniform array ${uniform_name} in ${input_file} is not supported so no id is generated for it")
+            continue()
+        endif()
+
+        get_std140_type(${uniform_type} cpp_type alignment size)
+
+        # Outside of a block nothing is padded, so matrices and bools are set from their plain c++ types
+        if(uniform_type MATCHES "^(mat[234]|bool|bvec[234])$")
+            set(cpp_type "glm::${uniform_type}")
+            if(uniform_type STREQUAL "bool")
+                set(cpp_type "bool")
+            endif()
+        endif()
+        if(cpp_type STREQUAL "")
+            message(FATAL_ERROR "Unsupported type ${uniform_type} of uniform ${uniform_name} in ${input_file}")
+        endif()
+
+        # Keyword variants can declare the same uniform in each branch of an #ifdef, which only needs one id as
+        # long as every declaration is set from the same c++ type
+        if(DEFINED uniform_cpp_type_${uniform_name})
+            if(NOT uniform_cpp_type_${uniform_name} STREQUAL cpp_type)
+                message(FATAL_ERROR "Uniform ${uniform_name} in ${input_file} is declared as both ${uniform_cpp_type_${uniform_name}} and ${cpp_type}")
+            endif()
+            continue()
+        endif()
+        set(uniform_cpp_type_${uniform_name} ${cpp_type})
+
+        string(APPEND uniform_ids "    constexpr GEM::Renderer::Uniform<${cpp_type}> ${uniform_name} = {\"${uniform_name}\"};\n")
+    endforeach()
+
+    set(header_contents "#pragma once\n\n")
+    string(APPEND header_contents "/**\n * @brief This file is generated from ${input_file_name} by cmake/CreateShaderReflectionFile.cmake, do not edit it\n */\n\n")
+    string(APPEND header_contents "#include <cstddef> // offsetof\n#include <cstdint>\n\n")
+    string(APPEND header_contents "#include <glm/glm.hpp>\n\n")
+    string(APPEND header_contents "#include \"gemstone/renderer/shader/Uniform.hpp\"\n#include \"gemstone/renderer/texture/Texture.hpp\"\n\n")
+    string(APPEND header_contents "namespace Shaders {\nnamespace ${shader_identifier} {\n")
+    string(APPEND header_contents "${uniform_blocks}")
+    if(NOT uniform_blocks STREQUAL "" AND NOT uniform_ids STREQUAL "")
+        string(APPEND header_contents "\n")
+    endif()
+    string(APPEND header_contents "${uniform_ids}")
+    string(APPEND header_contents "}\n}")
+
+    # Only touch the header when it changes so everything including it isn't rebuilt every configure
+    if(EXISTS ${output_file})
+        file(READ ${output_file} existing_contents)
+        if(existing_contents STREQUAL header_contents)
+            return()
+        endif()
+    endif()
+    file(WRITE ${output_file} "${header_contents}")
+endfunction()
\ No newline at end of file
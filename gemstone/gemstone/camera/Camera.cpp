@@ -1,8 +1,10 @@
+#include <array>
 #include <cmath>
 #include <string>
 #include <vector>
 
 #include <glm/glm.hpp>
+#include <glm/gtc/matrix_access.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
 #include "util/logger/Logger.hpp"
@@ -101,7 +103,10 @@ GEM::Camera::Camera(
             ) :
             settings.minFOVDegrees
     ),
-    m_settings(settings)
+    m_settings(settings),
+    m_viewMatrix(1.0f),                 // updated in the updateMatrices call
+    m_projectionMatrix(1.0f),           // updated in the updateMatrices call
+    m_viewProjectionMatrix(1.0f)        // updated in the updateMatrices call
 {
     LOG_FUNCTION_CALL_INFO(
         "id {} , position ({} {} {}) , look ({} {} {}) , up ({} {} {}) , pitch {} , yaw {} , roll {} , fov deg {}",
@@ -113,6 +118,7 @@ GEM::Camera::Camera(
     );
     UNUSED(m_roll);
     updateOrientation();
+    updateMatrices();
 }
 
 /**
@@ -123,35 +129,44 @@ GEM::Camera::~Camera() {
 }
 
 /**
- * @brief Update the orientation, the field of view, and the position of the camera
+ * @brief Update the orientation, the field of view, and the position of the camera, then the matrices
+ * made from them
  */
 void GEM::Camera::update() {
     updateOrientation();
     updateFieldOfView();
     updatePosition();
+    updateMatrices();
 }
 
 /**
- * @brief Get the view matrix of the camera to represent where it is looking in world space and where from
+ * @brief Get the six planes bounding what the camera can see, extracted from the combined view and projection
+ * matrices (Gribb and Hartmann). Each plane is stored as (normal, distance) with its normal pointing into the
+ * frustum, so a point p is inside when dot(normal, p) + distance >= 0 for every plane
  * 
- * @return glm::mat4 The view matrix of the camera
+ * @return std::array<glm::vec4, 6> The left, right, bottom, top, near, and far planes in world space
  */
-glm::mat4 GEM::Camera::getViewMatrix() const {
-    return glm::lookAt(m_worldPosition, m_worldPosition + m_lookVector, m_upVector);
-}
+std::array<glm::vec4, 6> GEM::Camera::getFrustumPlanes() const {
+    const glm::vec4 row0 = glm::row(m_viewProjectionMatrix, 0);
+    const glm::vec4 row1 = glm::row(m_viewProjectionMatrix, 1);
+    const glm::vec4 row2 = glm::row(m_viewProjectionMatrix, 2);
+    const glm::vec4 row3 = glm::row(m_viewProjectionMatrix, 3);
+
+    std::array<glm::vec4, 6> frustumPlanes = {
+        row3 + row0,
+        row3 - row0,
+        row3 + row1,
+        row3 - row1,
+        row3 + row2,
+        row3 - row2
+    };
+
+    // Normalize so the plane equations give actual distances
+    for (glm::vec4& plane : frustumPlanes) {
+        plane = plane / glm::length(glm::vec3(plane));
+    }
 
-/**
- * @brief Get the projection matrix of the camera using its view frustum dimension
- * 
- * @return glm::mat4 The projection matrix for the camera
- */
-glm::mat4 GEM::Camera::getProjectionMatrix() const {
-    return glm::perspective(
-        glm::radians(m_fovDegrees), 
-        static_cast<float>(mp_context->getWindowWidthPixels()) / static_cast<float>(mp_context->getWindowHeightPixels()),
-        m_settings.nearClippingPlane,    
-        m_settings.farClippingPlane    
-    );
+    return frustumPlanes;
 }
 
 /* ------------------------------ private member functions ------------------------------ */
@@ -232,3 +247,18 @@ void GEM::Camera::updatePosition() {
     }
 }
 
+/**
+ * @brief Update the view matrix from where the camera is and where it is looking, and the projection matrix from
+ * its field of view, the window's aspect ratio, and its clipping planes
+ */
+void GEM::Camera::updateMatrices() {
+    m_viewMatrix = glm::lookAt(m_worldPosition, m_worldPosition + m_lookVector, m_upVector);
+    m_projectionMatrix = glm::perspective(
+        glm::radians(m_fovDegrees), 
+        static_cast<float>(mp_context->getWindowWidthPixels()) / static_cast<float>(mp_context->getWindowHeightPixels()),
+        m_settings.nearClippingPlane,    
+        m_settings.farClippingPlane    
+    );
+    m_viewProjectionMatrix = m_projectionMatrix * m_viewMatrix;
+}
+
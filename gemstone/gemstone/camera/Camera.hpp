@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <string>
 
 #include <glm/glm.hpp>
@@ -59,8 +60,14 @@ public: // public member functions
     Camera(const Camera& other) = default;
 
     uint32_t getID() const { return m_id; }
-    glm::mat4 getViewMatrix() const;
-    glm::mat4 getProjectionMatrix() const;
+    float getNearClippingPlane() const { return m_settings.nearClippingPlane; }
+    float getFarClippingPlane() const { return m_settings.farClippingPlane; }
+    const glm::vec3& getWorldPosition() const { return m_worldPosition; }
+    const glm::mat4& getViewMatrix() const { return m_viewMatrix; }
+    const glm::mat4& getProjectionMatrix() const { return m_projectionMatrix; }
+    const glm::mat4& getViewProjectionMatrix() const { return m_viewProjectionMatrix; }
+    std::array<glm::vec4, 6> getFrustumPlanes() const;
+    float getViewportHeightPixels() const { return static_cast<float>(mp_context->getWindowHeightPixels()); }
 
     void update();
     
@@ -71,6 +78,7 @@ private: // private member functions
     void updateOrientation();
     void updateFieldOfView();
     void updatePosition();
+    void updateMatrices();
 
 private: // private member variables
     const uint32_t m_id;
@@ -95,4 +103,9 @@ private: // private member variables
 
     // Settings
     GEM::Camera::Settings m_settings;
+
+    // Worked out once per update rather than every time they are asked for
+    glm::mat4 m_viewMatrix;
+    glm::mat4 m_projectionMatrix;
+    glm::mat4 m_viewProjectionMatrix;
 };
\ No newline at end of file
@@ -32,20 +32,21 @@ const std::string GEM::Object::LOGGER_NAME = OBJECT_LOGGER_NAME;
 /* ------------------------------ private static functions ------------------------------ */
 
 /**
- * @brief Load the mesh from the desired file
+ * @brief Load the mesh from the desired file. Objects loading the same file share the same gpu buffers
  * 
  * @param meshFilename The full path to the file containing the mesh
  * @return std::shared_ptr<GEM::Renderer::Mesh> The shared pointer to the mesh contained within the file
  */
 std::shared_ptr<GEM::Renderer::Mesh> GEM::Object::loadMesh(const std::string& meshFilename) {
     LOG_FUNCTION_CALL_TRACE("mesh filename {}", meshFilename);
-    return std::make_shared<GEM::Renderer::Mesh>();
+    return std::make_shared<GEM::Renderer::Mesh>(meshFilename);
 }
 
 /**
- * @brief Load a texture at the specified file
+ * @brief Load a texture at the specified file. Objects loading the same file share the same gl texture
  * 
  * @param textureFilename The full path to the texture file
+ * @param index The texture unit the texture is activated on
  * @return std::shared_ptr<GEM::Renderer::Texture> The shared pointer containing the texture
  */
 std::shared_ptr<GEM::Renderer::Texture> GEM::Object::loadTexture(const std::string& textureFilename, const uint32_t index) {
@@ -88,7 +89,9 @@ GEM::Object::Object(
     m_worldPosition(initialWorldPosition),
     m_scale(initialScale),
     m_rotationAxis(initialRotationAxis),
-    m_rotationAmountDegrees(initialRotationAmountDegrees)
+    m_rotationAmountDegrees(initialRotationAmountDegrees),
+    m_worldBoundsMin(0.0f),
+    m_worldBoundsMax(0.0f)
 {
     LOG_FUNCTION_ENTRY_TRACE(
         "id {} , mesh filename {} , texture filename {} , texture filename 2 {} , initial world position [ {} {} {} ]",
@@ -98,6 +101,8 @@ GEM::Object::Object(
         m_textureFilename2,
         m_worldPosition.x, m_worldPosition.y, m_worldPosition.z
     );
+
+    updateWorldBounds();
 }
 
 /**
@@ -127,6 +132,8 @@ void GEM::Object::update() {
         std::sin(3 * m_id + glfwTime)
     );
     m_scale = m_scale + scaleOffset;
+
+    updateWorldBounds();
 }
 
 /**
@@ -174,3 +181,23 @@ glm::mat4 GEM::Object::getModelMatrix() const {
 
 /* ------------------------------ private member functions ------------------------------ */
 
+/**
+ * @brief Transform the mesh's bounding box by the model matrix to get the box bounding the object in world
+ * space. The box's center is transformed as a point and its extents by the absolute value of the rotation
+ * and scale, giving the tightest axis aligned box around the rotated one (Arvo)
+ */
+void GEM::Object::updateWorldBounds() {
+    const glm::mat4 modelMatrix = getModelMatrix();
+    const glm::vec3 localCenter = (mp_mesh->getBoundsMin() + mp_mesh->getBoundsMax()) * 0.5f;
+    const glm::vec3 localExtents = (mp_mesh->getBoundsMax() - mp_mesh->getBoundsMin()) * 0.5f;
+
+    const glm::vec3 worldCenter = glm::vec3(modelMatrix * glm::vec4(localCenter, 1.0f));
+    const glm::vec3 worldExtents =
+        (glm::abs(glm::vec3(modelMatrix[0])) * localExtents.x) +
+        (glm::abs(glm::vec3(modelMatrix[1])) * localExtents.y) +
+        (glm::abs(glm::vec3(modelMatrix[2])) * localExtents.z);
+
+    m_worldBoundsMin = worldCenter - worldExtents;
+    m_worldBoundsMax = worldCenter + worldExtents;
+}
+
@@ -29,10 +29,14 @@ public: // public member functions
     );
     ~Object();
 
+    std::string getMeshFilename() const { return m_meshFilename; }
     glm::vec3 getWorldPosition() const { return m_worldPosition; }
     glm::vec3 getScale() const { return m_scale; }
     glm::mat4 getModelMatrix() const;
+    glm::vec3 getWorldBoundsMin() const { return m_worldBoundsMin; }
+    glm::vec3 getWorldBoundsMax() const { return m_worldBoundsMax; }
 
+    std::shared_ptr<const GEM::Renderer::Mesh> getMesh() const { return mp_mesh; }
     std::shared_ptr<const GEM::Renderer::Texture> getTexture() const { return mp_texture; }
     std::shared_ptr<const GEM::Renderer::Texture> getTexture2() const { return mp_texture2; }
 
@@ -40,6 +44,7 @@ public: // public member functions
     void draw();
 
 private: // private member functions
+    void updateWorldBounds();
     std::shared_ptr<GEM::Renderer::Mesh> loadMesh(const std::string& meshFilename);
     std::shared_ptr<GEM::Renderer::Texture> loadTexture(const std::string& textureFilename, const uint32_t index);
 
@@ -57,4 +62,8 @@ private: // private member variables
     glm::vec3 m_scale;
     glm::vec3 m_rotationAxis;
     float m_rotationAmountDegrees;
+
+    // The mesh's bounding box transformed into world space, refreshed every time the object moves
+    glm::vec3 m_worldBoundsMin;
+    glm::vec3 m_worldBoundsMax;
 };
\ No newline at end of file
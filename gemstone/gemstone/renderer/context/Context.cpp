@@ -13,6 +13,7 @@
 #include "gemstone/core.hpp"
 #include "gemstone/renderer/context/logger.hpp"
 #include "gemstone/renderer/context/Context.hpp"
+#include "gemstone/renderer/state/StateCache.hpp"
 
 /* ------------------------------ public static variables ------------------------------ */
 
@@ -205,7 +206,7 @@ std::shared_ptr<GLFWwindow> GEM::Renderer::Context::Context::glfwInitCreateWindo
     }
 
     // For 3d depth buffering
-    glEnable(GL_DEPTH_TEST);
+    GEM::Renderer::StateCache::enable(GL_DEPTH_TEST);
 
     return p_glfwWindow;
 }
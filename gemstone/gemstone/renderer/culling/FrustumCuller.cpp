@@ -0,0 +1,265 @@
+#include <array>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#endif
+
+#include "util/logger/Logger.hpp"
+
+#include "gemstone/camera/Camera.hpp"
+#include "gemstone/object/Object.hpp"
+#include "gemstone/renderer/culling/logger.hpp"
+#include "gemstone/renderer/culling/FrustumCuller.hpp"
+
+/* ------------------------------ public static variables ------------------------------ */
+
+/**
+ * @brief The name of the logger the FrustumCuller class uses
+ */
+const std::string GEM::Renderer::FrustumCuller::LOGGER_NAME = CULLING_LOGGER_NAME;
+
+/**
+ * @brief The number of boxes tested at once, decided by the widest instruction set we were compiled for
+ */
+#if defined(__AVX__)
+const uint32_t GEM::Renderer::FrustumCuller::SIMD_WIDTH = 8;
+#elif defined(__SSE__) || defined(_M_X64)
+const uint32_t GEM::Renderer::FrustumCuller::SIMD_WIDTH = 4;
+#else
+const uint32_t GEM::Renderer::FrustumCuller::SIMD_WIDTH = 1;
+#endif
+
+/* ------------------------------ private static variables ------------------------------ */
+
+/* ------------------------------ public static functions ------------------------------ */
+
+/* ------------------------------ private static functions ------------------------------ */
+
+/* ------------------------------ public member functions ------------------------------ */
+
+/**
+ * @brief Construct a new GEM::Renderer::FrustumCuller::FrustumCuller object with no bounds to test
+ */
+GEM::Renderer::FrustumCuller::FrustumCuller() :
+    m_centerX(),
+    m_centerY(),
+    m_centerZ(),
+    m_extentX(),
+    m_extentY(),
+    m_extentZ(),
+    m_boundsCount(0),
+    m_visibleIndices(),
+    m_visibleObjectPtrs(),
+    m_statistics({0, 0, 0})
+{
+    LOG_FUNCTION_CALL_INFO("simd width {}", GEM::Renderer::FrustumCuller::SIMD_WIDTH);
+}
+
+/**
+ * @brief Destroy the GEM::Renderer::FrustumCuller::FrustumCuller object
+ */
+GEM::Renderer::FrustumCuller::~FrustumCuller() {
+    LOG_FUNCTION_CALL_TRACE("this ptr {}", static_cast<void*>(this));
+}
+
+/**
+ * @brief Find every object whose world space bounding box is at least partly inside the camera's view
+ * frustum. The visible objects keep the order they were given in
+ *
+ * @param camera The camera whose frustum the objects are tested against
+ * @param objectPtrs The objects to cull
+ */
+void GEM::Renderer::FrustumCuller::cull(const GEM::Camera& camera, const std::vector<std::shared_ptr<GEM::Object>>& objectPtrs) {
+    clearBounds();
+    for (const std::shared_ptr<GEM::Object>& p_object : objectPtrs) {
+        addBounds(p_object->getWorldBoundsMin(), p_object->getWorldBoundsMax());
+    }
+
+    cullBounds(camera.getFrustumPlanes());
+
+    m_visibleObjectPtrs.clear();
+    for (const uint32_t index : m_visibleIndices) {
+        m_visibleObjectPtrs.push_back(objectPtrs[index]);
+    }
+}
+
+/**
+ * @brief Test every added bounding box against the frustum planes, keeping the indices of the boxes which are
+ * not entirely outside of any single plane. This is conservative, a box near a corner of the frustum may be
+ * kept even though it is outside, but a visible box is never thrown away
+ *
+ * @param frustumPlanes The planes bounding the frustum, with normalized normals pointing inwards
+ */
+void GEM::Renderer::FrustumCuller::cullBounds(const std::array<glm::vec4, 6>& frustumPlanes) {
+    padBounds();
+    m_visibleIndices.clear();
+
+    // A box is outside of a plane when its center is further behind the plane than its extents projected
+    // onto the plane's normal can reach, which only depends on the absolute value of the normal
+    std::array<glm::vec3, 6> absoluteNormals;
+    for (uint32_t p = 0; p < 6; ++p) {
+        absoluteNormals[p] = glm::abs(glm::vec3(frustumPlanes[p]));
+    }
+
+#if defined(__AVX__)
+    // Broadcast every plane across a register once rather than once per batch of boxes
+    __m256 planeX[6], planeY[6], planeZ[6], planeW[6], absoluteNormalX[6], absoluteNormalY[6], absoluteNormalZ[6];
+    for (uint32_t p = 0; p < 6; ++p) {
+        planeX[p] = _mm256_set1_ps(frustumPlanes[p].x);
+        planeY[p] = _mm256_set1_ps(frustumPlanes[p].y);
+        planeZ[p] = _mm256_set1_ps(frustumPlanes[p].z);
+        planeW[p] = _mm256_set1_ps(frustumPlanes[p].w);
+        absoluteNormalX[p] = _mm256_set1_ps(absoluteNormals[p].x);
+        absoluteNormalY[p] = _mm256_set1_ps(absoluteNormals[p].y);
+        absoluteNormalZ[p] = _mm256_set1_ps(absoluteNormals[p].z);
+    }
+#elif defined(__SSE__) || defined(_M_X64)
+    // Broadcast every plane across a register once rather than once per batch of boxes
+    __m128 planeX[6], planeY[6], planeZ[6], planeW[6], absoluteNormalX[6], absoluteNormalY[6], absoluteNormalZ[6];
+    for (uint32_t p = 0; p < 6; ++p) {
+        planeX[p] = _mm_set1_ps(frustumPlanes[p].x);
+        planeY[p] = _mm_set1_ps(frustumPlanes[p].y);
+        planeZ[p] = _mm_set1_ps(frustumPlanes[p].z);
+        planeW[p] = _mm_set1_ps(frustumPlanes[p].w);
+        absoluteNormalX[p] = _mm_set1_ps(absoluteNormals[p].x);
+        absoluteNormalY[p] = _mm_set1_ps(absoluteNormals[p].y);
+        absoluteNormalZ[p] = _mm_set1_ps(absoluteNormals[p].z);
+    }
+#endif
+
+    const uint32_t paddedCount = static_cast<uint32_t>(m_centerX.size());
+    for (uint32_t i = 0; i < paddedCount; i += GEM::Renderer::FrustumCuller::SIMD_WIDTH) {
+#if defined(__AVX__)
+        const __m256 centerX = _mm256_loadu_ps(m_centerX.data() + i);
+        const __m256 centerY = _mm256_loadu_ps(m_centerY.data() + i);
+        const __m256 centerZ = _mm256_loadu_ps(m_centerZ.data() + i);
+        const __m256 extentX = _mm256_loadu_ps(m_extentX.data() + i);
+        const __m256 extentY = _mm256_loadu_ps(m_extentY.data() + i);
+        const __m256 extentZ = _mm256_loadu_ps(m_extentZ.data() + i);
+
+        __m256 outside = _mm256_setzero_ps();
+        for (uint32_t p = 0; p < 6; ++p) {
+            const __m256 distance = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(centerX, planeX[p]), _mm256_mul_ps(centerY, planeY[p])),
+                _mm256_add_ps(_mm256_mul_ps(centerZ, planeZ[p]), planeW[p])
+            );
+            const __m256 radius = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(extentX, absoluteNormalX[p]), _mm256_mul_ps(extentY, absoluteNormalY[p])),
+                _mm256_mul_ps(extentZ, absoluteNormalZ[p])
+            );
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_LT_OQ));
+        }
+        const uint32_t visibleMask = ~static_cast<uint32_t>(_mm256_movemask_ps(outside)) & 0xFF;
+#elif defined(__SSE__) || defined(_M_X64)
+        const __m128 centerX = _mm_loadu_ps(m_centerX.data() + i);
+        const __m128 centerY = _mm_loadu_ps(m_centerY.data() + i);
+        const __m128 centerZ = _mm_loadu_ps(m_centerZ.data() + i);
+        const __m128 extentX = _mm_loadu_ps(m_extentX.data() + i);
+        const __m128 extentY = _mm_loadu_ps(m_extentY.data() + i);
+        const __m128 extentZ = _mm_loadu_ps(m_extentZ.data() + i);
+
+        __m128 outside = _mm_setzero_ps();
+        for (uint32_t p = 0; p < 6; ++p) {
+            const __m128 distance = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(centerX, planeX[p]), _mm_mul_ps(centerY, planeY[p])),
+                _mm_add_ps(_mm_mul_ps(centerZ, planeZ[p]), planeW[p])
+            );
+            const __m128 radius = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(extentX, absoluteNormalX[p]), _mm_mul_ps(extentY, absoluteNormalY[p])),
+                _mm_mul_ps(extentZ, absoluteNormalZ[p])
+            );
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+        }
+        const uint32_t visibleMask = ~static_cast<uint32_t>(_mm_movemask_ps(outside)) & 0xF;
+#else
+        bool outside = false;
+        for (uint32_t p = 0; p < 6 && !outside; ++p) {
+            const float distance = (m_centerX[i] * frustumPlanes[p].x) + (m_centerY[i] * frustumPlanes[p].y) + (m_centerZ[i] * frustumPlanes[p].z) + frustumPlanes[p].w;
+            const float radius = (m_extentX[i] * absoluteNormals[p].x) + (m_extentY[i] * absoluteNormals[p].y) + (m_extentZ[i] * absoluteNormals[p].z);
+            outside = distance + radius < 0.0f;
+        }
+        const uint32_t visibleMask = outside ? 0 : 1;
+#endif
+
+        // Keep the visible boxes, ignoring the padding past the end of the real ones
+        for (uint32_t lane = 0; lane < GEM::Renderer::FrustumCuller::SIMD_WIDTH; ++lane) {
+            if (((visibleMask >> lane) & 1) && i + lane < m_boundsCount) {
+                m_visibleIndices.push_back(i + lane);
+            }
+        }
+    }
+
+    m_statistics.testedCount = m_boundsCount;
+    m_statistics.visibleCount = static_cast<uint32_t>(m_visibleIndices.size());
+    m_statistics.culledCount = m_statistics.testedCount - m_statistics.visibleCount;
+
+    LOG_TRACE("Tested {} bounds , {} visible , {} culled", m_statistics.testedCount, m_statistics.visibleCount, m_statistics.culledCount);
+}
+
+/**
+ * @brief Forget every bounding box so a new set can be added
+ */
+void GEM::Renderer::FrustumCuller::clearBounds() {
+    m_centerX.clear();
+    m_centerY.clear();
+    m_centerZ.clear();
+    m_extentX.clear();
+    m_extentY.clear();
+    m_extentZ.clear();
+    m_boundsCount = 0;
+}
+
+/**
+ * @brief Add a bounding box to be tested by the next call to cullBounds. Boxes are identified by the order
+ * they were added in
+ *
+ * @param boundsMin The minimum corner of the box in world space
+ * @param boundsMax The maximum corner of the box in world space
+ */
+void GEM::Renderer::FrustumCuller::addBounds(const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+    // Drop the padding added by the last cull so the new box goes right after the real ones
+    if (m_centerX.size() != m_boundsCount) {
+        m_centerX.resize(m_boundsCount);
+        m_centerY.resize(m_boundsCount);
+        m_centerZ.resize(m_boundsCount);
+        m_extentX.resize(m_boundsCount);
+        m_extentY.resize(m_boundsCount);
+        m_extentZ.resize(m_boundsCount);
+    }
+
+    const glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+    const glm::vec3 extents = (boundsMax - boundsMin) * 0.5f;
+
+    m_centerX.push_back(center.x);
+    m_centerY.push_back(center.y);
+    m_centerZ.push_back(center.z);
+    m_extentX.push_back(extents.x);
+    m_extentY.push_back(extents.y);
+    m_extentZ.push_back(extents.z);
+    m_boundsCount += 1;
+}
+
+/* ------------------------------ private member functions ------------------------------ */
+
+/**
+ * @brief Pad the bounds out to a multiple of SIMD_WIDTH so every SIMD load stays within the arrays
+ */
+void GEM::Renderer::FrustumCuller::padBounds() {
+    const uint32_t simdWidth = GEM::Renderer::FrustumCuller::SIMD_WIDTH;
+    const uint32_t paddedCount = ((m_boundsCount + simdWidth - 1) / simdWidth) * simdWidth;
+
+    m_centerX.resize(paddedCount, 0.0f);
+    m_centerY.resize(paddedCount, 0.0f);
+    m_centerZ.resize(paddedCount, 0.0f);
+    m_extentX.resize(paddedCount, 0.0f);
+    m_extentY.resize(paddedCount, 0.0f);
+    m_extentZ.resize(paddedCount, 0.0f);
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "gemstone/camera/Camera.hpp"
+#include "gemstone/object/Object.hpp"
+
+namespace GEM {
+namespace Renderer {
+    class FrustumCuller;
+}
+}
+
+/**
+ * @brief A class that throws away every object whose world space bounding box lies entirely outside of
+ * the camera's view frustum. The boxes are gathered into structure of arrays form, as centers and extents,
+ * so they can be tested against each plane SIMD_WIDTH at a time with SSE, or AVX when it is enabled
+ * 
+ * @note Build with -mavx to test 8 boxes at a time instead of 4
+ */
+class GEM::Renderer::FrustumCuller {
+public: // public classes and enums
+    struct Statistics {
+        uint32_t testedCount;
+        uint32_t visibleCount;
+        uint32_t culledCount;
+    };
+
+public: // public static variables
+    static const std::string LOGGER_NAME;
+
+    // The number of boxes tested at once
+    static const uint32_t SIMD_WIDTH;
+
+public: // public member functions
+    FrustumCuller();
+    ~FrustumCuller();
+
+    FrustumCuller(const FrustumCuller& other) = delete;
+    void operator=(const FrustumCuller& other) = delete;
+
+    void cull(const GEM::Camera& camera, const std::vector<std::shared_ptr<GEM::Object>>& objectPtrs);
+    void cullBounds(const std::array<glm::vec4, 6>& frustumPlanes);
+
+    const std::vector<std::shared_ptr<GEM::Object>>& getVisibleObjectPtrs() const { return m_visibleObjectPtrs; }
+    const std::vector<uint32_t>& getVisibleIndices() const { return m_visibleIndices; }
+    const GEM::Renderer::FrustumCuller::Statistics& getStatistics() const { return m_statistics; }
+
+    void clearBounds();
+    void addBounds(const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+
+private: // private member functions
+    void padBounds();
+
+private: // private member variables
+    // The bounding boxes as structure of arrays, padded to a multiple of SIMD_WIDTH
+    std::vector<float> m_centerX;
+    std::vector<float> m_centerY;
+    std::vector<float> m_centerZ;
+    std::vector<float> m_extentX;
+    std::vector<float> m_extentY;
+    std::vector<float> m_extentZ;
+    uint32_t m_boundsCount;
+
+    std::vector<uint32_t> m_visibleIndices;
+    std::vector<std::shared_ptr<GEM::Object>> m_visibleObjectPtrs;
+    GEM::Renderer::FrustumCuller::Statistics m_statistics;
+};
\ No newline at end of file
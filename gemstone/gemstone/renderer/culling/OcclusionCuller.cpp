@@ -0,0 +1,620 @@
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#endif
+
+#include "util/io/FileSystem.hpp"
+#include "util/logger/Logger.hpp"
+
+#include "gemstone/camera/Camera.hpp"
+#include "gemstone/object/Object.hpp"
+#include "gemstone/renderer/culling/logger.hpp"
+#include "gemstone/renderer/culling/OcclusionCuller.hpp"
+#include "gemstone/renderer/mesh/CookedMesh.hpp"
+#include "gemstone/renderer/mesh/IndexedGeometry.hpp"
+#include "gemstone/renderer/mesh/Mesh.hpp"
+
+/* ------------------------------ public static variables ------------------------------ */
+
+/**
+ * @brief The name of the logger the OcclusionCuller class uses
+ */
+const std::string GEM::Renderer::OcclusionCuller::LOGGER_NAME = CULLING_LOGGER_NAME;
+
+/**
+ * @brief The number of pixels rasterized at once, decided by whether we were compiled with SSE
+ */
+#if defined(__SSE__) || defined(_M_X64)
+const uint32_t GEM::Renderer::OcclusionCuller::SIMD_WIDTH = 4;
+#else
+const uint32_t GEM::Renderer::OcclusionCuller::SIMD_WIDTH = 1;
+#endif
+
+/**
+ * @brief The width of the depth buffer in pixels. This must be a multiple of SIMD_WIDTH
+ */
+const uint32_t GEM::Renderer::OcclusionCuller::DEPTH_BUFFER_WIDTH = 256;
+
+/**
+ * @brief The height of the depth buffer in pixels
+ */
+const uint32_t GEM::Renderer::OcclusionCuller::DEPTH_BUFFER_HEIGHT = 128;
+
+/**
+ * @brief The smallest clip space w a triangle's vertices may have to be rasterized. Skipping a triangle only
+ * ever makes the culling more conservative, so triangles crossing the near plane are dropped instead of clipped
+ */
+const float GEM::Renderer::OcclusionCuller::NEAR_CLIP_W = 1e-3f;
+
+/**
+ * @brief How far in pixels every triangle is grown before being rasterized, to keep floating point error from
+ * opening cracks between neighbouring triangles
+ */
+const float GEM::Renderer::OcclusionCuller::EDGE_BIAS_PIXELS = 1.0f / 256.0f;
+
+/**
+ * @brief The number of triangles which makes it worth rasterizing another band of the depth buffer on its
+ * own thread
+ */
+const uint32_t GEM::Renderer::OcclusionCuller::MIN_TRIANGLES_PER_THREAD = 256;
+
+/* ------------------------------ private static variables ------------------------------ */
+
+/* ------------------------------ public static functions ------------------------------ */
+
+/* ------------------------------ private static functions ------------------------------ */
+
+/**
+ * @brief Load the positions and triangles of a mesh for the cpu to rasterize. Cooked meshes are read straight
+ * out of their mapped file and only their full detail level is kept, anything else goes through the same
+ * loading as the mesh on the gpu
+ *
+ * @param meshFilename The full path to the file containing the mesh
+ * @return GEM::Renderer::OcclusionCuller::OccluderMesh The positions and triangles of the mesh
+ * @note This function will throw if the file exists but cannot be loaded
+ */
+GEM::Renderer::OcclusionCuller::OccluderMesh GEM::Renderer::OcclusionCuller::loadOccluderMesh(const std::string& meshFilename) {
+    LOG_FUNCTION_CALL_TRACE("mesh filename {}", meshFilename);
+
+    GEM::Renderer::OcclusionCuller::OccluderMesh occluderMesh;
+
+    const std::string extension = meshFilename.substr(meshFilename.find_last_of(".") + 1);
+    if (GEM::util::FileSystem::fileExists(meshFilename) && extension == GEM::Renderer::CookedMesh::FILE_EXTENSION) {
+        const GEM::Renderer::CookedMesh cookedMesh(meshFilename);
+
+        const GEM::Renderer::CookedMesh::Attribute* p_positionAttribute = nullptr;
+        for (uint32_t i = 0; i < cookedMesh.getAttributeCount(); ++i) {
+            const GEM::Renderer::CookedMesh::Attribute& attribute = cookedMesh.getAttribute(i);
+            if (attribute.location == 0 && attribute.type == GL_FLOAT && attribute.componentCount >= 3) {
+                p_positionAttribute = &attribute;
+            }
+        }
+        if (p_positionAttribute == nullptr) {
+            const std::string errorMessage = "Cooked mesh " + meshFilename + " has no float positions to use as an occluder";
+            LOG_CRITICAL(errorMessage);
+            throw std::runtime_error(errorMessage);
+        }
+
+        const uint8_t* p_vertexData = static_cast<const uint8_t*>(cookedMesh.getVertexData());
+        occluderMesh.positions.resize(cookedMesh.getVertexCount());
+        for (uint32_t i = 0; i < cookedMesh.getVertexCount(); ++i) {
+            const float* p_position = reinterpret_cast<const float*>(p_vertexData + i * cookedMesh.getVertexStrideBytes() + p_positionAttribute->offsetBytes);
+            occluderMesh.positions[i] = glm::vec3(p_position[0], p_position[1], p_position[2]);
+        }
+
+        const uint32_t firstIndex = cookedMesh.getLodCount() > 0 ? cookedMesh.getLod(0).firstIndex : 0;
+        const uint32_t indexCount = cookedMesh.getLodCount() > 0 ? cookedMesh.getLod(0).indexCount : cookedMesh.getIndexCount();
+        occluderMesh.indices.resize(indexCount);
+        if (cookedMesh.getIndexType() == GL_UNSIGNED_SHORT) {
+            const uint16_t* p_indexData = static_cast<const uint16_t*>(cookedMesh.getIndexData()) + firstIndex;
+            std::copy(p_indexData, p_indexData + indexCount, occluderMesh.indices.begin());
+        } else {
+            const uint32_t* p_indexData = static_cast<const uint32_t*>(cookedMesh.getIndexData()) + firstIndex;
+            std::copy(p_indexData, p_indexData + indexCount, occluderMesh.indices.begin());
+        }
+
+        return occluderMesh;
+    }
+
+    const GEM::Renderer::IndexedGeometry geometry = GEM::Renderer::Mesh::loadGeometry(meshFilename);
+    occluderMesh.positions.resize(geometry.getVertexCount());
+    for (uint32_t i = 0; i < geometry.getVertexCount(); ++i) {
+        const size_t offset = static_cast<size_t>(i) * geometry.vertexComponentCount;
+        occluderMesh.positions[i] = glm::vec3(geometry.vertices[offset], geometry.vertices[offset + 1], geometry.vertices[offset + 2]);
+    }
+    occluderMesh.indices = geometry.indices;
+
+    return occluderMesh;
+}
+
+/**
+ * @brief Rasterize every triangle overlapping a band of rows into the depth buffer, keeping the nearest depth
+ * at each pixel. A pixel is covered when its center is inside the triangle. Each band is only ever
+ * written by one thread, so this must not log or throw
+ *
+ * @param triangles The triangles, set up in screen space
+ * @param bandMinY The first row of the band
+ * @param bandMaxY The last row of the band
+ * @param depths The depth buffer, DEPTH_BUFFER_WIDTH pixels per row
+ */
+void GEM::Renderer::OcclusionCuller::rasterizeBand(
+    const std::vector<GEM::Renderer::OcclusionCuller::ScreenTriangle>& triangles,
+    const int32_t bandMinY,
+    const int32_t bandMaxY,
+    std::vector<float>& depths
+) {
+    const int32_t simdWidth = static_cast<int32_t>(GEM::Renderer::OcclusionCuller::SIMD_WIDTH);
+    const size_t rowStride = GEM::Renderer::OcclusionCuller::DEPTH_BUFFER_WIDTH;
+
+#if defined(__SSE__) || defined(_M_X64)
+    const __m128 laneOffsets = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    const __m128 zero = _mm_setzero_ps();
+#endif
+
+    for (const GEM::Renderer::OcclusionCuller::ScreenTriangle& triangle : triangles) {
+        const int32_t minY = std::max(triangle.minY, bandMinY);
+        const int32_t maxY = std::min(triangle.maxY, bandMaxY);
+        if (minY > maxY) {
+            continue;
+        }
+
+        // Start on a SIMD_WIDTH boundary so every batch of pixels stays inside the row
+        const int32_t minX = triangle.minX - (triangle.minX % simdWidth);
+        const float startX = static_cast<float>(minX) + 0.5f;
+
+#if defined(__SSE__) || defined(_M_X64)
+        const __m128 edgeAStepX = _mm_set1_ps(triangle.edgeA.x * simdWidth);
+        const __m128 edgeBStepX = _mm_set1_ps(triangle.edgeB.x * simdWidth);
+        const __m128 edgeCStepX = _mm_set1_ps(triangle.edgeC.x * simdWidth);
+        const __m128 depthStepX = _mm_set1_ps(triangle.depthPlane.x * simdWidth);
+        const __m128 edgeALanes = _mm_mul_ps(laneOffsets, _mm_set1_ps(triangle.edgeA.x));
+        const __m128 edgeBLanes = _mm_mul_ps(laneOffsets, _mm_set1_ps(triangle.edgeB.x));
+        const __m128 edgeCLanes = _mm_mul_ps(laneOffsets, _mm_set1_ps(triangle.edgeC.x));
+        const __m128 depthLanes = _mm_mul_ps(laneOffsets, _mm_set1_ps(triangle.depthPlane.x));
+#endif
+
+        for (int32_t y = minY; y <= maxY; ++y) {
+            const float pixelY = static_cast<float>(y) + 0.5f;
+            float* p_row = depths.data() + static_cast<size_t>(y) * rowStride;
+
+            const float edgeA = triangle.edgeA.x * startX + triangle.edgeA.y * pixelY + triangle.edgeA.z;
+            const float edgeB = triangle.edgeB.x * startX + triangle.edgeB.y * pixelY + triangle.edgeB.z;
+            const float edgeC = triangle.edgeC.x * startX + triangle.edgeC.y * pixelY + triangle.edgeC.z;
+            const float depth = triangle.depthPlane.x * startX + triangle.depthPlane.y * pixelY + triangle.depthPlane.z;
+
+#if defined(__SSE__) || defined(_M_X64)
+            __m128 edgeAs = _mm_add_ps(_mm_set1_ps(edgeA), edgeALanes);
+            __m128 edgeBs = _mm_add_ps(_mm_set1_ps(edgeB), edgeBLanes);
+            __m128 edgeCs = _mm_add_ps(_mm_set1_ps(edgeC), edgeCLanes);
+            __m128 pixelDepths = _mm_add_ps(_mm_set1_ps(depth), depthLanes);
+
+            for (int32_t x = minX; x <= triangle.maxX; x += simdWidth) {
+                const __m128 covered = _mm_and_ps(
+                    _mm_and_ps(_mm_cmpgt_ps(edgeAs, zero), _mm_cmpgt_ps(edgeBs, zero)),
+                    _mm_cmpgt_ps(edgeCs, zero)
+                );
+
+                if (_mm_movemask_ps(covered) != 0) {
+                    const __m128 oldDepths = _mm_loadu_ps(p_row + x);
+                    const __m128 newDepths = _mm_min_ps(oldDepths, pixelDepths);
+                    _mm_storeu_ps(p_row + x, _mm_or_ps(_mm_and_ps(covered, newDepths), _mm_andnot_ps(covered, oldDepths)));
+                }
+
+                edgeAs = _mm_add_ps(edgeAs, edgeAStepX);
+                edgeBs = _mm_add_ps(edgeBs, edgeBStepX);
+                edgeCs = _mm_add_ps(edgeCs, edgeCStepX);
+                pixelDepths = _mm_add_ps(pixelDepths, depthStepX);
+            }
+#else
+            for (int32_t x = minX; x <= triangle.maxX; ++x) {
+                const float offsetX = static_cast<float>(x - minX);
+                if (edgeA + triangle.edgeA.x * offsetX > 0.0f && edgeB + triangle.edgeB.x * offsetX > 0.0f && edgeC + triangle.edgeC.x * offsetX > 0.0f) {
+                    p_row[x] = std::min(p_row[x], depth + triangle.depthPlane.x * offsetX);
+                }
+            }
+#endif
+        }
+    }
+}
+
+/* ------------------------------ public member functions ------------------------------ */
+
+/**
+ * @brief Construct a new GEM::Renderer::OcclusionCuller::OcclusionCuller object with no occluders
+ */
+GEM::Renderer::OcclusionCuller::OcclusionCuller() :
+    m_occluderPtrs(),
+    m_occluderMeshes(),
+    m_screenTriangles(),
+    m_hierarchicalDepthLevels(),
+    m_visibleIndices(),
+    m_visibleObjectPtrs(),
+    m_statistics({0, 0, 0, 0}),
+    m_mutex(),
+    m_bandAvailable(),
+    m_bandsFinished(),
+    m_pendingBands(),
+    m_unfinishedBandCount(0),
+    m_stopping(false),
+    m_workerThreads()
+{
+    LOG_FUNCTION_CALL_INFO(
+        "simd width {} , depth buffer {} x {}",
+        GEM::Renderer::OcclusionCuller::SIMD_WIDTH,
+        GEM::Renderer::OcclusionCuller::DEPTH_BUFFER_WIDTH,
+        GEM::Renderer::OcclusionCuller::DEPTH_BUFFER_HEIGHT
+    );
+
+    // Every level is half the size of the one above it, down to a single texel
+    uint32_t width = GEM::Renderer::OcclusionCuller::DEPTH_BUFFER_WIDTH;
+    uint32_t height = GEM::Renderer::OcclusionCuller::DEPTH_BUFFER_HEIGHT;
+    while (true) {
+        m_hierarchicalDepthLevels.push_back({width, height, std::vector<float>(static_cast<size_t>(width) * height, 1.0f)});
+        if (width == 1 && height == 1) {
+            break;
+        }
+        width = std::max(width / 2, 1u);
+        height = std::max(height / 2, 1u);
+    }
+
+    // The calling thread rasterizes a band of its own, so it gets a core to itself
+    const uint32_t hardwareThreadCount = std::max<uint32_t>(std::thread::hardware_concurrency(), 1);
+    m_workerThreads.reserve(hardwareThreadCount - 1);
+    for (uint32_t i = 1; i < hardwareThreadCount; ++i) {
+        m_workerThreads.emplace_back(&GEM::Renderer::OcclusionCuller::rasterizeBands, this);
+    }
+}
+
+/**
+ * @brief Destroy the GEM::Renderer::OcclusionCuller::OcclusionCuller object, stopping and joining the worker
+ * threads
+ */
+GEM::Renderer::OcclusionCuller::~OcclusionCuller() {
+    LOG_FUNCTION_CALL_TRACE("this ptr {} , worker thread count {}", static_cast<void*>(this), m_workerThreads.size());
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_bandAvailable.notify_all();
+
+    for (std::thread& workerThread : m_workerThreads) {
+        workerThread.join();
+    }
+}
+
+/**
+ * @brief Designate an object as an occluder, rasterizing its mesh into the depth buffer every cull. Occluders
+ * should be few, large, and solid, like walls and floors. Their meshes are loaded once per file and kept on
+ * the cpu
+ *
+ * @param p_occluder The object to occlude with
+ * @note This function will throw if the object's mesh file exists but cannot be loaded
+ */
+void GEM::Renderer::OcclusionCuller::addOccluder(std::shared_ptr<const GEM::Object> p_occluder) {
+    const std::string meshFilename = p_occluder->getMeshFilename();
+    LOG_FUNCTION_CALL_INFO("occluder ptr {} , mesh filename {}", static_cast<const void*>(p_occluder.get()), meshFilename);
+
+    if (m_occluderMeshes.find(meshFilename) == m_occluderMeshes.end()) {
+        m_occluderMeshes.emplace(meshFilename, GEM::Renderer::OcclusionCuller::loadOccluderMesh(meshFilename));
+    }
+
+    m_occluderPtrs.push_back(p_occluder);
+}
+
+/**
+ * @brief Stop occluding with every occluder, and forget their meshes
+ */
+void GEM::Renderer::OcclusionCuller::clearOccluders() {
+    LOG_FUNCTION_CALL_TRACE("occluder count {}", m_occluderPtrs.size());
+
+    m_occluderPtrs.clear();
+    m_occluderMeshes.clear();
+}
+
+/**
+ * @brief Find every object which isn't hidden behind the occluders from the camera's point of view. The
+ * visible objects keep the order they were given in. Objects should already be frustum culled, since
+ * anything off screen is treated as visible here
+ *
+ * @param camera The camera the objects are seen from
+ * @param objectPtrs The objects to cull
+ */
+void GEM::Renderer::OcclusionCuller::cull(const GEM::Camera& camera, const std::vector<std::shared_ptr<GEM::Object>>& objectPtrs) {
+    const glm::mat4& viewProjectionMatrix = camera.getViewProjectionMatrix();
+    rasterizeOccluders(viewProjectionMatrix);
+
+    m_visibleIndices.clear();
+    m_visibleObjectPtrs.clear();
+    for (uint32_t i = 0; i < objectPtrs.size(); ++i) {
+        if (boundsAreVisible(viewProjectionMatrix, objectPtrs[i]->getWorldBoundsMin(), objectPtrs[i]->getWorldBoundsMax())) {
+            m_visibleIndices.push_back(i);
+            m_visibleObjectPtrs.push_back(objectPtrs[i]);
+        }
+    }
+
+    m_statistics.testedCount = static_cast<uint32_t>(objectPtrs.size());
+    m_statistics.visibleCount = static_cast<uint32_t>(m_visibleIndices.size());
+    m_statistics.culledCount = m_statistics.testedCount - m_statistics.visibleCount;
+}
+
+/**
+ * @brief Clear the depth buffer and rasterize every occluder into it, then rebuild the hierarchical depth
+ * buffer. The rows of the depth buffer are split into bands which are rasterized in parallel when there are
+ * enough triangles to keep the threads busy
+ *
+ * @param viewProjectionMatrix The matrix taking world space to clip space
+ */
+void GEM::Renderer::OcclusionCuller::rasterizeOccluders(const glm::mat4& viewProjectionMatrix) {
+    setUpTriangles(viewProjectionMatrix);
+
+    std::vector<float>& depths = m_hierarchicalDepthLevels[0].depths;
+    std::fill(depths.begin(), depths.end(), 1.0f);
+
+    const int32_t height = static_cast<int32_t>(GEM::Renderer::OcclusionCuller::DEPTH_BUFFER_HEIGHT);
+    const size_t threadCount = m_workerThreads.size() + 1;
+    const size_t bandCount = std::max<size_t>(std::min(
+        std::min(threadCount, static_cast<size_t>(height)),
+        m_screenTriangles.size() / GEM::Renderer::OcclusionCuller::MIN_TRIANGLES_PER_THREAD
+    ), 1);
+    const int32_t bandHeight = static_cast<int32_t>((static_cast<size_t>(height) + bandCount - 1) / bandCount);
+
+    // The first band is rasterized on this thread while the worker threads rasterize the others
+    if (bandCount > 1) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (size_t i = 1; i < bandCount; ++i) {
+                const int32_t bandMinY = static_cast<int32_t>(i) * bandHeight;
+                m_pendingBands.push_back({bandMinY, std::min(bandMinY + bandHeight, height) - 1});
+            }
+            m_unfinishedBandCount = static_cast<uint32_t>(bandCount - 1);
+        }
+        m_bandAvailable.notify_all();
+    }
+
+    GEM::Renderer::OcclusionCuller::rasterizeBand(m_screenTriangles, 0, std::min(bandHeight, height) - 1, depths);
+
+    if (bandCount > 1) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_bandsFinished.wait(lock, [this]() { return m_unfinishedBandCount == 0; });
+    }
+
+    buildHierarchicalDepth();
+
+    m_statistics.occluderTriangleCount = static_cast<uint32_t>(m_screenTriangles.size());
+}
+
+/**
+ * @brief Determine whether any part of a bounding box could be seen past the occluders last rasterized. The
+ * box's screen space rectangle is tested at the level of the hierarchical depth buffer where it covers at most
+ * 3 by 3 texels, and it is hidden only if its nearest point is behind the farthest occluder in every one
+ *
+ * @param viewProjectionMatrix The matrix taking world space to clip space, the same one the occluders were
+ * rasterized with
+ * @param boundsMin The minimum corner of the box in world space
+ * @param boundsMax The maximum corner of the box in world space
+ * @return true If the box might be visible
+ * @return false If the box is definitely hidden
+ */
+bool GEM::Renderer::OcclusionCuller::boundsAreVisible(const glm::mat4& viewProjectionMatrix, const glm::vec3& boundsMin, const glm::vec3& boundsMax) const {
+    const float width = static_cast<float>(GEM::Renderer::OcclusionCuller::DEPTH_BUFFER_WIDTH);
+    const float height = static_cast<float>(GEM::Renderer::OcclusionCuller::DEPTH_BUFFER_HEIGHT);
+
+    glm::vec2 screenMin(std::numeric_limits<float>::max());
+    glm::vec2 screenMax(std::numeric_limits<float>::lowest());
+    float nearestDepth = std::numeric_limits<float>::max();
+    for (uint32_t corner = 0; corner < 8; ++corner) {
+        const glm::vec4 clipPosition = viewProjectionMatrix * glm::vec4(
+            (corner & 1) ? boundsMax.x : boundsMin.x,
+            (corner & 2) ? boundsMax.y : boundsMin.y,
+            (corner & 4) ? boundsMax.z : boundsMin.z,
+            1.0f
+        );
+
+        // Part of the box is behind the camera, so the camera may well be inside of it
+        if (clipPosition.w < GEM::Renderer::OcclusionCuller::NEAR_CLIP_W) {
+            return true;
+        }
+
+        const glm::vec3 ndcPosition = glm::vec3(clipPosition) / clipPosition.w;
+        screenMin = glm::min(screenMin, glm::vec2((ndcPosition.x * 0.5f + 0.5f) * width, (ndcPosition.y * 0.5f + 0.5f) * height));
+        screenMax = glm::max(screenMax, glm::vec2((ndcPosition.x * 0.5f + 0.5f) * width, (ndcPosition.y * 0.5f + 0.5f) * height));
+        nearestDepth = std::min(nearestDepth, ndcPosition.z * 0.5f + 0.5f);
+    }
+
+    // Anything off screen is the frustum culler's business
+    if (screenMax.x < 0.0f || screenMax.y < 0.0f || screenMin.x >= width || screenMin.y >= height) {
+        return true;
+    }
+
+    const int32_t minX = std::max(static_cast<int32_t>(std::floor(screenMin.x)), 0);
+    const int32_t minY = std::max(static_cast<int32_t>(std::floor(screenMin.y)), 0);
+    const int32_t maxX = std::min(static_cast<int32_t>(std::floor(screenMax.x)), static_cast<int32_t>(width) - 1);
+    const int32_t maxY = std::min(static_cast<int32_t>(std::floor(screenMax.y)), static_cast<int32_t>(height) - 1);
+
+    uint32_t level = 0;
+    while (level + 1 < m_hierarchicalDepthLevels.size() && std::max((maxX >> level) - (minX >> level), (maxY >> level) - (minY >> level)) > 2) {
+        ++level;
+    }
+
+    const GEM::Renderer::OcclusionCuller::DepthLevel& depthLevel = m_hierarchicalDepthLevels[level];
+    const int32_t levelMaxX = static_cast<int32_t>(depthLevel.width) - 1;
+    const int32_t levelMaxY = static_cast<int32_t>(depthLevel.height) - 1;
+    for (int32_t y = std::min(minY >> level, levelMaxY); y <= std::min(maxY >> level, levelMaxY); ++y) {
+        for (int32_t x = std::min(minX >> level, levelMaxX); x <= std::min(maxX >> level, levelMaxX); ++x) {
+            if (nearestDepth <= depthLevel.depths[static_cast<size_t>(y) * depthLevel.width + x]) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/* ------------------------------ private member functions ------------------------------ */
+
+/**
+ * @brief Transform every occluder triangle into screen space and work out its edge functions, depth plane,
+ * and bounding rectangle. Triangles crossing the near plane, entirely off screen, or too thin to cover a
+ * pixel center are dropped
+ *
+ * @param viewProjectionMatrix The matrix taking world space to clip space
+ */
+void GEM::Renderer::OcclusionCuller::setUpTriangles(const glm::mat4& viewProjectionMatrix) {
+    const float width = static_cast<float>(GEM::Renderer::OcclusionCuller::DEPTH_BUFFER_WIDTH);
+    const float height = static_cast<float>(GEM::Renderer::OcclusionCuller::DEPTH_BUFFER_HEIGHT);
+
+    m_screenTriangles.clear();
+
+    // Reused for every occluder so we only allocate when we see a mesh bigger than any before it
+    std::vector<glm::vec4> screenPositions;
+
+    for (const std::shared_ptr<const GEM::Object>& p_occluder : m_occluderPtrs) {
+        const GEM::Renderer::OcclusionCuller::OccluderMesh& occluderMesh = m_occluderMeshes.at(p_occluder->getMeshFilename());
+        const glm::mat4 modelViewProjectionMatrix = viewProjectionMatrix * p_occluder->getModelMatrix();
+
+        // x and y in pixels, z is the depth, and w is kept to reject vertices behind the near plane
+        screenPositions.resize(occluderMesh.positions.size());
+        for (size_t i = 0; i < occluderMesh.positions.size(); ++i) {
+            const glm::vec4 clipPosition = modelViewProjectionMatrix * glm::vec4(occluderMesh.positions[i], 1.0f);
+            const float inverseW = 1.0f / clipPosition.w;
+            screenPositions[i] = glm::vec4(
+                (clipPosition.x * inverseW * 0.5f + 0.5f) * width,
+                (clipPosition.y * inverseW * 0.5f + 0.5f) * height,
+                clipPosition.z * inverseW * 0.5f + 0.5f,
+                clipPosition.w
+            );
+        }
+
+        for (size_t i = 0; i + 2 < occluderMesh.indices.size(); i += 3) {
+            glm::vec4 v0 = screenPositions[occluderMesh.indices[i]];
+            glm::vec4 v1 = screenPositions[occluderMesh.indices[i + 1]];
+            glm::vec4 v2 = screenPositions[occluderMesh.indices[i + 2]];
+
+            const float nearClipW = GEM::Renderer::OcclusionCuller::NEAR_CLIP_W;
+            if (v0.w < nearClipW || v1.w < nearClipW || v2.w < nearClipW) {
+                continue;
+            }
+
+            const float minScreenX = std::min(std::min(v0.x, v1.x), v2.x);
+            const float maxScreenX = std::max(std::max(v0.x, v1.x), v2.x);
+            const float minScreenY = std::min(std::min(v0.y, v1.y), v2.y);
+            const float maxScreenY = std::max(std::max(v0.y, v1.y), v2.y);
+            if (maxScreenX < 0.0f || maxScreenY < 0.0f || minScreenX >= width || minScreenY >= height) {
+                continue;
+            }
+
+            // Wind every triangle the same way so the inside is where all three edge functions are positive
+            float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+            if (std::abs(area) < 1e-6f) {
+                continue;
+            }
+            if (area < 0.0f) {
+                std::swap(v1, v2);
+                area = -area;
+            }
+
+            // The edge function of the edge from a to b, positive on the inside of the triangle
+            const auto edgeFunction = [](const glm::vec4& a, const glm::vec4& b) {
+                const float edgeX = a.y - b.y;
+                const float edgeY = b.x - a.x;
+                return glm::vec3(edgeX, edgeY, -(edgeX * a.x + edgeY * a.y));
+            };
+
+            GEM::Renderer::OcclusionCuller::ScreenTriangle triangle;
+            triangle.edgeA = edgeFunction(v1, v2);
+            triangle.edgeB = edgeFunction(v2, v0);
+            triangle.edgeC = edgeFunction(v0, v1);
+
+            // Depth is linear in screen space, weighted by each vertex's barycentric coordinate
+            triangle.depthPlane = (triangle.edgeA * v0.z + triangle.edgeB * v1.z + triangle.edgeC * v2.z) / area;
+
+            // Push each edge out by a sliver of a pixel so the pixel centers lying exactly on an edge shared by two
+            // triangles are covered by at least one of them instead of falling through the crack
+            for (glm::vec3* p_edge : {&triangle.edgeA, &triangle.edgeB, &triangle.edgeC}) {
+                p_edge->z += (std::abs(p_edge->x) + std::abs(p_edge->y)) * GEM::Renderer::OcclusionCuller::EDGE_BIAS_PIXELS;
+            }
+
+            triangle.minX = std::max(static_cast<int32_t>(std::floor(minScreenX)), 0);
+            triangle.maxX = std::min(static_cast<int32_t>(std::floor(maxScreenX)), static_cast<int32_t>(width) - 1);
+            triangle.minY = std::max(static_cast<int32_t>(std::floor(minScreenY)), 0);
+            triangle.maxY = std::min(static_cast<int32_t>(std::floor(maxScreenY)), static_cast<int32_t>(height) - 1);
+
+            m_screenTriangles.push_back(triangle);
+        }
+    }
+}
+
+/**
+ * @brief Reduce the depth buffer into the rest of the hierarchical depth buffer. Every texel holds the farthest
+ * depth of the texels it covers in the level above it, so anything behind a texel is behind everything it covers
+ */
+void GEM::Renderer::OcclusionCuller::buildHierarchicalDepth() {
+    for (size_t level = 1; level < m_hierarchicalDepthLevels.size(); ++level) {
+        const GEM::Renderer::OcclusionCuller::DepthLevel& source = m_hierarchicalDepthLevels[level - 1];
+        GEM::Renderer::OcclusionCuller::DepthLevel& destination = m_hierarchicalDepthLevels[level];
+
+        for (uint32_t y = 0; y < destination.height; ++y) {
+            const uint32_t sourceY0 = std::min(y * 2, source.height - 1);
+            const uint32_t sourceY1 = std::min(y * 2 + 1, source.height - 1);
+            for (uint32_t x = 0; x < destination.width; ++x) {
+                const uint32_t sourceX0 = std::min(x * 2, source.width - 1);
+                const uint32_t sourceX1 = std::min(x * 2 + 1, source.width - 1);
+                destination.depths[static_cast<size_t>(y) * destination.width + x] = std::max(
+                    std::max(source.depths[static_cast<size_t>(sourceY0) * source.width + sourceX0], source.depths[static_cast<size_t>(sourceY0) * source.width + sourceX1]),
+                    std::max(source.depths[static_cast<size_t>(sourceY1) * source.width + sourceX0], source.depths[static_cast<size_t>(sourceY1) * source.width + sourceX1])
+                );
+            }
+        }
+    }
+}
+
+/**
+ * @brief The loop each worker thread runs, rasterizing bands of the depth buffer until the culler is destroyed.
+ * The triangles and the depth buffer are left alone by the calling thread until every band is finished, and
+ * each band only writes its own rows. This must not log or throw
+ */
+void GEM::Renderer::OcclusionCuller::rasterizeBands() {
+    while (true) {
+        std::pair<int32_t, int32_t> band;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_bandAvailable.wait(lock, [this]() { return m_stopping || !m_pendingBands.empty(); });
+            if (m_stopping) {
+                return;
+            }
+
+            band = m_pendingBands.back();
+            m_pendingBands.pop_back();
+        }
+
+        GEM::Renderer::OcclusionCuller::rasterizeBand(m_screenTriangles, band.first, band.second, m_hierarchicalDepthLevels[0].depths);
+
+        bool finished;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_unfinishedBandCount -= 1;
+            finished = m_unfinishedBandCount == 0;
+        }
+        if (finished) {
+            m_bandsFinished.notify_one();
+        }
+    }
+}
\ No newline at end of file
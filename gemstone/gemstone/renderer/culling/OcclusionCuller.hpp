@@ -0,0 +1,146 @@
+#pragma once
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "gemstone/camera/Camera.hpp"
+#include "gemstone/object/Object.hpp"
+
+namespace GEM {
+namespace Renderer {
+    class OcclusionCuller;
+}
+}
+
+/**
+ * @brief A class that throws away every object hidden behind one of a handful of designated occluders. The
+ * occluders' triangles are rasterized on the cpu into a small depth buffer, split into horizontal bands
+ * which are filled in parallel SIMD_WIDTH pixels at a time. The depth buffer is then reduced into a
+ * hierarchical depth buffer, where every texel holds the farthest depth of the 4 texels below it, and each
+ * object's screen space bounds are tested against the level where they cover only a few texels
+ * 
+ * The bands are handed to worker threads which live as long as the culler, so no threads are started while
+ * culling. The Mesh library is only used to load the occluders' geometry on the cpu, and no gl calls are made
+ * here, so it behaves the same with or without a window
+ */
+class GEM::Renderer::OcclusionCuller {
+public: // public classes and enums
+    struct Statistics {
+        uint32_t occluderTriangleCount;
+        uint32_t testedCount;
+        uint32_t visibleCount;
+        uint32_t culledCount;
+    };
+
+public: // public static variables
+    static const std::string LOGGER_NAME;
+
+    // The number of pixels rasterized at once
+    static const uint32_t SIMD_WIDTH;
+
+    // The resolution of the depth buffer, independent of the window's resolution
+    static const uint32_t DEPTH_BUFFER_WIDTH;
+    static const uint32_t DEPTH_BUFFER_HEIGHT;
+
+    // Triangles closer to the camera than this are skipped rather than clipped
+    static const float NEAR_CLIP_W;
+    static const float EDGE_BIAS_PIXELS;
+
+    // Fewer triangles than this per band aren't worth handing to another thread
+    static const uint32_t MIN_TRIANGLES_PER_THREAD;
+
+public: // public member functions
+    OcclusionCuller();
+    ~OcclusionCuller();
+
+    OcclusionCuller(const OcclusionCuller& other) = delete;
+    void operator=(const OcclusionCuller& other) = delete;
+
+    void addOccluder(std::shared_ptr<const GEM::Object> p_occluder);
+    void clearOccluders();
+
+    void cull(const GEM::Camera& camera, const std::vector<std::shared_ptr<GEM::Object>>& objectPtrs);
+    void rasterizeOccluders(const glm::mat4& viewProjectionMatrix);
+    bool boundsAreVisible(const glm::mat4& viewProjectionMatrix, const glm::vec3& boundsMin, const glm::vec3& boundsMax) const;
+
+    const std::vector<std::shared_ptr<GEM::Object>>& getVisibleObjectPtrs() const { return m_visibleObjectPtrs; }
+    const std::vector<uint32_t>& getVisibleIndices() const { return m_visibleIndices; }
+    const GEM::Renderer::OcclusionCuller::Statistics& getStatistics() const { return m_statistics; }
+
+    uint32_t getHierarchicalDepthLevelCount() const { return static_cast<uint32_t>(m_hierarchicalDepthLevels.size()); }
+    const std::vector<float>& getHierarchicalDepthLevel(const uint32_t level) const { return m_hierarchicalDepthLevels[level].depths; }
+
+private: // private classes and enums
+    /**
+     * @brief The positions and triangles of an occluder's mesh, kept on the cpu
+     */
+    struct OccluderMesh {
+        std::vector<glm::vec3> positions;
+        std::vector<uint32_t> indices;
+    };
+
+    /**
+     * @brief A triangle in screen space, set up for rasterizing. Each edge function and the depth are planes
+     * over the screen, evaluated as a * x + b * y + c
+     */
+    struct ScreenTriangle {
+        glm::vec3 edgeA;
+        glm::vec3 edgeB;
+        glm::vec3 edgeC;
+        glm::vec3 depthPlane;
+        int32_t minX;
+        int32_t maxX;
+        int32_t minY;
+        int32_t maxY;
+    };
+
+    struct DepthLevel {
+        uint32_t width;
+        uint32_t height;
+        std::vector<float> depths;
+    };
+
+private: // private static functions
+    static GEM::Renderer::OcclusionCuller::OccluderMesh loadOccluderMesh(const std::string& meshFilename);
+    static void rasterizeBand(
+        const std::vector<GEM::Renderer::OcclusionCuller::ScreenTriangle>& triangles,
+        const int32_t bandMinY,
+        const int32_t bandMaxY,
+        std::vector<float>& depths
+    );
+
+private: // private member functions
+    void setUpTriangles(const glm::mat4& viewProjectionMatrix);
+    void buildHierarchicalDepth();
+    void rasterizeBands();
+
+private: // private member variables
+    std::vector<std::shared_ptr<const GEM::Object>> m_occluderPtrs;
+    std::map<std::string, GEM::Renderer::OcclusionCuller::OccluderMesh> m_occluderMeshes;
+
+    std::vector<GEM::Renderer::OcclusionCuller::ScreenTriangle> m_screenTriangles;
+    std::vector<GEM::Renderer::OcclusionCuller::DepthLevel> m_hierarchicalDepthLevels;
+
+    std::vector<uint32_t> m_visibleIndices;
+    std::vector<std::shared_ptr<GEM::Object>> m_visibleObjectPtrs;
+    GEM::Renderer::OcclusionCuller::Statistics m_statistics;
+
+    // Guards everything below, which is shared with the worker threads
+    std::mutex m_mutex;
+    std::condition_variable m_bandAvailable;
+    std::condition_variable m_bandsFinished;
+    // The first and last rows of each band waiting for a worker thread
+    std::vector<std::pair<int32_t, int32_t>> m_pendingBands;
+    uint32_t m_unfinishedBandCount;
+    bool m_stopping;
+
+    std::vector<std::thread> m_workerThreads;
+};
\ No newline at end of file
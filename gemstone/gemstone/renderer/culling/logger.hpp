@@ -0,0 +1,6 @@
+#pragma once
+
+/**
+ * @brief The name of the logger used by the culling classes
+ */
+#define CULLING_LOGGER_NAME "CULLING"
\ No newline at end of file
@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include "util/logger/Logger.hpp"
+
+#include "gemstone/camera/Camera.hpp"
+#include "gemstone/object/Object.hpp"
+#include "gemstone/renderer/instancing/logger.hpp"
+#include "gemstone/renderer/instancing/InstancedRenderer.hpp"
+#include "gemstone/renderer/mesh/Mesh.hpp"
+#include "gemstone/renderer/mesh/MeshInstance.hpp"
+#include "gemstone/renderer/queue/RenderQueue.hpp"
+#include "gemstone/renderer/shader/ShaderProgram.hpp"
+#include "gemstone/renderer/state/StateCache.hpp"
+#include "gemstone/renderer/texture/Texture.hpp"
+
+/* ------------------------------ public static variables ------------------------------ */
+
+/**
+ * @brief The name of the logger the InstancedRenderer class uses
+ */
+const std::string GEM::Renderer::InstancedRenderer::LOGGER_NAME = INSTANCING_LOGGER_NAME;
+
+/* ------------------------------ private static variables ------------------------------ */
+
+/* ------------------------------ public static functions ------------------------------ */
+
+/* ------------------------------ private static functions ------------------------------ */
+
+/**
+ * @brief Create the buffer that will hold the model matrix and texture layers of every instance we draw each
+ * frame
+ *
+ * @return uint32_t The id of the instance buffer
+ */
+uint32_t GEM::Renderer::InstancedRenderer::createInstanceBufferObject() {
+    LOG_FUNCTION_ENTRY_TRACE("{}", nullptr);
+
+    uint32_t instanceBufferObjectID;
+    glGenBuffers(1, &instanceBufferObjectID);
+
+    return instanceBufferObjectID;
+}
+
+/* ------------------------------ public member functions ------------------------------ */
+
+/**
+ * @brief Construct a new GEM::Renderer::InstancedRenderer::InstancedRenderer object with an empty instance buffer
+ */
+GEM::Renderer::InstancedRenderer::InstancedRenderer() :
+    m_instanceBufferObjectID(GEM::Renderer::InstancedRenderer::createInstanceBufferObject()),
+    m_instanceBufferCapacity(0),
+    m_sortedObjectIndices(),
+    m_instances(),
+    m_batches()
+{
+    LOG_FUNCTION_CALL_INFO("instance buffer id {}", m_instanceBufferObjectID);
+}
+
+/**
+ * @brief Destroy the GEM::Renderer::InstancedRenderer::InstancedRenderer object by deleting the instance buffer
+ */
+GEM::Renderer::InstancedRenderer::~InstancedRenderer() {
+    LOG_FUNCTION_CALL_TRACE("instance buffer id {}", m_instanceBufferObjectID);
+    GEM::Renderer::StateCache::deleteBuffer(m_instanceBufferObjectID);
+}
+
+/**
+ * @brief Submit all of the objects to the render queue as one instanced draw for each group of objects
+ * sharing the same mesh, level of detail, and textures. Each draw is as far away as its nearest instance
+ *
+ * @note The instance buffer is overwritten by the next call, so the render queue must be executed first
+ *
+ * @param p_shaderProgram The instanced shader program to draw the objects with
+ * @param p_textureArrayShaderProgram The instanced shader program to draw the objects whose textures are both
+ * packed into texture arrays with
+ * @param p_camera The camera the objects are viewed from, used to pick their levels of detail
+ * @param objectPtrs The objects to draw
+ * @param renderQueue The render queue to submit the draws to
+ */
+void GEM::Renderer::InstancedRenderer::submit(
+    std::shared_ptr<GEM::Renderer::ShaderProgram> p_shaderProgram,
+    std::shared_ptr<GEM::Renderer::ShaderProgram> p_textureArrayShaderProgram,
+    std::shared_ptr<const GEM::Camera> p_camera,
+    const std::vector<std::shared_ptr<GEM::Object>>& objectPtrs,
+    GEM::Renderer::RenderQueue& renderQueue
+) {
+    buildBatches(*p_camera, objectPtrs);
+    uploadInstances();
+
+    for (const GEM::Renderer::InstancedRenderer::Batch& batch : m_batches) {
+        const bool texturesPacked = batch.p_texture->isPacked() && batch.p_texture2->isPacked();
+        const std::shared_ptr<GEM::Renderer::ShaderProgram> p_batchShaderProgram = texturesPacked ?
+            p_textureArrayShaderProgram :
+            p_shaderProgram;
+
+        renderQueue.submit({
+            GEM::Renderer::RenderQueue::makeSortKey(
+                GEM::Renderer::RenderQueue::Pass::opaque,
+                p_batchShaderProgram->getID(),
+                texturesPacked ? batch.p_texture->getID() : batch.p_texture->getUnpackedID(),
+                texturesPacked ? batch.p_texture2->getID() : batch.p_texture2->getUnpackedID(),
+                batch.p_mesh->getVertexArrayObjectID(),
+                batch.depth
+            ),
+            p_batchShaderProgram,
+            batch.p_mesh,
+            batch.p_texture,
+            batch.p_texture2,
+            m_instanceBufferObjectID,
+            batch.firstInstance,
+            batch.instanceCount,
+            batch.lodIndex
+        });
+    }
+}
+
+/* ------------------------------ private member functions ------------------------------ */
+
+/**
+ * @brief Pick the level of detail of each object, group the objects by their mesh, level of detail, and
+ * textures, then lay out their instances so that each group's instances are contiguous and go from nearest
+ * to farthest
+ *
+ * @param camera The camera the objects are viewed from
+ * @param objectPtrs The objects to group into batches
+ */
+void GEM::Renderer::InstancedRenderer::buildBatches(const GEM::Camera& camera, const std::vector<std::shared_ptr<GEM::Object>>& objectPtrs) {
+    m_sortedObjectIndices.clear();
+    m_instances.clear();
+    m_batches.clear();
+
+    const glm::mat4& viewMatrix = camera.getViewMatrix();
+    const glm::mat4& projectionMatrix = camera.getProjectionMatrix();
+    const float viewportHeightPixels = camera.getViewportHeightPixels();
+    const float nearClippingPlane = camera.getNearClippingPlane();
+    const float farClippingPlane = camera.getFarClippingPlane();
+
+    // Sort the objects by their key so that everything in the same batch ends up next to each other, then
+    // by how far they are in front of the camera, from the near plane at 0 to the far plane at 1
+    for (size_t i = 0; i < objectPtrs.size(); ++i) {
+        // Only objects whose textures are both packed are drawn from the texture arrays, the rest sample each
+        // texture's plain texture, so only they can share a batch with objects using other layers
+        const std::shared_ptr<const GEM::Renderer::Mesh> p_mesh = objectPtrs[i]->getMesh();
+        const std::shared_ptr<const GEM::Renderer::Texture> p_texture = objectPtrs[i]->getTexture();
+        const std::shared_ptr<const GEM::Renderer::Texture> p_texture2 = objectPtrs[i]->getTexture2();
+        const bool texturesPacked = p_texture->isPacked() && p_texture2->isPacked();
+        const GEM::Renderer::InstancedRenderer::BatchKey key = {
+            p_mesh->getSourceHash(),
+            p_mesh->selectLod(objectPtrs[i]->getModelMatrix(), viewMatrix, projectionMatrix, viewportHeightPixels),
+            texturesPacked ? p_texture->getID() : p_texture->getUnpackedID(),
+            texturesPacked ? p_texture2->getID() : p_texture2->getUnpackedID()
+        };
+        const float viewDepth = -(viewMatrix * glm::vec4(objectPtrs[i]->getWorldPosition(), 1.0f)).z;
+        const float depth = (viewDepth - nearClippingPlane) / (farClippingPlane - nearClippingPlane);
+        m_sortedObjectIndices.push_back({key, depth, i});
+    }
+    std::sort(m_sortedObjectIndices.begin(), m_sortedObjectIndices.end());
+
+    // Walk the sorted objects, starting a new batch every time the key changes
+    for (size_t i = 0; i < m_sortedObjectIndices.size(); ++i) {
+        const std::shared_ptr<GEM::Object>& p_object = objectPtrs[std::get<2>(m_sortedObjectIndices[i])];
+        const GEM::Renderer::InstancedRenderer::BatchKey& key = std::get<0>(m_sortedObjectIndices[i]);
+
+        // The first instance of each batch is its nearest, so it decides how far away the batch is
+        if (i == 0 || key != std::get<0>(m_sortedObjectIndices[i - 1])) {
+            m_batches.push_back({
+                p_object->getMesh(),
+                p_object->getTexture(),
+                p_object->getTexture2(),
+                std::get<1>(key),
+                static_cast<uint32_t>(m_instances.size()),
+                0,
+                std::get<1>(m_sortedObjectIndices[i])
+            });
+        }
+
+        m_instances.push_back({
+            p_object->getModelMatrix(),
+            glm::vec2(static_cast<float>(p_object->getTexture()->getLayer()), static_cast<float>(p_object->getTexture2()->getLayer()))
+        });
+        m_batches.back().instanceCount += 1;
+    }
+
+    LOG_TRACE("Built {} batches from {} objects", m_batches.size(), objectPtrs.size());
+}
+
+/**
+ * @brief Upload all of this frame's instances into the instance buffer, growing it if it is too small
+ */
+void GEM::Renderer::InstancedRenderer::uploadInstances() {
+    const size_t requiredSize = m_instances.size() * sizeof(GEM::Renderer::MeshInstance);
+
+    GEM::Renderer::StateCache::bindBuffer(GL_ARRAY_BUFFER, m_instanceBufferObjectID);
+
+    // Orphan the old storage so we don't have to wait on the previous frame's draws still reading from it
+    if (requiredSize > m_instanceBufferCapacity) {
+        LOG_DEBUG("Growing instance buffer from {} bytes to {} bytes", m_instanceBufferCapacity, requiredSize);
+        m_instanceBufferCapacity = requiredSize;
+    }
+    glBufferData(GL_ARRAY_BUFFER, m_instanceBufferCapacity, nullptr, GL_STREAM_DRAW);
+
+    if (requiredSize > 0) {
+        glBufferSubData(GL_ARRAY_BUFFER, 0, requiredSize, m_instances.data());
+    }
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "gemstone/camera/Camera.hpp"
+#include "gemstone/object/Object.hpp"
+#include "gemstone/renderer/mesh/Mesh.hpp"
+#include "gemstone/renderer/mesh/MeshInstance.hpp"
+#include "gemstone/renderer/queue/RenderQueue.hpp"
+#include "gemstone/renderer/shader/ShaderProgram.hpp"
+#include "gemstone/renderer/texture/Texture.hpp"
+
+namespace GEM {
+namespace Renderer {
+    class InstancedRenderer;
+}
+}
+
+/**
+ * @brief A class that draws objects sharing the same mesh, level of detail, and pair of textures with a
+ * single instanced draw call. Each frame every object's level of detail is picked from how large it
+ * appears on screen, the objects are grouped into batches, all of their instances are uploaded
+ * into one per instance attribute buffer, then each batch is submitted to a render queue to be drawn at
+ * once. Instances within a batch are ordered front to back
+ * 
+ * Textures packed into the same texture array share an id, so objects whose textures are different layers of
+ * the same arrays land in the same batch. Those batches are drawn with the texture array shader program, which
+ * picks each instance's layers from the per instance texture layers. Objects with a texture which isn't packed
+ * are batched by each texture's plain texture instead, and drawn with the other shader program
+ * 
+ * @note The shader programs used must read the model matrix from the per instance attribute at location 3,
+ * and the texture layers from location 7 (see vertex_instanced.vert)
+ */
+class GEM::Renderer::InstancedRenderer {
+public: // public static variables
+    static const std::string LOGGER_NAME;
+
+public: // public member functions
+    InstancedRenderer();
+    ~InstancedRenderer();
+
+    InstancedRenderer(const InstancedRenderer& other) = delete;
+    void operator=(const InstancedRenderer& other) = delete;
+
+    void submit(
+        std::shared_ptr<GEM::Renderer::ShaderProgram> p_shaderProgram,
+        std::shared_ptr<GEM::Renderer::ShaderProgram> p_textureArrayShaderProgram,
+        std::shared_ptr<const GEM::Camera> p_camera,
+        const std::vector<std::shared_ptr<GEM::Object>>& objectPtrs,
+        GEM::Renderer::RenderQueue& renderQueue
+    );
+
+    uint32_t getBatchCount() const { return static_cast<uint32_t>(m_batches.size()); }
+
+private: // private enums and classes
+    /**
+     * @brief The mesh source hash, the level of detail, and the ids of both textures. Objects with the same
+     * key are drawn together
+     */
+    using BatchKey = std::tuple<size_t, uint32_t, uint32_t, uint32_t>;
+
+    struct Batch {
+        std::shared_ptr<const GEM::Renderer::Mesh> p_mesh;
+        std::shared_ptr<const GEM::Renderer::Texture> p_texture;
+        std::shared_ptr<const GEM::Renderer::Texture> p_texture2;
+        uint32_t lodIndex;
+        uint32_t firstInstance;
+        uint32_t instanceCount;
+        float depth;
+    };
+
+private: // private static functions
+    static uint32_t createInstanceBufferObject();
+
+private: // private member functions
+    void buildBatches(const GEM::Camera& camera, const std::vector<std::shared_ptr<GEM::Object>>& objectPtrs);
+    void uploadInstances();
+
+private: // private member variables
+    const uint32_t m_instanceBufferObjectID;
+    size_t m_instanceBufferCapacity;
+
+    // Kept between frames so we don't reallocate every frame
+    std::vector<std::tuple<GEM::Renderer::InstancedRenderer::BatchKey, float, size_t>> m_sortedObjectIndices;
+    std::vector<GEM::Renderer::MeshInstance> m_instances;
+    std::vector<GEM::Renderer::InstancedRenderer::Batch> m_batches;
+};
\ No newline at end of file
@@ -0,0 +1,6 @@
+#pragma once
+
+/**
+ * @brief The name of the logger used by the instancing classes
+ */
+#define INSTANCING_LOGGER_NAME "INSTANCING"
\ No newline at end of file
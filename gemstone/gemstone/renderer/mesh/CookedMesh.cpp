@@ -0,0 +1,267 @@
+#include "gemstone/renderer/mesh/CookedMesh.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "util/io/MappedFile.hpp"
+#include "util/logger/Logger.hpp"
+
+#include "gemstone/renderer/mesh/logger.hpp"
+#include "gemstone/renderer/mesh/IndexedGeometry.hpp"
+#include "gemstone/renderer/mesh/Mesh.hpp"
+#include "gemstone/renderer/mesh/MeshLod.hpp"
+
+// The header and attributes are read straight out of the mapped file, so their layout must never change
+// without bumping the version
+static_assert(sizeof(GEM::Renderer::CookedMesh::Header) == 88, "Cooked mesh header must be 88 bytes");
+static_assert(sizeof(GEM::Renderer::CookedMesh::Attribute) == 16, "Cooked mesh attribute must be 16 bytes");
+static_assert(sizeof(GEM::Renderer::MeshLod) == 12, "Cooked mesh lod must be 12 bytes");
+
+/* ------------------------------ public static variables ------------------------------ */
+
+/**
+ * @brief The name of the logger the CookedMesh class uses
+ */
+const std::string GEM::Renderer::CookedMesh::LOGGER_NAME = MESH_LOGGER_NAME;
+
+/**
+ * @brief The extension given to cooked mesh files
+ */
+const std::string GEM::Renderer::CookedMesh::FILE_EXTENSION = "gmesh";
+
+/**
+ * @brief The version of the cooked mesh format. Files written with any other version are rejected
+ */
+const uint32_t GEM::Renderer::CookedMesh::VERSION = 2;
+
+/**
+ * @brief The alignment in bytes of the start of the vertex and index sections
+ */
+const uint64_t GEM::Renderer::CookedMesh::SECTION_ALIGNMENT = 64;
+
+/* ------------------------------ private static variables ------------------------------ */
+
+/* ------------------------------ public static functions ------------------------------ */
+
+/**
+ * @brief Write the geometry into a cooked mesh file so it can be uploaded straight to the gpu when it
+ * is loaded. The geometry should already be optimized and hold the indices of every level of detail,
+ * nothing is done to it here other than narrowing the indices to 16 bits when they all fit
+ * 
+ * @note This function will throw if the geometry isn't made of position, color, and texture coord
+ * vertices, if there are no levels of detail, or if the file cannot be written
+ * 
+ * @param geometry The vertices and indices to cook
+ * @param lods The range of indices of each level of detail, starting with full detail
+ * @param filename The full path to the file to write
+ */
+void GEM::Renderer::CookedMesh::cook(
+    const GEM::Renderer::IndexedGeometry& geometry,
+    const std::vector<GEM::Renderer::MeshLod>& lods,
+    const std::string& filename
+) {
+    LOG_FUNCTION_CALL_INFO("filename {} , vertex count {} , index count {} , lod count {}", filename, geometry.getVertexCount(), geometry.getIndexCount(), lods.size());
+
+    // 3 position + 3 color + 2 texture
+    if (geometry.vertexComponentCount != 8) {
+        const std::string errorMessage = "Cannot cook mesh with " + std::to_string(geometry.vertexComponentCount) + " components per vertex into " + filename;
+        LOG_CRITICAL(errorMessage);
+        throw std::invalid_argument(errorMessage);
+    }
+
+    if (lods.empty()) {
+        const std::string errorMessage = "Cannot cook mesh without any levels of detail into " + filename;
+        LOG_CRITICAL(errorMessage);
+        throw std::invalid_argument(errorMessage);
+    }
+
+    const std::vector<GEM::Renderer::CookedMesh::Attribute> attributes = {
+        {0, 3, GL_FLOAT, 0},
+        {1, 3, GL_FLOAT, 3 * sizeof(float)},
+        {2, 2, GL_FLOAT, 6 * sizeof(float)}
+    };
+
+    // Narrow the indices now so loading never has to
+    const GLenum indexType = GEM::Renderer::Mesh::getIndexType(geometry.getVertexCount());
+    const std::vector<uint16_t> shortIndices = indexType == GL_UNSIGNED_SHORT ?
+        std::vector<uint16_t>(geometry.indices.begin(), geometry.indices.end()) :
+        std::vector<uint16_t>();
+    const char* p_indexData = indexType == GL_UNSIGNED_SHORT ?
+        reinterpret_cast<const char*>(shortIndices.data()) :
+        reinterpret_cast<const char*>(geometry.indices.data());
+
+    GEM::Renderer::CookedMesh::Header header;
+    std::memcpy(header.magic, "GMSH", 4);
+    header.version = GEM::Renderer::CookedMesh::VERSION;
+    header.vertexCount = geometry.getVertexCount();
+    header.indexCount = geometry.getIndexCount();
+    header.indexType = indexType;
+    header.vertexStrideBytes = geometry.vertexComponentCount * sizeof(float);
+    header.attributeCount = static_cast<uint32_t>(attributes.size());
+    header.lodCount = static_cast<uint32_t>(lods.size());
+
+    const glm::vec3 boundsMin = geometry.getBoundsMin();
+    const glm::vec3 boundsMax = geometry.getBoundsMax();
+    for (uint32_t i = 0; i < 3; ++i) {
+        header.boundsMin[i] = boundsMin[i];
+        header.boundsMax[i] = boundsMax[i];
+    }
+
+    const uint64_t tablesEnd = sizeof(header) + (attributes.size() * sizeof(GEM::Renderer::CookedMesh::Attribute)) + (lods.size() * sizeof(GEM::Renderer::MeshLod));
+    header.vertexDataOffset = GEM::Renderer::CookedMesh::alignOffset(tablesEnd);
+    header.vertexDataSizeBytes = geometry.vertices.size() * sizeof(float);
+    header.indexDataOffset = GEM::Renderer::CookedMesh::alignOffset(header.vertexDataOffset + header.vertexDataSizeBytes);
+    header.indexDataSizeBytes = header.indexCount * (indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t));
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        const std::string errorMessage = "Failed to open " + filename + " for writing";
+        LOG_CRITICAL(errorMessage);
+        throw std::runtime_error(errorMessage);
+    }
+
+    // Pad each section out to its aligned offset with zeroes
+    const std::vector<char> padding(GEM::Renderer::CookedMesh::SECTION_ALIGNMENT, 0);
+    const uint64_t verticesEnd = header.vertexDataOffset + header.vertexDataSizeBytes;
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(attributes.data()), attributes.size() * sizeof(GEM::Renderer::CookedMesh::Attribute));
+    file.write(reinterpret_cast<const char*>(lods.data()), lods.size() * sizeof(GEM::Renderer::MeshLod));
+    file.write(padding.data(), header.vertexDataOffset - tablesEnd);
+    file.write(reinterpret_cast<const char*>(geometry.vertices.data()), header.vertexDataSizeBytes);
+    file.write(padding.data(), header.indexDataOffset - verticesEnd);
+    file.write(p_indexData, header.indexDataSizeBytes);
+
+    if (!file) {
+        const std::string errorMessage = "Failed to write cooked mesh to " + filename;
+        LOG_CRITICAL(errorMessage);
+        throw std::runtime_error(errorMessage);
+    }
+
+    LOG_DEBUG("Cooked mesh into {} , {} vertices , {} indices , {} lods", filename, header.vertexCount, header.indexCount, header.lodCount);
+}
+
+/* ------------------------------ private static functions ------------------------------ */
+
+/**
+ * @brief Round an offset up to the next multiple of SECTION_ALIGNMENT
+ * 
+ * @param offset The offset in bytes to align
+ * @return uint64_t The aligned offset
+ */
+uint64_t GEM::Renderer::CookedMesh::alignOffset(const uint64_t offset) {
+    const uint64_t alignment = GEM::Renderer::CookedMesh::SECTION_ALIGNMENT;
+    return ((offset + alignment - 1) / alignment) * alignment;
+}
+
+/**
+ * @brief Make sure the mapped file is a cooked mesh we understand and that every section it describes
+ * actually lies within the file, so nothing read through the header can go out of bounds
+ * 
+ * @note This function will throw if the file is not a valid cooked mesh
+ * 
+ * @param file The mapped cooked mesh file
+ * @return const GEM::Renderer::CookedMesh::Header* The header at the start of the file
+ */
+const GEM::Renderer::CookedMesh::Header* GEM::Renderer::CookedMesh::validateHeader(const GEM::util::MappedFile& file) {
+    LOG_FUNCTION_ENTRY_TRACE("filename {} , size {}", file.getFilename(), file.getSize());
+
+    const auto fail = [&file](const std::string& reason) {
+        const std::string errorMessage = "Invalid cooked mesh " + file.getFilename() + " : " + reason;
+        LOG_CRITICAL(errorMessage);
+        throw std::runtime_error(errorMessage);
+    };
+
+    if (file.getSize() < sizeof(GEM::Renderer::CookedMesh::Header)) {
+        fail("file is smaller than the header");
+    }
+
+    const GEM::Renderer::CookedMesh::Header* p_header = reinterpret_cast<const GEM::Renderer::CookedMesh::Header*>(file.getData());
+    if (std::memcmp(p_header->magic, "GMSH", 4) != 0) {
+        fail("bad magic");
+    }
+    if (p_header->version != GEM::Renderer::CookedMesh::VERSION) {
+        fail("version " + std::to_string(p_header->version) + " , expected " + std::to_string(GEM::Renderer::CookedMesh::VERSION));
+    }
+    if (p_header->indexType != GL_UNSIGNED_SHORT && p_header->indexType != GL_UNSIGNED_INT) {
+        fail("unknown index type " + std::to_string(p_header->indexType));
+    }
+
+    const uint64_t tablesEnd =
+        sizeof(GEM::Renderer::CookedMesh::Header) +
+        (static_cast<uint64_t>(p_header->attributeCount) * sizeof(GEM::Renderer::CookedMesh::Attribute)) +
+        (static_cast<uint64_t>(p_header->lodCount) * sizeof(GEM::Renderer::MeshLod));
+    const uint64_t indexSize = p_header->indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+    if (tablesEnd > file.getSize()) {
+        fail("attribute and lod tables extend past the end of the file");
+    }
+    if (p_header->lodCount == 0) {
+        fail("no levels of detail");
+    }
+    if (p_header->vertexDataSizeBytes != static_cast<uint64_t>(p_header->vertexCount) * p_header->vertexStrideBytes) {
+        fail("vertex section size does not match the vertex count");
+    }
+    if (p_header->indexDataSizeBytes != static_cast<uint64_t>(p_header->indexCount) * indexSize) {
+        fail("index section size does not match the index count");
+    }
+    if (p_header->vertexDataOffset < tablesEnd || p_header->vertexDataOffset > file.getSize() || p_header->vertexDataSizeBytes > file.getSize() - p_header->vertexDataOffset) {
+        fail("vertex section extends past the end of the file");
+    }
+    if (p_header->indexDataOffset < tablesEnd || p_header->indexDataOffset > file.getSize() || p_header->indexDataSizeBytes > file.getSize() - p_header->indexDataOffset) {
+        fail("index section extends past the end of the file");
+    }
+
+    const GEM::Renderer::MeshLod* p_lods = reinterpret_cast<const GEM::Renderer::MeshLod*>(
+        file.getData() + sizeof(GEM::Renderer::CookedMesh::Header) + (p_header->attributeCount * sizeof(GEM::Renderer::CookedMesh::Attribute))
+    );
+    for (uint32_t i = 0; i < p_header->lodCount; ++i) {
+        if (p_lods[i].firstIndex > p_header->indexCount || p_lods[i].indexCount > p_header->indexCount - p_lods[i].firstIndex) {
+            fail("lod " + std::to_string(i) + " indexes past the end of the index section");
+        }
+    }
+
+    // An index past the last vertex would have the gpu read outside of the vertex buffer
+    const uint8_t* p_indexData = reinterpret_cast<const uint8_t*>(file.getData()) + p_header->indexDataOffset;
+    for (uint32_t i = 0; i < p_header->indexCount; ++i) {
+        const uint32_t index = p_header->indexType == GL_UNSIGNED_SHORT ?
+            reinterpret_cast<const uint16_t*>(p_indexData)[i] :
+            reinterpret_cast<const uint32_t*>(p_indexData)[i];
+        if (index >= p_header->vertexCount) {
+            fail("index " + std::to_string(i) + " is " + std::to_string(index) + " , past the last of " + std::to_string(p_header->vertexCount) + " vertices");
+        }
+    }
+
+    return p_header;
+}
+
+/* ------------------------------ public member functions ------------------------------ */
+
+/**
+ * @brief Construct a new GEM::Renderer::CookedMesh::CookedMesh object by mapping the cooked file into memory
+ * 
+ * @note This will throw if the file cannot be mapped or is not a valid cooked mesh
+ * 
+ * @param filename The full path to the cooked mesh file
+ */
+GEM::Renderer::CookedMesh::CookedMesh(const std::string& filename) :
+    m_file(filename),
+    mp_header(GEM::Renderer::CookedMesh::validateHeader(m_file)),
+    mp_attributes(reinterpret_cast<const GEM::Renderer::CookedMesh::Attribute*>(m_file.getData() + sizeof(GEM::Renderer::CookedMesh::Header))),
+    mp_lods(reinterpret_cast<const GEM::Renderer::MeshLod*>(mp_attributes + mp_header->attributeCount))
+{
+    LOG_FUNCTION_CALL_TRACE("filename {} , vertex count {} , index count {}", filename, mp_header->vertexCount, mp_header->indexCount);
+}
+
+/**
+ * @brief Destroy the GEM::Renderer::CookedMesh::CookedMesh object, unmapping the file
+ */
+GEM::Renderer::CookedMesh::~CookedMesh() {
+    LOG_FUNCTION_CALL_TRACE("filename {}", m_file.getFilename());
+}
+
+/* ------------------------------ private member functions ------------------------------ */
\ No newline at end of file
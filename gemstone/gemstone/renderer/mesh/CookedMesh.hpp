@@ -0,0 +1,104 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include "util/io/MappedFile.hpp"
+
+#include "gemstone/renderer/mesh/IndexedGeometry.hpp"
+#include "gemstone/renderer/mesh/MeshLod.hpp"
+
+namespace GEM {
+namespace Renderer {
+    class CookedMesh;
+}
+}
+
+/**
+ * @brief A mesh cooked offline into a binary blob which can be handed straight to the gpu. The blob is laid
+ * out as a header, a descriptor for each vertex attribute, the range of indices of each level of detail, then
+ * the vertex and index data, each starting on a SECTION_ALIGNMENT boundary. Loading one maps the file into
+ * memory and exposes pointers into the mapping, so no parsing or copying happens on our side
+ * 
+ * @note All values are stored little endian
+ */
+class GEM::Renderer::CookedMesh {
+public: // public classes and enums
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint32_t indexType;
+        uint32_t vertexStrideBytes;
+        uint32_t attributeCount;
+        uint32_t lodCount;
+        float boundsMin[3];
+        float boundsMax[3];
+        uint64_t vertexDataOffset;
+        uint64_t vertexDataSizeBytes;
+        uint64_t indexDataOffset;
+        uint64_t indexDataSizeBytes;
+    };
+
+    struct Attribute {
+        uint32_t location;
+        uint32_t componentCount;
+        uint32_t type;
+        uint32_t offsetBytes;
+    };
+
+public: // public static variables
+    static const std::string LOGGER_NAME;
+    static const std::string FILE_EXTENSION;
+    static const uint32_t VERSION;
+    static const uint64_t SECTION_ALIGNMENT;
+
+public: // public static functions
+    static void cook(
+        const GEM::Renderer::IndexedGeometry& geometry,
+        const std::vector<GEM::Renderer::MeshLod>& lods,
+        const std::string& filename
+    );
+
+public: // public member functions
+    CookedMesh(const std::string& filename);
+    ~CookedMesh();
+
+    CookedMesh(const CookedMesh& other) = delete;
+    void operator=(const CookedMesh& other) = delete;
+
+    uint32_t getVertexCount() const { return mp_header->vertexCount; }
+    uint32_t getIndexCount() const { return mp_header->indexCount; }
+    GLenum getIndexType() const { return mp_header->indexType; }
+    uint32_t getVertexStrideBytes() const { return mp_header->vertexStrideBytes; }
+    uint32_t getAttributeCount() const { return mp_header->attributeCount; }
+    const GEM::Renderer::CookedMesh::Attribute& getAttribute(const uint32_t i) const { return mp_attributes[i]; }
+    uint32_t getLodCount() const { return mp_header->lodCount; }
+    const GEM::Renderer::MeshLod& getLod(const uint32_t i) const { return mp_lods[i]; }
+    glm::vec3 getBoundsMin() const {
+        return glm::vec3(mp_header->boundsMin[0], mp_header->boundsMin[1], mp_header->boundsMin[2]);
+    }
+    glm::vec3 getBoundsMax() const {
+        return glm::vec3(mp_header->boundsMax[0], mp_header->boundsMax[1], mp_header->boundsMax[2]);
+    }
+
+    const void* getVertexData() const { return m_file.getData() + mp_header->vertexDataOffset; }
+    size_t getVertexDataSizeBytes() const { return mp_header->vertexDataSizeBytes; }
+    const void* getIndexData() const { return m_file.getData() + mp_header->indexDataOffset; }
+    size_t getIndexDataSizeBytes() const { return mp_header->indexDataSizeBytes; }
+
+private: // private static functions
+    static uint64_t alignOffset(const uint64_t offset);
+    static const GEM::Renderer::CookedMesh::Header* validateHeader(const GEM::util::MappedFile& file);
+
+private: // private member variables
+    const GEM::util::MappedFile m_file;
+    const GEM::Renderer::CookedMesh::Header* const mp_header;
+    const GEM::Renderer::CookedMesh::Attribute* const mp_attributes;
+    const GEM::Renderer::MeshLod* const mp_lods;
+};
\ No newline at end of file
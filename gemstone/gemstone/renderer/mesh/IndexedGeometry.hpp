@@ -0,0 +1,42 @@
+#pragma once
+
+#include <limits>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace GEM {
+namespace Renderer {
+    struct IndexedGeometry;
+}
+}
+
+/**
+ * @brief Interleaved vertices paired with the indices of the triangles drawn from them. Every vertex is
+ * made up of vertexComponentCount floats, the first 3 of which are its position, and every 3 indices make up
+ * a triangle
+ */
+struct GEM::Renderer::IndexedGeometry {
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+    uint32_t vertexComponentCount;
+
+    uint32_t getVertexCount() const { return static_cast<uint32_t>(vertices.size() / vertexComponentCount); }
+    uint32_t getIndexCount() const { return static_cast<uint32_t>(indices.size()); }
+
+    glm::vec3 getBoundsMin() const {
+        glm::vec3 boundsMin(vertices.empty() ? 0.0f : std::numeric_limits<float>::max());
+        for (size_t i = 0; i + 2 < vertices.size(); i += vertexComponentCount) {
+            boundsMin = glm::min(boundsMin, glm::vec3(vertices[i], vertices[i + 1], vertices[i + 2]));
+        }
+        return boundsMin;
+    }
+
+    glm::vec3 getBoundsMax() const {
+        glm::vec3 boundsMax(vertices.empty() ? 0.0f : std::numeric_limits<float>::lowest());
+        for (size_t i = 0; i + 2 < vertices.size(); i += vertexComponentCount) {
+            boundsMax = glm::max(boundsMax, glm::vec3(vertices[i], vertices[i + 1], vertices[i + 2]));
+        }
+        return boundsMax;
+    }
+};
\ No newline at end of file
@@ -1,5 +1,14 @@
 #include "gemstone/renderer/mesh/Mesh.hpp"
 
+#include <algorithm>
+#include <cstddef> // offsetof
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <functional> // std::hash
+#include <limits>
+#include <map>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -7,9 +16,19 @@
 
 #include <glm/glm.hpp>
 
+#include "util/io/FileSystem.hpp"
 #include "util/logger/Logger.hpp"
 
 #include "gemstone/renderer/mesh/logger.hpp"
+#include "gemstone/renderer/mesh/CookedMesh.hpp"
+#include "gemstone/renderer/mesh/IndexedGeometry.hpp"
+#include "gemstone/renderer/mesh/MeshInstance.hpp"
+#include "gemstone/renderer/mesh/MeshLod.hpp"
+#include "gemstone/renderer/mesh/MeshOptimizer.hpp"
+#include "gemstone/renderer/mesh/MeshSimplifier.hpp"
+#include "gemstone/renderer/mesh/ObjLoader.hpp"
+#include "gemstone/renderer/state/StateCache.hpp"
+#include "gemstone/renderer/upload/UploadQueue.hpp"
 
 /* ------------------------------ public static variables ------------------------------ */
 
@@ -18,18 +37,343 @@
  */
 const std::string GEM::Renderer::Mesh::LOGGER_NAME = MESH_LOGGER_NAME;
 
+/**
+ * @brief How many pixels on screen a level of detail's error may cover before we need a more detailed one
+ */
+const float GEM::Renderer::Mesh::LOD_MAX_PIXEL_ERROR = 1.0f;
+
+/**
+ * @brief The attribute location of the first column of each instance's model matrix, whose 4 columns take up 4
+ * consecutive locations
+ */
+const uint32_t GEM::Renderer::Mesh::INSTANCE_MODEL_MATRIX_LOCATION = 3;
+
+/**
+ * @brief The attribute location of each instance's texture layers
+ */
+const uint32_t GEM::Renderer::Mesh::INSTANCE_TEXTURE_LAYERS_LOCATION = 7;
+
 /* ------------------------------ private static variables ------------------------------ */
 
+/**
+ * @brief Map of the mesh's source file (hash) to the gpu buffers holding that mesh.
+ * This allows us to prevent uploading the same geometry twice and instead just share the
+ * buffers if the same file is loaded subsequent times.
+ * Each entry tracks its use count so we can delete the buffers once it is decremented to 0
+ */
+std::map<size_t, GEM::Renderer::Mesh::Info> GEM::Renderer::Mesh::meshIDMap;
+
 /* ------------------------------ public static functions ------------------------------ */
 
+/**
+ * @brief Get the smallest index type able to address every vertex of the mesh
+ * 
+ * @param vertexCount The number of unique vertices in the mesh
+ * @return GLenum GL_UNSIGNED_SHORT if every index fits in 16 bits, GL_UNSIGNED_INT otherwise
+ */
+GLenum GEM::Renderer::Mesh::getIndexType(const uint32_t vertexCount) {
+    if (vertexCount <= std::numeric_limits<uint16_t>::max()) {
+        return GL_UNSIGNED_SHORT;
+    }
+
+    return GL_UNSIGNED_INT;
+}
+
+/**
+ * @brief Reorder the deduplicated vertices and indices so the gpu transforms as few vertices as possible
+ * and reads the vertex buffer in order, generating the levels of detail along the way. The indices of
+ * every level of detail are appended to the geometry's indices
+ * 
+ * @param geometry The vertices and indices to optimize in place
+ * @return std::vector<GEM::Renderer::MeshLod> The range of indices and error of each level of detail
+ */
+std::vector<GEM::Renderer::MeshLod> GEM::Renderer::Mesh::optimizeGeometry(GEM::Renderer::IndexedGeometry& geometry) {
+    LOG_FUNCTION_ENTRY_TRACE("vertex count {} , index count {}", geometry.getVertexCount(), geometry.getIndexCount());
+
+    GEM::Renderer::MeshOptimizer::optimizeVertexCache(geometry);
+    const std::vector<GEM::Renderer::MeshLod> lods = GEM::Renderer::MeshSimplifier::generateLodChain(geometry);
+
+    // Fetch order is decided last, over every level, so the full detail level still reads front to back
+    GEM::Renderer::MeshOptimizer::optimizeVertexFetch(geometry);
+
+    return lods;
+}
+
+/**
+ * @brief Load the deduplicated vertices and indices out of the mesh's file. If the file doesn't exist
+ * or isn't a format we can read then we fall back to the default cube. The geometry stays on our side,
+ * so this is also how the cpu gets at a mesh's triangles
+ * 
+ * @note This function will throw if the file exists but cannot be parsed
+ * 
+ * @param filename The full path to the file containing the mesh
+ * @return GEM::Renderer::IndexedGeometry The vertices and indices making up this mesh
+ */
+GEM::Renderer::IndexedGeometry GEM::Renderer::Mesh::loadGeometry(const std::string& filename) {
+    LOG_FUNCTION_CALL_TRACE("filename {}", filename);
+
+    const std::string extension = filename.substr(filename.find_last_of(".") + 1);
+
+    if (GEM::util::FileSystem::fileExists(filename) && extension == "obj") {
+        return GEM::Renderer::ObjLoader::load(filename);
+    }
+
+    LOG_WARNING("Could not load mesh at {} , using the default cube instead", filename);
+
+    // 3 position + 3 color + 2 texture
+    return GEM::Renderer::MeshOptimizer::deduplicateVertices(GEM::Renderer::Mesh::loadDefaultVertices(), 8);
+}
+
 /* ------------------------------ private static functions ------------------------------ */
 
 /**
- * @brief Load the vertices for this mesh
+ * @brief Add a newly loaded mesh to the map so it can be found by subsequent loads of the same file
+ * 
+ * @param meshSourceHash The hash of the mesh's source file
+ * @param info The ids of the gpu buffers holding the mesh
+ */
+void GEM::Renderer::Mesh::addMeshToMap(const size_t meshSourceHash, const GEM::Renderer::Mesh::Info& info) {
+    LOG_FUNCTION_ENTRY_TRACE("hash {} , VAO id {} , VBO id {} , EBO id {}", meshSourceHash, info.vertexArrayObjectID, info.vertexBufferObjectID, info.elementBufferObjectID);
+
+    GEM::Renderer::Mesh::meshIDMap.insert({meshSourceHash, info});
+
+    GEM::Renderer::Mesh::incrementMeshUseCount(meshSourceHash);
+}
+
+/**
+ * @brief Increment the use count of the mesh so we know how many things are using it
+ * 
+ * @param meshSourceHash The hash of the mesh's source file
+ */
+void GEM::Renderer::Mesh::incrementMeshUseCount(const size_t meshSourceHash) {
+    LOG_FUNCTION_ENTRY_TRACE("hash {}", meshSourceHash);
+
+    GEM::Renderer::Mesh::Info info = GEM::Renderer::Mesh::meshIDMap[meshSourceHash];
+    info.useCount += 1;
+
+    LOG_TRACE("Use count for mesh with VAO id {} and hash {} is now: {}", info.vertexArrayObjectID, meshSourceHash, info.useCount);
+
+    GEM::Renderer::Mesh::meshIDMap[meshSourceHash] = info;
+}
+
+/**
+ * @brief Decrement the use count of the mesh so we know how many things are using it. If the count
+ * reaches 0 then we are going to remove it from the map and delete its buffers
+ * 
+ * @param meshSourceHash The hash of the mesh's source file
+ */
+void GEM::Renderer::Mesh::decrementMeshUseCount(const size_t meshSourceHash) {
+    LOG_FUNCTION_ENTRY_TRACE("hash {}", meshSourceHash);
+
+    GEM::Renderer::Mesh::Info info = GEM::Renderer::Mesh::meshIDMap[meshSourceHash];
+    LOG_TRACE("Use count for mesh with VAO id {} and hash {} was: {}", info.vertexArrayObjectID, meshSourceHash, info.useCount);
+    info.useCount -= 1;
+
+    LOG_TRACE("Use count for mesh with VAO id {} and hash {} is now: {}", info.vertexArrayObjectID, meshSourceHash, info.useCount);
+
+    if (info.useCount > 0) {
+        LOG_TRACE("Updating use count for mesh with VAO id {} and hash {}", info.vertexArrayObjectID, meshSourceHash);
+        GEM::Renderer::Mesh::meshIDMap[meshSourceHash] = info;
+        return;
+    }
+
+    LOG_TRACE("Erasing mesh with VAO id {} and hash {}", info.vertexArrayObjectID, meshSourceHash);
+    GEM::Renderer::Mesh::meshIDMap.erase(meshSourceHash);
+
+    LOG_TRACE("Deleting VAO id {} , VBO id {} , EBO id {}", info.vertexArrayObjectID, info.vertexBufferObjectID, info.elementBufferObjectID);
+    GEM::Renderer::StateCache::deleteVertexArray(info.vertexArrayObjectID);
+    GEM::Renderer::StateCache::deleteBuffer(info.vertexBufferObjectID);
+    GEM::Renderer::StateCache::deleteBuffer(info.elementBufferObjectID);
+}
+
+/**
+ * @brief Determine if the mesh in the given file has already been loaded and is being tracked
+ * 
+ * @param meshSourceHash The hash of the mesh's source file
+ * @return true The hash has an entry in the map
+ * @return false The hash does not have an entry in the map
+ */
+bool GEM::Renderer::Mesh::meshIsLoaded(const size_t meshSourceHash) {
+    LOG_FUNCTION_ENTRY_TRACE("hash {}", meshSourceHash);
+
+    const bool isLoaded = GEM::Renderer::Mesh::meshIDMap.count(meshSourceHash) > 0;
+
+    if (isLoaded) {
+        LOG_TRACE("Found loaded mesh for hash {}", meshSourceHash);
+    }
+
+    return isLoaded;
+}
+
+/**
+ * @brief Get the canonical path of a mesh file, so the same file is found no matter how its path is spelled
+ *
+ * @param filename The path to the mesh file
+ * @return std::string The canonical path, or the path as given if it can't be made canonical
+ */
+std::string GEM::Renderer::Mesh::getCanonicalFilename(const std::string& filename) {
+    std::error_code errorCode;
+    const std::filesystem::path canonicalPath = std::filesystem::weakly_canonical(filename, errorCode);
+    if (errorCode) {
+        LOG_WARNING("Could not get the canonical path of {} : {}", filename, errorCode.message());
+        return filename;
+    }
+
+    return canonicalPath.string();
+}
+
+/**
+ * @brief Take the canonical filename of a mesh and determine its hash value. This is so we can look into the
+ * map of loaded meshes
+ * 
+ * @param filename The canonical path to the file containing the mesh
+ * @return size_t The hash of the mesh's filename
+ */
+size_t GEM::Renderer::Mesh::getHashFromFilename(const std::string& filename) {
+    return std::hash<std::string>{}(filename);
+}
+
+/**
+ * @brief Get the ids of the gpu buffers for an already loaded mesh
+ * 
+ * @param meshSourceHash The hash of the mesh's source file
+ * @return GEM::Renderer::Mesh::Info The ids of the mesh's buffers
+ */
+GEM::Renderer::Mesh::Info GEM::Renderer::Mesh::getLoadedMeshInfo(const size_t meshSourceHash) {
+    LOG_FUNCTION_ENTRY_TRACE("hash {}", meshSourceHash);
+
+    GEM::Renderer::Mesh::Info info = GEM::Renderer::Mesh::meshIDMap[meshSourceHash];
+    LOG_TRACE("Got loaded mesh VAO id: {}", info.vertexArrayObjectID);
+
+    return info;
+}
+
+/**
+ * @brief Load a mesh onto the gpu given the file it is stored in. If the file has already been
+ * loaded then the existing buffers are reused and their use count is incremented
+ * 
+ * @param filename The full path to the file containing the mesh
+ * @return GEM::Renderer::Mesh::Info The ids of the mesh's buffers
+ */
+GEM::Renderer::Mesh::Info GEM::Renderer::Mesh::loadMesh(const std::string& filename) {
+    LOG_FUNCTION_CALL_INFO("filename {}", filename);
+
+    // Before we actually upload anything, check if this file has already been loaded
+    // If it has been loaded before, use those buffers and increment the counter
+    const size_t meshSourceHash = GEM::Renderer::Mesh::getHashFromFilename(filename);
+    if (GEM::Renderer::Mesh::meshIsLoaded(meshSourceHash)) {
+        GEM::Renderer::Mesh::Info info = GEM::Renderer::Mesh::getLoadedMeshInfo(meshSourceHash);
+
+        GEM::Renderer::Mesh::incrementMeshUseCount(meshSourceHash);
+
+        LOG_DEBUG("Successfully found loaded mesh with VAO id {}", info.vertexArrayObjectID);
+
+        return info;
+    }
+
+    // Cooked meshes go straight from the file to the gpu, anything else has to be parsed and optimized first
+    const std::string extension = filename.substr(filename.find_last_of(".") + 1);
+    GEM::Renderer::Mesh::Info info = extension == GEM::Renderer::CookedMesh::FILE_EXTENSION ?
+        GEM::Renderer::Mesh::uploadCookedMesh(filename) :
+        GEM::Renderer::Mesh::uploadGeometry(filename);
+
+    // Unbind our VAO so nothing bound after this can change which EBO it uses
+    GEM::Renderer::StateCache::bindVertexArray(0);
+
+    GEM::Renderer::Mesh::addMeshToMap(meshSourceHash, info);
+
+    LOG_DEBUG("Successfully loaded mesh with VAO id {} , {} vertices , {} indices , {} lods", info.vertexArrayObjectID, info.vertexCount, info.indexCount, info.lods.size());
+
+    return info;
+}
+
+/**
+ * @brief Map a cooked mesh file into memory and hand the mapped vertex and index sections straight to
+ * the gpu. The file is unmapped as soon as the upload is done, so no copy of the mesh stays on our side
+ * 
+ * @note This function will throw if the file is not a valid cooked mesh
+ * 
+ * @param filename The full path to the cooked mesh file
+ * @return GEM::Renderer::Mesh::Info The ids of the mesh's buffers, with a use count of 0
+ */
+GEM::Renderer::Mesh::Info GEM::Renderer::Mesh::uploadCookedMesh(const std::string& filename) {
+    LOG_FUNCTION_CALL_TRACE("filename {}", filename);
+
+    const GEM::Renderer::CookedMesh cookedMesh(filename);
+
+    GEM::Renderer::Mesh::Info info;
+    info.vertexCount = cookedMesh.getVertexCount();
+    info.indexCount = cookedMesh.getIndexCount();
+    info.indexType = cookedMesh.getIndexType();
+    info.boundsMin = cookedMesh.getBoundsMin();
+    info.boundsMax = cookedMesh.getBoundsMax();
+    for (uint32_t i = 0; i < cookedMesh.getLodCount(); ++i) {
+        info.lods.push_back(cookedMesh.getLod(i));
+    }
+    info.vertexArrayObjectID = GEM::Renderer::Mesh::createVertexArrayObject();
+    info.vertexBufferObjectID = GEM::Renderer::Mesh::createVertexBufferObject(cookedMesh.getVertexData(), cookedMesh.getVertexDataSizeBytes());
+    info.elementBufferObjectID = GEM::Renderer::Mesh::createElementBufferObject(cookedMesh.getIndexData(), cookedMesh.getIndexDataSizeBytes());
+    info.useCount = 0;
+
+    try {
+        GEM::Renderer::Mesh::configureCookedVertexAttributePointers(cookedMesh);
+    } catch (const std::exception&) {
+        // Nothing holds on to the buffers until the mesh is added to the map, so they would leak
+        GEM::Renderer::StateCache::bindVertexArray(0);
+        GEM::Renderer::StateCache::deleteVertexArray(info.vertexArrayObjectID);
+        GEM::Renderer::StateCache::deleteBuffer(info.vertexBufferObjectID);
+        GEM::Renderer::StateCache::deleteBuffer(info.elementBufferObjectID);
+        throw;
+    }
+
+    return info;
+}
+
+/**
+ * @brief Load the geometry out of a mesh file that hasn't been cooked, optimize it, generate its levels of
+ * detail, and upload it to the gpu.
+ * The geometry only lives long enough to be uploaded
+ * 
+ * @note This function will throw if the file exists but cannot be parsed
+ * 
+ * @param filename The full path to the file containing the mesh
+ * @return GEM::Renderer::Mesh::Info The ids of the mesh's buffers, with a use count of 0
+ */
+GEM::Renderer::Mesh::Info GEM::Renderer::Mesh::uploadGeometry(const std::string& filename) {
+    LOG_FUNCTION_CALL_TRACE("filename {}", filename);
+
+    GEM::Renderer::IndexedGeometry geometry = GEM::Renderer::Mesh::loadGeometry(filename);
+
+    GEM::Renderer::Mesh::Info info;
+    info.lods = GEM::Renderer::Mesh::optimizeGeometry(geometry);
+    info.vertexCount = geometry.getVertexCount();
+    info.indexCount = geometry.getIndexCount();
+    info.indexType = GEM::Renderer::Mesh::getIndexType(info.vertexCount);
+    info.boundsMin = geometry.getBoundsMin();
+    info.boundsMax = geometry.getBoundsMax();
+    info.vertexArrayObjectID = GEM::Renderer::Mesh::createVertexArrayObject();
+    info.vertexBufferObjectID = GEM::Renderer::Mesh::createVertexBufferObject(geometry.vertices.data(), geometry.vertices.size() * sizeof(float));
+
+    // Halve the size of the indices if they all fit in 16 bits
+    if (info.indexType == GL_UNSIGNED_SHORT) {
+        const std::vector<uint16_t> shortIndices(geometry.indices.begin(), geometry.indices.end());
+        info.elementBufferObjectID = GEM::Renderer::Mesh::createElementBufferObject(shortIndices.data(), shortIndices.size() * sizeof(uint16_t));
+    } else {
+        info.elementBufferObjectID = GEM::Renderer::Mesh::createElementBufferObject(geometry.indices.data(), geometry.indices.size() * sizeof(uint32_t));
+    }
+    info.useCount = 0;
+
+    GEM::Renderer::Mesh::configureVertexAttributePointers();
+
+    return info;
+}
+
+/**
+ * @brief Load the vertices of the default cube, used when a mesh's file cannot be loaded
  * 
- * @return std::vector<float> The vector of vertices making up this mesh
+ * @return std::vector<float> The vector of vertices making up the cube
  */
-std::vector<float> GEM::Renderer::Mesh::loadVertices() {
+std::vector<float> GEM::Renderer::Mesh::loadDefaultVertices() {
     LOG_FUNCTION_ENTRY_TRACE("{}", nullptr);
 
     return {
@@ -88,7 +432,7 @@ uint32_t GEM::Renderer::Mesh::createVertexArrayObject() {
 
     uint32_t vertexArrayObjectID;
     glGenVertexArrays(1, &vertexArrayObjectID);
-    glBindVertexArray(vertexArrayObjectID);
+    GEM::Renderer::StateCache::bindVertexArray(vertexArrayObjectID);
 
     return vertexArrayObjectID;
 }
@@ -97,37 +441,42 @@ uint32_t GEM::Renderer::Mesh::createVertexArrayObject() {
  * @brief Create the vertex buffer object and bind it so we can configure it with
  * subsequent calls to GL_ARRAY_BUFFER
  * 
- * @param vertices The vector of vertices, color values, and texture coords
+ * @param p_vertexData The interleaved vertices, color values, and texture coords
+ * @param vertexDataSizeBytes The size of the vertex data in bytes
  * @return uint32_t The id of the VBO
  */
-uint32_t GEM::Renderer::Mesh::createVertexBufferObject(const std::vector<float>& vertices) {
-    LOG_FUNCTION_ENTRY_TRACE("vertices size {}", vertices.size());
+uint32_t GEM::Renderer::Mesh::createVertexBufferObject(const void* p_vertexData, const size_t vertexDataSizeBytes) {
+    LOG_FUNCTION_ENTRY_TRACE("vertex data size {} bytes", vertexDataSizeBytes);
 
     uint32_t vertexBufferObjectID;
     glGenBuffers(1, &vertexBufferObjectID);
-    glBindBuffer(GL_ARRAY_BUFFER, vertexBufferObjectID);
+    GEM::Renderer::StateCache::bindBuffer(GL_ARRAY_BUFFER, vertexBufferObjectID);
 
-    // Copy the vertices into the currently bound vertex buffer
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    // Allocate the vertex buffer, then copy the vertices into it through the upload queue. The mesh is drawn
+    // as soon as it is created, so the copy is made right away and only counts against the frame's budget
+    glBufferData(GL_ARRAY_BUFFER, vertexDataSizeBytes, nullptr, GL_STATIC_DRAW);
+    GEM::Renderer::UploadQueue::uploadBuffer(GL_ARRAY_BUFFER, p_vertexData, vertexDataSizeBytes);
 
     return vertexBufferObjectID;
 }
 
 /**
- * @brief Create the EBO similarly to creating a VBO
+ * @brief Create the EBO similarly to creating a VBO. The VAO must be bound so it remembers the EBO
  * 
- * @param vertices The vector of vertices, color values, and texture coords
+ * @param p_indexData The indices of the vertices making up each triangle, already in the type they will be drawn with
+ * @param indexDataSizeBytes The size of the index data in bytes
  * @return uint32_t The id of the EBO
  */
-uint32_t GEM::Renderer::Mesh::createElementBufferObject(const std::vector<float>& vertices) {
-    LOG_FUNCTION_ENTRY_TRACE("vertices size {}", vertices.size());
+uint32_t GEM::Renderer::Mesh::createElementBufferObject(const void* p_indexData, const size_t indexDataSizeBytes) {
+    LOG_FUNCTION_ENTRY_TRACE("index data size {} bytes", indexDataSizeBytes);
 
     uint32_t elementBufferObjectID;
     glGenBuffers(1, &elementBufferObjectID);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementBufferObjectID);
+    GEM::Renderer::StateCache::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementBufferObjectID);
 
-    // Copy the vertices into the buffer
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    // Allocate the element buffer, then copy the indices into it through the upload queue
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexDataSizeBytes, nullptr, GL_STATIC_DRAW);
+    GEM::Renderer::UploadQueue::uploadBuffer(GL_ELEMENT_ARRAY_BUFFER, p_indexData, indexDataSizeBytes);
 
     return elementBufferObjectID;
 }
@@ -175,42 +524,204 @@ void GEM::Renderer::Mesh::configureVertexAttributePointers() {
     glEnableVertexAttribArray(p_vertexTextureAttribute);
 }
 
+/**
+ * @brief Configure the vertex attribute pointers from the layout described in a cooked mesh. The VAO and
+ * VBO must already be bound
+ * 
+ * @note This function will throw if an attribute does not fit within a vertex, or is at a location gl doesn't
+ * have or the per instance attributes use
+ * 
+ * @param cookedMesh The cooked mesh describing its vertex layout
+ */
+void GEM::Renderer::Mesh::configureCookedVertexAttributePointers(const GEM::Renderer::CookedMesh& cookedMesh) {
+    LOG_FUNCTION_ENTRY_TRACE("attribute count {} , stride {} bytes", cookedMesh.getAttributeCount(), cookedMesh.getVertexStrideBytes());
+
+    int32_t maxAttributeCount;
+    glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &maxAttributeCount);
+
+    for (uint32_t i = 0; i < cookedMesh.getAttributeCount(); ++i) {
+        const GEM::Renderer::CookedMesh::Attribute& attribute = cookedMesh.getAttribute(i);
+
+        // configureInstanceAttributePointers overwrites the instance locations whenever the mesh is drawn instanced
+        const bool overlapsInstanceAttributes =
+            attribute.location >= GEM::Renderer::Mesh::INSTANCE_MODEL_MATRIX_LOCATION &&
+            attribute.location <= GEM::Renderer::Mesh::INSTANCE_TEXTURE_LAYERS_LOCATION;
+
+        if (attribute.type != GL_FLOAT || attribute.componentCount < 1 || attribute.componentCount > 4 ||
+            attribute.offsetBytes + attribute.componentCount * sizeof(float) > cookedMesh.getVertexStrideBytes() ||
+            attribute.location >= static_cast<uint32_t>(maxAttributeCount) || overlapsInstanceAttributes) {
+            const std::string errorMessage = "Invalid vertex attribute at location " + std::to_string(attribute.location) + " in cooked mesh";
+            LOG_CRITICAL(errorMessage);
+            throw std::runtime_error(errorMessage);
+        }
+
+        glVertexAttribPointer(
+            attribute.location,
+            attribute.componentCount,
+            attribute.type,
+            GL_FALSE,
+            cookedMesh.getVertexStrideBytes(),
+            (void*)(static_cast<uintptr_t>(attribute.offsetBytes))
+        );
+        glEnableVertexAttribArray(attribute.location);
+    }
+}
+
+/**
+ * @brief Configure the per instance vertex attribute pointers for the model matrix and texture layers of each
+ * instance. The instance buffer must be bound to GL_ARRAY_BUFFER before calling this
+ * 
+ * @param firstInstance The index of the first MeshInstance within the instance buffer to read from
+ */
+void GEM::Renderer::Mesh::configureInstanceAttributePointers(const uint32_t firstInstance) {
+    const size_t firstInstanceOffset = firstInstance * sizeof(GEM::Renderer::MeshInstance);
+
+    // A mat4 attribute takes up 4 consecutive attribute locations, one for each column
+    const uint32_t p_instanceModelMatrixAttribute = GEM::Renderer::Mesh::INSTANCE_MODEL_MATRIX_LOCATION;
+    for (uint32_t column = 0; column < 4; ++column) {
+        glVertexAttribPointer(
+            p_instanceModelMatrixAttribute + column,
+            4,
+            GL_FLOAT,
+            GL_FALSE,
+            sizeof(GEM::Renderer::MeshInstance),                                                                    // Stride length of one whole instance
+            (void*)(firstInstanceOffset + offsetof(GEM::Renderer::MeshInstance, modelMatrix) + (column * sizeof(glm::vec4)))   // Offset to the first instance's matrix, then to the column
+        );
+        glEnableVertexAttribArray(p_instanceModelMatrixAttribute + column);
+
+        // Advance this attribute once per instance instead of once per vertex
+        glVertexAttribDivisor(p_instanceModelMatrixAttribute + column, 1);
+    }
+
+    const uint32_t p_instanceTextureLayersAttribute = GEM::Renderer::Mesh::INSTANCE_TEXTURE_LAYERS_LOCATION;
+    glVertexAttribPointer(
+        p_instanceTextureLayersAttribute,
+        2,
+        GL_FLOAT,
+        GL_FALSE,
+        sizeof(GEM::Renderer::MeshInstance),
+        (void*)(firstInstanceOffset + offsetof(GEM::Renderer::MeshInstance, textureLayers))
+    );
+    glEnableVertexAttribArray(p_instanceTextureLayersAttribute);
+    glVertexAttribDivisor(p_instanceTextureLayersAttribute, 1);
+}
+
 /* ------------------------------ public member functions ------------------------------ */
 
 /**
- * @brief Generate and configure the VAO, the VBO, the EBO, and attribute pointers to be
- * stored for later use
+ * @brief Get the VAO, the VBO, the EBO, and attribute pointers for the mesh in the given file. These
+ * are only generated and configured if no other mesh has already loaded the same file. Files are told apart by
+ * their canonical path, so different spellings of the same path share the same buffers
+ * 
+ * @param filename The path to the file containing the mesh
  */
-GEM::Renderer::Mesh::Mesh() :
-    m_vertices(GEM::Renderer::Mesh::loadVertices()),
-    m_vertexArrayObjectID(GEM::Renderer::Mesh::createVertexArrayObject()),
-    m_vertexBufferObjectID(GEM::Renderer::Mesh::createVertexBufferObject(m_vertices)),
-    m_elementBufferObjectID(GEM::Renderer::Mesh::createElementBufferObject(m_vertices))
-{
-    GEM::Renderer::Mesh::configureVertexAttributePointers();
+GEM::Renderer::Mesh::Mesh(const std::string& filename) :
+    m_filename(GEM::Renderer::Mesh::getCanonicalFilename(filename)),
+    m_sourceHash(GEM::Renderer::Mesh::getHashFromFilename(m_filename)),
+    m_info(GEM::Renderer::Mesh::loadMesh(m_filename))
+{}
 
-    // Unbind our VAO, VBO, and EBO so the next objects loaded in can handle it
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+/**
+ * @brief Decrement the use count for this mesh. If the use count falls to 0 then we delete the buffers
+ */
+GEM::Renderer::Mesh::~Mesh() {
+    LOG_FUNCTION_CALL_TRACE("filename {} , VAO id {} , VBO id {} , EBO id {}", m_filename, m_info.vertexArrayObjectID, m_info.vertexBufferObjectID, m_info.elementBufferObjectID);
+    GEM::Renderer::Mesh::decrementMeshUseCount(m_sourceHash);
 }
 
-GEM::Renderer::Mesh::~Mesh() {
-    LOG_FUNCTION_CALL_TRACE("vertices size {}, VAO id {}, VBO id {}, EBO id {}", m_vertices.size(), m_vertexArrayObjectID, m_vertexBufferObjectID, m_elementBufferObjectID);
-    glDeleteVertexArrays(1, &m_vertexArrayObjectID);
-    glDeleteBuffers(1, &m_vertexBufferObjectID);
-    glDeleteBuffers(1, &m_elementBufferObjectID);
+/**
+ * @brief Pick the coarsest level of detail which still looks the same as full detail when drawn with the
+ * given matrices. The mesh's bounding sphere is projected onto the screen, and each level's error is
+ * scaled by the same amount to see how many pixels it would cover
+ * 
+ * @param modelMatrix The model matrix the mesh will be drawn with
+ * @param viewMatrix The camera's view matrix
+ * @param projectionMatrix The camera's perspective projection matrix
+ * @param viewportHeightPixels The height of the viewport the mesh is drawn into
+ * @return uint32_t The index of the level of detail to draw
+ */
+uint32_t GEM::Renderer::Mesh::selectLod(
+    const glm::mat4& modelMatrix,
+    const glm::mat4& viewMatrix,
+    const glm::mat4& projectionMatrix,
+    const float viewportHeightPixels
+) const {
+    const glm::vec3 boundsCenter = (m_info.boundsMin + m_info.boundsMax) * 0.5f;
+    const float boundsRadius = glm::length(m_info.boundsMax - m_info.boundsMin) * 0.5f;
+    if (m_info.lods.size() < 2 || boundsRadius <= 0.0f) {
+        return 0;
+    }
+
+    // The world space radius grows with the largest scale along any axis
+    const float scale = std::max({
+        glm::length(glm::vec3(modelMatrix[0])),
+        glm::length(glm::vec3(modelMatrix[1])),
+        glm::length(glm::vec3(modelMatrix[2]))
+    });
+    const float worldRadius = boundsRadius * scale;
+
+    // Use full detail when the camera is inside or right up against the mesh
+    const glm::vec4 viewCenter = viewMatrix * modelMatrix * glm::vec4(boundsCenter, 1.0f);
+    const float distance = -viewCenter.z;
+    if (distance <= worldRadius) {
+        return 0;
+    }
+
+    // projectionMatrix[1][1] is the cotangent of half the vertical field of view
+    const float projectedRadiusPixels = (worldRadius * projectionMatrix[1][1] * viewportHeightPixels * 0.5f) / distance;
+
+    for (uint32_t lodIndex = static_cast<uint32_t>(m_info.lods.size()) - 1; lodIndex > 0; --lodIndex) {
+        const float errorPixels = (m_info.lods[lodIndex].error / boundsRadius) * projectedRadiusPixels;
+        if (errorPixels <= GEM::Renderer::Mesh::LOD_MAX_PIXEL_ERROR) {
+            return lodIndex;
+        }
+    }
+
+    return 0;
 }
 
 /**
- * @brief Bind the corresponding VAO, draw it, then unbind the VAO
+ * @brief Bind the corresponding VAO and draw it at full detail. The VAO is left bound, so drawing the same
+ * mesh again doesn't rebind it
  */
 void GEM::Renderer::Mesh::draw() {
-    glBindVertexArray(m_vertexArrayObjectID);
+    GEM::Renderer::StateCache::bindVertexArray(m_info.vertexArrayObjectID);
 
-    glDrawArrays(GL_TRIANGLES, 0, 36);
+    glDrawElements(GL_TRIANGLES, m_info.lods[0].indexCount, m_info.indexType, nullptr);
+}
+
+/**
+ * @brief Bind the corresponding VAO so that any number of drawInstanced calls can follow without binding
+ * it again
+ */
+void GEM::Renderer::Mesh::bind() const {
+    GEM::Renderer::StateCache::bindVertexArray(m_info.vertexArrayObjectID);
+}
 
-    glBindVertexArray(0);
+/**
+ * @brief Point the per instance attributes at the instances in the instance buffer and draw every
+ * instance with a single call. The VAO is left bound for the next draw of the same mesh
+ * 
+ * @note The mesh must already be bound with bind
+ * 
+ * @param instanceBufferObjectID The id of the buffer holding one MeshInstance per instance
+ * @param firstInstance The index of the first MeshInstance within the instance buffer to draw
+ * @param instanceCount The number of instances to draw
+ * @param lodIndex The level of detail to draw every instance at
+ */
+void GEM::Renderer::Mesh::drawInstanced(
+    const uint32_t instanceBufferObjectID,
+    const uint32_t firstInstance,
+    const uint32_t instanceCount,
+    const uint32_t lodIndex
+) const {
+    GEM::Renderer::StateCache::bindBuffer(GL_ARRAY_BUFFER, instanceBufferObjectID);
+    GEM::Renderer::Mesh::configureInstanceAttributePointers(firstInstance);
+
+    // Each level of detail is a range of the EBO, so offset to where its indices start
+    const GEM::Renderer::MeshLod& lod = m_info.lods[lodIndex];
+    const size_t indexSizeBytes = m_info.indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+    glDrawElementsInstanced(GL_TRIANGLES, lod.indexCount, m_info.indexType, (void*)(lod.firstIndex * indexSizeBytes), instanceCount);
 }
 
 /* ------------------------------ private member functions ------------------------------ */
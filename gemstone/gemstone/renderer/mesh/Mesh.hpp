@@ -1,36 +1,121 @@
 #pragma once
 
+#include <map>
 #include <string>
 #include <vector>
 
+#include <glad/glad.h>
+
 #include <glm/glm.hpp>
 
+#include "gemstone/renderer/mesh/CookedMesh.hpp"
+#include "gemstone/renderer/mesh/IndexedGeometry.hpp"
+#include "gemstone/renderer/mesh/MeshInstance.hpp"
+#include "gemstone/renderer/mesh/MeshLod.hpp"
+
 namespace GEM {
 namespace Renderer{
     class Mesh;
 }
 }
 
+/**
+ * @brief A class representing a mesh loaded onto the gpu. Meshes loaded from the same file share
+ * a single VAO, VBO, and EBO. When the use count for a file hits 0 the buffers are deleted and the
+ * mesh is removed from the meshIDMap
+ * 
+ * Every mesh has a chain of levels of detail sharing its vertices, each drawing its own range of the
+ * EBO. Level 0 is full detail, and selectLod picks the coarsest level whose error stays invisible
+ */
 class GEM::Renderer::Mesh {
 public: // public static variables
     const static std::string LOGGER_NAME;
 
+    static const float LOD_MAX_PIXEL_ERROR;
+
+    // The per instance attributes take up every location from the model matrix's first column to the texture layers
+    static const uint32_t INSTANCE_MODEL_MATRIX_LOCATION;
+    static const uint32_t INSTANCE_TEXTURE_LAYERS_LOCATION;
+
+public: // public static functions
+    static GLenum getIndexType(const uint32_t vertexCount);
+    static std::vector<GEM::Renderer::MeshLod> optimizeGeometry(GEM::Renderer::IndexedGeometry& geometry);
+    static GEM::Renderer::IndexedGeometry loadGeometry(const std::string& filename);
+
 public: // public member functions
-    Mesh();
+    Mesh(const std::string& filename);
     ~Mesh();
 
+    Mesh(const Mesh& other) = delete;
+    void operator=(const Mesh& other) = delete;
+
+    size_t getSourceHash() const { return m_sourceHash; }
+    uint32_t getVertexArrayObjectID() const { return m_info.vertexArrayObjectID; }
+    uint32_t getVertexCount() const { return m_info.vertexCount; }
+    uint32_t getIndexCount() const { return m_info.indexCount; }
+    uint32_t getLodCount() const { return static_cast<uint32_t>(m_info.lods.size()); }
+    const GEM::Renderer::MeshLod& getLod(const uint32_t lodIndex) const { return m_info.lods[lodIndex]; }
+    glm::vec3 getBoundsMin() const { return m_info.boundsMin; }
+    glm::vec3 getBoundsMax() const { return m_info.boundsMax; }
+
+    uint32_t selectLod(
+        const glm::mat4& modelMatrix,
+        const glm::mat4& viewMatrix,
+        const glm::mat4& projectionMatrix,
+        const float viewportHeightPixels
+    ) const;
+
     void draw();
+    void bind() const;
+    void drawInstanced(
+        const uint32_t instanceBufferObjectID,
+        const uint32_t firstInstance,
+        const uint32_t instanceCount,
+        const uint32_t lodIndex
+    ) const;
+
+private: // private static enums and classes
+    struct Info {
+        uint32_t vertexArrayObjectID;
+        uint32_t vertexBufferObjectID;
+        uint32_t elementBufferObjectID;
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        GLenum indexType;
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+        std::vector<GEM::Renderer::MeshLod> lods;
+        uint32_t useCount;
+    };
 
 private: // private static functions
-    static std::vector<float> loadVertices();
+    static void addMeshToMap(const size_t meshSourceHash, const GEM::Renderer::Mesh::Info& info);
+    static void incrementMeshUseCount(const size_t meshSourceHash);
+    static void decrementMeshUseCount(const size_t meshSourceHash);
+    static bool meshIsLoaded(const size_t meshSourceHash);
+
+    static std::string getCanonicalFilename(const std::string& filename);
+    static size_t getHashFromFilename(const std::string& filename);
+    static GEM::Renderer::Mesh::Info getLoadedMeshInfo(const size_t meshSourceHash);
+    static GEM::Renderer::Mesh::Info loadMesh(const std::string& filename);
+
+    static GEM::Renderer::Mesh::Info uploadCookedMesh(const std::string& filename);
+    static GEM::Renderer::Mesh::Info uploadGeometry(const std::string& filename);
+
+    static std::vector<float> loadDefaultVertices();
+
     static uint32_t createVertexArrayObject();
-    static uint32_t createVertexBufferObject(const std::vector<float>& vertices);
-    static uint32_t createElementBufferObject(const std::vector<float>& vertices);
+    static uint32_t createVertexBufferObject(const void* p_vertexData, const size_t vertexDataSizeBytes);
+    static uint32_t createElementBufferObject(const void* p_indexData, const size_t indexDataSizeBytes);
     static void configureVertexAttributePointers();
+    static void configureCookedVertexAttributePointers(const GEM::Renderer::CookedMesh& cookedMesh);
+    static void configureInstanceAttributePointers(const uint32_t firstInstance);
+
+private: // private static variables
+    static std::map<size_t, GEM::Renderer::Mesh::Info> meshIDMap;
 
 private: // private member variables
-    const std::vector<float> m_vertices;
-    const uint32_t m_vertexArrayObjectID;
-    const uint32_t m_vertexBufferObjectID;
-    const uint32_t m_elementBufferObjectID;
+    const std::string m_filename;
+    const size_t m_sourceHash;
+    const GEM::Renderer::Mesh::Info m_info;
 };
\ No newline at end of file
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace GEM {
+namespace Renderer {
+    struct MeshInstance;
+}
+}
+
+/**
+ * @brief The per instance attributes of an instanced draw, laid out in the instance buffer one after another.
+ * The texture layers are the layers of the instance's two textures within their texture arrays, and are 0 for
+ * textures which aren't packed into one
+ *
+ * @note The attribute locations are set in Mesh::configureInstanceAttributePointers and must match
+ * vertex_instanced.vert
+ */
+struct GEM::Renderer::MeshInstance {
+    glm::mat4 modelMatrix;
+    glm::vec2 textureLayers;
+};
\ No newline at end of file
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+
+namespace GEM {
+namespace Renderer {
+    struct MeshLod;
+}
+}
+
+/**
+ * @brief One level of detail of a mesh. Every level shares the mesh's vertex buffer and draws its own range
+ * of the mesh's index buffer. The error is how far, in model space, the simplified surface strays from the
+ * full detail one
+ * 
+ * @note This is written directly into cooked mesh files, so its layout must not change without bumping the
+ * cooked mesh version
+ */
+struct GEM::Renderer::MeshLod {
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    float error;
+};
\ No newline at end of file
@@ -0,0 +1,324 @@
+#include <cmath>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "util/logger/Logger.hpp"
+
+#include "gemstone/renderer/mesh/logger.hpp"
+#include "gemstone/renderer/mesh/IndexedGeometry.hpp"
+#include "gemstone/renderer/mesh/MeshOptimizer.hpp"
+
+/* ------------------------------ public static variables ------------------------------ */
+
+/**
+ * @brief The name of the logger the MeshOptimizer class uses
+ */
+const std::string GEM::Renderer::MeshOptimizer::LOGGER_NAME = MESH_LOGGER_NAME;
+
+/**
+ * @brief The number of vertices we assume the gpu keeps around after transforming them. Most hardware
+ * has somewhere between 16 and 32 entries, and optimizing for 32 still does well on the smaller caches
+ */
+const uint32_t GEM::Renderer::MeshOptimizer::VERTEX_CACHE_SIZE = 32;
+
+/* ------------------------------ private static variables ------------------------------ */
+
+/* ------------------------------ public static functions ------------------------------ */
+
+/**
+ * @brief Turn a list of triangles, where every 3 vertices make a triangle, into unique vertices and indices
+ * into them. Vertices are considered the same if all of their components are bitwise equal
+ *
+ * @param triangleVertices The interleaved vertices, every 3 of which make up a triangle
+ * @param vertexComponentCount The number of floats making up each vertex
+ * @return GEM::Renderer::IndexedGeometry The unique vertices and the indices of each triangle
+ */
+GEM::Renderer::IndexedGeometry GEM::Renderer::MeshOptimizer::deduplicateVertices(const std::vector<float>& triangleVertices, const uint32_t vertexComponentCount) {
+    LOG_FUNCTION_CALL_TRACE("vertices size {} , vertex component count {}", triangleVertices.size(), vertexComponentCount);
+
+    const size_t vertexCount = triangleVertices.size() / vertexComponentCount;
+    const size_t vertexSizeBytes = vertexComponentCount * sizeof(float);
+
+    GEM::Renderer::IndexedGeometry geometry;
+    geometry.vertexComponentCount = vertexComponentCount;
+    geometry.indices.reserve(vertexCount);
+
+    // Key each vertex by its raw bytes. The views point into triangleVertices, which outlives the map
+    std::unordered_map<std::string_view, uint32_t> uniqueVertexIndices;
+    uniqueVertexIndices.reserve(vertexCount);
+
+    for (size_t i = 0; i < vertexCount; ++i) {
+        const float* p_vertex = triangleVertices.data() + (i * vertexComponentCount);
+        const std::string_view vertexBytes(reinterpret_cast<const char*>(p_vertex), vertexSizeBytes);
+
+        const uint32_t nextIndex = static_cast<uint32_t>(uniqueVertexIndices.size());
+        const auto [it, inserted] = uniqueVertexIndices.insert({vertexBytes, nextIndex});
+        if (inserted) {
+            geometry.vertices.insert(geometry.vertices.end(), p_vertex, p_vertex + vertexComponentCount);
+        }
+
+        geometry.indices.push_back(it->second);
+    }
+
+    LOG_DEBUG("Deduplicated {} vertices down to {}", vertexCount, geometry.getVertexCount());
+
+    return geometry;
+}
+
+/**
+ * @brief Reorder the triangles so that consecutive triangles reuse the vertices still sitting in the post
+ * transform vertex cache. This is Tom Forsyth's linear speed vertex cache optimization: every vertex is
+ * scored by its position in a simulated cache and how many triangles still need it, and we greedily emit
+ * the triangle with the highest total score
+ *
+ * @link https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html
+ *
+ * @param geometry The geometry whose indices will be reordered in place
+ */
+void GEM::Renderer::MeshOptimizer::optimizeVertexCache(GEM::Renderer::IndexedGeometry& geometry) {
+    LOG_FUNCTION_CALL_TRACE("vertex count {} , index count {}", geometry.getVertexCount(), geometry.getIndexCount());
+
+    const uint32_t vertexCount = geometry.getVertexCount();
+    const uint32_t triangleCount = geometry.getIndexCount() / 3;
+    const uint32_t invalidTriangle = std::numeric_limits<uint32_t>::max();
+
+    if (triangleCount == 0) {
+        return;
+    }
+
+    const float cacheMissRatioBefore = GEM::Renderer::MeshOptimizer::getAverageCacheMissRatio(geometry);
+
+    // Build the list of triangles using each vertex. The first activeTriangleCounts[v] entries of each
+    // vertex's range are the triangles which have not been emitted yet
+    std::vector<uint32_t> activeTriangleCounts(vertexCount, 0);
+    for (const uint32_t index : geometry.indices) {
+        activeTriangleCounts[index] += 1;
+    }
+
+    std::vector<uint32_t> vertexTriangleOffsets(vertexCount + 1, 0);
+    for (uint32_t v = 0; v < vertexCount; ++v) {
+        vertexTriangleOffsets[v + 1] = vertexTriangleOffsets[v] + activeTriangleCounts[v];
+    }
+
+    std::vector<uint32_t> vertexTriangles(geometry.indices.size());
+    {
+        std::vector<uint32_t> fillCounts(vertexCount, 0);
+        for (uint32_t t = 0; t < triangleCount; ++t) {
+            for (uint32_t corner = 0; corner < 3; ++corner) {
+                const uint32_t v = geometry.indices[(t * 3) + corner];
+                vertexTriangles[vertexTriangleOffsets[v] + fillCounts[v]] = t;
+                fillCounts[v] += 1;
+            }
+        }
+    }
+
+    // Score every vertex and every triangle before anything is in the cache
+    std::vector<int32_t> cachePositions(vertexCount, -1);
+    std::vector<float> vertexScores(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; ++v) {
+        vertexScores[v] = GEM::Renderer::MeshOptimizer::computeVertexScore(-1, activeTriangleCounts[v]);
+    }
+
+    std::vector<float> triangleScores(triangleCount);
+    std::vector<bool> triangleEmitted(triangleCount, false);
+    uint32_t bestTriangle = 0;
+    for (uint32_t t = 0; t < triangleCount; ++t) {
+        triangleScores[t] =
+            vertexScores[geometry.indices[(t * 3) + 0]] +
+            vertexScores[geometry.indices[(t * 3) + 1]] +
+            vertexScores[geometry.indices[(t * 3) + 2]];
+
+        if (triangleScores[t] > triangleScores[bestTriangle]) {
+            bestTriangle = t;
+        }
+    }
+
+    std::vector<uint32_t> cache;
+    std::vector<uint32_t> updatedCache;
+    cache.reserve(GEM::Renderer::MeshOptimizer::VERTEX_CACHE_SIZE + 3);
+    updatedCache.reserve(GEM::Renderer::MeshOptimizer::VERTEX_CACHE_SIZE + 3);
+
+    std::vector<uint32_t> optimizedIndices;
+    optimizedIndices.reserve(geometry.indices.size());
+
+    uint32_t fallbackSearchStart = 0;
+    while (optimizedIndices.size() < geometry.indices.size()) {
+        // If no triangle touching the cache is left then start over at the best remaining triangle
+        if (bestTriangle == invalidTriangle) {
+            float bestScore = -1.0f;
+            for (uint32_t t = fallbackSearchStart; t < triangleCount; ++t) {
+                if (triangleEmitted[t]) {
+                    if (t == fallbackSearchStart) {
+                        fallbackSearchStart += 1;
+                    }
+                    continue;
+                }
+
+                if (triangleScores[t] > bestScore) {
+                    bestScore = triangleScores[t];
+                    bestTriangle = t;
+                }
+            }
+        }
+
+        // Emit the triangle and take it out of each of its vertices' lists of active triangles
+        triangleEmitted[bestTriangle] = true;
+        const uint32_t* p_triangle = geometry.indices.data() + (bestTriangle * 3);
+        for (uint32_t corner = 0; corner < 3; ++corner) {
+            const uint32_t v = p_triangle[corner];
+            optimizedIndices.push_back(v);
+
+            uint32_t* p_activeTriangles = vertexTriangles.data() + vertexTriangleOffsets[v];
+            const uint32_t lastActive = activeTriangleCounts[v] - 1;
+            for (uint32_t i = 0; i <= lastActive; ++i) {
+                if (p_activeTriangles[i] == bestTriangle) {
+                    std::swap(p_activeTriangles[i], p_activeTriangles[lastActive]);
+                    break;
+                }
+            }
+            activeTriangleCounts[v] -= 1;
+        }
+
+        // The emitted triangle's vertices move to the front of the cache and everything else is pushed back
+        updatedCache.assign(p_triangle, p_triangle + 3);
+        for (const uint32_t v : cache) {
+            if (v != p_triangle[0] && v != p_triangle[1] && v != p_triangle[2]) {
+                updatedCache.push_back(v);
+            }
+        }
+        std::swap(cache, updatedCache);
+
+        // Rescore every vertex that is in the cache or was just evicted from it
+        for (uint32_t i = 0; i < cache.size(); ++i) {
+            const uint32_t v = cache[i];
+            cachePositions[v] = i < GEM::Renderer::MeshOptimizer::VERTEX_CACHE_SIZE ? static_cast<int32_t>(i) : -1;
+            vertexScores[v] = GEM::Renderer::MeshOptimizer::computeVertexScore(cachePositions[v], activeTriangleCounts[v]);
+        }
+
+        // Rescore the triangles using those vertices and pick the best one to emit next
+        bestTriangle = invalidTriangle;
+        float bestScore = -1.0f;
+        for (const uint32_t v : cache) {
+            const uint32_t* p_activeTriangles = vertexTriangles.data() + vertexTriangleOffsets[v];
+            for (uint32_t i = 0; i < activeTriangleCounts[v]; ++i) {
+                const uint32_t t = p_activeTriangles[i];
+                triangleScores[t] =
+                    vertexScores[geometry.indices[(t * 3) + 0]] +
+                    vertexScores[geometry.indices[(t * 3) + 1]] +
+                    vertexScores[geometry.indices[(t * 3) + 2]];
+
+                if (triangleScores[t] > bestScore) {
+                    bestScore = triangleScores[t];
+                    bestTriangle = t;
+                }
+            }
+        }
+
+        if (cache.size() > GEM::Renderer::MeshOptimizer::VERTEX_CACHE_SIZE) {
+            cache.resize(GEM::Renderer::MeshOptimizer::VERTEX_CACHE_SIZE);
+        }
+    }
+
+    geometry.indices = std::move(optimizedIndices);
+
+    LOG_DEBUG(
+        "Average cache miss ratio went from {} to {}",
+        cacheMissRatioBefore,
+        GEM::Renderer::MeshOptimizer::getAverageCacheMissRatio(geometry)
+    );
+}
+
+/**
+ * @brief Reorder the vertices into the order the indices first reference them so the gpu reads the vertex
+ * buffer front to back. Vertices which no triangle references are dropped
+ *
+ * @param geometry The geometry whose vertices will be reordered and whose indices will be remapped in place
+ */
+void GEM::Renderer::MeshOptimizer::optimizeVertexFetch(GEM::Renderer::IndexedGeometry& geometry) {
+    LOG_FUNCTION_CALL_TRACE("vertex count {} , index count {}", geometry.getVertexCount(), geometry.getIndexCount());
+
+    const uint32_t unmapped = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> remappedIndices(geometry.getVertexCount(), unmapped);
+
+    std::vector<float> reorderedVertices;
+    reorderedVertices.reserve(geometry.vertices.size());
+
+    uint32_t nextIndex = 0;
+    for (uint32_t& index : geometry.indices) {
+        if (remappedIndices[index] == unmapped) {
+            remappedIndices[index] = nextIndex++;
+
+            const float* p_vertex = geometry.vertices.data() + (index * geometry.vertexComponentCount);
+            reorderedVertices.insert(reorderedVertices.end(), p_vertex, p_vertex + geometry.vertexComponentCount);
+        }
+
+        index = remappedIndices[index];
+    }
+
+    geometry.vertices = std::move(reorderedVertices);
+}
+
+/**
+ * @brief Simulate a fifo post transform vertex cache to get the average number of vertices transformed per
+ * triangle. 3 is the worst possible, and 0.5 is about the best possible for a regular grid
+ *
+ * @param geometry The geometry to simulate drawing
+ * @return float The number of cache misses per triangle
+ */
+float GEM::Renderer::MeshOptimizer::getAverageCacheMissRatio(const GEM::Renderer::IndexedGeometry& geometry) {
+    const uint32_t triangleCount = geometry.getIndexCount() / 3;
+    if (triangleCount == 0) {
+        return 0.0f;
+    }
+
+    // The timestamp at which each vertex was last put into the cache
+    std::vector<uint32_t> cacheTimestamps(geometry.getVertexCount(), 0);
+    uint32_t timestamp = GEM::Renderer::MeshOptimizer::VERTEX_CACHE_SIZE + 1;
+    uint32_t cacheMissCount = 0;
+
+    for (const uint32_t index : geometry.indices) {
+        if (timestamp - cacheTimestamps[index] > GEM::Renderer::MeshOptimizer::VERTEX_CACHE_SIZE) {
+            cacheTimestamps[index] = timestamp++;
+            cacheMissCount += 1;
+        }
+    }
+
+    return static_cast<float>(cacheMissCount) / static_cast<float>(triangleCount);
+}
+
+/* ------------------------------ private static functions ------------------------------ */
+
+/**
+ * @brief Score a vertex by how soon it will fall out of the cache and how many triangles still need it. Vertices
+ * used by few remaining triangles get a boost so we finish off small pieces of the mesh instead of leaving them
+ * stranded until the end
+ *
+ * @param cachePosition The position of the vertex in the simulated cache, -1 if it isn't in the cache
+ * @param activeTriangleCount The number of triangles using this vertex which have not been emitted yet
+ * @return float The score of the vertex, -1 if no triangles need it anymore
+ */
+float GEM::Renderer::MeshOptimizer::computeVertexScore(const int32_t cachePosition, const uint32_t activeTriangleCount) {
+    if (activeTriangleCount == 0) {
+        return -1.0f;
+    }
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            // The vertices of the last triangle get a fixed score so we don't just emit the same triangle's
+            // neighbor in a strip-like fashion every time
+            score = 0.75f;
+        } else {
+            const float scaler = 1.0f / static_cast<float>(GEM::Renderer::MeshOptimizer::VERTEX_CACHE_SIZE - 3);
+            score = std::pow(1.0f - (static_cast<float>(cachePosition - 3) * scaler), 1.5f);
+        }
+    }
+
+    score += 2.0f * std::pow(static_cast<float>(activeTriangleCount), -0.5f);
+
+    return score;
+}
\ No newline at end of file
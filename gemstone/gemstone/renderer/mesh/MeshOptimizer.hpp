@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "gemstone/renderer/mesh/IndexedGeometry.hpp"
+
+namespace GEM {
+namespace Renderer {
+    class MeshOptimizer;
+}
+}
+
+/**
+ * @brief A collection of load time passes turning raw triangle lists into indexed geometry that is
+ * cheap for the gpu to draw. Vertices are deduplicated, triangles are reordered to make the most of the
+ * post transform vertex cache, then vertices are reordered so they are fetched in memory order
+ */
+class GEM::Renderer::MeshOptimizer {
+public: // public static variables
+    static const std::string LOGGER_NAME;
+
+    // The size of the post transform vertex cache we are optimizing for
+    static const uint32_t VERTEX_CACHE_SIZE;
+
+public: // public static functions
+    static GEM::Renderer::IndexedGeometry deduplicateVertices(const std::vector<float>& triangleVertices, const uint32_t vertexComponentCount);
+    static void optimizeVertexCache(GEM::Renderer::IndexedGeometry& geometry);
+    static void optimizeVertexFetch(GEM::Renderer::IndexedGeometry& geometry);
+
+    static float getAverageCacheMissRatio(const GEM::Renderer::IndexedGeometry& geometry);
+
+public: // public member functions
+    MeshOptimizer() = delete;
+
+private: // private static functions
+    static float computeVertexScore(const int32_t cachePosition, const uint32_t activeTriangleCount);
+};
\ No newline at end of file
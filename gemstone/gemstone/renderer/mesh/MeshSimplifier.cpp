@@ -0,0 +1,431 @@
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "util/logger/Logger.hpp"
+
+#include "gemstone/renderer/mesh/logger.hpp"
+#include "gemstone/renderer/mesh/IndexedGeometry.hpp"
+#include "gemstone/renderer/mesh/MeshLod.hpp"
+#include "gemstone/renderer/mesh/MeshOptimizer.hpp"
+#include "gemstone/renderer/mesh/MeshSimplifier.hpp"
+
+/* ------------------------------ public static variables ------------------------------ */
+
+/**
+ * @brief The name of the logger the MeshSimplifier class uses
+ */
+const std::string GEM::Renderer::MeshSimplifier::LOGGER_NAME = MESH_LOGGER_NAME;
+
+/**
+ * @brief The most levels of detail a mesh can have, including the full detail one
+ */
+const uint32_t GEM::Renderer::MeshSimplifier::MAX_LOD_COUNT = 5;
+
+/**
+ * @brief The fraction of the previous level's triangles each level of detail aims to keep
+ */
+const float GEM::Renderer::MeshSimplifier::LOD_REDUCTION_RATIO = 0.5f;
+
+/**
+ * @brief Meshes are not simplified below this many triangles, there is nothing left to gain
+ */
+const uint32_t GEM::Renderer::MeshSimplifier::MIN_LOD_TRIANGLE_COUNT = 32;
+
+/* ------------------------------ private static variables ------------------------------ */
+
+/* ------------------------------ public static functions ------------------------------ */
+
+/**
+ * @brief Generate the chain of levels of detail for the geometry. The indices of every level are optimized
+ * for the vertex cache and appended to the geometry's indices, after the full detail ones. Generation stops
+ * once a level would not remove enough triangles to be worth drawing instead of the previous one
+ *
+ * @note The geometry's indices should already be optimized for the vertex cache, they become the first level
+ *
+ * @param geometry The geometry to generate levels of detail for, whose indices will be appended to
+ * @return std::vector<GEM::Renderer::MeshLod> The range of indices and error of each level, starting with full detail
+ */
+std::vector<GEM::Renderer::MeshLod> GEM::Renderer::MeshSimplifier::generateLodChain(GEM::Renderer::IndexedGeometry& geometry) {
+    LOG_FUNCTION_CALL_TRACE("vertex count {} , index count {}", geometry.getVertexCount(), geometry.getIndexCount());
+
+    std::vector<GEM::Renderer::MeshLod> lods = {{0, geometry.getIndexCount(), 0.0f}};
+
+    // Every level is simplified from the full detail indices so its error is measured against the real surface
+    const std::vector<uint32_t> fullDetailIndices = geometry.indices;
+
+    // The lod is cache optimized on its own geometry, borrowing the vertices so they don't need copying
+    GEM::Renderer::IndexedGeometry lodGeometry;
+    lodGeometry.vertexComponentCount = geometry.vertexComponentCount;
+
+    while (lods.size() < GEM::Renderer::MeshSimplifier::MAX_LOD_COUNT) {
+        const uint32_t previousIndexCount = lods.back().indexCount;
+        const uint32_t targetIndexCount = static_cast<uint32_t>(previousIndexCount * GEM::Renderer::MeshSimplifier::LOD_REDUCTION_RATIO) / 3 * 3;
+        if (targetIndexCount < GEM::Renderer::MeshSimplifier::MIN_LOD_TRIANGLE_COUNT * 3) {
+            break;
+        }
+
+        float error = 0.0f;
+        lodGeometry.vertices = std::move(geometry.vertices);
+        lodGeometry.indices = GEM::Renderer::MeshSimplifier::simplify(lodGeometry, fullDetailIndices, targetIndexCount, error);
+
+        // Give up once simplification stalls, most likely because the rest of the mesh is borders and seams
+        const bool worthKeeping = lodGeometry.getIndexCount() < previousIndexCount * 0.85f;
+        if (worthKeeping) {
+            GEM::Renderer::MeshOptimizer::optimizeVertexCache(lodGeometry);
+        }
+
+        geometry.vertices = std::move(lodGeometry.vertices);
+        if (!worthKeeping) {
+            break;
+        }
+
+        lods.push_back({geometry.getIndexCount(), lodGeometry.getIndexCount(), error});
+        geometry.indices.insert(geometry.indices.end(), lodGeometry.indices.begin(), lodGeometry.indices.end());
+
+        LOG_DEBUG("Generated lod {} with {} triangles and error {}", lods.size() - 1, lods.back().indexCount / 3, error);
+    }
+
+    return lods;
+}
+
+/**
+ * @brief Simplify a set of triangles down to roughly the target number of indices by repeatedly collapsing
+ * the edges which move the surface the least. Each pass collapses a batch of independent edges, cheapest
+ * first, then removes the triangles that became degenerate
+ *
+ * @param geometry The geometry holding the vertices the triangles index into. Positions are the first 3 components
+ * @param indices The triangles to simplify
+ * @param targetIndexCount The number of indices to stop at, fewer may not be reachable
+ * @param error Set to the largest distance the surface moved by, in model space
+ * @return std::vector<uint32_t> The indices of the simplified triangles, still indexing into the same vertices
+ */
+std::vector<uint32_t> GEM::Renderer::MeshSimplifier::simplify(
+    const GEM::Renderer::IndexedGeometry& geometry,
+    const std::vector<uint32_t>& indices,
+    const uint32_t targetIndexCount,
+    float& error
+) {
+    LOG_FUNCTION_CALL_TRACE("index count {} , target index count {}", indices.size(), targetIndexCount);
+
+    const uint32_t vertexCount = geometry.getVertexCount();
+    std::vector<uint32_t> simplifiedIndices = indices;
+    double maxCost = 0.0;
+
+    // Every vertex starts out with the planes of the triangles around it
+    std::vector<GEM::Renderer::MeshSimplifier::Quadric> quadrics(vertexCount, GEM::Renderer::MeshSimplifier::Quadric{});
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        const glm::dvec3 p0 = GEM::Renderer::MeshSimplifier::getPosition(geometry, indices[i + 0]);
+        const glm::dvec3 p1 = GEM::Renderer::MeshSimplifier::getPosition(geometry, indices[i + 1]);
+        const glm::dvec3 p2 = GEM::Renderer::MeshSimplifier::getPosition(geometry, indices[i + 2]);
+
+        const glm::dvec3 normal = glm::cross(p1 - p0, p2 - p0);
+        const double normalLength = glm::length(normal);
+        if (normalLength == 0.0) {
+            continue;
+        }
+
+        const glm::dvec3 unitNormal = normal / normalLength;
+        for (uint32_t corner = 0; corner < 3; ++corner) {
+            quadrics[indices[i + corner]].addPlane(unitNormal, -glm::dot(unitNormal, p0));
+        }
+    }
+
+    const std::vector<bool> lockedVertices = GEM::Renderer::MeshSimplifier::findLockedVertices(indices, vertexCount);
+
+    std::vector<GEM::Renderer::MeshSimplifier::Collapse> collapses;
+    std::vector<uint32_t> vertexTriangleOffsets(vertexCount + 1);
+    std::vector<uint32_t> vertexTriangles;
+    std::vector<uint32_t> remap(vertexCount);
+    std::vector<bool> touchedVertices(vertexCount);
+
+    while (simplifiedIndices.size() > targetIndexCount) {
+        // Find the cheapest direction to collapse every edge in, keeping the position of the vertex collapsed onto
+        collapses.clear();
+        for (size_t i = 0; i + 2 < simplifiedIndices.size(); i += 3) {
+            for (uint32_t corner = 0; corner < 3; ++corner) {
+                const uint32_t a = simplifiedIndices[i + corner];
+                const uint32_t b = simplifiedIndices[i + ((corner + 1) % 3)];
+
+                // Each interior edge is shared by two triangles, only consider it from one of them
+                if (a > b) {
+                    continue;
+                }
+
+                GEM::Renderer::MeshSimplifier::Quadric quadric = quadrics[a];
+                quadric.add(quadrics[b]);
+
+                const double costAToB = lockedVertices[a] ? -1.0 : quadric.evaluate(GEM::Renderer::MeshSimplifier::getPosition(geometry, b));
+                const double costBToA = lockedVertices[b] ? -1.0 : quadric.evaluate(GEM::Renderer::MeshSimplifier::getPosition(geometry, a));
+
+                if (costAToB >= 0.0 && (costBToA < 0.0 || costAToB <= costBToA)) {
+                    collapses.push_back({a, b, costAToB});
+                } else if (costBToA >= 0.0) {
+                    collapses.push_back({b, a, costBToA});
+                }
+            }
+        }
+
+        if (collapses.empty()) {
+            break;
+        }
+
+        std::sort(collapses.begin(), collapses.end(), [](const GEM::Renderer::MeshSimplifier::Collapse& lhs, const GEM::Renderer::MeshSimplifier::Collapse& rhs) {
+            return lhs.cost < rhs.cost;
+        });
+
+        // Build the list of triangles around each vertex so collapses can be checked for flipped triangles
+        std::fill(vertexTriangleOffsets.begin(), vertexTriangleOffsets.end(), 0);
+        for (const uint32_t index : simplifiedIndices) {
+            vertexTriangleOffsets[index + 1] += 1;
+        }
+        for (uint32_t v = 0; v < vertexCount; ++v) {
+            vertexTriangleOffsets[v + 1] += vertexTriangleOffsets[v];
+        }
+        vertexTriangles.resize(simplifiedIndices.size());
+        {
+            std::vector<uint32_t> fillCounts(vertexCount, 0);
+            for (size_t i = 0; i < simplifiedIndices.size(); ++i) {
+                const uint32_t v = simplifiedIndices[i];
+                vertexTriangles[vertexTriangleOffsets[v] + fillCounts[v]] = static_cast<uint32_t>(i / 3);
+                fillCounts[v] += 1;
+            }
+        }
+
+        // Apply as many collapses as we need, cheapest first. A vertex takes part in at most one collapse per
+        // pass so every collapse sees the positions it was costed with
+        for (uint32_t v = 0; v < vertexCount; ++v) {
+            remap[v] = v;
+        }
+        std::fill(touchedVertices.begin(), touchedVertices.end(), false);
+
+        const size_t trianglesToRemove = (simplifiedIndices.size() - targetIndexCount) / 3;
+        size_t removedTriangleCount = 0;
+        uint32_t collapseCount = 0;
+        for (const GEM::Renderer::MeshSimplifier::Collapse& collapse : collapses) {
+            if (removedTriangleCount >= trianglesToRemove) {
+                break;
+            }
+
+            if (touchedVertices[collapse.from] || touchedVertices[collapse.to]) {
+                continue;
+            }
+
+            if (GEM::Renderer::MeshSimplifier::collapseFlipsTriangle(geometry, simplifiedIndices, vertexTriangleOffsets, vertexTriangles, remap, collapse)) {
+                continue;
+            }
+
+            remap[collapse.from] = collapse.to;
+            touchedVertices[collapse.from] = true;
+            touchedVertices[collapse.to] = true;
+            quadrics[collapse.to].add(quadrics[collapse.from]);
+            maxCost = std::max(maxCost, collapse.cost);
+            collapseCount += 1;
+
+            // The triangles sharing the collapsed edge are the ones that disappear
+            for (uint32_t i = vertexTriangleOffsets[collapse.from]; i < vertexTriangleOffsets[collapse.from + 1]; ++i) {
+                const uint32_t* p_triangle = simplifiedIndices.data() + (vertexTriangles[i] * 3);
+                if (p_triangle[0] == collapse.to || p_triangle[1] == collapse.to || p_triangle[2] == collapse.to) {
+                    removedTriangleCount += 1;
+                }
+            }
+        }
+
+        if (collapseCount == 0) {
+            break;
+        }
+
+        // Point the triangles at the vertices they were collapsed onto and drop the ones that became degenerate
+        size_t writeOffset = 0;
+        for (size_t i = 0; i + 2 < simplifiedIndices.size(); i += 3) {
+            const uint32_t a = remap[simplifiedIndices[i + 0]];
+            const uint32_t b = remap[simplifiedIndices[i + 1]];
+            const uint32_t c = remap[simplifiedIndices[i + 2]];
+            if (a == b || b == c || c == a) {
+                continue;
+            }
+
+            simplifiedIndices[writeOffset + 0] = a;
+            simplifiedIndices[writeOffset + 1] = b;
+            simplifiedIndices[writeOffset + 2] = c;
+            writeOffset += 3;
+        }
+        simplifiedIndices.resize(writeOffset);
+    }
+
+    // The quadric error is a sum of squared distances, so its root is a conservative distance estimate
+    error = static_cast<float>(std::sqrt(maxCost));
+
+    return simplifiedIndices;
+}
+
+/* ------------------------------ private static functions ------------------------------ */
+
+/**
+ * @brief Get the position of a vertex, which makes up the first 3 components of every vertex
+ *
+ * @param geometry The geometry holding the vertex
+ * @param vertex The index of the vertex
+ * @return glm::dvec3 The position of the vertex
+ */
+glm::dvec3 GEM::Renderer::MeshSimplifier::getPosition(const GEM::Renderer::IndexedGeometry& geometry, const uint32_t vertex) {
+    const float* p_vertex = geometry.vertices.data() + (static_cast<size_t>(vertex) * geometry.vertexComponentCount);
+    return glm::dvec3(p_vertex[0], p_vertex[1], p_vertex[2]);
+}
+
+/**
+ * @brief Find the vertices which must never be collapsed. Any vertex on an edge not shared by exactly two
+ * triangles is on a border, and vertices with the same position but different attributes are split apart
+ * in the index buffer, so attribute seams show up as borders too
+ *
+ * @param indices The triangles making up the mesh
+ * @param vertexCount The number of vertices the triangles index into
+ * @return std::vector<bool> Whether each vertex is locked in place
+ */
+std::vector<bool> GEM::Renderer::MeshSimplifier::findLockedVertices(const std::vector<uint32_t>& indices, const uint32_t vertexCount) {
+    LOG_FUNCTION_ENTRY_TRACE("index count {} , vertex count {}", indices.size(), vertexCount);
+
+    // Count the triangles using each undirected edge, keyed by both of its vertices
+    std::unordered_map<uint64_t, uint32_t> edgeTriangleCounts;
+    edgeTriangleCounts.reserve(indices.size());
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        for (uint32_t corner = 0; corner < 3; ++corner) {
+            const uint32_t a = indices[i + corner];
+            const uint32_t b = indices[i + ((corner + 1) % 3)];
+            const uint64_t key = (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+            edgeTriangleCounts[key] += 1;
+        }
+    }
+
+    std::vector<bool> lockedVertices(vertexCount, false);
+    for (const auto& [key, triangleCount] : edgeTriangleCounts) {
+        if (triangleCount != 2) {
+            lockedVertices[static_cast<uint32_t>(key >> 32)] = true;
+            lockedVertices[static_cast<uint32_t>(key & 0xFFFFFFFF)] = true;
+        }
+    }
+
+    return lockedVertices;
+}
+
+/**
+ * @brief Determine if moving a vertex onto another would turn any of the triangles around it inside out
+ *
+ * @param geometry The geometry holding the vertices
+ * @param indices The triangles as they were at the start of this pass
+ * @param vertexTriangleOffsets Where each vertex's range in vertexTriangles starts
+ * @param vertexTriangles The triangles around each vertex
+ * @param remap The collapses already made this pass
+ * @param collapse The collapse to check
+ * @return true At least one triangle would flip or become a sliver
+ * @return false The collapse is safe to make
+ */
+bool GEM::Renderer::MeshSimplifier::collapseFlipsTriangle(
+    const GEM::Renderer::IndexedGeometry& geometry,
+    const std::vector<uint32_t>& indices,
+    const std::vector<uint32_t>& vertexTriangleOffsets,
+    const std::vector<uint32_t>& vertexTriangles,
+    const std::vector<uint32_t>& remap,
+    const GEM::Renderer::MeshSimplifier::Collapse& collapse
+) {
+    const glm::dvec3 newPosition = GEM::Renderer::MeshSimplifier::getPosition(geometry, collapse.to);
+
+    for (uint32_t i = vertexTriangleOffsets[collapse.from]; i < vertexTriangleOffsets[collapse.from + 1]; ++i) {
+        const uint32_t* p_triangle = indices.data() + (vertexTriangles[i] * 3);
+
+        // The triangles on the collapsed edge disappear, so they can't flip
+        const uint32_t a = remap[p_triangle[0]];
+        const uint32_t b = remap[p_triangle[1]];
+        const uint32_t c = remap[p_triangle[2]];
+        if (a == collapse.to || b == collapse.to || c == collapse.to || a == b || b == c || c == a) {
+            continue;
+        }
+
+        const glm::dvec3 positions[3] = {
+            GEM::Renderer::MeshSimplifier::getPosition(geometry, a),
+            GEM::Renderer::MeshSimplifier::getPosition(geometry, b),
+            GEM::Renderer::MeshSimplifier::getPosition(geometry, c)
+        };
+        glm::dvec3 movedPositions[3] = {positions[0], positions[1], positions[2]};
+        for (uint32_t corner = 0; corner < 3; ++corner) {
+            if (p_triangle[corner] == collapse.from) {
+                movedPositions[corner] = newPosition;
+            }
+        }
+
+        const glm::dvec3 normalBefore = glm::cross(positions[1] - positions[0], positions[2] - positions[0]);
+        const glm::dvec3 normalAfter = glm::cross(movedPositions[1] - movedPositions[0], movedPositions[2] - movedPositions[0]);
+
+        // Reject the collapse if the triangle turns over or becomes close to degenerate
+        const double lengthsProduct = glm::length(normalBefore) * glm::length(normalAfter);
+        if (lengthsProduct == 0.0 || glm::dot(normalBefore, normalAfter) < 0.25 * lengthsProduct) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* ------------------------------ private member functions ------------------------------ */
+
+/**
+ * @brief Add the squared distance to a plane to the quadric
+ *
+ * @param normal The unit normal of the plane
+ * @param distance The plane's offset, such that dot(normal, p) + distance is 0 on the plane
+ */
+void GEM::Renderer::MeshSimplifier::Quadric::addPlane(const glm::dvec3& normal, const double distance) {
+    a2 += normal.x * normal.x;
+    ab += normal.x * normal.y;
+    ac += normal.x * normal.z;
+    ad += normal.x * distance;
+    b2 += normal.y * normal.y;
+    bc += normal.y * normal.z;
+    bd += normal.y * distance;
+    c2 += normal.z * normal.z;
+    cd += normal.z * distance;
+    d2 += distance * distance;
+}
+
+/**
+ * @brief Add another quadric to this one, so this one measures the distance to both sets of planes
+ *
+ * @param other The quadric to add
+ */
+void GEM::Renderer::MeshSimplifier::Quadric::add(const GEM::Renderer::MeshSimplifier::Quadric& other) {
+    a2 += other.a2;
+    ab += other.ab;
+    ac += other.ac;
+    ad += other.ad;
+    b2 += other.b2;
+    bc += other.bc;
+    bd += other.bd;
+    c2 += other.c2;
+    cd += other.cd;
+    d2 += other.d2;
+}
+
+/**
+ * @brief Evaluate the sum of the squared distances from the point to each of the quadric's planes
+ *
+ * @param point The point to measure from
+ * @return double The sum of the squared distances, never negative
+ */
+double GEM::Renderer::MeshSimplifier::Quadric::evaluate(const glm::dvec3& point) const {
+    const double x = point.x;
+    const double y = point.y;
+    const double z = point.z;
+
+    const double result =
+        (a2 * x * x) + (2.0 * ab * x * y) + (2.0 * ac * x * z) + (2.0 * ad * x) +
+        (b2 * y * y) + (2.0 * bc * y * z) + (2.0 * bd * y) +
+        (c2 * z * z) + (2.0 * cd * z) +
+        d2;
+
+    return std::max(result, 0.0);
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "gemstone/renderer/mesh/IndexedGeometry.hpp"
+#include "gemstone/renderer/mesh/MeshLod.hpp"
+
+namespace GEM {
+namespace Renderer {
+    class MeshSimplifier;
+}
+}
+
+/**
+ * @brief Generates lower levels of detail for a mesh by collapsing edges, choosing the collapses that
+ * move the surface the least according to each vertex's error quadric (Garland and Heckbert). Only the
+ * indices are simplified, so every level of detail can keep sharing the original vertices
+ * 
+ * @note Vertices on borders and attribute seams are never collapsed, so the outline of the mesh and
+ * its texture mapping are preserved
+ */
+class GEM::Renderer::MeshSimplifier {
+public: // public static variables
+    static const std::string LOGGER_NAME;
+
+    static const uint32_t MAX_LOD_COUNT;
+    static const float LOD_REDUCTION_RATIO;
+    static const uint32_t MIN_LOD_TRIANGLE_COUNT;
+
+public: // public static functions
+    static std::vector<GEM::Renderer::MeshLod> generateLodChain(GEM::Renderer::IndexedGeometry& geometry);
+    static std::vector<uint32_t> simplify(
+        const GEM::Renderer::IndexedGeometry& geometry,
+        const std::vector<uint32_t>& indices,
+        const uint32_t targetIndexCount,
+        float& error
+    );
+
+public: // public member functions
+    MeshSimplifier() = delete;
+
+private: // private classes and enums
+    /**
+     * @brief The symmetric 4x4 matrix summing the squared distances to a set of planes, stored as its
+     * upper triangle
+     */
+    struct Quadric {
+        double a2, ab, ac, ad, b2, bc, bd, c2, cd, d2;
+
+        void addPlane(const glm::dvec3& normal, const double distance);
+        void add(const Quadric& other);
+        double evaluate(const glm::dvec3& point) const;
+    };
+
+    struct Collapse {
+        uint32_t from;
+        uint32_t to;
+        double cost;
+    };
+
+private: // private static functions
+    static glm::dvec3 getPosition(const GEM::Renderer::IndexedGeometry& geometry, const uint32_t vertex);
+    static std::vector<bool> findLockedVertices(const std::vector<uint32_t>& indices, const uint32_t vertexCount);
+    static bool collapseFlipsTriangle(
+        const GEM::Renderer::IndexedGeometry& geometry,
+        const std::vector<uint32_t>& indices,
+        const std::vector<uint32_t>& vertexTriangleOffsets,
+        const std::vector<uint32_t>& vertexTriangles,
+        const std::vector<uint32_t>& remap,
+        const GEM::Renderer::MeshSimplifier::Collapse& collapse
+    );
+};
\ No newline at end of file
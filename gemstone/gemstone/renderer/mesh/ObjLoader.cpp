@@ -0,0 +1,496 @@
+#include <algorithm>
+#include <cmath>
+#include <functional> // std::ref
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "util/io/MappedFile.hpp"
+#include "util/logger/Logger.hpp"
+
+#include "gemstone/renderer/mesh/logger.hpp"
+#include "gemstone/renderer/mesh/IndexedGeometry.hpp"
+#include "gemstone/renderer/mesh/ObjLoader.hpp"
+
+/* ------------------------------ public static variables ------------------------------ */
+
+/**
+ * @brief The name of the logger the ObjLoader class uses
+ */
+const std::string GEM::Renderer::ObjLoader::LOGGER_NAME = MESH_LOGGER_NAME;
+
+/**
+ * @brief The smallest amount of the file we will give to a single thread
+ */
+const size_t GEM::Renderer::ObjLoader::MIN_CHUNK_SIZE_BYTES = 1024 * 1024;
+
+/* ------------------------------ private static variables ------------------------------ */
+
+/* ------------------------------ public static functions ------------------------------ */
+
+/**
+ * @brief Load the geometry out of an OBJ file
+ *
+ * @note This function will throw if the file cannot be read or contains malformed data
+ *
+ * @param filename The full path to the OBJ file
+ * @return GEM::Renderer::IndexedGeometry The deduplicated vertices and the indices of every triangle
+ */
+GEM::Renderer::IndexedGeometry GEM::Renderer::ObjLoader::load(const std::string& filename) {
+    LOG_FUNCTION_CALL_INFO("filename {}", filename);
+
+    const GEM::util::MappedFile file(filename);
+
+    std::vector<GEM::Renderer::ObjLoader::Chunk> chunks = GEM::Renderer::ObjLoader::splitIntoChunks(file.getData(), file.getSize());
+    LOG_DEBUG("Parsing {} bytes in {} chunks", file.getSize(), chunks.size());
+
+    // The first chunk is parsed on this thread while the others are parsed in the background
+    std::vector<std::thread> threads;
+    threads.reserve(chunks.size() - 1);
+    for (size_t i = 1; i < chunks.size(); ++i) {
+        threads.emplace_back(GEM::Renderer::ObjLoader::parseChunk, std::ref(chunks[i]));
+    }
+    GEM::Renderer::ObjLoader::parseChunk(chunks[0]);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // Exceptions can't leave the worker threads, so each chunk holds on to its error for us to throw here
+    for (const GEM::Renderer::ObjLoader::Chunk& chunk : chunks) {
+        if (!chunk.error.empty()) {
+            const std::string errorMessage = "Failed to parse OBJ file at " + filename + ": " + chunk.error;
+            LOG_CRITICAL(errorMessage);
+            throw std::invalid_argument(errorMessage);
+        }
+    }
+
+    return GEM::Renderer::ObjLoader::mergeChunks(chunks, filename);
+}
+
+/* ------------------------------ private static functions ------------------------------ */
+
+/**
+ * @brief Split the file into one chunk per thread. Every chunk starts at the beginning of a line and ends
+ * just after a newline (or at the end of the file) so no line is split between two chunks
+ *
+ * @param p_data The start of the file's contents
+ * @param size The size of the file in bytes
+ * @return std::vector<GEM::Renderer::ObjLoader::Chunk> The chunks covering the whole file, at least 1
+ */
+std::vector<GEM::Renderer::ObjLoader::Chunk> GEM::Renderer::ObjLoader::splitIntoChunks(const char* p_data, const size_t size) {
+    LOG_FUNCTION_ENTRY_TRACE("size {}", size);
+
+    const size_t hardwareThreadCount = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    const size_t chunkCount = std::max<size_t>(std::min(hardwareThreadCount, size / GEM::Renderer::ObjLoader::MIN_CHUNK_SIZE_BYTES), 1);
+
+    std::vector<GEM::Renderer::ObjLoader::Chunk> chunks;
+    chunks.reserve(chunkCount);
+
+    const char* p_end = p_data + size;
+    const char* p_chunkBegin = p_data;
+    for (size_t i = 1; i <= chunkCount; ++i) {
+        const char* p_chunkEnd = p_end;
+
+        // Move the split point forward to just after the next newline
+        if (i < chunkCount) {
+            p_chunkEnd = std::max(p_chunkBegin, p_data + ((size * i) / chunkCount));
+            while (p_chunkEnd < p_end && *p_chunkEnd != '\n') {
+                ++p_chunkEnd;
+            }
+            if (p_chunkEnd < p_end) {
+                ++p_chunkEnd;
+            }
+        }
+
+        GEM::Renderer::ObjLoader::Chunk chunk;
+        chunk.p_begin = p_chunkBegin;
+        chunk.p_end = p_chunkEnd;
+        chunks.push_back(std::move(chunk));
+
+        p_chunkBegin = p_chunkEnd;
+    }
+
+    return chunks;
+}
+
+/**
+ * @brief Parse all of the lines within a chunk. This runs on a worker thread so it must not log or throw,
+ * any error is stored in the chunk instead
+ *
+ * @param chunk The chunk to parse, which will be filled with its positions, texture coordinates, and triangles
+ */
+void GEM::Renderer::ObjLoader::parseChunk(GEM::Renderer::ObjLoader::Chunk& chunk) {
+    // Rough guess of the number of lines so the vectors don't have to grow as often
+    const size_t estimatedLineCount = static_cast<size_t>(chunk.p_end - chunk.p_begin) / 32;
+    chunk.positions.reserve(estimatedLineCount * 3);
+    chunk.colors.reserve(estimatedLineCount * 3);
+    chunk.corners.reserve(estimatedLineCount * 3);
+
+    // Reused for every face so we only allocate when we see a polygon bigger than any before it
+    std::vector<GEM::Renderer::ObjLoader::Corner> polygonCorners;
+
+    const char* p_cursor = chunk.p_begin;
+    while (p_cursor < chunk.p_end) {
+        const char* p_lineBegin = p_cursor;
+        GEM::Renderer::ObjLoader::skipWhitespace(p_cursor, chunk.p_end);
+        if (p_cursor == chunk.p_end) {
+            break;
+        }
+
+        const char* p_next = p_cursor + 1;
+        const bool nextIsWhitespace = p_next < chunk.p_end && (*p_next == ' ' || *p_next == '\t');
+        const bool nextIsTexture = p_next < chunk.p_end && *p_next == 't' && p_next + 1 < chunk.p_end && (p_next[1] == ' ' || p_next[1] == '\t');
+
+        bool success = true;
+        if (*p_cursor == 'v' && nextIsWhitespace) {
+            // v x y z [w | r g b]
+            p_cursor = p_next;
+            float position[3] = {0.0f, 0.0f, 0.0f};
+            success =
+                GEM::Renderer::ObjLoader::parseFloat(p_cursor, chunk.p_end, position[0]) &&
+                GEM::Renderer::ObjLoader::parseFloat(p_cursor, chunk.p_end, position[1]) &&
+                GEM::Renderer::ObjLoader::parseFloat(p_cursor, chunk.p_end, position[2]);
+            chunk.positions.insert(chunk.positions.end(), position, position + 3);
+
+            // Default to white so the texture's color is unchanged in the fragment shader. A single extra
+            // value is the rarely used w component, which we ignore
+            float color[3] = {1.0f, 1.0f, 1.0f};
+            float extraValues[3] = {1.0f, 1.0f, 1.0f};
+            if (
+                success &&
+                GEM::Renderer::ObjLoader::parseFloat(p_cursor, chunk.p_end, extraValues[0]) &&
+                GEM::Renderer::ObjLoader::parseFloat(p_cursor, chunk.p_end, extraValues[1])
+            ) {
+                success = GEM::Renderer::ObjLoader::parseFloat(p_cursor, chunk.p_end, extraValues[2]);
+                std::copy(extraValues, extraValues + 3, color);
+            }
+            chunk.colors.insert(chunk.colors.end(), color, color + 3);
+        } else if (*p_cursor == 'v' && nextIsTexture) {
+            // vt u [v [w]]
+            p_cursor = p_next + 1;
+            float textureCoord[2] = {0.0f, 0.0f};
+            success = GEM::Renderer::ObjLoader::parseFloat(p_cursor, chunk.p_end, textureCoord[0]);
+            GEM::Renderer::ObjLoader::parseFloat(p_cursor, chunk.p_end, textureCoord[1]);
+            chunk.textureCoords.insert(chunk.textureCoords.end(), textureCoord, textureCoord + 2);
+        } else if (*p_cursor == 'f' && nextIsWhitespace) {
+            // f p[/t[/n]] p[/t[/n]] p[/t[/n]] ...
+            p_cursor = p_next;
+            success = GEM::Renderer::ObjLoader::parseFace(p_cursor, chunk.p_end, chunk, polygonCorners);
+        }
+
+        if (!success) {
+            const char* p_lineEnd = std::find(p_lineBegin, chunk.p_end, '\n');
+            chunk.error = "malformed line \"" + std::string(p_lineBegin, p_lineEnd) + "\"";
+            return;
+        }
+
+        GEM::Renderer::ObjLoader::skipLine(p_cursor, chunk.p_end);
+    }
+}
+
+/**
+ * @brief Parse the corners of a face and triangulate it as a fan around the first corner
+ *
+ * @param p_cursor The position just after the "f", moved to the end of the last corner
+ * @param p_end The end of the chunk
+ * @param chunk The chunk the face is in, which the triangles are added to
+ * @param polygonCorners Scratch space to hold the corners of the face
+ * @return true The face was parsed successfully
+ * @return false The face was malformed or had fewer than 3 corners
+ */
+bool GEM::Renderer::ObjLoader::parseFace(
+    const char*& p_cursor,
+    const char* p_end,
+    GEM::Renderer::ObjLoader::Chunk& chunk,
+    std::vector<GEM::Renderer::ObjLoader::Corner>& polygonCorners
+) {
+    const int32_t chunkPositionCount = static_cast<int32_t>(chunk.positions.size() / 3);
+    const int32_t chunkTextureCoordCount = static_cast<int32_t>(chunk.textureCoords.size() / 2);
+
+    polygonCorners.clear();
+
+    int32_t positionIndex;
+    while (GEM::Renderer::ObjLoader::parseInt(p_cursor, p_end, positionIndex)) {
+        if (positionIndex == 0) {
+            return false;
+        }
+
+        GEM::Renderer::ObjLoader::Corner corner;
+        corner.positionIndex = positionIndex < 0 ? chunkPositionCount + positionIndex : positionIndex;
+        corner.positionIsRelative = positionIndex < 0;
+        corner.textureCoordIndex = 0;
+        corner.textureCoordIsRelative = false;
+        corner.hasTextureCoord = false;
+
+        if (p_cursor < p_end && *p_cursor == '/') {
+            ++p_cursor;
+
+            // p/t or p/t/n, but not p//n
+            int32_t textureCoordIndex;
+            if (p_cursor < p_end && *p_cursor != '/') {
+                if (!GEM::Renderer::ObjLoader::parseInt(p_cursor, p_end, textureCoordIndex) || textureCoordIndex == 0) {
+                    return false;
+                }
+
+                corner.textureCoordIndex = textureCoordIndex < 0 ? chunkTextureCoordCount + textureCoordIndex : textureCoordIndex;
+                corner.textureCoordIsRelative = textureCoordIndex < 0;
+                corner.hasTextureCoord = true;
+            }
+
+            // Normals are not part of our vertex layout so just step over them
+            if (p_cursor < p_end && *p_cursor == '/') {
+                ++p_cursor;
+                int32_t normalIndex;
+                if (!GEM::Renderer::ObjLoader::parseInt(p_cursor, p_end, normalIndex)) {
+                    return false;
+                }
+            }
+        }
+
+        polygonCorners.push_back(corner);
+    }
+
+    if (polygonCorners.size() < 3) {
+        return false;
+    }
+
+    for (size_t i = 1; i + 1 < polygonCorners.size(); ++i) {
+        chunk.corners.push_back(polygonCorners[0]);
+        chunk.corners.push_back(polygonCorners[i]);
+        chunk.corners.push_back(polygonCorners[i + 1]);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Merge the parsed chunks into one set of deduplicated vertices. Corners referring to the same position
+ * and texture coordinate share a single vertex
+ *
+ * @note This function will throw if a face refers to a position or texture coordinate which doesn't exist
+ *
+ * @param chunks The parsed chunks, in file order
+ * @param filename The full path to the OBJ file, for error messages
+ * @return GEM::Renderer::IndexedGeometry The deduplicated vertices and the indices of every triangle
+ */
+GEM::Renderer::IndexedGeometry GEM::Renderer::ObjLoader::mergeChunks(const std::vector<GEM::Renderer::ObjLoader::Chunk>& chunks, const std::string& filename) {
+    LOG_FUNCTION_CALL_TRACE("chunk count {} , filename {}", chunks.size(), filename);
+
+    // The index of the first position and texture coordinate of each chunk within the whole file
+    std::vector<int64_t> positionOffsets(chunks.size() + 1, 0);
+    std::vector<int64_t> textureCoordOffsets(chunks.size() + 1, 0);
+    size_t cornerCount = 0;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        positionOffsets[i + 1] = positionOffsets[i] + static_cast<int64_t>(chunks[i].positions.size() / 3);
+        textureCoordOffsets[i + 1] = textureCoordOffsets[i] + static_cast<int64_t>(chunks[i].textureCoords.size() / 2);
+        cornerCount += chunks[i].corners.size();
+    }
+    const int64_t positionCount = positionOffsets.back();
+    const int64_t textureCoordCount = textureCoordOffsets.back();
+
+    GEM::Renderer::IndexedGeometry geometry;
+    geometry.vertexComponentCount = 8;
+    geometry.indices.reserve(cornerCount);
+    geometry.vertices.reserve(static_cast<size_t>(positionCount) * geometry.vertexComponentCount);
+
+    // Keyed by the position index in the upper 32 bits and the texture coordinate index in the lower 32 bits
+    const uint32_t noTextureCoord = std::numeric_limits<uint32_t>::max();
+    std::unordered_map<uint64_t, uint32_t> vertexIndices;
+    vertexIndices.reserve(static_cast<size_t>(positionCount));
+
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        for (const GEM::Renderer::ObjLoader::Corner& corner : chunks[i].corners) {
+            const int64_t positionIndex = corner.positionIsRelative ?
+                positionOffsets[i] + corner.positionIndex :
+                corner.positionIndex - 1;
+            const int64_t textureCoordIndex = !corner.hasTextureCoord ? noTextureCoord : (
+                corner.textureCoordIsRelative ?
+                    textureCoordOffsets[i] + corner.textureCoordIndex :
+                    corner.textureCoordIndex - 1
+            );
+
+            if (positionIndex < 0 || positionIndex >= positionCount || (corner.hasTextureCoord && (textureCoordIndex < 0 || textureCoordIndex >= textureCoordCount))) {
+                const std::string errorMessage = "Face refers to a vertex which does not exist in OBJ file at " + filename;
+                LOG_CRITICAL(errorMessage);
+                throw std::invalid_argument(errorMessage);
+            }
+
+            const uint64_t key = (static_cast<uint64_t>(positionIndex) << 32) | static_cast<uint64_t>(textureCoordIndex);
+            const uint32_t nextIndex = static_cast<uint32_t>(vertexIndices.size());
+            const auto [it, inserted] = vertexIndices.insert({key, nextIndex});
+            if (inserted) {
+                // Find which chunk the position and texture coordinate were defined in
+                const size_t positionChunk = std::upper_bound(positionOffsets.begin(), positionOffsets.end(), positionIndex) - positionOffsets.begin() - 1;
+                const float* p_position = chunks[positionChunk].positions.data() + ((positionIndex - positionOffsets[positionChunk]) * 3);
+                const float* p_color = chunks[positionChunk].colors.data() + ((positionIndex - positionOffsets[positionChunk]) * 3);
+
+                geometry.vertices.insert(geometry.vertices.end(), p_position, p_position + 3);
+                geometry.vertices.insert(geometry.vertices.end(), p_color, p_color + 3);
+
+                if (corner.hasTextureCoord) {
+                    const size_t textureCoordChunk = std::upper_bound(textureCoordOffsets.begin(), textureCoordOffsets.end(), textureCoordIndex) - textureCoordOffsets.begin() - 1;
+                    const float* p_textureCoord = chunks[textureCoordChunk].textureCoords.data() + ((textureCoordIndex - textureCoordOffsets[textureCoordChunk]) * 2);
+                    geometry.vertices.insert(geometry.vertices.end(), p_textureCoord, p_textureCoord + 2);
+                } else {
+                    geometry.vertices.push_back(0.0f);
+                    geometry.vertices.push_back(0.0f);
+                }
+            }
+
+            geometry.indices.push_back(it->second);
+        }
+    }
+
+    LOG_DEBUG(
+        "Merged {} positions and {} texture coords into {} vertices and {} indices",
+        positionCount,
+        textureCoordCount,
+        geometry.getVertexCount(),
+        geometry.getIndexCount()
+    );
+
+    return geometry;
+}
+
+/**
+ * @brief Parse a float without allocating or depending on the locale. Leading spaces and tabs are skipped
+ *
+ * @param p_cursor The position to start parsing from, moved to just after the number if successful
+ * @param p_end The end of the data we may read
+ * @param value The parsed value
+ * @return true A number was parsed
+ * @return false There was no number at the cursor
+ */
+bool GEM::Renderer::ObjLoader::parseFloat(const char*& p_cursor, const char* p_end, float& value) {
+    static const double powersOfTen[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+        1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    GEM::Renderer::ObjLoader::skipWhitespace(p_cursor, p_end);
+    const char* p = p_cursor;
+
+    bool negative = false;
+    if (p < p_end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+
+    // Accumulate up to 18 significant digits in an integer, anything past that only affects the exponent
+    uint64_t mantissa = 0;
+    int32_t exponent = 0;
+    bool hasDigits = false;
+    for (; p < p_end && *p >= '0' && *p <= '9'; ++p) {
+        if (mantissa < 100000000000000000ull) {
+            mantissa = (mantissa * 10) + static_cast<uint64_t>(*p - '0');
+        } else {
+            exponent += 1;
+        }
+        hasDigits = true;
+    }
+    if (p < p_end && *p == '.') {
+        ++p;
+        for (; p < p_end && *p >= '0' && *p <= '9'; ++p) {
+            if (mantissa < 100000000000000000ull) {
+                mantissa = (mantissa * 10) + static_cast<uint64_t>(*p - '0');
+                exponent -= 1;
+            }
+            hasDigits = true;
+        }
+    }
+
+    if (!hasDigits) {
+        return false;
+    }
+
+    if (p < p_end && (*p == 'e' || *p == 'E')) {
+        const char* p_exponent = p + 1;
+        int32_t writtenExponent;
+        if (GEM::Renderer::ObjLoader::parseInt(p_exponent, p_end, writtenExponent) && p_exponent > p + 1 && p[1] != ' ' && p[1] != '\t') {
+            exponent += writtenExponent;
+            p = p_exponent;
+        }
+    }
+
+    double result = static_cast<double>(mantissa);
+    if (exponent < 0) {
+        result = -exponent <= 22 ? result / powersOfTen[-exponent] : result * std::pow(10.0, exponent);
+    } else if (exponent > 0) {
+        result = exponent <= 22 ? result * powersOfTen[exponent] : result * std::pow(10.0, exponent);
+    }
+
+    value = static_cast<float>(negative ? -result : result);
+    p_cursor = p;
+
+    return true;
+}
+
+/**
+ * @brief Parse an integer without allocating. Leading spaces and tabs are skipped
+ *
+ * @param p_cursor The position to start parsing from, moved to just after the number if successful
+ * @param p_end The end of the data we may read
+ * @param value The parsed value
+ * @return true A number was parsed
+ * @return false There was no number at the cursor
+ */
+bool GEM::Renderer::ObjLoader::parseInt(const char*& p_cursor, const char* p_end, int32_t& value) {
+    GEM::Renderer::ObjLoader::skipWhitespace(p_cursor, p_end);
+    const char* p = p_cursor;
+
+    bool negative = false;
+    if (p < p_end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+
+    int64_t result = 0;
+    const char* p_digitsBegin = p;
+    for (; p < p_end && *p >= '0' && *p <= '9'; ++p) {
+        result = (result * 10) + (*p - '0');
+        if (result > std::numeric_limits<int32_t>::max()) {
+            return false;
+        }
+    }
+
+    if (p == p_digitsBegin) {
+        return false;
+    }
+
+    value = static_cast<int32_t>(negative ? -result : result);
+    p_cursor = p;
+
+    return true;
+}
+
+/**
+ * @brief Move the cursor past any spaces and tabs, stopping at the end of the line
+ *
+ * @param p_cursor The position to start from
+ * @param p_end The end of the data we may read
+ */
+void GEM::Renderer::ObjLoader::skipWhitespace(const char*& p_cursor, const char* p_end) {
+    while (p_cursor < p_end && (*p_cursor == ' ' || *p_cursor == '\t')) {
+        ++p_cursor;
+    }
+}
+
+/**
+ * @brief Move the cursor to the start of the next line
+ *
+ * @param p_cursor The position to start from
+ * @param p_end The end of the data we may read
+ */
+void GEM::Renderer::ObjLoader::skipLine(const char*& p_cursor, const char* p_end) {
+    while (p_cursor < p_end && *p_cursor != '\n') {
+        ++p_cursor;
+    }
+    if (p_cursor < p_end) {
+        ++p_cursor;
+    }
+}
+
+/* ------------------------------ private member functions ------------------------------ */
\ No newline at end of file
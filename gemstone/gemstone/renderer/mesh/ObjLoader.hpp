@@ -0,0 +1,73 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "gemstone/renderer/mesh/IndexedGeometry.hpp"
+
+namespace GEM {
+namespace Renderer {
+    class ObjLoader;
+}
+}
+
+/**
+ * @brief A loader for Wavefront OBJ files. The file is memory mapped and split into line aligned chunks
+ * which are parsed in parallel, then the chunks are merged into deduplicated vertices and indices laid
+ * out as 3 position + 3 color + 2 texture coordinate floats per vertex
+ * 
+ * @note Only positions (with optional "v x y z r g b" colors), texture coordinates, and faces are read.
+ * Faces with more than 3 corners are triangulated as a fan. Everything else is skipped
+ */
+class GEM::Renderer::ObjLoader {
+public: // public static variables
+    static const std::string LOGGER_NAME;
+
+    // Files smaller than this per thread are not worth splitting up any further
+    static const size_t MIN_CHUNK_SIZE_BYTES;
+
+public: // public static functions
+    static GEM::Renderer::IndexedGeometry load(const std::string& filename);
+
+public: // public member functions
+    ObjLoader() = delete;
+
+private: // private enums and classes
+    /**
+     * @brief A single corner of a triangle. Relative indices (negative in the file) are stored as 0 based
+     * offsets from the start of the chunk, absolute indices are stored as they are written (1 based)
+     */
+    struct Corner {
+        int32_t positionIndex;
+        int32_t textureCoordIndex;
+        bool positionIsRelative;
+        bool textureCoordIsRelative;
+        bool hasTextureCoord;
+    };
+
+    struct Chunk {
+        const char* p_begin;
+        const char* p_end;
+        std::vector<float> positions;
+        std::vector<float> colors;
+        std::vector<float> textureCoords;
+        std::vector<GEM::Renderer::ObjLoader::Corner> corners;
+        std::string error;
+    };
+
+private: // private static functions
+    static std::vector<GEM::Renderer::ObjLoader::Chunk> splitIntoChunks(const char* p_data, const size_t size);
+    static void parseChunk(GEM::Renderer::ObjLoader::Chunk& chunk);
+    static bool parseFace(
+        const char*& p_cursor,
+        const char* p_end,
+        GEM::Renderer::ObjLoader::Chunk& chunk,
+        std::vector<GEM::Renderer::ObjLoader::Corner>& polygonCorners
+    );
+    static GEM::Renderer::IndexedGeometry mergeChunks(const std::vector<GEM::Renderer::ObjLoader::Chunk>& chunks, const std::string& filename);
+
+    static bool parseFloat(const char*& p_cursor, const char* p_end, float& value);
+    static bool parseInt(const char*& p_cursor, const char* p_end, int32_t& value);
+    static void skipWhitespace(const char*& p_cursor, const char* p_end);
+    static void skipLine(const char*& p_cursor, const char* p_end);
+};
\ No newline at end of file
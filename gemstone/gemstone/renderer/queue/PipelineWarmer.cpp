@@ -0,0 +1,209 @@
+#include <array>
+#include <chrono>
+#include <memory>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include "util/logger/Logger.hpp"
+
+#include "gemstone/renderer/mesh/Mesh.hpp"
+#include "gemstone/renderer/mesh/MeshInstance.hpp"
+#include "gemstone/renderer/queue/logger.hpp"
+#include "gemstone/renderer/queue/PipelineWarmer.hpp"
+#include "gemstone/renderer/queue/RenderQueue.hpp"
+#include "gemstone/renderer/shader/ShaderProgram.hpp"
+#include "gemstone/renderer/state/StateCache.hpp"
+
+/* ------------------------------ public static variables ------------------------------ */
+
+/**
+ * @brief The name of the logger the PipelineWarmer class uses
+ */
+const std::string GEM::Renderer::PipelineWarmer::LOGGER_NAME = RENDER_QUEUE_LOGGER_NAME;
+
+/* ------------------------------ private static variables ------------------------------ */
+
+/* ------------------------------ public static functions ------------------------------ */
+
+/* ------------------------------ private static functions ------------------------------ */
+
+/**
+ * @brief Create a 1x1 renderbuffer to draw the warm up draws into
+ *
+ * @param internalFormat The format of the renderbuffer, which should match the window's
+ * @return uint32_t The id of the renderbuffer
+ */
+uint32_t GEM::Renderer::PipelineWarmer::createRenderbuffer(const GLenum internalFormat) {
+    LOG_FUNCTION_ENTRY_TRACE("internal format {}", internalFormat);
+
+    uint32_t renderbufferID;
+    glGenRenderbuffers(1, &renderbufferID);
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbufferID);
+    glRenderbufferStorage(GL_RENDERBUFFER, internalFormat, 1, 1);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    return renderbufferID;
+}
+
+/**
+ * @brief Create the framebuffer the warm up draws go into, so nothing of them ever reaches the window
+ *
+ * @param colorRenderbufferID The id of the color renderbuffer
+ * @param depthStencilRenderbufferID The id of the depth and stencil renderbuffer
+ * @return uint32_t The id of the framebuffer
+ */
+uint32_t GEM::Renderer::PipelineWarmer::createFramebuffer(const uint32_t colorRenderbufferID, const uint32_t depthStencilRenderbufferID) {
+    LOG_FUNCTION_ENTRY_TRACE("color renderbuffer id {} , depth stencil renderbuffer id {}", colorRenderbufferID, depthStencilRenderbufferID);
+
+    uint32_t framebufferID;
+    glGenFramebuffers(1, &framebufferID);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebufferID);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRenderbufferID);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthStencilRenderbufferID);
+
+    const GLenum framebufferStatus = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (framebufferStatus != GL_FRAMEBUFFER_COMPLETE) {
+        LOG_WARNING("Warm up framebuffer with id {} is incomplete with status {}", framebufferID, framebufferStatus);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    return framebufferID;
+}
+
+/**
+ * @brief Create the instance buffer holding the one instance every warm up draw is made with
+ *
+ * @return uint32_t The id of the instance buffer
+ */
+uint32_t GEM::Renderer::PipelineWarmer::createInstanceBufferObject() {
+    LOG_FUNCTION_ENTRY_TRACE("{}", nullptr);
+
+    const GEM::Renderer::MeshInstance instance = {glm::mat4(1.0f), glm::vec2(0.0f)};
+
+    uint32_t instanceBufferObjectID;
+    glGenBuffers(1, &instanceBufferObjectID);
+    GEM::Renderer::StateCache::bindBuffer(GL_ARRAY_BUFFER, instanceBufferObjectID);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(instance), &instance, GL_STATIC_DRAW);
+
+    return instanceBufferObjectID;
+}
+
+/* ------------------------------ public member functions ------------------------------ */
+
+/**
+ * @brief Construct a new GEM::Renderer::PipelineWarmer::PipelineWarmer object with its framebuffer and
+ * nothing to warm up yet
+ */
+GEM::Renderer::PipelineWarmer::PipelineWarmer() :
+    m_colorRenderbufferID(GEM::Renderer::PipelineWarmer::createRenderbuffer(GL_RGBA8)),
+    m_depthStencilRenderbufferID(GEM::Renderer::PipelineWarmer::createRenderbuffer(GL_DEPTH24_STENCIL8)),
+    m_framebufferID(GEM::Renderer::PipelineWarmer::createFramebuffer(m_colorRenderbufferID, m_depthStencilRenderbufferID)),
+    m_instanceBufferObjectID(GEM::Renderer::PipelineWarmer::createInstanceBufferObject()),
+    m_combinationKeys(),
+    m_combinations(),
+    m_timings()
+{
+    LOG_FUNCTION_CALL_INFO("framebuffer id {}", m_framebufferID);
+}
+
+/**
+ * @brief Destroy the GEM::Renderer::PipelineWarmer::PipelineWarmer object by deleting its framebuffer and
+ * instance buffer
+ */
+GEM::Renderer::PipelineWarmer::~PipelineWarmer() {
+    LOG_FUNCTION_CALL_TRACE("framebuffer id {}", m_framebufferID);
+
+    glDeleteFramebuffers(1, &m_framebufferID);
+    glDeleteRenderbuffers(1, &m_colorRenderbufferID);
+    glDeleteRenderbuffers(1, &m_depthStencilRenderbufferID);
+    GEM::Renderer::StateCache::deleteBuffer(m_instanceBufferObjectID);
+}
+
+/**
+ * @brief Add a combination to warm up. Combinations which were already added are ignored
+ *
+ * @param p_shaderProgram The shader program, which must read the model matrix from the per instance attribute
+ * like the shader programs the render queue draws with
+ * @param p_mesh The mesh whose vertex layout is drawn with
+ * @param pass The pass whose blend and depth state is drawn with
+ */
+void GEM::Renderer::PipelineWarmer::add(
+    std::shared_ptr<GEM::Renderer::ShaderProgram> p_shaderProgram,
+    std::shared_ptr<const GEM::Renderer::Mesh> p_mesh,
+    const GEM::Renderer::RenderQueue::Pass pass
+) {
+    const std::tuple<uint32_t, uint32_t, uint32_t> combinationKey = {
+        p_shaderProgram->getID(),
+        p_mesh->getVertexArrayObjectID(),
+        static_cast<uint32_t>(pass)
+    };
+    if (!m_combinationKeys.insert(combinationKey).second) {
+        return;
+    }
+
+    LOG_TRACE("Adding shader program with id {} , vertex array with id {} , pass {}", p_shaderProgram->getID(), p_mesh->getVertexArrayObjectID(), static_cast<uint32_t>(pass));
+    m_combinations.push_back({p_shaderProgram, p_mesh, pass});
+}
+
+/**
+ * @brief Draw every combination once into the framebuffer, waiting for each draw to finish and logging how long
+ * it took. The framebuffer, viewport, and opaque pass state are put back afterwards
+ */
+void GEM::Renderer::PipelineWarmer::warmUp() {
+    LOG_FUNCTION_CALL_INFO("{} combinations", m_combinations.size());
+
+    m_timings.clear();
+    if (m_combinations.empty()) {
+        return;
+    }
+
+    std::array<int32_t, 4> previousViewport;
+    glGetIntegerv(GL_VIEWPORT, previousViewport.data());
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebufferID);
+    glViewport(0, 0, 1, 1);
+    GEM::Renderer::RenderQueue::setPassState(GEM::Renderer::RenderQueue::Pass::opaque);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+    const std::chrono::steady_clock::time_point warmUpStartTime = std::chrono::steady_clock::now();
+    for (const GEM::Renderer::PipelineWarmer::Combination& combination : m_combinations) {
+        const std::chrono::steady_clock::time_point drawStartTime = std::chrono::steady_clock::now();
+
+        GEM::Renderer::RenderQueue::setPassState(combination.pass);
+        combination.p_shaderProgram->use();
+        combination.p_mesh->bind();
+
+        // The coarsest level of detail has the fewest triangles, and the same vertex layout as the rest
+        combination.p_mesh->drawInstanced(m_instanceBufferObjectID, 0, 1, combination.p_mesh->getLodCount() - 1);
+
+        // Wait for the draw so whatever the driver put off happens now, and is part of the timing
+        glFinish();
+
+        const std::chrono::duration<double, std::milli> drawTime = std::chrono::steady_clock::now() - drawStartTime;
+        m_timings.push_back({combination.p_shaderProgram->getID(), combination.p_mesh->getVertexArrayObjectID(), combination.pass, drawTime.count()});
+
+        LOG_INFO(
+            "Warmed up shader program with id {} , vertex array with id {} , {} pass in {} ms",
+            combination.p_shaderProgram->getID(),
+            combination.p_mesh->getVertexArrayObjectID(),
+            combination.pass == GEM::Renderer::RenderQueue::Pass::translucent ? "translucent" : "opaque",
+            drawTime.count()
+        );
+    }
+    const std::chrono::duration<double, std::milli> warmUpTime = std::chrono::steady_clock::now() - warmUpStartTime;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+    GEM::Renderer::RenderQueue::setPassState(GEM::Renderer::RenderQueue::Pass::opaque);
+
+    LOG_INFO("Warmed up {} combinations in {} ms", m_combinations.size(), warmUpTime.count());
+}
+
+/* ------------------------------ private member functions ------------------------------ */
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <memory>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "gemstone/renderer/mesh/Mesh.hpp"
+#include "gemstone/renderer/queue/RenderQueue.hpp"
+#include "gemstone/renderer/shader/ShaderProgram.hpp"
+
+namespace GEM {
+namespace Renderer {
+    class PipelineWarmer;
+}
+}
+
+/**
+ * @brief A class that draws every combination of shader program, vertex layout, and pass a scene is going to be
+ * drawn with once while the scene loads. Drivers often put off the real work of compiling a shader program until
+ * the first draw which uses it with a particular vertex layout and blend and depth state, which shows up as a
+ * hitch the first time each of them is seen. Warming them up moves that work to load time, so the first real
+ * frame is as fast as every one after it
+ *
+ * The draws are a single instance of each mesh's coarsest level of detail into a 1x1 framebuffer, with the same
+ * formats as the window's, and each one is waited on so it can be timed
+ */
+class GEM::Renderer::PipelineWarmer {
+public: // public classes and enums
+    struct Combination {
+        std::shared_ptr<GEM::Renderer::ShaderProgram> p_shaderProgram;
+        std::shared_ptr<const GEM::Renderer::Mesh> p_mesh;
+        GEM::Renderer::RenderQueue::Pass pass;
+    };
+
+    struct Timing {
+        uint32_t shaderProgramID;
+        uint32_t vertexArrayObjectID;
+        GEM::Renderer::RenderQueue::Pass pass;
+        double milliseconds;
+    };
+
+public: // public static variables
+    static const std::string LOGGER_NAME;
+
+public: // public member functions
+    PipelineWarmer();
+    ~PipelineWarmer();
+
+    PipelineWarmer(const PipelineWarmer& other) = delete;
+    void operator=(const PipelineWarmer& other) = delete;
+
+    void add(
+        std::shared_ptr<GEM::Renderer::ShaderProgram> p_shaderProgram,
+        std::shared_ptr<const GEM::Renderer::Mesh> p_mesh,
+        const GEM::Renderer::RenderQueue::Pass pass
+    );
+    void warmUp();
+
+    uint32_t getCombinationCount() const { return static_cast<uint32_t>(m_combinations.size()); }
+    const std::vector<GEM::Renderer::PipelineWarmer::Timing>& getTimings() const { return m_timings; }
+
+private: // private static functions
+    static uint32_t createRenderbuffer(const GLenum internalFormat);
+    static uint32_t createFramebuffer(const uint32_t colorRenderbufferID, const uint32_t depthStencilRenderbufferID);
+    static uint32_t createInstanceBufferObject();
+
+private: // private member variables
+    const uint32_t m_colorRenderbufferID;
+    const uint32_t m_depthStencilRenderbufferID;
+    const uint32_t m_framebufferID;
+    const uint32_t m_instanceBufferObjectID;
+
+    // The shader program id, vertex array id, and pass of every combination added, so each is only drawn once
+    std::set<std::tuple<uint32_t, uint32_t, uint32_t>> m_combinationKeys;
+    std::vector<GEM::Renderer::PipelineWarmer::Combination> m_combinations;
+    std::vector<GEM::Renderer::PipelineWarmer::Timing> m_timings;
+};
\ No newline at end of file
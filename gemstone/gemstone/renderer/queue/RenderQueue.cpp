@@ -0,0 +1,279 @@
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "util/logger/Logger.hpp"
+
+#include "gemstone/renderer/mesh/Mesh.hpp"
+#include "gemstone/renderer/queue/logger.hpp"
+#include "gemstone/renderer/queue/RenderQueue.hpp"
+#include "gemstone/renderer/shader/ShaderProgram.hpp"
+#include "gemstone/renderer/state/StateCache.hpp"
+#include "gemstone/renderer/texture/Texture.hpp"
+
+/* ------------------------------ public static variables ------------------------------ */
+
+/**
+ * @brief The name of the logger the RenderQueue class uses
+ */
+const std::string GEM::Renderer::RenderQueue::LOGGER_NAME = RENDER_QUEUE_LOGGER_NAME;
+
+/**
+ * @brief The name of the sampler uniform the first texture of every draw is bound to
+ */
+const std::string GEM::Renderer::RenderQueue::TEXTURE_SAMPLER_NAME = "ourTexture";
+
+/**
+ * @brief The name of the sampler uniform the second texture of every draw is bound to
+ */
+const std::string GEM::Renderer::RenderQueue::TEXTURE2_SAMPLER_NAME = "ourTexture2";
+
+/* ------------------------------ private static variables ------------------------------ */
+
+/* ------------------------------ public static functions ------------------------------ */
+
+/**
+ * @brief Pack the state a draw uses and how far away it is into a key which sorts draws into the order they
+ * should be drawn in. From the most significant bit down, opaque keys are laid out as
+ *
+ *  pass (2) | shader program (10) | texture (12) | texture 2 (12) | vertex array (12) | depth (16)
+ *
+ * and translucent keys as
+ *
+ *  pass (2) | inverted depth (16) | shader program (10) | texture (12) | texture 2 (12) | vertex array (12)
+ *
+ * so opaque draws are grouped by state and go front to back within each group, while translucent draws go
+ * strictly back to front
+ *
+ * @param pass The pass the draw belongs to
+ * @param shaderProgramID The id of the shader program the draw uses
+ * @param textureID The id of the draw's first texture
+ * @param texture2ID The id of the draw's second texture
+ * @param vertexArrayObjectID The id of the VAO of the draw's mesh
+ * @param depth How far away the draw is, from 0 at the near plane to 1 at the far plane. This is clamped
+ * @return uint64_t The sort key
+ */
+uint64_t GEM::Renderer::RenderQueue::makeSortKey(
+    const GEM::Renderer::RenderQueue::Pass pass,
+    const uint32_t shaderProgramID,
+    const uint32_t textureID,
+    const uint32_t texture2ID,
+    const uint32_t vertexArrayObjectID,
+    const float depth
+) {
+    const uint64_t passBits = static_cast<uint64_t>(pass) & 0x3;
+    const uint64_t shaderProgramBits = shaderProgramID & 0x3FF;
+    const uint64_t textureBits = textureID & 0xFFF;
+    const uint64_t texture2Bits = texture2ID & 0xFFF;
+    const uint64_t vertexArrayBits = vertexArrayObjectID & 0xFFF;
+    const uint64_t depthBits = static_cast<uint64_t>(std::min(std::max(depth, 0.0f), 1.0f) * 65535.0f);
+
+    const uint64_t stateBits = (shaderProgramBits << 36) | (textureBits << 24) | (texture2Bits << 12) | vertexArrayBits;
+
+    if (pass == GEM::Renderer::RenderQueue::Pass::translucent) {
+        return (passBits << 62) | ((0xFFFF - depthBits) << 46) | stateBits;
+    }
+
+    return (passBits << 62) | (stateBits << 16) | depthBits;
+}
+
+/**
+ * @brief Get the pass a draw belongs to back out of its sort key
+ *
+ * @param sortKey The sort key made by makeSortKey
+ * @return GEM::Renderer::RenderQueue::Pass The pass the draw belongs to
+ */
+GEM::Renderer::RenderQueue::Pass GEM::Renderer::RenderQueue::getPass(const uint64_t sortKey) {
+    return static_cast<GEM::Renderer::RenderQueue::Pass>(sortKey >> 62);
+}
+
+/**
+ * @brief Set the blend and depth state every draw of a pass is made with. Opaque draws write depth and don't
+ * blend, translucent draws are depth tested against the opaque draws but don't write depth, and blend over
+ * what is behind them
+ *
+ * @param pass The pass about to be drawn
+ */
+void GEM::Renderer::RenderQueue::setPassState(const GEM::Renderer::RenderQueue::Pass pass) {
+    LOG_FUNCTION_ENTRY_TRACE("pass {}", static_cast<uint32_t>(pass));
+
+    GEM::Renderer::StateCache::enable(GL_DEPTH_TEST);
+    if (pass == GEM::Renderer::RenderQueue::Pass::translucent) {
+        GEM::Renderer::StateCache::enable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glDepthMask(GL_FALSE);
+        return;
+    }
+
+    GEM::Renderer::StateCache::disable(GL_BLEND);
+    glDepthMask(GL_TRUE);
+}
+
+/* ------------------------------ private static functions ------------------------------ */
+
+/* ------------------------------ public member functions ------------------------------ */
+
+/**
+ * @brief Construct a new GEM::Renderer::RenderQueue::RenderQueue object with nothing in it
+ */
+GEM::Renderer::RenderQueue::RenderQueue() :
+    m_drawItems(),
+    m_sortEntries(),
+    m_sortScratch(),
+    m_statistics({0, 0, 0, 0})
+{
+    LOG_FUNCTION_CALL_INFO("this ptr {}", static_cast<void*>(this));
+}
+
+/**
+ * @brief Destroy the GEM::Renderer::RenderQueue::RenderQueue object
+ */
+GEM::Renderer::RenderQueue::~RenderQueue() {
+    LOG_FUNCTION_CALL_TRACE("this ptr {}", static_cast<void*>(this));
+}
+
+/**
+ * @brief Throw away every draw submitted so far, ready for the next frame
+ */
+void GEM::Renderer::RenderQueue::clear() {
+    m_drawItems.clear();
+}
+
+/**
+ * @brief Add a draw to the queue. Nothing is drawn until execute is called
+ *
+ * @param drawItem The draw, with its sort key made by makeSortKey
+ */
+void GEM::Renderer::RenderQueue::submit(const GEM::Renderer::RenderQueue::DrawItem& drawItem) {
+    m_drawItems.push_back(drawItem);
+}
+
+/**
+ * @brief Sort every submitted draw by its key and issue them in order. The shader program, textures, and
+ * mesh are only bound when they differ from the previous draw's. The camera's matrices come from the
+ * FrameData uniform block, so they must already be written for this frame
+ */
+void GEM::Renderer::RenderQueue::execute() {
+    sort();
+
+    m_statistics = {static_cast<uint32_t>(m_drawItems.size()), 0, 0, 0};
+
+    // 0 is never a valid id, so the first draw always binds everything
+    bool isFirstDraw = true;
+    GEM::Renderer::RenderQueue::Pass currentPass = GEM::Renderer::RenderQueue::Pass::opaque;
+    uint32_t currentShaderProgramID = 0;
+    uint32_t currentTextureID = 0;
+    uint32_t currentTexture2ID = 0;
+    const GEM::Renderer::Mesh* p_currentMesh = nullptr;
+
+    // The sampler uniforms of the shader program in use, looked up once each time the shader program changes
+    GEM::Renderer::ShaderProgram::UniformHandle textureSamplerHandle = {-1, GL_NONE, 0};
+    GEM::Renderer::ShaderProgram::UniformHandle texture2SamplerHandle = {-1, GL_NONE, 0};
+
+    for (const GEM::Renderer::RenderQueue::SortEntry& sortEntry : m_sortEntries) {
+        const GEM::Renderer::RenderQueue::DrawItem& drawItem = m_drawItems[sortEntry.drawItemIndex];
+
+        const GEM::Renderer::RenderQueue::Pass pass = GEM::Renderer::RenderQueue::getPass(sortEntry.sortKey);
+        if (isFirstDraw || pass != currentPass) {
+            GEM::Renderer::RenderQueue::setPassState(pass);
+            currentPass = pass;
+            isFirstDraw = false;
+        }
+
+        const bool shaderProgramChanged = drawItem.p_shaderProgram->getID() != currentShaderProgramID;
+        if (shaderProgramChanged) {
+            drawItem.p_shaderProgram->use();
+            textureSamplerHandle = drawItem.p_shaderProgram->getUniformHandle(GEM::Renderer::RenderQueue::TEXTURE_SAMPLER_NAME);
+            texture2SamplerHandle = drawItem.p_shaderProgram->getUniformHandle(GEM::Renderer::RenderQueue::TEXTURE2_SAMPLER_NAME);
+            currentShaderProgramID = drawItem.p_shaderProgram->getID();
+            m_statistics.shaderProgramChangeCount += 1;
+        }
+
+        // A packed texture is only sampled from its texture array by shader programs with array samplers, every
+        // other shader program samples its own plain texture, so that is the id which has to match. Sampler
+        // uniforms belong to the shader program, so they only need setting again when it changes
+        const uint32_t textureID = textureSamplerHandle.type == GL_SAMPLER_2D_ARRAY ?
+            drawItem.p_texture->getID() :
+            drawItem.p_texture->getUnpackedID();
+        if (shaderProgramChanged || textureID != currentTextureID) {
+            drawItem.p_texture->activate();
+            drawItem.p_shaderProgram->setUniformTextureSampler(textureSamplerHandle, drawItem.p_texture);
+            currentTextureID = textureID;
+            m_statistics.textureChangeCount += 1;
+        }
+        const uint32_t texture2ID = texture2SamplerHandle.type == GL_SAMPLER_2D_ARRAY ?
+            drawItem.p_texture2->getID() :
+            drawItem.p_texture2->getUnpackedID();
+        if (shaderProgramChanged || texture2ID != currentTexture2ID) {
+            drawItem.p_texture2->activate();
+            drawItem.p_shaderProgram->setUniformTextureSampler(texture2SamplerHandle, drawItem.p_texture2);
+            currentTexture2ID = texture2ID;
+            m_statistics.textureChangeCount += 1;
+        }
+
+        if (drawItem.p_mesh.get() != p_currentMesh) {
+            drawItem.p_mesh->bind();
+            p_currentMesh = drawItem.p_mesh.get();
+            m_statistics.meshChangeCount += 1;
+        }
+
+        drawItem.p_mesh->drawInstanced(drawItem.instanceBufferObjectID, drawItem.firstInstance, drawItem.instanceCount, drawItem.lodIndex);
+    }
+
+    // Leave everything after the queue drawing with the opaque state it expects
+    if (currentPass != GEM::Renderer::RenderQueue::Pass::opaque) {
+        GEM::Renderer::RenderQueue::setPassState(GEM::Renderer::RenderQueue::Pass::opaque);
+    }
+
+    LOG_TRACE(
+        "Executed {} draws with {} shader program changes , {} texture changes , {} mesh changes",
+        m_statistics.drawCount,
+        m_statistics.shaderProgramChangeCount,
+        m_statistics.textureChangeCount,
+        m_statistics.meshChangeCount
+    );
+}
+
+/* ------------------------------ private member functions ------------------------------ */
+
+/**
+ * @brief Order the draws by their keys with a least significant digit radix sort, one byte per pass. Passes
+ * where every key has the same byte are skipped, which is most of them since the high bits are mostly the
+ * same from draw to draw. The sort is stable, so draws with equal keys stay in submission order
+ */
+void GEM::Renderer::RenderQueue::sort() {
+    const size_t drawItemCount = m_drawItems.size();
+    m_sortEntries.resize(drawItemCount);
+    m_sortScratch.resize(drawItemCount);
+    for (size_t i = 0; i < drawItemCount; ++i) {
+        m_sortEntries[i] = {m_drawItems[i].sortKey, static_cast<uint32_t>(i)};
+    }
+
+    for (uint32_t shift = 0; shift < 64; shift += 8) {
+        std::array<size_t, 256> counts = {};
+        for (const GEM::Renderer::RenderQueue::SortEntry& sortEntry : m_sortEntries) {
+            counts[(sortEntry.sortKey >> shift) & 0xFF] += 1;
+        }
+
+        if (drawItemCount == 0 || counts[(m_sortEntries[0].sortKey >> shift) & 0xFF] == drawItemCount) {
+            continue;
+        }
+
+        // Turn the counts into the offset each digit's entries start at
+        size_t offset = 0;
+        for (size_t& count : counts) {
+            const size_t digitCount = count;
+            count = offset;
+            offset += digitCount;
+        }
+
+        for (const GEM::Renderer::RenderQueue::SortEntry& sortEntry : m_sortEntries) {
+            m_sortScratch[counts[(sortEntry.sortKey >> shift) & 0xFF]++] = sortEntry;
+        }
+        m_sortEntries.swap(m_sortScratch);
+    }
+}
\ No newline at end of file
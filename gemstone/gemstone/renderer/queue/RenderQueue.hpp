@@ -0,0 +1,110 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gemstone/renderer/mesh/Mesh.hpp"
+#include "gemstone/renderer/shader/ShaderProgram.hpp"
+#include "gemstone/renderer/texture/Texture.hpp"
+
+namespace GEM {
+namespace Renderer {
+    class RenderQueue;
+}
+}
+
+/**
+ * @brief A class that collects every draw of a frame, sorts them by a packed 64 bit key, then issues them
+ * in that order while only changing the gl state that differs from the previous draw. Opaque draws are
+ * grouped by shader program, textures, then mesh, and go front to back within each group so early depth
+ * testing throws away as many fragments as possible. Translucent draws come after every opaque draw and go
+ * back to front so they blend correctly. Each pass is drawn with its own blend and depth state, set by
+ * setPassState
+ *
+ * The key only decides the order. Whether state actually changes is decided by comparing the real ids, so
+ * two ids sharing the same bits in the key costs an extra state change at worst
+ */
+class GEM::Renderer::RenderQueue {
+public: // public classes and enums
+    /**
+     * @brief The passes draws are split into, in the order they are drawn
+     */
+    enum class Pass {
+        opaque,
+        translucent
+    };
+
+    /**
+     * @brief Everything needed to issue one instanced draw call
+     */
+    struct DrawItem {
+        uint64_t sortKey;
+        std::shared_ptr<GEM::Renderer::ShaderProgram> p_shaderProgram;
+        std::shared_ptr<const GEM::Renderer::Mesh> p_mesh;
+        std::shared_ptr<const GEM::Renderer::Texture> p_texture;
+        std::shared_ptr<const GEM::Renderer::Texture> p_texture2;
+        uint32_t instanceBufferObjectID;
+        uint32_t firstInstance;
+        uint32_t instanceCount;
+        uint32_t lodIndex;
+    };
+
+    struct Statistics {
+        uint32_t drawCount;
+        uint32_t shaderProgramChangeCount;
+        uint32_t textureChangeCount;
+        uint32_t meshChangeCount;
+    };
+
+public: // public static variables
+    static const std::string LOGGER_NAME;
+
+    // The names of the sampler uniforms the two textures of a draw are bound to
+    static const std::string TEXTURE_SAMPLER_NAME;
+    static const std::string TEXTURE2_SAMPLER_NAME;
+
+public: // public static functions
+    static uint64_t makeSortKey(
+        const GEM::Renderer::RenderQueue::Pass pass,
+        const uint32_t shaderProgramID,
+        const uint32_t textureID,
+        const uint32_t texture2ID,
+        const uint32_t vertexArrayObjectID,
+        const float depth
+    );
+    static GEM::Renderer::RenderQueue::Pass getPass(const uint64_t sortKey);
+    static void setPassState(const GEM::Renderer::RenderQueue::Pass pass);
+
+public: // public member functions
+    RenderQueue();
+    ~RenderQueue();
+
+    RenderQueue(const RenderQueue& other) = delete;
+    void operator=(const RenderQueue& other) = delete;
+
+    void clear();
+    void submit(const GEM::Renderer::RenderQueue::DrawItem& drawItem);
+    void execute();
+
+    uint32_t getDrawItemCount() const { return static_cast<uint32_t>(m_drawItems.size()); }
+    const GEM::Renderer::RenderQueue::Statistics& getStatistics() const { return m_statistics; }
+
+private: // private classes and enums
+    struct SortEntry {
+        uint64_t sortKey;
+        uint32_t drawItemIndex;
+    };
+
+private: // private member functions
+    void sort();
+
+private: // private member variables
+    std::vector<GEM::Renderer::RenderQueue::DrawItem> m_drawItems;
+
+    // Kept between frames so we don't reallocate every frame
+    std::vector<GEM::Renderer::RenderQueue::SortEntry> m_sortEntries;
+    std::vector<GEM::Renderer::RenderQueue::SortEntry> m_sortScratch;
+
+    GEM::Renderer::RenderQueue::Statistics m_statistics;
+};
\ No newline at end of file
@@ -0,0 +1,6 @@
+#pragma once
+
+/**
+ * @brief The name of the logger used by the render queue classes
+ */
+#define RENDER_QUEUE_LOGGER_NAME "RENDER_QUEUE"
\ No newline at end of file
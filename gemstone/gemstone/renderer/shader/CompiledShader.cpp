@@ -1,7 +1,10 @@
+#include <exception>
 #include <functional> // std::hash
 #include <map>
+#include <stdexcept>
 #include <utility> // std::pair
 #include <string>
+#include <string_view>
 
 #include <glad/glad.h>
 
@@ -32,6 +35,18 @@ std::map<size_t, GEM::Renderer::CompiledShader::Info> GEM::Renderer::CompiledSha
 
 /* ------------------------------ public static functions ------------------------------ */
 
+/**
+ * @brief Take the source code of a shader and determine its hash value. This is so we can look
+ * into the maps of shader ids, and so a program binary saved on a previous run can be matched to
+ * its sources. The contents are hashed rather than the pointer so the same source always gives the
+ * same hash, no matter where it lives or which run it is
+ * 
+ * @param shaderSource The source code of the shader
+ * @return size_t The hash of the shader's source code
+ */
+size_t GEM::Renderer::CompiledShader::getHashFromShaderSource(const char* shaderSource) {
+    return std::hash<std::string_view>{}(std::string_view(shaderSource));
+}
 
 /* ------------------------------ private static functions ------------------------------ */
 
@@ -75,13 +90,14 @@ std::string GEM::Renderer::CompiledShader::getShaderTypeString(const GLenum shad
  * @param shaderSourceHash The hash of the shader's source code
  * @param shaderID The id of the shader to map to its hash
  * @param shaderType The type of the shader
+ * @param statusChecked Whether or not the shader's compile status has already been checked
  */
-void GEM::Renderer::CompiledShader::addShaderToMap(const size_t shaderSourceHash, const uint32_t shaderID, const GLenum shaderType) {
-    LOG_FUNCTION_ENTRY_TRACE("hash {} , id {} , type {}", shaderSourceHash, shaderID, GEM::Renderer::CompiledShader::getShaderTypeString(shaderType));
+void GEM::Renderer::CompiledShader::addShaderToMap(const size_t shaderSourceHash, const uint32_t shaderID, const GLenum shaderType, const bool statusChecked) {
+    LOG_FUNCTION_ENTRY_TRACE("hash {} , id {} , type {} , status checked {}", shaderSourceHash, shaderID, GEM::Renderer::CompiledShader::getShaderTypeString(shaderType), statusChecked);
 
     std::map<size_t, GEM::Renderer::CompiledShader::Info>& shaderIDMap = GEM::Renderer::CompiledShader::getShaderIDMap(shaderType);
 
-    shaderIDMap.insert({shaderSourceHash, {shaderID, 0}});
+    shaderIDMap.insert({shaderSourceHash, {shaderID, 0, statusChecked}});
 
     GEM::Renderer::CompiledShader::incrementShaderUseCount(shaderSourceHash, shaderType);
 }
@@ -159,17 +175,6 @@ bool GEM::Renderer::CompiledShader::shaderIsCompiled(const size_t shaderSourceHa
     return isCompiled;
 }
 
-/**
- * @brief Take the source code of a shader and determine its hash value. This is so we can look
- * into the maps of shader ids
- * 
- * @param shaderSource The source code of the shader
- * @return size_t The hash of the shader's source code
- */
-size_t GEM::Renderer::CompiledShader::getHashFromShaderSource(const char* shaderSource) {
-    return std::hash<const char*>{}(shaderSource);
-}
-
 /**
  * @brief Get the id of the compiled shader
  * 
@@ -188,17 +193,43 @@ uint32_t GEM::Renderer::CompiledShader::getCompiledShaderID(const size_t shaderS
     return shaderID;
 }
 
+/**
+ * @brief Ask gl whether a shader compiled successfully. This waits for the driver to finish compiling the
+ * shader if it hasn't already
+ * 
+ * @note This function will throw an exception if the shader failed to compile
+ * 
+ * @param shaderID The id of the shader
+ * @param shaderType The type of the shader
+ */
+void GEM::Renderer::CompiledShader::checkShaderCompileStatus(const uint32_t shaderID, const GLenum shaderType) {
+    LOG_FUNCTION_ENTRY_TRACE("id {} , type {}", shaderID, GEM::Renderer::CompiledShader::getShaderTypeString(shaderType));
+
+    int shaderCompilationSuccess;
+    char shaderCompilationInfoLog[512];
+    glGetShaderiv(shaderID, GL_COMPILE_STATUS, &shaderCompilationSuccess);
+    if (!shaderCompilationSuccess) {
+        glGetShaderInfoLog(shaderID, sizeof(shaderCompilationInfoLog), nullptr, shaderCompilationInfoLog);
+
+        const std::string errorMessage = getShaderTypeString(shaderType) + " shader failed to compile:\n" + std::string(shaderCompilationInfoLog);
+        LOG_CRITICAL(errorMessage);
+        throw std::invalid_argument(errorMessage);
+    }
+}
+
 /**
  * @brief Compile a shader given it's source code and the type of shader 
  * 
- * @note This function will throw an exception if the shader fails to compile
+ * @note This function will throw an exception if the shader fails to compile, unless the check is deferred
  * 
  * @param shaderSource The source code of the shader
  * @param shaderType The type of the shader (GL_VERTEX_SHADER, GL_FRAGMENT_SHADER, etc ...)
+ * @param deferStatusCheck Whether to leave checking the compile status to checkStatus, so the driver can
+ * keep compiling while we hand it more work
  * @return uint32_t The compiled shader
  */
-uint32_t GEM::Renderer::CompiledShader::compileShader(const char* shaderSource, const GLenum shaderType) {
-    LOG_FUNCTION_CALL_INFO("{} shader", GEM::Renderer::CompiledShader::getShaderTypeString(shaderType));
+uint32_t GEM::Renderer::CompiledShader::compileShader(const char* shaderSource, const GLenum shaderType, const bool deferStatusCheck) {
+    LOG_FUNCTION_CALL_INFO("{} shader , defer status check {}", GEM::Renderer::CompiledShader::getShaderTypeString(shaderType), deferStatusCheck);
 
     // Before we actually try to compile, check if this shader has already been compiled
     // If it has been compiled before, use that index and increment the counter
@@ -206,6 +237,13 @@ uint32_t GEM::Renderer::CompiledShader::compileShader(const char* shaderSource,
     if (GEM::Renderer::CompiledShader::shaderIsCompiled(shaderSourceHash, shaderType)) {
         uint32_t shaderID = GEM::Renderer::CompiledShader::getCompiledShaderID(shaderSourceHash, shaderType);
 
+        // The shader may have been submitted by a deferred user which hasn't checked it yet
+        std::map<size_t, GEM::Renderer::CompiledShader::Info>& shaderIDMap = GEM::Renderer::CompiledShader::getShaderIDMap(shaderType);
+        if (!deferStatusCheck && !shaderIDMap[shaderSourceHash].statusChecked) {
+            GEM::Renderer::CompiledShader::checkShaderCompileStatus(shaderID, shaderType);
+            shaderIDMap[shaderSourceHash].statusChecked = true;
+        }
+
         GEM::Renderer::CompiledShader::incrementShaderUseCount(shaderSourceHash, shaderType);
 
         LOG_DEBUG("Successfully found compiled shader with id {}", shaderID);
@@ -221,31 +259,29 @@ uint32_t GEM::Renderer::CompiledShader::compileShader(const char* shaderSource,
     glShaderSource(shaderID, 1, &shaderSource, nullptr);
     glCompileShader(shaderID);
 
-    // Check for successful compilation of the shader
-    int shaderCompilationSuccess;
-    char shaderCompilationInfoLog[512];
-    glGetShaderiv(shaderID, GL_COMPILE_STATUS, &shaderCompilationSuccess);
-    if (!shaderCompilationSuccess) {
-        glGetShaderInfoLog(shaderID, sizeof(shaderCompilationInfoLog), nullptr, shaderCompilationInfoLog);
-
-        const std::string errorMessage = getShaderTypeString(shaderType) + " shader failed to compile:\n" + std::string(shaderCompilationInfoLog);
-        LOG_CRITICAL(errorMessage);
-        throw std::invalid_argument(errorMessage);
+    // Check for successful compilation of the shader. Asking right away waits for the compile to finish
+    if (!deferStatusCheck) {
+        try {
+            GEM::Renderer::CompiledShader::checkShaderCompileStatus(shaderID, shaderType);
+        } catch (const std::exception&) {
+            glDeleteShader(shaderID);
+            throw;
+        }
     }
 
-    GEM::Renderer::CompiledShader::addShaderToMap(shaderSourceHash, shaderID, shaderType);
+    GEM::Renderer::CompiledShader::addShaderToMap(shaderSourceHash, shaderID, shaderType, !deferStatusCheck);
 
-    LOG_DEBUG("Successfully compiled shader program with id {}", shaderID);
+    LOG_DEBUG("Successfully {} shader with id {}", deferStatusCheck ? "submitted" : "compiled", shaderID);
 
     return shaderID;
 }
 
 /* ------------------------------ public member functions ------------------------------ */
 
-GEM::Renderer::CompiledShader::CompiledShader(const char* shaderSource, const GLenum shaderType) :
+GEM::Renderer::CompiledShader::CompiledShader(const char* shaderSource, const GLenum shaderType, const bool deferStatusCheck) :
     m_sourceHash(GEM::Renderer::CompiledShader::getHashFromShaderSource(shaderSource)),
     m_type(shaderType),
-    m_id(GEM::Renderer::CompiledShader::compileShader(shaderSource, shaderType))
+    m_id(GEM::Renderer::CompiledShader::compileShader(shaderSource, shaderType, deferStatusCheck))
 {}
 
 GEM::Renderer::CompiledShader::~CompiledShader() {
@@ -253,4 +289,22 @@ GEM::Renderer::CompiledShader::~CompiledShader() {
     GEM::Renderer::CompiledShader::decrementShaderUseCount(m_sourceHash, m_type);
 }
 
+/**
+ * @brief Make sure the shader compiled successfully, waiting for the driver to finish compiling it if it
+ * hasn't already. Only the first check of a shader reaches gl
+ * 
+ * @note This function will throw an exception if the shader failed to compile
+ */
+void GEM::Renderer::CompiledShader::checkStatus() const {
+    LOG_FUNCTION_ENTRY_TRACE("id {}", m_id);
+
+    std::map<size_t, GEM::Renderer::CompiledShader::Info>& shaderIDMap = GEM::Renderer::CompiledShader::getShaderIDMap(m_type);
+    if (shaderIDMap[m_sourceHash].statusChecked) {
+        return;
+    }
+
+    GEM::Renderer::CompiledShader::checkShaderCompileStatus(m_id, m_type);
+    shaderIDMap[m_sourceHash].statusChecked = true;
+}
+
 /* ------------------------------ private member functions ------------------------------ */
\ No newline at end of file
@@ -16,23 +16,33 @@ namespace Renderer {
  * @brief A class that represents a compiled shader. When the use count hits 0, it should
  * call glDeleteShader and be removed from the shaderIDMap in the Shader class
  * 
+ * A shader can be created with its compile status check deferred, so many compiles can be handed to the
+ * driver before waiting on any of them. Whoever uses a deferred shader must call checkStatus before
+ * relying on it. The maps remember which shaders have been checked, so a shader shared between a deferred
+ * and an immediate user is only ever asked about once
  */
 class GEM::Renderer::CompiledShader {
 public: // public static variables
     static const std::string LOGGER_NAME;
 
+public: // public static functions
+    static size_t getHashFromShaderSource(const char* shaderSource);
+
 public: // public member functions
-    CompiledShader(const char* shaderSource, const GLenum shaderType);
+    CompiledShader(const char* shaderSource, const GLenum shaderType, const bool deferStatusCheck = false);
     ~CompiledShader();
     
     size_t getSourceHash() const { return m_sourceHash; }
     GLenum getType() const { return m_type; }
     uint32_t getID() const { return m_id; }
 
+    void checkStatus() const;
+
 private: // private static enums and classes
     struct Info {
         uint32_t id;
         int useCount;
+        bool statusChecked;
     };
 
 private: // private static functions
@@ -40,14 +50,14 @@ private: // private static functions
 
     static std::string getShaderTypeString(const GLenum shaderType);
 
-    static void addShaderToMap(const size_t shaderSourceHash, const uint32_t shaderID, const GLenum shaderType);
+    static void addShaderToMap(const size_t shaderSourceHash, const uint32_t shaderID, const GLenum shaderType, const bool statusChecked);
     static void incrementShaderUseCount(const size_t shaderSourceHash, const GLenum shaderType);
     static void decrementShaderUseCount(const size_t shaderSourceHash, const GLenum shaderType);
     static bool shaderIsCompiled(const size_t shaderSourceHash, const GLenum shaderType);
     
-    static size_t getHashFromShaderSource(const char* shaderSource);
     static uint32_t getCompiledShaderID(const size_t shaderSourceHash, const GLenum shaderType);
-    static uint32_t compileShader(const char* shaderSource, const GLenum shaderType);
+    static void checkShaderCompileStatus(const uint32_t shaderID, const GLenum shaderType);
+    static uint32_t compileShader(const char* shaderSource, const GLenum shaderType, const bool deferStatusCheck);
 
 private: // private static variables
     static std::map<size_t, GEM::Renderer::CompiledShader::Info> vertexShaderIDMap;
@@ -0,0 +1,108 @@
+#include <cstddef> // offsetof
+#include <string>
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include "util/logger/Logger.hpp"
+
+#include "gemstone/camera/Camera.hpp"
+#include "gemstone/renderer/shader/logger.hpp"
+#include "gemstone/renderer/shader/FrameUniformBuffer.hpp"
+#include "gemstone/renderer/state/StateCache.hpp"
+
+// The struct is copied into the buffer as is, so it has to match the std140 layout of the block exactly
+static_assert(offsetof(GEM::Renderer::FrameUniformBuffer::FrameData, viewMatrix) == 0, "FrameData does not match std140");
+static_assert(offsetof(GEM::Renderer::FrameUniformBuffer::FrameData, projectionMatrix) == 64, "FrameData does not match std140");
+static_assert(offsetof(GEM::Renderer::FrameUniformBuffer::FrameData, viewProjectionMatrix) == 128, "FrameData does not match std140");
+static_assert(offsetof(GEM::Renderer::FrameUniformBuffer::FrameData, cameraPosition) == 192, "FrameData does not match std140");
+static_assert(offsetof(GEM::Renderer::FrameUniformBuffer::FrameData, time) == 204, "FrameData does not match std140");
+static_assert(sizeof(GEM::Renderer::FrameUniformBuffer::FrameData) == 208, "FrameData does not match std140");
+
+/* ------------------------------ public static variables ------------------------------ */
+
+/**
+ * @brief The name of the logger the FrameUniformBuffer class uses
+ */
+const std::string GEM::Renderer::FrameUniformBuffer::LOGGER_NAME = SHADER_LOGGER_NAME;
+
+/**
+ * @brief The name of the uniform block in the shaders
+ */
+const std::string GEM::Renderer::FrameUniformBuffer::BLOCK_NAME = "FrameData";
+
+/**
+ * @brief The uniform buffer binding point the buffer is bound to and every shader program reads the block from
+ */
+const uint32_t GEM::Renderer::FrameUniformBuffer::BINDING_POINT = 0;
+
+/* ------------------------------ private static variables ------------------------------ */
+
+/* ------------------------------ public static functions ------------------------------ */
+
+/* ------------------------------ private static functions ------------------------------ */
+
+/**
+ * @brief Create the uniform buffer with room for one FrameData and bind it to the binding point
+ *
+ * @return uint32_t The id of the uniform buffer
+ */
+uint32_t GEM::Renderer::FrameUniformBuffer::createUniformBuffer() {
+    LOG_FUNCTION_ENTRY_TRACE("size {} bytes", sizeof(GEM::Renderer::FrameUniformBuffer::FrameData));
+
+    uint32_t uniformBufferID;
+    glGenBuffers(1, &uniformBufferID);
+    GEM::Renderer::StateCache::bindBuffer(GL_UNIFORM_BUFFER, uniformBufferID);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(GEM::Renderer::FrameUniformBuffer::FrameData), nullptr, GL_DYNAMIC_DRAW);
+
+    GEM::Renderer::StateCache::bindBufferBase(GL_UNIFORM_BUFFER, GEM::Renderer::FrameUniformBuffer::BINDING_POINT, uniformBufferID);
+
+    return uniformBufferID;
+}
+
+/* ------------------------------ public member functions ------------------------------ */
+
+/**
+ * @brief Construct a new GEM::Renderer::FrameUniformBuffer::FrameUniformBuffer object, creating the uniform
+ * buffer and binding it to the binding point
+ */
+GEM::Renderer::FrameUniformBuffer::FrameUniformBuffer() :
+    m_id(GEM::Renderer::FrameUniformBuffer::createUniformBuffer()),
+    m_frameData({glm::mat4(1.0f), glm::mat4(1.0f), glm::mat4(1.0f), glm::vec3(0.0f), 0.0f})
+{
+    LOG_FUNCTION_CALL_INFO("id {}", m_id);
+}
+
+/**
+ * @brief Destroy the GEM::Renderer::FrameUniformBuffer::FrameUniformBuffer object by deleting the uniform buffer
+ */
+GEM::Renderer::FrameUniformBuffer::~FrameUniformBuffer() {
+    LOG_FUNCTION_CALL_TRACE("id {}", m_id);
+    GEM::Renderer::StateCache::deleteBuffer(m_id);
+}
+
+/**
+ * @brief Write this frame's data into the uniform buffer. This should be called once per frame, before
+ * anything reading the FrameData block is drawn
+ *
+ * @param camera The camera the frame is drawn from
+ * @param time The time in seconds the frame started at
+ */
+void GEM::Renderer::FrameUniformBuffer::update(const GEM::Camera& camera, const float time) {
+    m_frameData = {
+        camera.getViewMatrix(),
+        camera.getProjectionMatrix(),
+        camera.getViewProjectionMatrix(),
+        camera.getWorldPosition(),
+        time
+    };
+
+    GEM::Renderer::StateCache::bindBuffer(GL_UNIFORM_BUFFER, m_id);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(GEM::Renderer::FrameUniformBuffer::FrameData), &m_frameData);
+
+    // Something else may have taken the binding point since we were created
+    GEM::Renderer::StateCache::bindBufferBase(GL_UNIFORM_BUFFER, GEM::Renderer::FrameUniformBuffer::BINDING_POINT, m_id);
+}
+
+/* ------------------------------ private member functions ------------------------------ */
\ No newline at end of file
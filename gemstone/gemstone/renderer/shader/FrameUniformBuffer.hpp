@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+
+#include <glm/glm.hpp>
+
+#include "gemstone/camera/Camera.hpp"
+
+namespace GEM {
+namespace Renderer {
+    class FrameUniformBuffer;
+}
+}
+
+/**
+ * @brief A class owning the uniform buffer behind the FrameData uniform block, which holds everything that
+ * changes once per frame rather than once per draw. It is written once per frame and stays bound to a fixed
+ * binding point that every shader program's FrameData block is pointed at when it is linked
+ *
+ * The block is declared in glsl as
+ *
+ *  layout (std140) uniform FrameData {
+ *      mat4 viewMatrix;
+ *      mat4 projectionMatrix;
+ *      mat4 viewProjectionMatrix;
+ *      vec3 cameraPosition;
+ *      float time;
+ *  };
+ */
+class GEM::Renderer::FrameUniformBuffer {
+public: // public classes and enums
+    /**
+     * @brief The contents of the FrameData uniform block, laid out to match std140
+     */
+    struct FrameData {
+        glm::mat4 viewMatrix;
+        glm::mat4 projectionMatrix;
+        glm::mat4 viewProjectionMatrix;
+        glm::vec3 cameraPosition;
+        float time;
+    };
+
+public: // public static variables
+    static const std::string LOGGER_NAME;
+
+    static const std::string BLOCK_NAME;
+    static const uint32_t BINDING_POINT;
+
+public: // public member functions
+    FrameUniformBuffer();
+    ~FrameUniformBuffer();
+
+    FrameUniformBuffer(const FrameUniformBuffer& other) = delete;
+    void operator=(const FrameUniformBuffer& other) = delete;
+
+    void update(const GEM::Camera& camera, const float time);
+
+    uint32_t getID() const { return m_id; }
+    const GEM::Renderer::FrameUniformBuffer::FrameData& getFrameData() const { return m_frameData; }
+
+private: // private static functions
+    static uint32_t createUniformBuffer();
+
+private: // private member variables
+    const uint32_t m_id;
+
+    GEM::Renderer::FrameUniformBuffer::FrameData m_frameData;
+};
\ No newline at end of file
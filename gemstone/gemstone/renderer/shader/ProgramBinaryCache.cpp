@@ -0,0 +1,358 @@
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional> // std::hash
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <utility> // std::pair
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "util/io/FileSystem.hpp"
+#include "util/io/MappedFile.hpp"
+#include "util/logger/Logger.hpp"
+
+#include "gemstone/renderer/shader/logger.hpp"
+#include "gemstone/renderer/shader/ProgramBinaryCache.hpp"
+#include "gemstone/renderer/state/StateCache.hpp"
+
+// GL_ARB_get_program_binary, which glad is not generated with
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+// The header is read straight out of the mapped file, so its layout must never change without bumping the version
+static_assert(sizeof(GEM::Renderer::ProgramBinaryCache::Header) == 40, "Program binary header must be 40 bytes");
+
+/* ------------------------------ public static variables ------------------------------ */
+
+/**
+ * @brief The name of the logger the ProgramBinaryCache class uses
+ */
+const std::string GEM::Renderer::ProgramBinaryCache::LOGGER_NAME = SHADER_LOGGER_NAME;
+
+/**
+ * @brief The extension given to program binary files
+ */
+const std::string GEM::Renderer::ProgramBinaryCache::FILE_EXTENSION = "gprog";
+
+/**
+ * @brief The version of the program binary file format. Files written with any other version are ignored
+ */
+const uint32_t GEM::Renderer::ProgramBinaryCache::VERSION = 1;
+
+/* ------------------------------ private static variables ------------------------------ */
+
+/**
+ * @brief Whether or not the driver can give us program binaries and take them back
+ */
+bool GEM::Renderer::ProgramBinaryCache::supported = false;
+
+/**
+ * @brief The hash of the driver's vendor, renderer, and version strings
+ */
+size_t GEM::Renderer::ProgramBinaryCache::driverHash = 0;
+
+/**
+ * @brief The full path to the directory the program binaries are kept in
+ */
+std::string GEM::Renderer::ProgramBinaryCache::directory = GEM::util::FileSystem::getFullPath(".cache/program_binaries");
+
+/**
+ * @brief The gl functions for getting and loading program binaries, null until initialize finds them
+ */
+GEM::Renderer::ProgramBinaryCache::GetProgramBinaryFunction GEM::Renderer::ProgramBinaryCache::getProgramBinary = nullptr;
+GEM::Renderer::ProgramBinaryCache::ProgramBinaryFunction GEM::Renderer::ProgramBinaryCache::programBinary = nullptr;
+GEM::Renderer::ProgramBinaryCache::ProgramParameteriFunction GEM::Renderer::ProgramBinaryCache::programParameteri = nullptr;
+
+/* ------------------------------ public static functions ------------------------------ */
+
+/**
+ * @brief Load the program binary functions and find out if the driver can actually use them. This must be
+ * called after glad has been loaded for the current context
+ *
+ * @param loadFunction The function used to load glad, which gives the address of a gl function by name
+ */
+void GEM::Renderer::ProgramBinaryCache::initialize(GLADloadproc loadFunction) {
+    LOG_FUNCTION_CALL_INFO("gl version {}.{}", GLVersion.major, GLVersion.minor);
+
+    GEM::Renderer::ProgramBinaryCache::supported = false;
+
+    const bool isCore = GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 1);
+    if (!isCore && !GEM::Renderer::StateCache::isExtensionSupported("GL_ARB_get_program_binary")) {
+        LOG_INFO("Program binaries are not supported, shader programs will always be compiled from source");
+        return;
+    }
+
+    GEM::Renderer::ProgramBinaryCache::getProgramBinary = reinterpret_cast<GEM::Renderer::ProgramBinaryCache::GetProgramBinaryFunction>(loadFunction("glGetProgramBinary"));
+    GEM::Renderer::ProgramBinaryCache::programBinary = reinterpret_cast<GEM::Renderer::ProgramBinaryCache::ProgramBinaryFunction>(loadFunction("glProgramBinary"));
+    GEM::Renderer::ProgramBinaryCache::programParameteri = reinterpret_cast<GEM::Renderer::ProgramBinaryCache::ProgramParameteriFunction>(loadFunction("glProgramParameteri"));
+    if (!GEM::Renderer::ProgramBinaryCache::getProgramBinary || !GEM::Renderer::ProgramBinaryCache::programBinary || !GEM::Renderer::ProgramBinaryCache::programParameteri) {
+        LOG_WARNING("Could not load the program binary functions, shader programs will always be compiled from source");
+        return;
+    }
+
+    // Some drivers expose the functions but have no formats to give us binaries in
+    int32_t binaryFormatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormatCount);
+    if (binaryFormatCount <= 0) {
+        LOG_INFO("The driver has no program binary formats, shader programs will always be compiled from source");
+        return;
+    }
+
+    GEM::Renderer::ProgramBinaryCache::driverHash = GEM::Renderer::ProgramBinaryCache::createDriverHash();
+    GEM::Renderer::ProgramBinaryCache::supported = true;
+
+    LOG_DEBUG("Program binaries are supported with {} formats, caching them in {}", binaryFormatCount, GEM::Renderer::ProgramBinaryCache::directory);
+}
+
+/**
+ * @brief Set the directory the program binaries are kept in. It is created when the first binary is saved
+ *
+ * @param cacheDirectory The full path to the directory
+ */
+void GEM::Renderer::ProgramBinaryCache::setDirectory(const std::string& cacheDirectory) {
+    LOG_FUNCTION_CALL_INFO("directory {}", cacheDirectory);
+    GEM::Renderer::ProgramBinaryCache::directory = cacheDirectory;
+}
+
+/**
+ * @brief Try to create a shader program from a binary saved on a previous run. Shader programs loaded this way
+ * are already linked, and never see their sources compiled
+ *
+ * @param sourceHashes The hashes of the vertex and fragment shader sources
+ * @return uint32_t The id of the linked shader program, 0 if there was no usable binary for the sources
+ */
+uint32_t GEM::Renderer::ProgramBinaryCache::loadProgram(const std::pair<size_t, size_t>& sourceHashes) {
+    LOG_FUNCTION_ENTRY_TRACE("vertex hash {} , fragment hash {}", sourceHashes.first, sourceHashes.second);
+
+    if (!GEM::Renderer::ProgramBinaryCache::supported) {
+        return 0;
+    }
+
+    const std::string filename = GEM::Renderer::ProgramBinaryCache::getFilename(sourceHashes);
+    if (!GEM::util::FileSystem::fileExists(filename)) {
+        LOG_DEBUG("No program binary at {}", filename);
+        return 0;
+    }
+
+    uint32_t shaderProgramID = 0;
+    try {
+        const GEM::util::MappedFile file(filename);
+        const GEM::Renderer::ProgramBinaryCache::Header* p_header = GEM::Renderer::ProgramBinaryCache::validateHeader(file, sourceHashes);
+        if (!p_header) {
+            GEM::Renderer::ProgramBinaryCache::removeFile(filename);
+            return 0;
+        }
+
+        shaderProgramID = glCreateProgram();
+        GEM::Renderer::ProgramBinaryCache::programBinary(
+            shaderProgramID,
+            p_header->binaryFormat,
+            file.getData() + sizeof(GEM::Renderer::ProgramBinaryCache::Header),
+            static_cast<GLsizei>(p_header->binarySizeBytes)
+        );
+    } catch (const std::exception& ex) {
+        LOG_WARNING("Failed to read program binary at {} : {}", filename, ex.what());
+        return 0;
+    }
+
+    // The driver is allowed to turn down any binary, such as one from before it was updated, in which case
+    // the shader program is left unlinked
+    int shaderProgramLinkSuccess;
+    glGetProgramiv(shaderProgramID, GL_LINK_STATUS, &shaderProgramLinkSuccess);
+    if (!shaderProgramLinkSuccess) {
+        LOG_WARNING("The driver rejected the program binary at {}", filename);
+        glDeleteProgram(shaderProgramID);
+        GEM::Renderer::ProgramBinaryCache::removeFile(filename);
+        return 0;
+    }
+
+    LOG_DEBUG("Loaded shader program with id {} from program binary at {}", shaderProgramID, filename);
+
+    return shaderProgramID;
+}
+
+/**
+ * @brief Tell the driver we are going to ask for a shader program's binary. This must be called before the
+ * shader program is linked
+ *
+ * @param shaderProgramID The id of the shader program which is about to be linked
+ */
+void GEM::Renderer::ProgramBinaryCache::prepareProgram(const uint32_t shaderProgramID) {
+    LOG_FUNCTION_ENTRY_TRACE("shader program id {}", shaderProgramID);
+
+    if (!GEM::Renderer::ProgramBinaryCache::supported) {
+        return;
+    }
+
+    GEM::Renderer::ProgramBinaryCache::programParameteri(shaderProgramID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+/**
+ * @brief Save a linked shader program's binary so the next run can load it instead of compiling the sources.
+ * Failing to save is not an error, the shader program is just compiled again next time
+ *
+ * @param sourceHashes The hashes of the vertex and fragment shader sources the shader program was built from
+ * @param shaderProgramID The id of the linked shader program
+ */
+void GEM::Renderer::ProgramBinaryCache::saveProgram(const std::pair<size_t, size_t>& sourceHashes, const uint32_t shaderProgramID) {
+    LOG_FUNCTION_ENTRY_TRACE("vertex hash {} , fragment hash {} , shader program id {}", sourceHashes.first, sourceHashes.second, shaderProgramID);
+
+    if (!GEM::Renderer::ProgramBinaryCache::supported) {
+        return;
+    }
+
+    int32_t binarySizeBytes = 0;
+    glGetProgramiv(shaderProgramID, GL_PROGRAM_BINARY_LENGTH, &binarySizeBytes);
+    if (binarySizeBytes <= 0) {
+        LOG_WARNING("The driver gave no program binary for shader program with id {}", shaderProgramID);
+        return;
+    }
+
+    std::vector<char> binary(binarySizeBytes);
+    GEM::Renderer::ProgramBinaryCache::Header header;
+    std::memcpy(header.magic, "GPRG", 4);
+    header.version = GEM::Renderer::ProgramBinaryCache::VERSION;
+    header.vertexSourceHash = sourceHashes.first;
+    header.fragmentSourceHash = sourceHashes.second;
+    header.driverHash = GEM::Renderer::ProgramBinaryCache::driverHash;
+    header.binaryFormat = GL_NONE;
+
+    int32_t writtenSizeBytes = 0;
+    GEM::Renderer::ProgramBinaryCache::getProgramBinary(shaderProgramID, binarySizeBytes, &writtenSizeBytes, &header.binaryFormat, binary.data());
+    header.binarySizeBytes = static_cast<uint32_t>(writtenSizeBytes);
+
+    std::error_code errorCode;
+    std::filesystem::create_directories(GEM::Renderer::ProgramBinaryCache::directory, errorCode);
+    if (errorCode) {
+        LOG_WARNING("Failed to create the program binary directory {} : {}", GEM::Renderer::ProgramBinaryCache::directory, errorCode.message());
+        return;
+    }
+
+    // Write next to the real file then move it over, so another run never sees half of a binary
+    const std::string filename = GEM::Renderer::ProgramBinaryCache::getFilename(sourceHashes);
+    const std::string temporaryFilename = filename + ".tmp";
+    {
+        std::ofstream file(temporaryFilename, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), header.binarySizeBytes);
+        if (!file) {
+            LOG_WARNING("Failed to write program binary to {}", temporaryFilename);
+            file.close();
+            GEM::Renderer::ProgramBinaryCache::removeFile(temporaryFilename);
+            return;
+        }
+    }
+
+    std::filesystem::rename(temporaryFilename, filename, errorCode);
+    if (errorCode) {
+        LOG_WARNING("Failed to move program binary to {} : {}", filename, errorCode.message());
+        GEM::Renderer::ProgramBinaryCache::removeFile(temporaryFilename);
+        return;
+    }
+
+    LOG_DEBUG("Saved {} byte program binary of shader program with id {} to {}", header.binarySizeBytes, shaderProgramID, filename);
+}
+
+/* ------------------------------ private static functions ------------------------------ */
+
+/**
+ * @brief Hash the strings identifying the driver. A binary saved with one driver can't be given to another,
+ * or to the same one after it is updated, so this goes into the key of every file
+ *
+ * @return size_t The hash of the driver's vendor, renderer, and version strings
+ */
+size_t GEM::Renderer::ProgramBinaryCache::createDriverHash() {
+    const auto getString = [](const GLenum name) {
+        const char* p_string = reinterpret_cast<const char*>(glGetString(name));
+        return std::string(p_string ? p_string : "");
+    };
+
+    const std::string driverString = getString(GL_VENDOR) + "\n" + getString(GL_RENDERER) + "\n" + getString(GL_VERSION);
+    LOG_TRACE("Driver is {}", driverString);
+
+    return std::hash<std::string>{}(driverString);
+}
+
+/**
+ * @brief Get the full path to the file a shader program's binary is kept in
+ *
+ * @param sourceHashes The hashes of the vertex and fragment shader sources
+ * @return std::string The full path to the file
+ */
+std::string GEM::Renderer::ProgramBinaryCache::getFilename(const std::pair<size_t, size_t>& sourceHashes) {
+    std::ostringstream filename;
+    filename << GEM::Renderer::ProgramBinaryCache::directory << "/" << std::hex << std::setfill('0')
+        << std::setw(16) << sourceHashes.first << "_"
+        << std::setw(16) << sourceHashes.second << "_"
+        << std::setw(16) << GEM::Renderer::ProgramBinaryCache::driverHash
+        << "." << GEM::Renderer::ProgramBinaryCache::FILE_EXTENSION;
+    return filename.str();
+}
+
+/**
+ * @brief Make sure the mapped file is a program binary we wrote for these sources with this driver, and that
+ * the whole binary is actually in the file
+ *
+ * @param file The mapped program binary file
+ * @param sourceHashes The hashes of the vertex and fragment shader sources
+ * @return const GEM::Renderer::ProgramBinaryCache::Header* The header at the start of the file, nullptr if the
+ * file can't be used
+ */
+const GEM::Renderer::ProgramBinaryCache::Header* GEM::Renderer::ProgramBinaryCache::validateHeader(const GEM::util::MappedFile& file, const std::pair<size_t, size_t>& sourceHashes) {
+    LOG_FUNCTION_ENTRY_TRACE("filename {} , size {}", file.getFilename(), file.getSize());
+
+    const auto fail = [&file](const std::string& reason) -> const GEM::Renderer::ProgramBinaryCache::Header* {
+        LOG_WARNING("Ignoring program binary {} : {}", file.getFilename(), reason);
+        return nullptr;
+    };
+
+    if (file.getSize() < sizeof(GEM::Renderer::ProgramBinaryCache::Header)) {
+        return fail("file is smaller than the header");
+    }
+
+    const GEM::Renderer::ProgramBinaryCache::Header* p_header = reinterpret_cast<const GEM::Renderer::ProgramBinaryCache::Header*>(file.getData());
+    if (std::memcmp(p_header->magic, "GPRG", 4) != 0) {
+        return fail("bad magic");
+    }
+    if (p_header->version != GEM::Renderer::ProgramBinaryCache::VERSION) {
+        return fail("version " + std::to_string(p_header->version) + " , expected " + std::to_string(GEM::Renderer::ProgramBinaryCache::VERSION));
+    }
+    if (p_header->vertexSourceHash != sourceHashes.first || p_header->fragmentSourceHash != sourceHashes.second) {
+        return fail("it was saved for other sources");
+    }
+    if (p_header->driverHash != GEM::Renderer::ProgramBinaryCache::driverHash) {
+        return fail("it was saved with another driver");
+    }
+    if (p_header->binarySizeBytes == 0 || p_header->binarySizeBytes != file.getSize() - sizeof(GEM::Renderer::ProgramBinaryCache::Header)) {
+        return fail("binary size does not match the file size");
+    }
+
+    return p_header;
+}
+
+/**
+ * @brief Remove a file from the cache, ignoring any failure since the file is rewritten either way
+ *
+ * @param filename The full path to the file
+ */
+void GEM::Renderer::ProgramBinaryCache::removeFile(const std::string& filename) {
+    LOG_FUNCTION_ENTRY_TRACE("filename {}", filename);
+
+    std::error_code errorCode;
+    std::filesystem::remove(filename, errorCode);
+}
+
+/* ------------------------------ public member functions ------------------------------ */
+
+/* ------------------------------ private member functions ------------------------------ */
\ No newline at end of file
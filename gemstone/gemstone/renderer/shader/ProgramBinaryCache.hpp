@@ -0,0 +1,79 @@
+#pragma once
+
+#include <string>
+#include <utility> // std::pair
+
+#include <glad/glad.h>
+
+#include "util/io/MappedFile.hpp"
+
+namespace GEM {
+namespace Renderer {
+    class ProgramBinaryCache;
+}
+}
+
+/**
+ * @brief A cache on disk of linked shader programs, so a shader program linked on one run can be loaded
+ * straight from the driver's binary on the next instead of compiling and linking its sources again. Each file
+ * is keyed by the hashes of the vertex and fragment shader sources plus a hash of the driver's vendor,
+ * renderer, and version strings, since a binary is only good for the driver that produced it
+ *
+ * Each file is a header followed by the binary gl gave us. Anything wrong with a file, including the driver
+ * refusing the binary, is treated as a miss and the file is removed so it is written again
+ *
+ * @note Program binaries are not part of gl 3.3, so the functions are loaded here when the context is 4.1 or
+ * higher or has GL_ARB_get_program_binary. Without them, or when the driver has no binary formats, nothing is
+ * ever loaded or saved and every shader program is compiled from source as before
+ */
+class GEM::Renderer::ProgramBinaryCache {
+public: // public classes and enums
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint64_t vertexSourceHash;
+        uint64_t fragmentSourceHash;
+        uint64_t driverHash;
+        uint32_t binaryFormat;
+        uint32_t binarySizeBytes;
+    };
+
+public: // public static variables
+    static const std::string LOGGER_NAME;
+    static const std::string FILE_EXTENSION;
+    static const uint32_t VERSION;
+
+public: // public static functions
+    static void initialize(GLADloadproc loadFunction);
+    static void setDirectory(const std::string& cacheDirectory);
+
+    static bool isSupported() { return supported; }
+    static const std::string& getDirectory() { return directory; }
+
+    static uint32_t loadProgram(const std::pair<size_t, size_t>& sourceHashes);
+    static void prepareProgram(const uint32_t shaderProgramID);
+    static void saveProgram(const std::pair<size_t, size_t>& sourceHashes, const uint32_t shaderProgramID);
+
+public: // public member functions
+    ProgramBinaryCache() = delete;
+
+private: // private classes and enums
+    typedef void (APIENTRYP GetProgramBinaryFunction)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+    typedef void (APIENTRYP ProgramBinaryFunction)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+    typedef void (APIENTRYP ProgramParameteriFunction)(GLuint program, GLenum pname, GLint value);
+
+private: // private static functions
+    static size_t createDriverHash();
+    static std::string getFilename(const std::pair<size_t, size_t>& sourceHashes);
+    static const GEM::Renderer::ProgramBinaryCache::Header* validateHeader(const GEM::util::MappedFile& file, const std::pair<size_t, size_t>& sourceHashes);
+    static void removeFile(const std::string& filename);
+
+private: // private static variables
+    static bool supported;
+    static size_t driverHash;
+    static std::string directory;
+
+    static GEM::Renderer::ProgramBinaryCache::GetProgramBinaryFunction getProgramBinary;
+    static GEM::Renderer::ProgramBinaryCache::ProgramBinaryFunction programBinary;
+    static GEM::Renderer::ProgramBinaryCache::ProgramParameteriFunction programParameteri;
+};
\ No newline at end of file
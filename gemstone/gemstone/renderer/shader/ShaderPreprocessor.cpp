@@ -0,0 +1,213 @@
+#include <algorithm>
+#include <exception>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility> // std::pair
+#include <vector>
+
+#include "util/logger/Logger.hpp"
+
+#include "gemstone/renderer/shader/logger.hpp"
+#include "gemstone/renderer/shader/CompiledShader.hpp"
+#include "gemstone/renderer/shader/ShaderPreprocessor.hpp"
+
+/* ------------------------------ public static variables ------------------------------ */
+
+/**
+ * @brief The name of the logger the ShaderPreprocessor class uses
+ */
+const std::string GEM::Renderer::ShaderPreprocessor::LOGGER_NAME = SHADER_LOGGER_NAME;
+
+/* ------------------------------ private static variables ------------------------------ */
+
+/**
+ * @brief The sources which can be included, by the name they are included with
+ */
+std::map<std::string, std::string> GEM::Renderer::ShaderPreprocessor::includeSources;
+
+/**
+ * @brief Every variant which has been asked for, so asking again gives back the same source
+ */
+std::map<std::pair<size_t, std::string>, std::string> GEM::Renderer::ShaderPreprocessor::variants;
+
+/* ------------------------------ public static functions ------------------------------ */
+
+/**
+ * @brief Add a source which shaders can include with #include "name". Adding a source under a name which
+ * already has one replaces it for every variant made afterwards
+ *
+ * @param name The name the source is included with
+ * @param source The source, which must not have a #version directive
+ */
+void GEM::Renderer::ShaderPreprocessor::addIncludeSource(const std::string& name, const char* source) {
+    LOG_FUNCTION_CALL_INFO("name {}", name);
+
+    if (!source) {
+        const std::string errorMessage = "Include source " + name + " is null";
+        LOG_CRITICAL(errorMessage);
+        throw std::invalid_argument(errorMessage);
+    }
+
+    GEM::Renderer::ShaderPreprocessor::includeSources[name] = source;
+}
+
+/**
+ * @brief Get the variant of a shader source specialized with the given keywords, expanding it the first time
+ * it is asked for
+ *
+ * @param shaderSource The unexpanded source of the shader
+ * @param keywords The keywords to define, each of which must be declared with #pragma keywords in the source
+ * or something it includes. The order doesn't matter
+ * @return const char* The expanded source of the variant, which lives for the rest of the program
+ */
+const char* GEM::Renderer::ShaderPreprocessor::getVariant(const char* shaderSource, const std::vector<std::string>& keywords) {
+    LOG_FUNCTION_ENTRY_TRACE("{} keywords", keywords.size());
+
+    // Sort the keywords so the same set of them always makes the same variant
+    const std::set<std::string> sortedKeywords(keywords.begin(), keywords.end());
+    std::string keywordString;
+    for (const std::string& keyword : sortedKeywords) {
+        keywordString += keywordString.empty() ? keyword : " " + keyword;
+    }
+
+    const std::pair<size_t, std::string> variantKey = {GEM::Renderer::CompiledShader::getHashFromShaderSource(shaderSource), keywordString};
+    const std::map<std::pair<size_t, std::string>, std::string>::const_iterator variantIterator = GEM::Renderer::ShaderPreprocessor::variants.find(variantKey);
+    if (variantIterator != GEM::Renderer::ShaderPreprocessor::variants.end()) {
+        LOG_TRACE("Variant with keywords [{}] of source with hash {} already exists", keywordString, variantKey.first);
+        return variantIterator->second.c_str();
+    }
+
+    std::vector<std::string> includeStack;
+    std::set<std::string> includedNames;
+    std::set<std::string> declaredKeywords;
+    std::string versionLine;
+    std::string expandedSource;
+    GEM::Renderer::ShaderPreprocessor::expandSource(shaderSource, "shader source", includeStack, includedNames, declaredKeywords, versionLine, expandedSource);
+
+    std::string variantSource = versionLine;
+    for (const std::string& keyword : sortedKeywords) {
+        if (declaredKeywords.find(keyword) == declaredKeywords.end()) {
+            const std::string errorMessage = "Keyword " + keyword + " is not declared by the shader source or anything it includes";
+            LOG_CRITICAL(errorMessage);
+            throw std::invalid_argument(errorMessage);
+        }
+
+        variantSource += "#define " + keyword + "\n";
+    }
+    variantSource += expandedSource;
+
+    LOG_DEBUG("Created variant with keywords [{}] of source with hash {} , including {} sources", keywordString, variantKey.first, includedNames.size());
+
+    return GEM::Renderer::ShaderPreprocessor::variants.emplace(variantKey, std::move(variantSource)).first->second.c_str();
+}
+
+/* ------------------------------ private static functions ------------------------------ */
+
+/**
+ * @brief Get the name of the preprocessor directive on a line
+ *
+ * @param line The line of source
+ * @param arguments Set to everything after the directive's name, without the whitespace around it
+ * @return std::string The name of the directive, empty if the line isn't a directive
+ */
+std::string GEM::Renderer::ShaderPreprocessor::getDirective(const std::string& line, std::string& arguments) {
+    const std::string whitespace = " \t\r";
+
+    const size_t hashPosition = line.find_first_not_of(whitespace);
+    if (hashPosition == std::string::npos || line[hashPosition] != '#') {
+        return "";
+    }
+
+    const size_t nameStart = line.find_first_not_of(whitespace, hashPosition + 1);
+    if (nameStart == std::string::npos) {
+        return "";
+    }
+
+    const size_t nameEnd = std::min(line.find_first_of(whitespace, nameStart), line.size());
+    const size_t argumentsStart = line.find_first_not_of(whitespace, nameEnd);
+    const size_t argumentsEnd = line.find_last_not_of(whitespace);
+    arguments = argumentsStart == std::string::npos ? "" : line.substr(argumentsStart, argumentsEnd - argumentsStart + 1);
+
+    return line.substr(nameStart, nameEnd - nameStart);
+}
+
+/**
+ * @brief Expand the includes of a source and collect the keywords it declares, recursing into each source it
+ * includes
+ *
+ * @param source The source to expand
+ * @param sourceName The name of the source, for error messages
+ * @param includeStack The names of the sources currently being included, to catch includes which loop
+ * @param includedNames The names of every source included so far, so each is included once
+ * @param declaredKeywords Filled with the keywords declared with #pragma keywords
+ * @param versionLine Set to the #version directive of the top level source, which the defines go after
+ * @param expandedSource Filled with the expanded source, without the #version directive
+ */
+void GEM::Renderer::ShaderPreprocessor::expandSource(
+    const std::string& source,
+    const std::string& sourceName,
+    std::vector<std::string>& includeStack,
+    std::set<std::string>& includedNames,
+    std::set<std::string>& declaredKeywords,
+    std::string& versionLine,
+    std::string& expandedSource
+) {
+    LOG_FUNCTION_ENTRY_TRACE("source name {} , include depth {}", sourceName, includeStack.size());
+
+    std::istringstream sourceStream(source);
+    std::string line;
+    while (std::getline(sourceStream, line)) {
+        std::string arguments;
+        const std::string directive = GEM::Renderer::ShaderPreprocessor::getDirective(line, arguments);
+
+        if (directive == "version") {
+            if (!includeStack.empty() || !versionLine.empty()) {
+                const std::string errorMessage = "Unexpected #version directive in " + sourceName + ", only the top level source may have one";
+                LOG_CRITICAL(errorMessage);
+                throw std::invalid_argument(errorMessage);
+            }
+
+            versionLine = line + "\n";
+        } else if (directive == "include") {
+            if (arguments.size() < 2 || arguments.front() != '"' || arguments.back() != '"') {
+                const std::string errorMessage = "Malformed #include directive in " + sourceName + " : " + line;
+                LOG_CRITICAL(errorMessage);
+                throw std::invalid_argument(errorMessage);
+            }
+
+            const std::string includeName = arguments.substr(1, arguments.size() - 2);
+            if (std::find(includeStack.begin(), includeStack.end(), includeName) != includeStack.end()) {
+                const std::string errorMessage = "Include of " + includeName + " in " + sourceName + " includes itself";
+                LOG_CRITICAL(errorMessage);
+                throw std::invalid_argument(errorMessage);
+            }
+
+            if (!includedNames.insert(includeName).second) {
+                LOG_TRACE("{} was already included, skipping it in {}", includeName, sourceName);
+                continue;
+            }
+
+            const std::map<std::string, std::string>::const_iterator includeIterator = GEM::Renderer::ShaderPreprocessor::includeSources.find(includeName);
+            if (includeIterator == GEM::Renderer::ShaderPreprocessor::includeSources.end()) {
+                const std::string errorMessage = "No include source named " + includeName + " for " + sourceName;
+                LOG_CRITICAL(errorMessage);
+                throw std::invalid_argument(errorMessage);
+            }
+
+            includeStack.push_back(includeName);
+            GEM::Renderer::ShaderPreprocessor::expandSource(includeIterator->second, includeName, includeStack, includedNames, declaredKeywords, versionLine, expandedSource);
+            includeStack.pop_back();
+        } else if (directive == "pragma" && arguments.compare(0, 8, "keywords") == 0 && (arguments.size() == 8 || arguments[8] == ' ' || arguments[8] == '\t')) {
+            std::istringstream keywordStream(arguments.substr(8));
+            std::string keyword;
+            while (keywordStream >> keyword) {
+                declaredKeywords.insert(keyword);
+            }
+        } else {
+            expandedSource += line + "\n";
+        }
+    }
+}
\ No newline at end of file
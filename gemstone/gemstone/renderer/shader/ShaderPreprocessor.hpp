@@ -0,0 +1,61 @@
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+#include <utility> // std::pair
+#include <vector>
+
+namespace GEM {
+namespace Renderer {
+    class ShaderPreprocessor;
+}
+}
+
+/**
+ * @brief A class that expands glsl sources before they are compiled, so one shader source can be specialized
+ * into many variants instead of being copied by hand
+ *
+ * Two directives are handled here, everything else is left for the driver
+ *  - #include "name" is replaced with the source added under that name with addIncludeSource. Each source is
+ *    only ever included once per variant, and included sources may include others
+ *  - #pragma keywords NAME ... declares the keywords a source can be specialized with. Asking for a variant
+ *    with a keyword nobody declared is an error, so a typo can't silently produce the unspecialized shader
+ *
+ * A variant has a #define for each of its keywords placed right after the #version directive, so the source
+ * can pick between code paths with #ifdef instead of branching on a uniform at runtime. Variants are kept for
+ * the life of the program, so the source given back can be handed to the shader classes, whose maps are keyed
+ * on the hash of the source and so share the compiled shader between everyone asking for the same variant
+ *
+ * @note Includes are expanded whether or not they are inside a disabled #ifdef, and the line numbers in
+ * compile errors are for the expanded source
+ */
+class GEM::Renderer::ShaderPreprocessor {
+public: // public static variables
+    static const std::string LOGGER_NAME;
+
+public: // public static functions
+    static void addIncludeSource(const std::string& name, const char* source);
+    static const char* getVariant(const char* shaderSource, const std::vector<std::string>& keywords = {});
+
+public: // public member functions
+    ShaderPreprocessor() = delete;
+
+private: // private static functions
+    static std::string getDirective(const std::string& line, std::string& arguments);
+    static void expandSource(
+        const std::string& source,
+        const std::string& sourceName,
+        std::vector<std::string>& includeStack,
+        std::set<std::string>& includedNames,
+        std::set<std::string>& declaredKeywords,
+        std::string& versionLine,
+        std::string& expandedSource
+    );
+
+private: // private static variables
+    static std::map<std::string, std::string> includeSources;
+
+    // Keyed by the hash of the unexpanded source and its sorted keywords joined by spaces
+    static std::map<std::pair<size_t, std::string>, std::string> variants;
+};
\ No newline at end of file
@@ -1,5 +1,13 @@
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <functional> // std::hash
+#include <memory>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include <glad/glad.h>
 
@@ -9,11 +17,19 @@
 #include "util/macros.hpp"
 #include "util/logger/Logger.hpp"
 
+#include "gemstone/renderer/state/StateCache.hpp"
 #include "gemstone/renderer/texture/Texture.hpp"
 #include "gemstone/renderer/shader/logger.hpp"
 #include "gemstone/renderer/shader/CompiledShader.hpp"
+#include "gemstone/renderer/shader/FrameUniformBuffer.hpp"
+#include "gemstone/renderer/shader/ProgramBinaryCache.hpp"
 #include "gemstone/renderer/shader/ShaderProgram.hpp"
 
+// GL_KHR_parallel_shader_compile, which glad is not generated with. GL_ARB_parallel_shader_compile uses the same value
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
 /* ------------------------------ public static variables ------------------------------ */
 
 /**
@@ -21,40 +37,131 @@
  */
 const std::string GEM::Renderer::ShaderProgram::LOGGER_NAME = SHADER_LOGGER_NAME;
 
+/**
+ * @brief How long to poll the driver for link completion before giving up and waiting on each shader
+ * program's link status in turn, in case the driver never reports completion
+ */
+const uint32_t GEM::Renderer::ShaderProgram::LINK_POLL_TIMEOUT_MILLISECONDS = 5000;
+
 /* ------------------------------ private static variables ------------------------------ */
 
 /**
- * @brief A map of vertex and fragment shader IDs to linked shader programs
+ * @brief A map of the hashes of vertex and fragment shader sources to linked shader programs
  */
-std::map<std::pair<uint32_t, uint32_t>, GEM::Renderer::ShaderProgram::Info> GEM::Renderer::ShaderProgram::shaderProgramIDMap;
+std::map<std::pair<size_t, size_t>, GEM::Renderer::ShaderProgram::Info> GEM::Renderer::ShaderProgram::shaderProgramIDMap;
 
 /* ------------------------------ public static functions ------------------------------ */
 
+/**
+ * @brief Create many shader programs at once. Every compile is handed to the driver, then every link, and only
+ * after that do we wait on any of them, so the driver can work on all of them together rather than finishing
+ * each before it sees the next. With GL_KHR_parallel_shader_compile the driver spreads them over its compiler
+ * threads and we poll for completion instead of blocking on the first status query
+ * 
+ * @note This function will throw an exception if any of the shaders fail to compile or link, in which case
+ * none of the shader programs are kept
+ * 
+ * @param shaderSources The vertex and fragment shader sources of each shader program
+ * @return std::vector<std::shared_ptr<GEM::Renderer::ShaderProgram>> The shader programs, in the same order as
+ * their sources
+ */
+std::vector<std::shared_ptr<GEM::Renderer::ShaderProgram>> GEM::Renderer::ShaderProgram::createPtrs(const std::vector<std::pair<const char*, const char*>>& shaderSources) {
+    LOG_FUNCTION_CALL_INFO("{} shader programs", shaderSources.size());
+
+    // The batch holds a use of every shader program it adds to the map until they have all been handed out
+    std::vector<std::pair<size_t, size_t>> createdSourceHashes;
+    std::vector<GEM::Renderer::ShaderProgram::PendingLink> pendingLinks;
+    try {
+        for (const std::pair<const char*, const char*>& shaderSource : shaderSources) {
+            const std::pair<size_t, size_t> sourceHashes = {
+                GEM::Renderer::CompiledShader::getHashFromShaderSource(shaderSource.first),
+                GEM::Renderer::CompiledShader::getHashFromShaderSource(shaderSource.second)
+            };
+
+            const bool isPending = std::any_of(pendingLinks.begin(), pendingLinks.end(), [&sourceHashes](const GEM::Renderer::ShaderProgram::PendingLink& pendingLink) {
+                return pendingLink.sourceHashes == sourceHashes;
+            });
+            if (isPending || GEM::Renderer::ShaderProgram::shaderProgramIsLinked(sourceHashes)) {
+                continue;
+            }
+
+            const uint32_t shaderProgramID = GEM::Renderer::ProgramBinaryCache::loadProgram(sourceHashes);
+            if (shaderProgramID != 0) {
+                GEM::Renderer::ShaderProgram::addLinkedShaderProgram(sourceHashes, shaderProgramID);
+                createdSourceHashes.push_back(sourceHashes);
+                continue;
+            }
+
+            pendingLinks.push_back(GEM::Renderer::ShaderProgram::submitShaders(shaderSource.first, shaderSource.second, sourceHashes));
+        }
+
+        for (GEM::Renderer::ShaderProgram::PendingLink& pendingLink : pendingLinks) {
+            GEM::Renderer::ShaderProgram::submitLink(pendingLink);
+        }
+
+        GEM::Renderer::ShaderProgram::waitForLinks(pendingLinks);
+
+        for (GEM::Renderer::ShaderProgram::PendingLink& pendingLink : pendingLinks) {
+            GEM::Renderer::ShaderProgram::finishLink(pendingLink);
+            GEM::Renderer::ShaderProgram::addLinkedShaderProgram(pendingLink.sourceHashes, pendingLink.id);
+            createdSourceHashes.push_back(pendingLink.sourceHashes);
+
+            // The map owns the shader program now
+            pendingLink.id = 0;
+        }
+    } catch (const std::exception&) {
+        for (const GEM::Renderer::ShaderProgram::PendingLink& pendingLink : pendingLinks) {
+            if (pendingLink.id != 0) {
+                GEM::Renderer::StateCache::deleteProgram(pendingLink.id);
+            }
+        }
+        for (const std::pair<size_t, size_t>& sourceHashes : createdSourceHashes) {
+            GEM::Renderer::ShaderProgram::decrementShaderProgramUseCount(sourceHashes);
+        }
+        throw;
+    }
+
+    // Everything is linked now, so each of these just finds its shader program in the map
+    std::vector<std::shared_ptr<GEM::Renderer::ShaderProgram>> shaderProgramPtrs;
+    shaderProgramPtrs.reserve(shaderSources.size());
+    for (const std::pair<const char*, const char*>& shaderSource : shaderSources) {
+        shaderProgramPtrs.push_back(std::make_shared<GEM::Renderer::ShaderProgram>(shaderSource.first, shaderSource.second));
+    }
+
+    for (const std::pair<size_t, size_t>& sourceHashes : createdSourceHashes) {
+        GEM::Renderer::ShaderProgram::decrementShaderProgramUseCount(sourceHashes);
+    }
+
+    LOG_DEBUG("Created {} shader programs , {} linked from source", shaderProgramPtrs.size(), pendingLinks.size());
+
+    return shaderProgramPtrs;
+}
+
 /* ------------------------------ private static functions ------------------------------ */
 
 /**
  * @brief Add a newly linked shader program to the map for it to be found in the future
  * 
- * @param compiledIDs The ids of the compiled shaders
+ * @param sourceHashes The hashes of the vertex and fragment shader sources
  * @param shaderProgramID The id of the linked shader program
  */
-void GEM::Renderer::ShaderProgram::addShaderProgramToMap(const std::pair<uint32_t, uint32_t>& compiledIDs, const uint32_t shaderProgramID) {
-    LOG_FUNCTION_ENTRY_TRACE("vertex id {} , fragment id {} , shader program id {}", compiledIDs.first, compiledIDs.second, shaderProgramID);
+void GEM::Renderer::ShaderProgram::addShaderProgramToMap(const std::pair<size_t, size_t>& sourceHashes, const uint32_t shaderProgramID) {
+    LOG_FUNCTION_ENTRY_TRACE("vertex hash {} , fragment hash {} , shader program id {}", sourceHashes.first, sourceHashes.second, shaderProgramID);
 
-    GEM::Renderer::ShaderProgram::shaderProgramIDMap.insert({compiledIDs, {shaderProgramID, 0}});
+    GEM::Renderer::ShaderProgram::shaderProgramIDMap.insert({sourceHashes, {shaderProgramID, 0}});
 
-    GEM::Renderer::ShaderProgram::incrementShaderProgramUseCount(compiledIDs);
+    GEM::Renderer::ShaderProgram::incrementShaderProgramUseCount(sourceHashes);
 }
 
 /**
  * @brief Increment the use count for a given linked shader program so we know how many things are using it
  * 
- * @param compiledIDs The ids of the compiled shaders
+ * @param sourceHashes The hashes of the vertex and fragment shader sources
  */
-void GEM::Renderer::ShaderProgram::incrementShaderProgramUseCount(const std::pair<uint32_t, uint32_t>& compiledIDs) {
-    LOG_FUNCTION_ENTRY_TRACE("vertex id {} , fragment id {}", compiledIDs.first, compiledIDs.second);
+void GEM::Renderer::ShaderProgram::incrementShaderProgramUseCount(const std::pair<size_t, size_t>& sourceHashes) {
+    LOG_FUNCTION_ENTRY_TRACE("vertex hash {} , fragment hash {}", sourceHashes.first, sourceHashes.second);
 
-    GEM::Renderer::ShaderProgram::Info info = GEM::Renderer::ShaderProgram::shaderProgramIDMap[compiledIDs];
+    GEM::Renderer::ShaderProgram::Info info = GEM::Renderer::ShaderProgram::shaderProgramIDMap[sourceHashes];
 
     LOG_TRACE("Use count for shader program with id {} was: {}", info.id, info.useCount);
 
@@ -62,7 +169,7 @@ void GEM::Renderer::ShaderProgram::incrementShaderProgramUseCount(const std::pai
 
     LOG_TRACE("Use count for shader program with id {} is now: {}", info.id, info.useCount);
 
-    GEM::Renderer::ShaderProgram::shaderProgramIDMap[compiledIDs] = info;
+    GEM::Renderer::ShaderProgram::shaderProgramIDMap[sourceHashes] = info;
 }
 
 /**
@@ -70,12 +177,12 @@ void GEM::Renderer::ShaderProgram::incrementShaderProgramUseCount(const std::pai
  * use count hits 0 or below we will remove the linked shader program from the map and delete it because nothing
  * cares about it anymore
  * 
- * @param compiledIDs The ids of the compiled shaders
+ * @param sourceHashes The hashes of the vertex and fragment shader sources
  */
-void GEM::Renderer::ShaderProgram::decrementShaderProgramUseCount(const std::pair<uint32_t, uint32_t>& compiledIDs) {
-    LOG_FUNCTION_ENTRY_TRACE("vertex id {} , fragment id {}", compiledIDs.first, compiledIDs.second);
+void GEM::Renderer::ShaderProgram::decrementShaderProgramUseCount(const std::pair<size_t, size_t>& sourceHashes) {
+    LOG_FUNCTION_ENTRY_TRACE("vertex hash {} , fragment hash {}", sourceHashes.first, sourceHashes.second);
 
-    GEM::Renderer::ShaderProgram::Info info = GEM::Renderer::ShaderProgram::shaderProgramIDMap[compiledIDs];
+    GEM::Renderer::ShaderProgram::Info info = GEM::Renderer::ShaderProgram::shaderProgramIDMap[sourceHashes];
 
     LOG_TRACE("Use count for shader program with id {} was: {}", info.id, info.useCount);
 
@@ -86,46 +193,46 @@ void GEM::Renderer::ShaderProgram::decrementShaderProgramUseCount(const std::pai
     // If the shader is still in use then update the use count
     if (info.useCount > 0) {
         LOG_TRACE("Updating use count for shader program with id {}", info.id);
-        GEM::Renderer::ShaderProgram::shaderProgramIDMap[compiledIDs] = info;
+        GEM::Renderer::ShaderProgram::shaderProgramIDMap[sourceHashes] = info;
         return;
     }
 
     LOG_TRACE("Erasing shader program with id {} from map", info.id);
-    GEM::Renderer::ShaderProgram::shaderProgramIDMap.erase(compiledIDs);
+    GEM::Renderer::ShaderProgram::shaderProgramIDMap.erase(sourceHashes);
 
     LOG_TRACE("Deleting shader program with id {}", info.id);
-    glDeleteProgram(info.id);
+    GEM::Renderer::StateCache::deleteProgram(info.id);
 }
 
 /**
- * @brief Check if a shader program is linked given the compiled shader ids
+ * @brief Check if a shader program is linked given the hashes of its shader sources
  * 
- * @param compiledIDs The ids of the compiled shaders
- * @return true There already exists a linked shader program for the compiled shader ids
- * @return false There does not yet exist a linked shader program for the compiled shader ids
+ * @param sourceHashes The hashes of the vertex and fragment shader sources
+ * @return true There already exists a linked shader program for the shader sources
+ * @return false There does not yet exist a linked shader program for the shader sources
  */
-bool GEM::Renderer::ShaderProgram::shaderProgramIsLinked(const std::pair<uint32_t, uint32_t>& compiledIDs) {
-    LOG_FUNCTION_ENTRY_TRACE("vertex id {} , fragment id {}", compiledIDs.first, compiledIDs.second);
+bool GEM::Renderer::ShaderProgram::shaderProgramIsLinked(const std::pair<size_t, size_t>& sourceHashes) {
+    LOG_FUNCTION_ENTRY_TRACE("vertex hash {} , fragment hash {}", sourceHashes.first, sourceHashes.second);
 
-    bool isLinked = GEM::Renderer::ShaderProgram::shaderProgramIDMap.count(compiledIDs) > 0;
+    bool isLinked = GEM::Renderer::ShaderProgram::shaderProgramIDMap.count(sourceHashes) > 0;
 
     if (isLinked) {
-        LOG_DEBUG("Found shader program for vertex id {} and fragment id {}", compiledIDs.first, compiledIDs.second);
+        LOG_DEBUG("Found shader program for vertex hash {} and fragment hash {}", sourceHashes.first, sourceHashes.second);
     }
 
     return isLinked;
 }
 
 /**
- * @brief Given compiled shaders which we know are linked into a shader program already, get the id of that shader program
+ * @brief Given shader sources which we know are linked into a shader program already, get the id of that shader program
  * 
- * @param compiledIDs The ids of the compiled shaders
+ * @param sourceHashes The hashes of the vertex and fragment shader sources
  * @return uint32_t The id of the linked shader program
  */
-uint32_t GEM::Renderer::ShaderProgram::getShaderProgramID(const std::pair<uint32_t, uint32_t>& compiledIDs) {
-    LOG_FUNCTION_ENTRY_TRACE("vertex id {} , fragment id {}", compiledIDs.first, compiledIDs.second);
+uint32_t GEM::Renderer::ShaderProgram::getShaderProgramID(const std::pair<size_t, size_t>& sourceHashes) {
+    LOG_FUNCTION_ENTRY_TRACE("vertex hash {} , fragment hash {}", sourceHashes.first, sourceHashes.second);
 
-    uint32_t shaderProgramID = GEM::Renderer::ShaderProgram::shaderProgramIDMap[compiledIDs].id;
+    uint32_t shaderProgramID = GEM::Renderer::ShaderProgram::shaderProgramIDMap[sourceHashes].id;
 
     LOG_TRACE("Got shader program id {}", shaderProgramID);
 
@@ -133,54 +240,348 @@ uint32_t GEM::Renderer::ShaderProgram::getShaderProgramID(const std::pair<uint32
 }
 
 /**
- * @brief Create a shader program from the desired vertex and fragment shaders
+ * @brief Create a shader program from the desired vertex and fragment shaders. A shader program already
+ * linked for the same sources is shared, then a program binary saved on a previous run is tried, and only
+ * when both miss are the sources compiled and linked
  * 
- * @note This function will throw an exception if the linking fails
+ * @note This function will throw an exception if the compilation or linking fails
  * 
- * @param vertexShaderID The id of a compiled vertex shader to link into the shader program
- * @param fragmentShaderID The id of a compiled fragment shader to link into the shader program
+ * @param vertexShaderSource The string containing the source for the vertex shader
+ * @param fragmentShaderSource The string containing the source for the fragment shader
+ * @param sourceHashes The hashes of the vertex and fragment shader sources
  * @return uint32_t The id of the linked shader program
  */
-uint32_t GEM::Renderer::ShaderProgram::createShaderProgram(const uint32_t vertexShaderID, const uint32_t fragmentShaderID) {
-    LOG_FUNCTION_CALL_INFO("vertex id {} , fragment id {}", vertexShaderID, fragmentShaderID);
+uint32_t GEM::Renderer::ShaderProgram::createShaderProgram(const char* vertexShaderSource, const char* fragmentShaderSource, const std::pair<size_t, size_t>& sourceHashes) {
+    LOG_FUNCTION_CALL_INFO("vertex hash {} , fragment hash {}", sourceHashes.first, sourceHashes.second);
 
     // Before we try to link a new shader program, we should see if there is already one linked using the same
-    // compiled shaders
-    const std::pair<uint32_t, uint32_t> compiledIDs = {vertexShaderID, fragmentShaderID};
-    if (GEM::Renderer::ShaderProgram::shaderProgramIsLinked(compiledIDs)) {
+    // shader sources
+    if (GEM::Renderer::ShaderProgram::shaderProgramIsLinked(sourceHashes)) {
         // We found one given the vertex and fragment shaders, yay!
-        uint32_t shaderProgramID = GEM::Renderer::ShaderProgram::getShaderProgramID(compiledIDs);
+        uint32_t shaderProgramID = GEM::Renderer::ShaderProgram::getShaderProgramID(sourceHashes);
 
-        GEM::Renderer::ShaderProgram::incrementShaderProgramUseCount(compiledIDs);
+        GEM::Renderer::ShaderProgram::incrementShaderProgramUseCount(sourceHashes);
 
         LOG_DEBUG("Successfully found linked shader program with id {}", shaderProgramID);
 
         return shaderProgramID;
     }
 
-    // Create a shader program to link the vertex and fragment shaders and attach the compiled shaders
-    uint32_t shaderProgramID = glCreateProgram();
-    glAttachShader(shaderProgramID, vertexShaderID);
-    glAttachShader(shaderProgramID, fragmentShaderID);
-    glLinkProgram(shaderProgramID);
+    // Then see if we saved the linked shader program on a previous run, which skips compiling entirely
+    uint32_t shaderProgramID = GEM::Renderer::ProgramBinaryCache::loadProgram(sourceHashes);
+    if (shaderProgramID == 0) {
+        GEM::Renderer::ShaderProgram::PendingLink pendingLink = GEM::Renderer::ShaderProgram::submitShaders(vertexShaderSource, fragmentShaderSource, sourceHashes);
+        GEM::Renderer::ShaderProgram::submitLink(pendingLink);
+        GEM::Renderer::ShaderProgram::finishLink(pendingLink);
+        shaderProgramID = pendingLink.id;
+    }
+
+    GEM::Renderer::ShaderProgram::addLinkedShaderProgram(sourceHashes, shaderProgramID);
+
+    return shaderProgramID;
+}
+
+/**
+ * @brief Hand the compiles of a shader program's shaders to the driver without waiting for them to finish
+ * 
+ * @param vertexShaderSource The string containing the source for the vertex shader
+ * @param fragmentShaderSource The string containing the source for the fragment shader
+ * @param sourceHashes The hashes of the vertex and fragment shader sources
+ * @return GEM::Renderer::ShaderProgram::PendingLink The shader program waiting to be linked
+ */
+GEM::Renderer::ShaderProgram::PendingLink GEM::Renderer::ShaderProgram::submitShaders(const char* vertexShaderSource, const char* fragmentShaderSource, const std::pair<size_t, size_t>& sourceHashes) {
+    LOG_FUNCTION_ENTRY_TRACE("vertex hash {} , fragment hash {}", sourceHashes.first, sourceHashes.second);
+
+    return {
+        sourceHashes,
+        0,
+        std::make_unique<const GEM::Renderer::CompiledShader>(vertexShaderSource, GL_VERTEX_SHADER, true),
+        std::make_unique<const GEM::Renderer::CompiledShader>(fragmentShaderSource, GL_FRAGMENT_SHADER, true)
+    };
+}
+
+/**
+ * @brief Create the shader program, attach its shaders, and hand the link to the driver without waiting for it
+ * to finish
+ * 
+ * @param pendingLink The shader program waiting to be linked, which is given the id of the new shader program
+ */
+void GEM::Renderer::ShaderProgram::submitLink(GEM::Renderer::ShaderProgram::PendingLink& pendingLink) {
+    LOG_FUNCTION_ENTRY_TRACE("vertex id {} , fragment id {}", pendingLink.p_vertexShader->getID(), pendingLink.p_fragmentShader->getID());
+
+    pendingLink.id = glCreateProgram();
+    GEM::Renderer::ProgramBinaryCache::prepareProgram(pendingLink.id);
+    glAttachShader(pendingLink.id, pendingLink.p_vertexShader->getID());
+    glAttachShader(pendingLink.id, pendingLink.p_fragmentShader->getID());
+    glLinkProgram(pendingLink.id);
+}
+
+/**
+ * @brief Wait for the driver to finish linking shader programs. This only polls when the driver compiles in
+ * parallel, which lets the driver pick how many compiler threads to use. Otherwise the link status checks
+ * wait for each shader program in turn. Polling stops after LINK_POLL_TIMEOUT_MILLISECONDS, and the link
+ * status checks then wait for whichever shader programs the driver hasn't reported as complete
+ * 
+ * @param pendingLinks The shader programs which have been handed to the driver to link
+ */
+void GEM::Renderer::ShaderProgram::waitForLinks(const std::vector<GEM::Renderer::ShaderProgram::PendingLink>& pendingLinks) {
+    LOG_FUNCTION_ENTRY_TRACE("{} shader programs", pendingLinks.size());
+
+    if (pendingLinks.empty()) {
+        return;
+    }
+
+    if (
+        !GEM::Renderer::StateCache::isExtensionSupported("GL_KHR_parallel_shader_compile") &&
+        !GEM::Renderer::StateCache::isExtensionSupported("GL_ARB_parallel_shader_compile")
+    ) {
+        LOG_DEBUG("Parallel shader compilation is not supported, waiting on each of {} shader programs in turn", pendingLinks.size());
+        return;
+    }
+
+    std::vector<uint32_t> linkingShaderProgramIDs;
+    for (const GEM::Renderer::ShaderProgram::PendingLink& pendingLink : pendingLinks) {
+        linkingShaderProgramIDs.push_back(pendingLink.id);
+    }
+
+    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    while (true) {
+        linkingShaderProgramIDs.erase(
+            std::remove_if(linkingShaderProgramIDs.begin(), linkingShaderProgramIDs.end(), [](const uint32_t shaderProgramID) {
+                int completionStatus = GL_FALSE;
+                glGetProgramiv(shaderProgramID, GL_COMPLETION_STATUS_KHR, &completionStatus);
+                return completionStatus == GL_TRUE;
+            }),
+            linkingShaderProgramIDs.end()
+        );
+
+        if (linkingShaderProgramIDs.empty()) {
+            break;
+        }
+
+        if (std::chrono::steady_clock::now() - startTime > std::chrono::milliseconds(GEM::Renderer::ShaderProgram::LINK_POLL_TIMEOUT_MILLISECONDS)) {
+            LOG_WARNING("Driver did not report completion for {} shader programs within {} ms, waiting on their link status instead", linkingShaderProgramIDs.size(), GEM::Renderer::ShaderProgram::LINK_POLL_TIMEOUT_MILLISECONDS);
+            break;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    const std::chrono::duration<double, std::milli> waitTime = std::chrono::steady_clock::now() - startTime;
+    LOG_DEBUG("Waited {} ms for {} shader programs to link in parallel", waitTime.count(), pendingLinks.size());
+}
 
-    // Check that shader program linking was successful
+/**
+ * @brief Check that a shader program's shaders compiled and that it linked, then save it as a program binary.
+ * The compiled shaders are only needed for linking, so they are detached and let go of
+ * 
+ * @note This function will throw an exception if the compilation or linking failed, after deleting the shader
+ * program and setting the id of the pending link to 0
+ * 
+ * @param pendingLink The shader program which has been handed to the driver to link
+ */
+void GEM::Renderer::ShaderProgram::finishLink(GEM::Renderer::ShaderProgram::PendingLink& pendingLink) {
+    LOG_FUNCTION_ENTRY_TRACE("shader program id {}", pendingLink.id);
+
+    glDetachShader(pendingLink.id, pendingLink.p_vertexShader->getID());
+    glDetachShader(pendingLink.id, pendingLink.p_fragmentShader->getID());
+
+    // Check that shader program linking was successful. The compile errors are more useful than the link error
+    // they cause, so check the shaders first
     int shaderProgramLinkSuccess;
     char shaderProgramLinkInfoLog[512];
-    glGetProgramiv(shaderProgramID, GL_LINK_STATUS, &shaderProgramLinkSuccess);
-    if (!shaderProgramLinkSuccess) {
-        glGetProgramInfoLog(shaderProgramID, sizeof(shaderProgramLinkInfoLog), nullptr, shaderProgramLinkInfoLog);
+    try {
+        pendingLink.p_vertexShader->checkStatus();
+        pendingLink.p_fragmentShader->checkStatus();
+
+        glGetProgramiv(pendingLink.id, GL_LINK_STATUS, &shaderProgramLinkSuccess);
+        if (!shaderProgramLinkSuccess) {
+            glGetProgramInfoLog(pendingLink.id, sizeof(shaderProgramLinkInfoLog), nullptr, shaderProgramLinkInfoLog);
+
+            const std::string errorMessage = "Shader program failed to link:\n" + std::string(shaderProgramLinkInfoLog);
+            LOG_CRITICAL(errorMessage);
+            throw std::invalid_argument(errorMessage);
+        }
+    } catch (const std::exception&) {
+        GEM::Renderer::StateCache::deleteProgram(pendingLink.id);
+        pendingLink.id = 0;
+        throw;
+    }
+
+    pendingLink.p_vertexShader.reset();
+    pendingLink.p_fragmentShader.reset();
 
-        const std::string errorMessage = "Shader program failed to link:\n" + std::string(shaderProgramLinkInfoLog);
-        LOG_CRITICAL(errorMessage);
-        throw std::invalid_argument(errorMessage);
+    GEM::Renderer::ProgramBinaryCache::saveProgram(pendingLink.sourceHashes, pendingLink.id);
+
+    LOG_DEBUG("Successfully linked shader program with id {}", pendingLink.id);
+}
+
+/**
+ * @brief Finish setting up a linked shader program and add it to the map
+ * 
+ * @param sourceHashes The hashes of the vertex and fragment shader sources
+ * @param shaderProgramID The id of the linked shader program
+ */
+void GEM::Renderer::ShaderProgram::addLinkedShaderProgram(const std::pair<size_t, size_t>& sourceHashes, const uint32_t shaderProgramID) {
+    LOG_FUNCTION_ENTRY_TRACE("vertex hash {} , fragment hash {} , shader program id {}", sourceHashes.first, sourceHashes.second, shaderProgramID);
+
+    // Point the shader program's FrameData block, if it has one, at the binding point the per frame data is in.
+    // Block bindings aren't part of a program binary, so this is done however the shader program was made
+    const uint32_t frameDataBlockIndex = glGetUniformBlockIndex(shaderProgramID, GEM::Renderer::FrameUniformBuffer::BLOCK_NAME.c_str());
+    if (frameDataBlockIndex != GL_INVALID_INDEX) {
+        glUniformBlockBinding(shaderProgramID, frameDataBlockIndex, GEM::Renderer::FrameUniformBuffer::BINDING_POINT);
     }
 
-    GEM::Renderer::ShaderProgram::addShaderProgramToMap(compiledIDs, shaderProgramID);
+    GEM::Renderer::ShaderProgram::addShaderProgramToMap(sourceHashes, shaderProgramID);
+}
 
-    LOG_DEBUG("Successfully linked shader program with id {}", shaderProgramID);
+/**
+ * @brief Ask gl for every active uniform of a linked shader program and put them in a hash table keyed by
+ * name, so finding a uniform never has to ask the driver again. Arrays can be found both with and without
+ * the trailing [0]. Uniforms inside uniform blocks have no location and are left out
+ * 
+ * @param shaderProgramID The id of the linked shader program
+ * @return std::vector<GEM::Renderer::ShaderProgram::UniformEntry> The hash table of uniforms
+ */
+std::vector<GEM::Renderer::ShaderProgram::UniformEntry> GEM::Renderer::ShaderProgram::createUniformTable(const uint32_t shaderProgramID) {
+    LOG_FUNCTION_ENTRY_TRACE("shader program id {}", shaderProgramID);
+
+    int32_t activeUniformCount = 0;
+    int32_t maxUniformNameLength = 0;
+    glGetProgramiv(shaderProgramID, GL_ACTIVE_UNIFORMS, &activeUniformCount);
+    glGetProgramiv(shaderProgramID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxUniformNameLength);
+
+    // Every uniform can take up two slots, and we keep the table at most half full so probing stays short
+    size_t capacity = 1;
+    while (capacity < static_cast<size_t>(activeUniformCount) * 4) {
+        capacity *= 2;
+    }
+    std::vector<GEM::Renderer::ShaderProgram::UniformEntry> uniformTable(capacity, {0, "", {-1, GL_NONE, 0}});
+
+    std::vector<char> uniformNameBuffer(std::max(maxUniformNameLength, 1));
+    for (int32_t uniformIndex = 0; uniformIndex < activeUniformCount; ++uniformIndex) {
+        int32_t uniformNameLength = 0;
+        GEM::Renderer::ShaderProgram::UniformHandle uniformHandle = {-1, GL_NONE, 0};
+        glGetActiveUniform(
+            shaderProgramID,
+            uniformIndex,
+            static_cast<int32_t>(uniformNameBuffer.size()),
+            &uniformNameLength,
+            &uniformHandle.size,
+            &uniformHandle.type,
+            uniformNameBuffer.data()
+        );
+        const std::string uniformName(uniformNameBuffer.data(), uniformNameLength);
+
+        uniformHandle.location = glGetUniformLocation(shaderProgramID, uniformName.c_str());
+        if (uniformHandle.location == -1) {
+            continue;
+        }
+
+        LOG_TRACE("Found uniform {} at location {} with type {} and size {}", uniformName, uniformHandle.location, uniformHandle.type, uniformHandle.size);
+        GEM::Renderer::ShaderProgram::insertUniform(uniformTable, uniformName, uniformHandle);
+
+        const std::string arraySuffix = "[0]";
+        if (uniformName.size() > arraySuffix.size() && uniformName.compare(uniformName.size() - arraySuffix.size(), arraySuffix.size(), arraySuffix) == 0) {
+            GEM::Renderer::ShaderProgram::insertUniform(uniformTable, uniformName.substr(0, uniformName.size() - arraySuffix.size()), uniformHandle);
+        }
+    }
 
-    return shaderProgramID;
+    LOG_DEBUG("Found {} active uniforms in shader program with id {}", activeUniformCount, shaderProgramID);
+
+    return uniformTable;
+}
+
+/**
+ * @brief Put a uniform into the first free slot at or after the slot its name hashes to
+ * 
+ * @param uniformTable The hash table of uniforms, which must have a free slot
+ * @param uniformName The name of the uniform
+ * @param uniformHandle The handle to the uniform
+ */
+void GEM::Renderer::ShaderProgram::insertUniform(
+    std::vector<GEM::Renderer::ShaderProgram::UniformEntry>& uniformTable,
+    const std::string& uniformName,
+    const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle
+) {
+    const size_t nameHash = std::hash<std::string>{}(uniformName);
+    const size_t mask = uniformTable.size() - 1;
+
+    size_t slot = nameHash & mask;
+    while (!uniformTable[slot].name.empty()) {
+        slot = (slot + 1) & mask;
+    }
+
+    uniformTable[slot] = {nameHash, uniformName, uniformHandle};
+}
+
+/**
+ * @brief Set a uniform of the shader program in use to a value of a type generated from the shaders' sources.
+ * There is one of these for every type setUniform accepts
+ * 
+ * @param location The location of the uniform
+ * @param value(s) The value to set the uniform to
+ */
+
+void GEM::Renderer::ShaderProgram::setUniformValue(const int32_t location, const bool value) {
+    glUniform1i(location, static_cast<int32_t>(value));
+}
+void GEM::Renderer::ShaderProgram::setUniformValue(const int32_t location, const glm::bvec2& values) {
+    glUniform2i(location, static_cast<int32_t>(values.x), static_cast<int32_t>(values.y));
+}
+void GEM::Renderer::ShaderProgram::setUniformValue(const int32_t location, const glm::bvec3& values) {
+    glUniform3i(location, static_cast<int32_t>(values.x), static_cast<int32_t>(values.y), static_cast<int32_t>(values.z));
+}
+void GEM::Renderer::ShaderProgram::setUniformValue(const int32_t location, const glm::bvec4& values) {
+    glUniform4i(location, static_cast<int32_t>(values.x), static_cast<int32_t>(values.y), static_cast<int32_t>(values.z), static_cast<int32_t>(values.w));
+}
+void GEM::Renderer::ShaderProgram::setUniformValue(const int32_t location, const int32_t value) {
+    glUniform1i(location, value);
+}
+void GEM::Renderer::ShaderProgram::setUniformValue(const int32_t location, const glm::ivec2& values) {
+    glUniform2iv(location, 1, glm::value_ptr(values));
+}
+void GEM::Renderer::ShaderProgram::setUniformValue(const int32_t location, const glm::ivec3& values) {
+    glUniform3iv(location, 1, glm::value_ptr(values));
+}
+void GEM::Renderer::ShaderProgram::setUniformValue(const int32_t location, const glm::ivec4& values) {
+    glUniform4iv(location, 1, glm::value_ptr(values));
+}
+void GEM::Renderer::ShaderProgram::setUniformValue(const int32_t location, const uint32_t value) {
+    glUniform1ui(location, value);
+}
+void GEM::Renderer::ShaderProgram::setUniformValue(const int32_t location, const glm::uvec2& values) {
+    glUniform2uiv(location, 1, glm::value_ptr(values));
+}
+void GEM::Renderer::ShaderProgram::setUniformValue(const int32_t location, const glm::uvec3& values) {
+    glUniform3uiv(location, 1, glm::value_ptr(values));
+}
+void GEM::Renderer::ShaderProgram::setUniformValue(const int32_t location, const glm::uvec4& values) {
+    glUniform4uiv(location, 1, glm::value_ptr(values));
+}
+void GEM::Renderer::ShaderProgram::setUniformValue(const int32_t location, const float value) {
+    glUniform1f(location, value);
+}
+void GEM::Renderer::ShaderProgram::setUniformValue(const int32_t location, const glm::vec2& values) {
+    glUniform2fv(location, 1, glm::value_ptr(values));
+}
+void GEM::Renderer::ShaderProgram::setUniformValue(const int32_t location, const glm::vec3& values) {
+    glUniform3fv(location, 1, glm::value_ptr(values));
+}
+void GEM::Renderer::ShaderProgram::setUniformValue(const int32_t location, const glm::vec4& values) {
+    glUniform4fv(location, 1, glm::value_ptr(values));
+}
+void GEM::Renderer::ShaderProgram::setUniformValue(const int32_t location, const glm::mat2& matrix) {
+    glUniformMatrix2fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
+}
+void GEM::Renderer::ShaderProgram::setUniformValue(const int32_t location, const glm::mat3& matrix) {
+    glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
+}
+void GEM::Renderer::ShaderProgram::setUniformValue(const int32_t location, const glm::mat4& matrix) {
+    glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
+}
+void GEM::Renderer::ShaderProgram::setUniformValue(const int32_t location, const GEM::Renderer::Texture& texture) {
+    glUniform1i(location, texture.getIndex());
 }
 
 /* ------------------------------ public member functions ------------------------------ */
@@ -192,9 +593,12 @@ uint32_t GEM::Renderer::ShaderProgram::createShaderProgram(const uint32_t vertex
  * @param fragmentShaderSource The string containing the source for the fragment shader
  */
 GEM::Renderer::ShaderProgram::ShaderProgram(const char* vertexShaderSource, const char* fragmentShaderSource) :
-    m_vertexShader(vertexShaderSource, GL_VERTEX_SHADER),
-    m_fragmentShader(fragmentShaderSource, GL_FRAGMENT_SHADER),
-    m_id(GEM::Renderer::ShaderProgram::createShaderProgram(m_vertexShader.getID(), m_fragmentShader.getID()))
+    m_sourceHashes({
+        GEM::Renderer::CompiledShader::getHashFromShaderSource(vertexShaderSource),
+        GEM::Renderer::CompiledShader::getHashFromShaderSource(fragmentShaderSource)
+    }),
+    m_id(GEM::Renderer::ShaderProgram::createShaderProgram(vertexShaderSource, fragmentShaderSource, m_sourceHashes)),
+    m_uniformTable(GEM::Renderer::ShaderProgram::createUniformTable(m_id))
 {}
 
 /**
@@ -203,219 +607,265 @@ GEM::Renderer::ShaderProgram::ShaderProgram(const char* vertexShaderSource, cons
  */
 GEM::Renderer::ShaderProgram::~ShaderProgram() {
     LOG_FUNCTION_CALL_TRACE("id {}", m_id);
-    GEM::Renderer::ShaderProgram::decrementShaderProgramUseCount({m_vertexShader.getID(), m_fragmentShader.getID()});
+    GEM::Renderer::ShaderProgram::decrementShaderProgramUseCount(m_sourceHashes);
 }
 
 /**
- * @brief Set this shader as the active shader using glUseProgram
+ * @brief Set this shader as the active shader using glUseProgram, unless it already is
  */
 void GEM::Renderer::ShaderProgram::use() const {
-    glUseProgram(m_id);
+    GEM::Renderer::StateCache::useProgram(m_id);
+}
+
+/**
+ * @brief Look a uniform up by name. The handle can be kept and used to set the uniform any number of times
+ * without looking it up again
+ * 
+ * @param uniformName The name of the uniform
+ * @return GEM::Renderer::ShaderProgram::UniformHandle The handle to the uniform, which is invalid if this
+ * shader program has no active uniform with the name
+ */
+GEM::Renderer::ShaderProgram::UniformHandle GEM::Renderer::ShaderProgram::getUniformHandle(const std::string& uniformName) const {
+    const size_t nameHash = std::hash<std::string>{}(uniformName);
+    const size_t mask = m_uniformTable.size() - 1;
+
+    // The table always has a free slot, so this always stops
+    for (size_t slot = nameHash & mask; !m_uniformTable[slot].name.empty(); slot = (slot + 1) & mask) {
+        const GEM::Renderer::ShaderProgram::UniformEntry& uniformEntry = m_uniformTable[slot];
+        if (uniformEntry.nameHash == nameHash && uniformEntry.name == uniformName) {
+            return uniformEntry.handle;
+        }
+    }
+
+    LOG_CRITICAL("Could not find location of uniform: {}", uniformName);
+    return {-1, GL_NONE, 0};
 }
 
 /**
  * @brief Set the value of a uniform representing a bool or vector of bools within the glsl shader
  * 
- * @param name The name of the uniform to set
+ * @param name The name of the uniform to set, or a handle to it from getUniformHandle which skips looking it up
  * @param value(s) The values to set the uniform to
  */
 
 void GEM::Renderer::ShaderProgram::setUniformBool(const std::string& uniformName, const bool value) {
-    const int uniformLocation = glGetUniformLocation(m_id, uniformName.c_str());
-    if (uniformLocation == -1) {
-        LOG_CRITICAL("Could not find location of uniform: {}", uniformName);
+    setUniformBool(getUniformHandle(uniformName), value);
+}
+void GEM::Renderer::ShaderProgram::setUniformBool(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const bool value) {
+    if (!uniformHandle.isValid()) {
         return;
     }
-    glUniform1i(uniformLocation, static_cast<int32_t>(value));
+    glUniform1i(uniformHandle.location, static_cast<int32_t>(value));
 }
 void GEM::Renderer::ShaderProgram::setUniformBVec2(const std::string& uniformName, const std::array<bool, 2>& values) {
-    const int uniformLocation = glGetUniformLocation(m_id, uniformName.c_str());
-    if (uniformLocation == -1) {
-        LOG_CRITICAL("Could not find location of uniform: {}", uniformName);
+    setUniformBVec2(getUniformHandle(uniformName), values);
+}
+void GEM::Renderer::ShaderProgram::setUniformBVec2(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const std::array<bool, 2>& values) {
+    if (!uniformHandle.isValid()) {
         return;
     }
-    glUniform2i(uniformLocation, static_cast<int32_t>(values[0]), static_cast<int32_t>(values[1]));
+    glUniform2i(uniformHandle.location, static_cast<int32_t>(values[0]), static_cast<int32_t>(values[1]));
 }
 void GEM::Renderer::ShaderProgram::setUniformBVec3(const std::string& uniformName, const std::array<bool, 3>& values) {
-    const int uniformLocation = glGetUniformLocation(m_id, uniformName.c_str());
-    if (uniformLocation == -1) {
-        LOG_CRITICAL("Could not find location of uniform: {}", uniformName);
+    setUniformBVec3(getUniformHandle(uniformName), values);
+}
+void GEM::Renderer::ShaderProgram::setUniformBVec3(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const std::array<bool, 3>& values) {
+    if (!uniformHandle.isValid()) {
         return;
     }
-    glUniform3i(uniformLocation, static_cast<int32_t>(values[0]), static_cast<int32_t>(values[1]), static_cast<int32_t>(values[2]));
+    glUniform3i(uniformHandle.location, static_cast<int32_t>(values[0]), static_cast<int32_t>(values[1]), static_cast<int32_t>(values[2]));
 }
 void GEM::Renderer::ShaderProgram::setUniformBVec4(const std::string& uniformName, const std::array<bool, 4>& values) {
-    const int uniformLocation = glGetUniformLocation(m_id, uniformName.c_str());
-    if (uniformLocation == -1) {
-        LOG_CRITICAL("Could not find location of uniform: {}", uniformName);
+    setUniformBVec4(getUniformHandle(uniformName), values);
+}
+void GEM::Renderer::ShaderProgram::setUniformBVec4(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const std::array<bool, 4>& values) {
+    if (!uniformHandle.isValid()) {
         return;
     }
-    glUniform4i(uniformLocation, static_cast<int32_t>(values[0]), static_cast<int32_t>(values[1]), static_cast<int32_t>(values[2]), static_cast<int32_t>(values[3]));
+    glUniform4i(uniformHandle.location, static_cast<int32_t>(values[0]), static_cast<int32_t>(values[1]), static_cast<int32_t>(values[2]), static_cast<int32_t>(values[3]));
 }
 
 /**
  * @brief Set the value of a uniform representing a int or vector of ints within the glsl shader
  * 
- * @param name The name of the uniform to set
+ * @param name The name of the uniform to set, or a handle to it from getUniformHandle which skips looking it up
  * @param value(s) The values to set the uniform to
  */
 
 void GEM::Renderer::ShaderProgram::setUniformInt(const std::string& uniformName, const int32_t value) {
-    const int uniformLocation = glGetUniformLocation(m_id, uniformName.c_str());
-    if (uniformLocation == -1) {
-        LOG_CRITICAL("Could not find location of uniform: {}", uniformName);
+    setUniformInt(getUniformHandle(uniformName), value);
+}
+void GEM::Renderer::ShaderProgram::setUniformInt(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const int32_t value) {
+    if (!uniformHandle.isValid()) {
         return;
     }
-    glUniform1i(uniformLocation, value);
+    glUniform1i(uniformHandle.location, value);
 }
 void GEM::Renderer::ShaderProgram::setUniformIVec2(const std::string& uniformName, const std::array<int32_t, 2>& values) {
-    const int uniformLocation = glGetUniformLocation(m_id, uniformName.c_str());
-    if (uniformLocation == -1) {
-        LOG_CRITICAL("Could not find location of uniform: {}", uniformName);
+    setUniformIVec2(getUniformHandle(uniformName), values);
+}
+void GEM::Renderer::ShaderProgram::setUniformIVec2(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const std::array<int32_t, 2>& values) {
+    if (!uniformHandle.isValid()) {
         return;
     }
-    glUniform2i(uniformLocation, values[0], values[1]);
+    glUniform2i(uniformHandle.location, values[0], values[1]);
 }
 void GEM::Renderer::ShaderProgram::setUniformIVec3(const std::string& uniformName, const std::array<int32_t, 3>& values) {
-    const int uniformLocation = glGetUniformLocation(m_id, uniformName.c_str());
-    if (uniformLocation == -1) {
-        LOG_CRITICAL("Could not find location of uniform: {}", uniformName);
+    setUniformIVec3(getUniformHandle(uniformName), values);
+}
+void GEM::Renderer::ShaderProgram::setUniformIVec3(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const std::array<int32_t, 3>& values) {
+    if (!uniformHandle.isValid()) {
         return;
     }
-    glUniform3i(uniformLocation, values[0], values[1], values[2]);
+    glUniform3i(uniformHandle.location, values[0], values[1], values[2]);
 }
 void GEM::Renderer::ShaderProgram::setUniformIVec4(const std::string& uniformName, const std::array<int32_t, 4>& values) {
-    const int uniformLocation = glGetUniformLocation(m_id, uniformName.c_str());
-    if (uniformLocation == -1) {
-        LOG_CRITICAL("Could not find location of uniform: {}", uniformName);
+    setUniformIVec4(getUniformHandle(uniformName), values);
+}
+void GEM::Renderer::ShaderProgram::setUniformIVec4(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const std::array<int32_t, 4>& values) {
+    if (!uniformHandle.isValid()) {
         return;
     }
-    glUniform4i(uniformLocation, values[0], values[1], values[2], values[3]);
+    glUniform4i(uniformHandle.location, values[0], values[1], values[2], values[3]);
 }
 
 /**
  * @brief Set the value of a uniform representing a uint or vector of uints within the glsl shader
  * 
- * @param name The name of the uniform to set
+ * @param name The name of the uniform to set, or a handle to it from getUniformHandle which skips looking it up
  * @param value(s) The values to set the uniform to
  */
 
 void GEM::Renderer::ShaderProgram::setUniformUInt(const std::string& uniformName, const uint32_t value) {
-    const int uniformLocation = glGetUniformLocation(m_id, uniformName.c_str());
-    if (uniformLocation == -1) {
-        LOG_CRITICAL("Could not find location of uniform: {}", uniformName);
+    setUniformUInt(getUniformHandle(uniformName), value);
+}
+void GEM::Renderer::ShaderProgram::setUniformUInt(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const uint32_t value) {
+    if (!uniformHandle.isValid()) {
         return;
     }
-    glUniform1ui(uniformLocation, value);
+    glUniform1ui(uniformHandle.location, value);
 }
 void GEM::Renderer::ShaderProgram::setUniformUVec2(const std::string& uniformName, const std::array<uint32_t, 2>& values) {
-    const int uniformLocation = glGetUniformLocation(m_id, uniformName.c_str());
-    if (uniformLocation == -1) {
-        LOG_CRITICAL("Could not find location of uniform: {}", uniformName);
+    setUniformUVec2(getUniformHandle(uniformName), values);
+}
+void GEM::Renderer::ShaderProgram::setUniformUVec2(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const std::array<uint32_t, 2>& values) {
+    if (!uniformHandle.isValid()) {
         return;
     }
-    glUniform2ui(uniformLocation, values[0], values[1]);
+    glUniform2ui(uniformHandle.location, values[0], values[1]);
 }
 void GEM::Renderer::ShaderProgram::setUniformUVec3(const std::string& uniformName, const std::array<uint32_t, 3>& values) {
-    const int uniformLocation = glGetUniformLocation(m_id, uniformName.c_str());
-    if (uniformLocation == -1) {
-        LOG_CRITICAL("Could not find location of uniform: {}", uniformName);
+    setUniformUVec3(getUniformHandle(uniformName), values);
+}
+void GEM::Renderer::ShaderProgram::setUniformUVec3(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const std::array<uint32_t, 3>& values) {
+    if (!uniformHandle.isValid()) {
         return;
     }
-    glUniform3ui(uniformLocation, values[0], values[1], values[2]);
+    glUniform3ui(uniformHandle.location, values[0], values[1], values[2]);
 }
 void GEM::Renderer::ShaderProgram::setUniformUVec4(const std::string& uniformName, const std::array<uint32_t, 4>& values) {
-    const int uniformLocation = glGetUniformLocation(m_id, uniformName.c_str());
-    if (uniformLocation == -1) {
-        LOG_CRITICAL("Could not find location of uniform: {}", uniformName);
+    setUniformUVec4(getUniformHandle(uniformName), values);
+}
+void GEM::Renderer::ShaderProgram::setUniformUVec4(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const std::array<uint32_t, 4>& values) {
+    if (!uniformHandle.isValid()) {
         return;
     }
-    glUniform4ui(uniformLocation, values[0], values[1], values[2], values[3]);
+    glUniform4ui(uniformHandle.location, values[0], values[1], values[2], values[3]);
 }
 
 /**
  * @brief Set the value of a uniform representing a float or vector of floats within the glsl shader
  * 
- * @param name The name of the uniform to set
+ * @param name The name of the uniform to set, or a handle to it from getUniformHandle which skips looking it up
  * @param value(s) The values to set the uniform to
  */
 
 void GEM::Renderer::ShaderProgram::setUniformFloat(const std::string& uniformName, const float value) {
-    const int uniformLocation = glGetUniformLocation(m_id, uniformName.c_str());
-    if (uniformLocation == -1) {
-        LOG_CRITICAL("Could not find location of uniform: {}", uniformName);
+    setUniformFloat(getUniformHandle(uniformName), value);
+}
+void GEM::Renderer::ShaderProgram::setUniformFloat(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const float value) {
+    if (!uniformHandle.isValid()) {
         return;
     }
-    glUniform1f(uniformLocation, value);
+    glUniform1f(uniformHandle.location, value);
 }
 void GEM::Renderer::ShaderProgram::setUniformVec2(const std::string& uniformName, const std::array<float, 2>& values) {
-    const int uniformLocation = glGetUniformLocation(m_id, uniformName.c_str());
-    if (uniformLocation == -1) {
-        LOG_CRITICAL("Could not find location of uniform: {}", uniformName);
+    setUniformVec2(getUniformHandle(uniformName), values);
+}
+void GEM::Renderer::ShaderProgram::setUniformVec2(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const std::array<float, 2>& values) {
+    if (!uniformHandle.isValid()) {
         return;
     }
-    glUniform2f(uniformLocation, values[0], values[1]);
+    glUniform2f(uniformHandle.location, values[0], values[1]);
 }
 void GEM::Renderer::ShaderProgram::setUniformVec3(const std::string& uniformName, const std::array<float, 3>& values) {
-    const int uniformLocation = glGetUniformLocation(m_id, uniformName.c_str());
-    if (uniformLocation == -1) {
-        LOG_CRITICAL("Could not find location of uniform: {}", uniformName);
+    setUniformVec3(getUniformHandle(uniformName), values);
+}
+void GEM::Renderer::ShaderProgram::setUniformVec3(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const std::array<float, 3>& values) {
+    if (!uniformHandle.isValid()) {
         return;
     }
-    glUniform3f(uniformLocation, values[0], values[1], values[2]);
+    glUniform3f(uniformHandle.location, values[0], values[1], values[2]);
 }
 void GEM::Renderer::ShaderProgram::setUniformVec4(const std::string& uniformName, const std::array<float, 4>& values) {
-    const int uniformLocation = glGetUniformLocation(m_id, uniformName.c_str());
-    if (uniformLocation == -1) {
-        LOG_CRITICAL("Could not find location of uniform: {}", uniformName);
+    setUniformVec4(getUniformHandle(uniformName), values);
+}
+void GEM::Renderer::ShaderProgram::setUniformVec4(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const std::array<float, 4>& values) {
+    if (!uniformHandle.isValid()) {
         return;
     }
-    glUniform4f(uniformLocation, values[0], values[1], values[2], values[3]);
+    glUniform4f(uniformHandle.location, values[0], values[1], values[2], values[3]);
 }
 
 /**
  * @brief Set the value of a matrix within the glsl shader
  * 
- * @param name The name of the uniform to set
+ * @param name The name of the uniform to set, or a handle to it from getUniformHandle which skips looking it up
  * @param matrix The matrix we are going to set it to
  */
 
 void GEM::Renderer::ShaderProgram::setUniformMat2(const std::string& uniformName, const glm::mat2& matrix) {
-    const int uniformLocation = glGetUniformLocation(m_id, uniformName.c_str());
-    if (uniformLocation == -1) {
-        LOG_CRITICAL("Could not find location of uniform: {}", uniformName);
+    setUniformMat2(getUniformHandle(uniformName), matrix);
+}
+void GEM::Renderer::ShaderProgram::setUniformMat2(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const glm::mat2& matrix) {
+    if (!uniformHandle.isValid()) {
         return;
     }
-    glUniformMatrix2fv(uniformLocation, 1, GL_FALSE, glm::value_ptr(matrix));
+    glUniformMatrix2fv(uniformHandle.location, 1, GL_FALSE, glm::value_ptr(matrix));
 }
 
 void GEM::Renderer::ShaderProgram::setUniformMat3(const std::string& uniformName, const glm::mat3& matrix) {
-    const int uniformLocation = glGetUniformLocation(m_id, uniformName.c_str());
-    if (uniformLocation == -1) {
-        LOG_CRITICAL("Could not find location of uniform: {}", uniformName);
+    setUniformMat3(getUniformHandle(uniformName), matrix);
+}
+void GEM::Renderer::ShaderProgram::setUniformMat3(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const glm::mat3& matrix) {
+    if (!uniformHandle.isValid()) {
         return;
     }
-    glUniformMatrix3fv(uniformLocation, 1, GL_FALSE, glm::value_ptr(matrix));
+    glUniformMatrix3fv(uniformHandle.location, 1, GL_FALSE, glm::value_ptr(matrix));
 }
 
 void GEM::Renderer::ShaderProgram::setUniformMat4(const std::string& uniformName, const glm::mat4& matrix) {
-    const int uniformLocation = glGetUniformLocation(m_id, uniformName.c_str());
-    if (uniformLocation == -1) {
-        LOG_CRITICAL("Could not find location of uniform: {}", uniformName);
+    setUniformMat4(getUniformHandle(uniformName), matrix);
+}
+void GEM::Renderer::ShaderProgram::setUniformMat4(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const glm::mat4& matrix) {
+    if (!uniformHandle.isValid()) {
         return;
     }
-    glUniformMatrix4fv(uniformLocation, 1, GL_FALSE, glm::value_ptr(matrix));
+    glUniformMatrix4fv(uniformHandle.location, 1, GL_FALSE, glm::value_ptr(matrix));
 }
 
 /**
  * @brief Set the value of a Sampler2D uniform representing a texture within the glsl shader
  * 
- * @param name The name of the uniform to set
+ * @param name The name of the uniform to set, or a handle to it from getUniformHandle which skips looking it up
  * @param texture The texture we are going to set it to (we use the texture's index)
  */
 
 void GEM::Renderer::ShaderProgram::setUniformTextureSampler(const std::string& uniformName, std::shared_ptr<const GEM::Renderer::Texture> p_texture) {
     setUniformInt(uniformName, p_texture->getIndex());
 }
+void GEM::Renderer::ShaderProgram::setUniformTextureSampler(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, std::shared_ptr<const GEM::Renderer::Texture> p_texture) {
+    setUniformInt(uniformHandle, p_texture->getIndex());
+}
 
 /* ------------------------------ private member functions ------------------------------ */
@@ -5,6 +5,7 @@
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <glad/glad.h>
 
@@ -13,6 +14,7 @@
 #include "util/macros.hpp"
 
 #include "gemstone/renderer/shader/CompiledShader.hpp"
+#include "gemstone/renderer/shader/Uniform.hpp"
 #include "gemstone/renderer/texture/Texture.hpp"
 
 namespace GEM {
@@ -27,8 +29,34 @@ namespace Renderer {
  * then calling use()
  */
 class GEM::Renderer::ShaderProgram {
+public: // public classes and enums
+    /**
+     * @brief A uniform of a shader program resolved ahead of time, so setting it needs no name lookup. A
+     * handle only makes sense for the shader program it came from. Handles of uniforms the shader program
+     * doesn't have are invalid, and setting them does nothing
+     */
+    struct UniformHandle {
+        int32_t location;
+        GLenum type;
+        int32_t size;
+
+        bool isValid() const { return location != -1; }
+    };
+
+    /**
+     * @brief A uniform handle which only accepts values of the c++ type the uniform was generated with
+     */
+    template <typename T>
+    struct TypedUniformHandle {
+        GEM::Renderer::ShaderProgram::UniformHandle handle;
+    };
+
 public: // public static variables
     static const std::string LOGGER_NAME;
+    static const uint32_t LINK_POLL_TIMEOUT_MILLISECONDS;
+
+public: // public static functions
+    static std::vector<std::shared_ptr<GEM::Renderer::ShaderProgram>> createPtrs(const std::vector<std::pair<const char*, const char*>>& shaderSources);
     
 public: // public member functions
     ShaderProgram(const char* vertexShaderSource, const char* fragmentShaderSource);
@@ -38,46 +66,83 @@ public: // public member functions
 
     uint32_t getID() const { return m_id; }
 
+    GEM::Renderer::ShaderProgram::UniformHandle getUniformHandle(const std::string& uniformName) const;
+
     /**
-     * @todo Create a templated function for each of these to call.
-     *        * we will need to implement a function to return the correct glUniform<n><t>v function
-     *          as a pointer for us to call
-     *           * <n> = 1, 2, 3, or 4 based on the number of args (length of uniform vec)
-     *           * <t> = f, i, or ui based on the type of the parameters
-     *           * we will need to figure out how to use these functions to pass arrays to them
-     * 1) Use a std::array
-     *        * we will need to use std::enable_if to only allow arrays of bool, int, uint, float
-     *        * we will need to use std::enable_if to only arrays of lengths 1 - 4
-     * 2) Use variadic arguments
-     *        * we will need to ensure that all of the variables are of the same type
-     *        * we will need to ensure that we only have 1 - 4 variadic arguments
+     * @brief Look up a uniform generated from the shaders' sources. The handle can be kept and used to set the
+     * uniform any number of times without looking it up again
+     * 
+     * @tparam T The c++ type the uniform is set from
+     * @param uniform The generated uniform
+     * @return GEM::Renderer::ShaderProgram::TypedUniformHandle<T> The handle to the uniform, which is invalid if
+     * this shader program has no active uniform with the name
      */
+    template <typename T>
+    GEM::Renderer::ShaderProgram::TypedUniformHandle<T> getUniformHandle(const GEM::Renderer::Uniform<T>& uniform) const {
+        return {getUniformHandle(std::string(uniform.name))};
+    }
+
+    /**
+     * @brief Set a uniform through a handle from a generated uniform. The value must have exactly the type the
+     * uniform was generated with, so mismatches are caught at compile time, and nothing is looked up
+     * 
+     * @tparam T The c++ type the uniform is set from
+     * @param uniformHandle The handle to the uniform
+     * @param value The value to set the uniform to
+     */
+    template <typename T>
+    void setUniform(const GEM::Renderer::ShaderProgram::TypedUniformHandle<T>& uniformHandle, const T& value) {
+        if (!uniformHandle.handle.isValid()) {
+            return;
+        }
+        GEM::Renderer::ShaderProgram::setUniformValue(uniformHandle.handle.location, value);
+    }
 
     void setUniformBool(const std::string& uniformName, const bool value);
+    void setUniformBool(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const bool value);
     void setUniformBVec2(const std::string& uniformName, const std::array<bool, 2>& values);
+    void setUniformBVec2(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const std::array<bool, 2>& values);
     void setUniformBVec3(const std::string& uniformName, const std::array<bool, 3>& values);
+    void setUniformBVec3(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const std::array<bool, 3>& values);
     void setUniformBVec4(const std::string& uniformName, const std::array<bool, 4>& values);
+    void setUniformBVec4(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const std::array<bool, 4>& values);
     
     void setUniformInt(const std::string& uniformName, const int32_t value);
+    void setUniformInt(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const int32_t value);
     void setUniformIVec2(const std::string& uniformName, const std::array<int32_t, 2>& values);
+    void setUniformIVec2(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const std::array<int32_t, 2>& values);
     void setUniformIVec3(const std::string& uniformName, const std::array<int32_t, 3>& values);
+    void setUniformIVec3(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const std::array<int32_t, 3>& values);
     void setUniformIVec4(const std::string& uniformName, const std::array<int32_t, 4>& values);
+    void setUniformIVec4(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const std::array<int32_t, 4>& values);
 
     void setUniformUInt(const std::string& uniformName, const uint32_t value);
+    void setUniformUInt(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const uint32_t value);
     void setUniformUVec2(const std::string& uniformName, const std::array<uint32_t, 2>& values);
+    void setUniformUVec2(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const std::array<uint32_t, 2>& values);
     void setUniformUVec3(const std::string& uniformName, const std::array<uint32_t, 3>& values);
+    void setUniformUVec3(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const std::array<uint32_t, 3>& values);
     void setUniformUVec4(const std::string& uniformName, const std::array<uint32_t, 4>& values);
+    void setUniformUVec4(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const std::array<uint32_t, 4>& values);
     
     void setUniformFloat(const std::string& uniformName, const float value);
+    void setUniformFloat(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const float value);
     void setUniformVec2(const std::string& uniformName, const std::array<float, 2>& values);
+    void setUniformVec2(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const std::array<float, 2>& values);
     void setUniformVec3(const std::string& uniformName, const std::array<float, 3>& values);
+    void setUniformVec3(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const std::array<float, 3>& values);
     void setUniformVec4(const std::string& uniformName, const std::array<float, 4>& values);
+    void setUniformVec4(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const std::array<float, 4>& values);
 
     void setUniformMat2(const std::string& uniformName, const glm::mat2& matrix);
+    void setUniformMat2(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const glm::mat2& matrix);
     void setUniformMat3(const std::string& uniformName, const glm::mat3& matrix);
+    void setUniformMat3(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const glm::mat3& matrix);
     void setUniformMat4(const std::string& uniformName, const glm::mat4& matrix);
+    void setUniformMat4(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, const glm::mat4& matrix);
 
     void setUniformTextureSampler(const std::string& uniformName, std::shared_ptr<const GEM::Renderer::Texture> p_texture);
+    void setUniformTextureSampler(const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle, std::shared_ptr<const GEM::Renderer::Texture> p_texture);
 
 private: // private enums and classes
     struct Info {
@@ -85,20 +150,70 @@ private: // private enums and classes
         uint32_t useCount;
     };
 
-private: // private static functions
-    static void addShaderProgramToMap(const std::pair<uint32_t, uint32_t>& compiledIDs, const uint32_t shaderProgramID);
-    static void incrementShaderProgramUseCount(const std::pair<uint32_t, uint32_t>& compiledIDs);
-    static void decrementShaderProgramUseCount(const std::pair<uint32_t, uint32_t>& compiledIDs);
-    static bool shaderProgramIsLinked(const std::pair<uint32_t, uint32_t>& compiledIDs);
+    /**
+     * @brief A shader program whose shaders have been handed to the driver to compile, and possibly to link,
+     * which nobody has waited on yet. The id is 0 until the link is submitted
+     */
+    struct PendingLink {
+        std::pair<size_t, size_t> sourceHashes;
+        uint32_t id;
+        std::unique_ptr<const GEM::Renderer::CompiledShader> p_vertexShader;
+        std::unique_ptr<const GEM::Renderer::CompiledShader> p_fragmentShader;
+    };
 
-    static uint32_t getShaderProgramID(const std::pair<uint32_t, uint32_t>& compiledIDs);
-    static uint32_t createShaderProgram(const uint32_t vertexShaderID, const uint32_t fragmentShaderID);
+    /**
+     * @brief A slot of the uniform hash table. Slots with an empty name are free
+     */
+    struct UniformEntry {
+        size_t nameHash;
+        std::string name;
+        GEM::Renderer::ShaderProgram::UniformHandle handle;
+    };
+
+private: // private static functions
+    static void addShaderProgramToMap(const std::pair<size_t, size_t>& sourceHashes, const uint32_t shaderProgramID);
+    static void incrementShaderProgramUseCount(const std::pair<size_t, size_t>& sourceHashes);
+    static void decrementShaderProgramUseCount(const std::pair<size_t, size_t>& sourceHashes);
+    static bool shaderProgramIsLinked(const std::pair<size_t, size_t>& sourceHashes);
+
+    static uint32_t getShaderProgramID(const std::pair<size_t, size_t>& sourceHashes);
+    static uint32_t createShaderProgram(const char* vertexShaderSource, const char* fragmentShaderSource, const std::pair<size_t, size_t>& sourceHashes);
+    static GEM::Renderer::ShaderProgram::PendingLink submitShaders(const char* vertexShaderSource, const char* fragmentShaderSource, const std::pair<size_t, size_t>& sourceHashes);
+    static void submitLink(GEM::Renderer::ShaderProgram::PendingLink& pendingLink);
+    static void waitForLinks(const std::vector<GEM::Renderer::ShaderProgram::PendingLink>& pendingLinks);
+    static void finishLink(GEM::Renderer::ShaderProgram::PendingLink& pendingLink);
+    static void addLinkedShaderProgram(const std::pair<size_t, size_t>& sourceHashes, const uint32_t shaderProgramID);
+    static std::vector<GEM::Renderer::ShaderProgram::UniformEntry> createUniformTable(const uint32_t shaderProgramID);
+    static void insertUniform(std::vector<GEM::Renderer::ShaderProgram::UniformEntry>& uniformTable, const std::string& uniformName, const GEM::Renderer::ShaderProgram::UniformHandle& uniformHandle);
+
+    static void setUniformValue(const int32_t location, const bool value);
+    static void setUniformValue(const int32_t location, const glm::bvec2& values);
+    static void setUniformValue(const int32_t location, const glm::bvec3& values);
+    static void setUniformValue(const int32_t location, const glm::bvec4& values);
+    static void setUniformValue(const int32_t location, const int32_t value);
+    static void setUniformValue(const int32_t location, const glm::ivec2& values);
+    static void setUniformValue(const int32_t location, const glm::ivec3& values);
+    static void setUniformValue(const int32_t location, const glm::ivec4& values);
+    static void setUniformValue(const int32_t location, const uint32_t value);
+    static void setUniformValue(const int32_t location, const glm::uvec2& values);
+    static void setUniformValue(const int32_t location, const glm::uvec3& values);
+    static void setUniformValue(const int32_t location, const glm::uvec4& values);
+    static void setUniformValue(const int32_t location, const float value);
+    static void setUniformValue(const int32_t location, const glm::vec2& values);
+    static void setUniformValue(const int32_t location, const glm::vec3& values);
+    static void setUniformValue(const int32_t location, const glm::vec4& values);
+    static void setUniformValue(const int32_t location, const glm::mat2& matrix);
+    static void setUniformValue(const int32_t location, const glm::mat3& matrix);
+    static void setUniformValue(const int32_t location, const glm::mat4& matrix);
+    static void setUniformValue(const int32_t location, const GEM::Renderer::Texture& texture);
 
 private: // private static variables
-    static std::map<std::pair<uint32_t, uint32_t>, GEM::Renderer::ShaderProgram::Info> shaderProgramIDMap;
+    static std::map<std::pair<size_t, size_t>, GEM::Renderer::ShaderProgram::Info> shaderProgramIDMap;
 
 private: // private member variables
-    const CompiledShader m_vertexShader;
-    const CompiledShader m_fragmentShader;
+    const std::pair<size_t, size_t> m_sourceHashes;
     const uint32_t m_id;
+
+    // Open addressed with linear probing, with a power of 2 capacity
+    const std::vector<GEM::Renderer::ShaderProgram::UniformEntry> m_uniformTable;
 };
\ No newline at end of file
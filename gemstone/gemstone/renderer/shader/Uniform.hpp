@@ -0,0 +1,20 @@
+#pragma once
+
+namespace GEM {
+namespace Renderer {
+    template <typename T>
+    struct Uniform;
+}
+}
+
+/**
+ * @brief A uniform of a shader known at compile time, along with the c++ type it is set from. These are
+ * generated for every shader by cmake/CreateShaderReflectionFile.cmake, and a shader program turns one into a
+ * typed handle with getUniformHandle so setting the uniform to a value of the wrong type doesn't compile
+ *
+ * @tparam T The c++ type the uniform is set from, such as glm::mat4 for a mat4 or GEM::Renderer::Texture for a sampler
+ */
+template <typename T>
+struct GEM::Renderer::Uniform {
+    const char* name;
+};
\ No newline at end of file
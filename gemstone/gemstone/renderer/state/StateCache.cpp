@@ -0,0 +1,376 @@
+#include <array>
+#include <limits>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+
+#include <glad/glad.h>
+
+#include "util/logger/Logger.hpp"
+
+#include "gemstone/renderer/state/logger.hpp"
+#include "gemstone/renderer/state/StateCache.hpp"
+
+/* ------------------------------ public static variables ------------------------------ */
+
+/**
+ * @brief The name of the logger the StateCache class uses
+ */
+const std::string GEM::Renderer::StateCache::LOGGER_NAME = STATE_LOGGER_NAME;
+
+/**
+ * @brief The id we hold for state we don't know the value of. gl never hands out an id this large
+ */
+const uint32_t GEM::Renderer::StateCache::UNKNOWN_ID = std::numeric_limits<uint32_t>::max();
+
+/**
+ * @brief The number of texture units we track. Bindings on units past this are always passed through to gl.
+ * gl 3.3 guarantees at least 48 combined texture units, but we never use anywhere near that many
+ */
+const uint32_t GEM::Renderer::StateCache::MAX_TEXTURE_UNIT_COUNT = 32;
+
+/* ------------------------------ private static variables ------------------------------ */
+
+/**
+ * @brief The id of the program in use
+ */
+uint32_t GEM::Renderer::StateCache::programID = GEM::Renderer::StateCache::UNKNOWN_ID;
+
+/**
+ * @brief The id of the bound VAO
+ */
+uint32_t GEM::Renderer::StateCache::vertexArrayObjectID = GEM::Renderer::StateCache::UNKNOWN_ID;
+
+/**
+ * @brief The id of the buffer bound to each target. Targets missing from the map are unknown
+ */
+std::map<GLenum, uint32_t> GEM::Renderer::StateCache::bufferIDs = {};
+
+/**
+ * @brief The id of the buffer bound to each index of the indexed targets, such as the uniform buffer binding
+ * points. Indices missing from the map are unknown
+ */
+std::map<std::pair<GLenum, uint32_t>, uint32_t> GEM::Renderer::StateCache::indexedBufferIDs = {};
+
+/**
+ * @brief The active texture unit, counted from 0 rather than from GL_TEXTURE0
+ */
+uint32_t GEM::Renderer::StateCache::activeTextureUnit = GEM::Renderer::StateCache::UNKNOWN_ID;
+
+/**
+ * @brief The texture bound to GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY, and GL_TEXTURE_CUBE_MAP on each texture unit
+ */
+std::array<std::array<uint32_t, 3>, 32> GEM::Renderer::StateCache::textureIDs = GEM::Renderer::StateCache::makeUnknownTextureIDs();
+
+/**
+ * @brief Whether each capability is enabled. Capabilities missing from the map are unknown
+ */
+std::map<GLenum, bool> GEM::Renderer::StateCache::capabilities = {};
+
+/**
+ * @brief The extensions the context has, read from gl the first time an extension is asked about
+ */
+std::set<std::string> GEM::Renderer::StateCache::extensions = {};
+bool GEM::Renderer::StateCache::extensionsQueried = false;
+
+/**
+ * @brief The number of gl calls made and skipped since the statistics were last reset
+ */
+GEM::Renderer::StateCache::Statistics GEM::Renderer::StateCache::statistics = {0, 0};
+
+/* ------------------------------ public static functions ------------------------------ */
+
+/**
+ * @brief Use a program with glUseProgram, unless it is already in use
+ *
+ * @param programID The id of the program
+ */
+void GEM::Renderer::StateCache::useProgram(const uint32_t programID) {
+    if (GEM::Renderer::StateCache::elide(GEM::Renderer::StateCache::programID == programID)) {
+        return;
+    }
+
+    glUseProgram(programID);
+    GEM::Renderer::StateCache::programID = programID;
+}
+
+/**
+ * @brief Bind a VAO with glBindVertexArray, unless it is already bound. The element array buffer binding
+ * belongs to the VAO, so it becomes unknown whenever the VAO changes
+ *
+ * @param vertexArrayObjectID The id of the VAO
+ */
+void GEM::Renderer::StateCache::bindVertexArray(const uint32_t vertexArrayObjectID) {
+    if (GEM::Renderer::StateCache::elide(GEM::Renderer::StateCache::vertexArrayObjectID == vertexArrayObjectID)) {
+        return;
+    }
+
+    glBindVertexArray(vertexArrayObjectID);
+    GEM::Renderer::StateCache::vertexArrayObjectID = vertexArrayObjectID;
+    GEM::Renderer::StateCache::bufferIDs.erase(GL_ELEMENT_ARRAY_BUFFER);
+}
+
+/**
+ * @brief Bind a buffer to a target with glBindBuffer, unless it is already bound there
+ *
+ * @param target The target to bind the buffer to, such as GL_ARRAY_BUFFER
+ * @param bufferID The id of the buffer
+ */
+void GEM::Renderer::StateCache::bindBuffer(const GLenum target, const uint32_t bufferID) {
+    const std::map<GLenum, uint32_t>::const_iterator it = GEM::Renderer::StateCache::bufferIDs.find(target);
+    if (GEM::Renderer::StateCache::elide(it != GEM::Renderer::StateCache::bufferIDs.end() && it->second == bufferID)) {
+        return;
+    }
+
+    glBindBuffer(target, bufferID);
+    GEM::Renderer::StateCache::bufferIDs[target] = bufferID;
+}
+
+/**
+ * @brief Bind a buffer to an index of an indexed target with glBindBufferBase, unless it is already bound
+ * there. gl binds the buffer to the target itself as well
+ *
+ * @param target The indexed target to bind the buffer to, such as GL_UNIFORM_BUFFER
+ * @param index The index within the target, such as the uniform block binding point
+ * @param bufferID The id of the buffer
+ */
+void GEM::Renderer::StateCache::bindBufferBase(const GLenum target, const uint32_t index, const uint32_t bufferID) {
+    const std::map<std::pair<GLenum, uint32_t>, uint32_t>::const_iterator it = GEM::Renderer::StateCache::indexedBufferIDs.find({target, index});
+    if (GEM::Renderer::StateCache::elide(it != GEM::Renderer::StateCache::indexedBufferIDs.end() && it->second == bufferID)) {
+        return;
+    }
+
+    glBindBufferBase(target, index, bufferID);
+    GEM::Renderer::StateCache::indexedBufferIDs[{target, index}] = bufferID;
+    GEM::Renderer::StateCache::bufferIDs[target] = bufferID;
+}
+
+/**
+ * @brief Make a texture unit active with glActiveTexture, unless it is already active
+ *
+ * @param textureUnit The texture unit, counted from 0 rather than from GL_TEXTURE0
+ */
+void GEM::Renderer::StateCache::activeTexture(const uint32_t textureUnit) {
+    if (GEM::Renderer::StateCache::elide(GEM::Renderer::StateCache::activeTextureUnit == textureUnit)) {
+        return;
+    }
+
+    glActiveTexture(GL_TEXTURE0 + textureUnit);
+    GEM::Renderer::StateCache::activeTextureUnit = textureUnit;
+}
+
+/**
+ * @brief Bind a texture to a target of the active texture unit with glBindTexture, unless it is already
+ * bound there
+ *
+ * @param target The target to bind the texture to, such as GL_TEXTURE_2D
+ * @param textureID The id of the texture
+ */
+void GEM::Renderer::StateCache::bindTexture(const GLenum target, const uint32_t textureID) {
+    const int32_t targetIndex = GEM::Renderer::StateCache::getTextureTargetIndex(target);
+    const uint32_t textureUnit = GEM::Renderer::StateCache::activeTextureUnit;
+
+    // We can only remember bindings on a known, tracked unit and target
+    const bool tracked = targetIndex >= 0 && textureUnit < GEM::Renderer::StateCache::MAX_TEXTURE_UNIT_COUNT;
+    if (GEM::Renderer::StateCache::elide(tracked && GEM::Renderer::StateCache::textureIDs[textureUnit][targetIndex] == textureID)) {
+        return;
+    }
+
+    glBindTexture(target, textureID);
+    if (tracked) {
+        GEM::Renderer::StateCache::textureIDs[textureUnit][targetIndex] = textureID;
+    }
+}
+
+/**
+ * @brief Enable a capability with glEnable, unless it is already enabled
+ *
+ * @param capability The capability, such as GL_DEPTH_TEST
+ */
+void GEM::Renderer::StateCache::enable(const GLenum capability) {
+    const std::map<GLenum, bool>::const_iterator it = GEM::Renderer::StateCache::capabilities.find(capability);
+    if (GEM::Renderer::StateCache::elide(it != GEM::Renderer::StateCache::capabilities.end() && it->second)) {
+        return;
+    }
+
+    glEnable(capability);
+    GEM::Renderer::StateCache::capabilities[capability] = true;
+}
+
+/**
+ * @brief Disable a capability with glDisable, unless it is already disabled
+ *
+ * @param capability The capability, such as GL_DEPTH_TEST
+ */
+void GEM::Renderer::StateCache::disable(const GLenum capability) {
+    const std::map<GLenum, bool>::const_iterator it = GEM::Renderer::StateCache::capabilities.find(capability);
+    if (GEM::Renderer::StateCache::elide(it != GEM::Renderer::StateCache::capabilities.end() && !it->second)) {
+        return;
+    }
+
+    glDisable(capability);
+    GEM::Renderer::StateCache::capabilities[capability] = false;
+}
+
+/**
+ * @brief Delete a program. A program in use is only deleted once it stops being used, and its id may be handed
+ * out again after that, so we forget which program is in use
+ *
+ * @param programID The id of the program
+ */
+void GEM::Renderer::StateCache::deleteProgram(const uint32_t programID) {
+    glDeleteProgram(programID);
+    if (GEM::Renderer::StateCache::programID == programID) {
+        GEM::Renderer::StateCache::programID = GEM::Renderer::StateCache::UNKNOWN_ID;
+    }
+}
+
+/**
+ * @brief Delete a VAO. gl binds VAO 0 in place of a bound VAO when it is deleted
+ *
+ * @param vertexArrayObjectID The id of the VAO
+ */
+void GEM::Renderer::StateCache::deleteVertexArray(const uint32_t vertexArrayObjectID) {
+    glDeleteVertexArrays(1, &vertexArrayObjectID);
+    if (GEM::Renderer::StateCache::vertexArrayObjectID == vertexArrayObjectID) {
+        GEM::Renderer::StateCache::vertexArrayObjectID = 0;
+        GEM::Renderer::StateCache::bufferIDs.erase(GL_ELEMENT_ARRAY_BUFFER);
+    }
+}
+
+/**
+ * @brief Delete a buffer. gl binds buffer 0 in place of the buffer on every target and index it is bound to
+ *
+ * @param bufferID The id of the buffer
+ */
+void GEM::Renderer::StateCache::deleteBuffer(const uint32_t bufferID) {
+    glDeleteBuffers(1, &bufferID);
+    for (std::pair<const GLenum, uint32_t>& binding : GEM::Renderer::StateCache::bufferIDs) {
+        if (binding.second == bufferID) {
+            binding.second = 0;
+        }
+    }
+    for (std::pair<const std::pair<GLenum, uint32_t>, uint32_t>& binding : GEM::Renderer::StateCache::indexedBufferIDs) {
+        if (binding.second == bufferID) {
+            binding.second = 0;
+        }
+    }
+}
+
+/**
+ * @brief Delete a texture. gl binds texture 0 in place of the texture on every unit it is bound to
+ *
+ * @param textureID The id of the texture
+ */
+void GEM::Renderer::StateCache::deleteTexture(const uint32_t textureID) {
+    glDeleteTextures(1, &textureID);
+    for (std::array<uint32_t, 3>& unitTextureIDs : GEM::Renderer::StateCache::textureIDs) {
+        for (uint32_t& boundTextureID : unitTextureIDs) {
+            if (boundTextureID == textureID) {
+                boundTextureID = 0;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Forget all of the state, so the next call for each piece of state reaches gl. This must be called
+ * after anything changes gl state without going through here
+ */
+void GEM::Renderer::StateCache::invalidate() {
+    LOG_TRACE("Forgetting the cached gl state");
+
+    GEM::Renderer::StateCache::programID = GEM::Renderer::StateCache::UNKNOWN_ID;
+    GEM::Renderer::StateCache::vertexArrayObjectID = GEM::Renderer::StateCache::UNKNOWN_ID;
+    GEM::Renderer::StateCache::bufferIDs.clear();
+    GEM::Renderer::StateCache::indexedBufferIDs.clear();
+    GEM::Renderer::StateCache::activeTextureUnit = GEM::Renderer::StateCache::UNKNOWN_ID;
+    GEM::Renderer::StateCache::textureIDs = GEM::Renderer::StateCache::makeUnknownTextureIDs();
+    GEM::Renderer::StateCache::capabilities.clear();
+}
+
+/**
+ * @brief Determine whether or not the context has an extension. The extensions never change for a context, so
+ * they are read from gl once and kept, and invalidate leaves them alone
+ *
+ * @param extensionName The name of the extension, such as GL_KHR_parallel_shader_compile
+ * @return true The context has the extension
+ * @return false The context does not have the extension
+ */
+bool GEM::Renderer::StateCache::isExtensionSupported(const std::string& extensionName) {
+    if (!GEM::Renderer::StateCache::extensionsQueried) {
+        int32_t extensionCount = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+        for (int32_t i = 0; i < extensionCount; ++i) {
+            const char* p_extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+            if (p_extension) {
+                GEM::Renderer::StateCache::extensions.insert(p_extension);
+            }
+        }
+
+        GEM::Renderer::StateCache::extensionsQueried = true;
+        LOG_DEBUG("Context has {} extensions", GEM::Renderer::StateCache::extensions.size());
+    }
+
+    return GEM::Renderer::StateCache::extensions.count(extensionName) > 0;
+}
+
+/**
+ * @brief Start counting the gl calls made and skipped from 0 again
+ */
+void GEM::Renderer::StateCache::resetStatistics() {
+    GEM::Renderer::StateCache::statistics = {0, 0};
+}
+
+/* ------------------------------ private static functions ------------------------------ */
+
+/**
+ * @brief Get where the bindings of a texture target are kept for each texture unit
+ *
+ * @param target The texture target
+ * @return int32_t The index of the target, or -1 if bindings to the target are not tracked
+ */
+int32_t GEM::Renderer::StateCache::getTextureTargetIndex(const GLenum target) {
+    switch (target) {
+        case GL_TEXTURE_2D: return 0;
+        case GL_TEXTURE_2D_ARRAY: return 1;
+        case GL_TEXTURE_CUBE_MAP: return 2;
+        default: return -1;
+    }
+}
+
+/**
+ * @brief Make the texture bindings of every tracked unit and target unknown
+ *
+ * @return std::array<std::array<uint32_t, 3>, 32> The unknown texture bindings
+ */
+std::array<std::array<uint32_t, 3>, 32> GEM::Renderer::StateCache::makeUnknownTextureIDs() {
+    std::array<std::array<uint32_t, 3>, 32> textureIDs;
+    for (std::array<uint32_t, 3>& unitTextureIDs : textureIDs) {
+        unitTextureIDs.fill(GEM::Renderer::StateCache::UNKNOWN_ID);
+    }
+
+    return textureIDs;
+}
+
+/**
+ * @brief Count a call as either skipped or made
+ *
+ * @param unchanged Whether the call would leave the state as it already is
+ * @return true If the call should be skipped
+ * @return false If the call must be made
+ */
+bool GEM::Renderer::StateCache::elide(const bool unchanged) {
+    if (unchanged) {
+        GEM::Renderer::StateCache::statistics.elidedCount += 1;
+    } else {
+        GEM::Renderer::StateCache::statistics.issuedCount += 1;
+    }
+
+    return unchanged;
+}
+
+/* ------------------------------ public member functions ------------------------------ */
+
+/* ------------------------------ private member functions ------------------------------ */
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+
+#include <glad/glad.h>
+
+namespace GEM {
+namespace Renderer {
+    class StateCache;
+}
+}
+
+/**
+ * @brief A class shadowing the gl state the renderer touches: the program in use, the bound VAO, the buffers
+ * bound to each target, the textures bound to each unit, and which capabilities are enabled. Every change
+ * goes through here and the gl call is skipped when the state already has the value asked for
+ *
+ * State starts out unknown, so the first call for each piece of state always reaches gl. Anything which
+ * changes gl state behind our back must call invalidate afterwards
+ *
+ * @note There is only one gl context, so all of the state is static
+ */
+class GEM::Renderer::StateCache {
+public: // public classes and enums
+    struct Statistics {
+        uint64_t issuedCount;
+        uint64_t elidedCount;
+    };
+
+public: // public static variables
+    static const std::string LOGGER_NAME;
+
+    // The value of a piece of state we don't know, which never matches a real id
+    static const uint32_t UNKNOWN_ID;
+
+    static const uint32_t MAX_TEXTURE_UNIT_COUNT;
+
+public: // public static functions
+    static void useProgram(const uint32_t programID);
+    static void bindVertexArray(const uint32_t vertexArrayObjectID);
+    static void bindBuffer(const GLenum target, const uint32_t bufferID);
+    static void bindBufferBase(const GLenum target, const uint32_t index, const uint32_t bufferID);
+    static void activeTexture(const uint32_t textureUnit);
+    static void bindTexture(const GLenum target, const uint32_t textureID);
+    static void enable(const GLenum capability);
+    static void disable(const GLenum capability);
+
+    static void deleteProgram(const uint32_t programID);
+    static void deleteVertexArray(const uint32_t vertexArrayObjectID);
+    static void deleteBuffer(const uint32_t bufferID);
+    static void deleteTexture(const uint32_t textureID);
+
+    static void invalidate();
+
+    static bool isExtensionSupported(const std::string& extensionName);
+
+    static const GEM::Renderer::StateCache::Statistics& getStatistics() { return statistics; }
+    static void resetStatistics();
+
+public: // public member functions
+    StateCache() = delete;
+
+private: // private static functions
+    static int32_t getTextureTargetIndex(const GLenum target);
+    static std::array<std::array<uint32_t, 3>, 32> makeUnknownTextureIDs();
+    static bool elide(const bool unchanged);
+
+private: // private static variables
+    static uint32_t programID;
+    static uint32_t vertexArrayObjectID;
+    static std::map<GLenum, uint32_t> bufferIDs;
+    static std::map<std::pair<GLenum, uint32_t>, uint32_t> indexedBufferIDs;
+    static uint32_t activeTextureUnit;
+
+    // The texture bound to each of the tracked targets, for every texture unit
+    static std::array<std::array<uint32_t, 3>, 32> textureIDs;
+
+    static std::map<GLenum, bool> capabilities;
+
+    static std::set<std::string> extensions;
+    static bool extensionsQueried;
+
+    static GEM::Renderer::StateCache::Statistics statistics;
+};
\ No newline at end of file
@@ -0,0 +1,6 @@
+#pragma once
+
+/**
+ * @brief The name of the logger used by the state classes
+ */
+#define STATE_LOGGER_NAME "STATE"
\ No newline at end of file
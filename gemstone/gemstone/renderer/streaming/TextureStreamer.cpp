@@ -0,0 +1,293 @@
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "util/logger/Logger.hpp"
+
+#include "gemstone/camera/Camera.hpp"
+#include "gemstone/object/Object.hpp"
+#include "gemstone/renderer/streaming/logger.hpp"
+#include "gemstone/renderer/streaming/TextureStreamer.hpp"
+#include "gemstone/renderer/texture/Texture.hpp"
+#include "gemstone/renderer/upload/UploadQueue.hpp"
+
+/* ------------------------------ public static variables ------------------------------ */
+
+/**
+ * @brief The name of the logger the TextureStreamer class uses
+ */
+const std::string GEM::Renderer::TextureStreamer::LOGGER_NAME = STREAMING_LOGGER_NAME;
+
+/**
+ * @brief The budget streamers are created with unless they are given another, 256 MiB
+ */
+const uint64_t GEM::Renderer::TextureStreamer::DEFAULT_BUDGET_BYTES = 256ull * 1024ull * 1024ull;
+
+/* ------------------------------ private static variables ------------------------------ */
+
+/* ------------------------------ public static functions ------------------------------ */
+
+/* ------------------------------ private static functions ------------------------------ */
+
+/**
+ * @brief Estimate the finest level of a texture needed to draw an object with it. The object's world space
+ * bounding sphere is projected onto the screen the same way Mesh::selectLod does, and every level finer than the
+ * one with about as many texels across as the object covers pixels would only be minified away
+ *
+ * @param texture The streamable texture the object is drawn with
+ * @param object The object being drawn
+ * @param viewMatrix The camera's view matrix
+ * @param projectionMatrix The camera's perspective projection matrix
+ * @param viewportHeightPixels The height of the viewport the object is drawn into
+ * @return uint32_t The finest level needed, 0 being full resolution
+ */
+uint32_t GEM::Renderer::TextureStreamer::getNeededLevel(
+    const GEM::Renderer::Texture& texture,
+    const GEM::Object& object,
+    const glm::mat4& viewMatrix,
+    const glm::mat4& projectionMatrix,
+    const float viewportHeightPixels
+) {
+    const glm::vec3 boundsCenter = (object.getWorldBoundsMin() + object.getWorldBoundsMax()) * 0.5f;
+    const float boundsRadius = glm::length(object.getWorldBoundsMax() - object.getWorldBoundsMin()) * 0.5f;
+    if (boundsRadius <= 0.0f) {
+        return 0;
+    }
+
+    // Use full resolution when the camera is inside or right up against the object
+    const glm::vec4 viewCenter = viewMatrix * glm::vec4(boundsCenter, 1.0f);
+    const float distance = -viewCenter.z;
+    if (distance <= boundsRadius) {
+        return 0;
+    }
+
+    // projectionMatrix[1][1] is the cotangent of half the vertical field of view
+    const float projectedDiameterPixels = (boundsRadius * projectionMatrix[1][1] * viewportHeightPixels) / distance;
+    const float texelsAcross = static_cast<float>(std::max(texture.getWidth(), texture.getHeight()));
+    if (projectedDiameterPixels >= texelsAcross) {
+        return 0;
+    }
+
+    // Each level halves the texels across, so this is how many levels can be skipped before a texel covers more
+    // than a pixel
+    const uint32_t smallestLevel = static_cast<uint32_t>(texture.getLevelSizesBytes().size()) - 1;
+    const float neededLevel = std::floor(std::log2(texelsAcross / std::max(projectedDiameterPixels, 1.0f)));
+
+    return std::min(static_cast<uint32_t>(neededLevel), smallestLevel);
+}
+
+/**
+ * @brief Get the number of bytes a texture's levels take up on the gpu while a given level and every smaller one
+ * is resident
+ *
+ * @param streamedTexture The texture
+ * @param firstLevel The finest level resident
+ * @return uint64_t The size of the resident levels in bytes
+ */
+uint64_t GEM::Renderer::TextureStreamer::getSizeBytes(const GEM::Renderer::TextureStreamer::StreamedTexture& streamedTexture, const uint32_t firstLevel) {
+    uint64_t sizeBytes = 0;
+    for (size_t i = firstLevel; i < streamedTexture.levelSizesBytes.size(); i++) {
+        sizeBytes += streamedTexture.levelSizesBytes[i];
+    }
+
+    return sizeBytes;
+}
+
+/* ------------------------------ public member functions ------------------------------ */
+
+/**
+ * @brief Construct a new GEM::Renderer::TextureStreamer::TextureStreamer object which isn't streaming anything yet
+ *
+ * @param budgetBytes The most memory the streamable textures' resident levels may take up on the gpu
+ */
+GEM::Renderer::TextureStreamer::TextureStreamer(const uint64_t budgetBytes) :
+    m_budgetBytes(budgetBytes),
+    m_residentSizeBytes(0),
+    m_frameIndex(0),
+    m_streamedTextures()
+{
+    LOG_FUNCTION_CALL_INFO("budget {} bytes", m_budgetBytes);
+}
+
+/**
+ * @brief Destroy the GEM::Renderer::TextureStreamer::TextureStreamer object. The textures keep whichever levels
+ * are resident
+ */
+GEM::Renderer::TextureStreamer::~TextureStreamer() {
+    LOG_FUNCTION_CALL_TRACE("{} streamed textures", m_streamedTextures.size());
+}
+
+/**
+ * @brief Stream the levels the visible objects need in, and drop the least recently needed levels while the
+ * resident levels don't fit in the budget. This should be called once a frame with the objects which will be
+ * drawn, before anything reads their textures' ids
+ *
+ * @note This will throw if a cooked texture file can no longer be loaded
+ *
+ * @param camera The camera the objects will be drawn with
+ * @param visibleObjectPtrs The objects which will be drawn this frame
+ */
+void GEM::Renderer::TextureStreamer::update(const GEM::Camera& camera, const std::vector<std::shared_ptr<GEM::Object>>& visibleObjectPtrs) {
+    LOG_FUNCTION_ENTRY_TRACE("{} visible objects", visibleObjectPtrs.size());
+
+    m_frameIndex += 1;
+
+    // Forget the textures which are gone, and start every other one off keeping the levels it already has
+    for (std::map<size_t, GEM::Renderer::TextureStreamer::StreamedTexture>::iterator streamedTextureIterator = m_streamedTextures.begin(); streamedTextureIterator != m_streamedTextures.end();) {
+        const std::shared_ptr<const GEM::Renderer::Texture> p_texture = streamedTextureIterator->second.p_texture.lock();
+        if (!p_texture) {
+            streamedTextureIterator = m_streamedTextures.erase(streamedTextureIterator);
+            continue;
+        }
+
+        streamedTextureIterator->second.targetLevel = p_texture->getResidentLevel();
+        ++streamedTextureIterator;
+    }
+
+    const glm::mat4& viewMatrix = camera.getViewMatrix();
+    const glm::mat4& projectionMatrix = camera.getProjectionMatrix();
+    const float viewportHeightPixels = camera.getViewportHeightPixels();
+    for (const std::shared_ptr<GEM::Object>& p_object : visibleObjectPtrs) {
+        for (const std::shared_ptr<const GEM::Renderer::Texture>& p_texture : {p_object->getTexture(), p_object->getTexture2()}) {
+            if (!p_texture || !p_texture->isStreamable()) {
+                continue;
+            }
+
+            markNeededLevels(
+                p_texture,
+                GEM::Renderer::TextureStreamer::getNeededLevel(*p_texture, *p_object, viewMatrix, projectionMatrix, viewportHeightPixels)
+            );
+        }
+    }
+
+    fitTargetLevelsInBudget();
+    applyTargetLevels();
+}
+
+/* ------------------------------ private member functions ------------------------------ */
+
+/**
+ * @brief Record that a texture needs a level and every smaller one this frame, and have the level streamed in if
+ * it isn't resident. Textures seen for the first time start being tracked
+ *
+ * @param p_texture The streamable texture
+ * @param neededLevel The finest level the texture needs
+ */
+void GEM::Renderer::TextureStreamer::markNeededLevels(const std::shared_ptr<const GEM::Renderer::Texture>& p_texture, const uint32_t neededLevel) {
+    std::map<size_t, GEM::Renderer::TextureStreamer::StreamedTexture>::iterator streamedTextureIterator = m_streamedTextures.find(p_texture->getSourceHash());
+    if (streamedTextureIterator == m_streamedTextures.end()) {
+        LOG_TRACE("Streaming texture with hash {} , {} levels", p_texture->getSourceHash(), p_texture->getLevelSizesBytes().size());
+
+        streamedTextureIterator = m_streamedTextures.insert({p_texture->getSourceHash(), {
+            p_texture,
+            p_texture->getLevelSizesBytes(),
+            std::vector<uint64_t>(p_texture->getLevelSizesBytes().size(), 0),
+            p_texture->getResidentLevel()
+        }}).first;
+    }
+
+    GEM::Renderer::TextureStreamer::StreamedTexture& streamedTexture = streamedTextureIterator->second;
+    for (size_t i = neededLevel; i < streamedTexture.levelLastNeededFrames.size(); i++) {
+        streamedTexture.levelLastNeededFrames[i] = m_frameIndex;
+    }
+
+    streamedTexture.targetLevel = std::min(streamedTexture.targetLevel, neededLevel);
+}
+
+/**
+ * @brief Drop the finest target level of whichever texture needed it the longest ago, breaking ties by dropping
+ * the largest level, until the target levels fit in the budget. Each texture always keeps its smallest level, so
+ * the budget can still be exceeded if it is too small to hold even those
+ */
+void GEM::Renderer::TextureStreamer::fitTargetLevelsInBudget() {
+    uint64_t targetSizeBytes = 0;
+    for (const std::pair<const size_t, GEM::Renderer::TextureStreamer::StreamedTexture>& streamedTexturePair : m_streamedTextures) {
+        targetSizeBytes += GEM::Renderer::TextureStreamer::getSizeBytes(streamedTexturePair.second, streamedTexturePair.second.targetLevel);
+    }
+
+    while (targetSizeBytes > m_budgetBytes) {
+        GEM::Renderer::TextureStreamer::StreamedTexture* p_evictedTexture = nullptr;
+        for (std::pair<const size_t, GEM::Renderer::TextureStreamer::StreamedTexture>& streamedTexturePair : m_streamedTextures) {
+            GEM::Renderer::TextureStreamer::StreamedTexture& streamedTexture = streamedTexturePair.second;
+            if (streamedTexture.targetLevel + 1 >= streamedTexture.levelSizesBytes.size()) {
+                continue;
+            }
+
+            if (p_evictedTexture == nullptr) {
+                p_evictedTexture = &streamedTexture;
+                continue;
+            }
+
+            const uint64_t lastNeededFrame = streamedTexture.levelLastNeededFrames[streamedTexture.targetLevel];
+            const uint64_t evictedLastNeededFrame = p_evictedTexture->levelLastNeededFrames[p_evictedTexture->targetLevel];
+            if (
+                lastNeededFrame < evictedLastNeededFrame ||
+                (lastNeededFrame == evictedLastNeededFrame && streamedTexture.levelSizesBytes[streamedTexture.targetLevel] > p_evictedTexture->levelSizesBytes[p_evictedTexture->targetLevel])
+            ) {
+                p_evictedTexture = &streamedTexture;
+            }
+        }
+
+        if (p_evictedTexture == nullptr) {
+            LOG_DEBUG("Smallest levels of {} streamed textures take {} bytes , over the budget of {} bytes", m_streamedTextures.size(), targetSizeBytes, m_budgetBytes);
+            break;
+        }
+
+        targetSizeBytes -= p_evictedTexture->levelSizesBytes[p_evictedTexture->targetLevel];
+        p_evictedTexture->targetLevel += 1;
+    }
+}
+
+/**
+ * @brief Make every texture's resident level its target level. Levels are dropped before any are streamed in, so
+ * the resident levels never go over the budget in between. Dropping levels always happens right away, but levels
+ * are only streamed in while the UploadQueue has room in its budget for the frame, and the rest are left for a
+ * later frame
+ */
+void GEM::Renderer::TextureStreamer::applyTargetLevels() {
+    uint32_t droppedCount = 0;
+    uint32_t streamedInCount = 0;
+    uint32_t deferredCount = 0;
+    for (const bool droppingLevels : {true, false}) {
+        for (const std::pair<const size_t, GEM::Renderer::TextureStreamer::StreamedTexture>& streamedTexturePair : m_streamedTextures) {
+            const uint32_t residentLevel = streamedTexturePair.second.p_texture.lock()->getResidentLevel();
+            const uint32_t targetLevel = streamedTexturePair.second.targetLevel;
+            if (targetLevel == residentLevel || (targetLevel > residentLevel) != droppingLevels) {
+                continue;
+            }
+
+            if (!droppingLevels && !GEM::Renderer::UploadQueue::canStage()) {
+                deferredCount += 1;
+                continue;
+            }
+
+            GEM::Renderer::Texture::setResidentLevel(streamedTexturePair.first, targetLevel);
+            if (droppingLevels) {
+                droppedCount += 1;
+            } else {
+                streamedInCount += 1;
+            }
+        }
+    }
+
+    m_residentSizeBytes = 0;
+    for (const std::pair<const size_t, GEM::Renderer::TextureStreamer::StreamedTexture>& streamedTexturePair : m_streamedTextures) {
+        m_residentSizeBytes += GEM::Renderer::TextureStreamer::getSizeBytes(streamedTexturePair.second, streamedTexturePair.second.p_texture.lock()->getResidentLevel());
+    }
+
+    if (droppedCount > 0 || streamedInCount > 0 || deferredCount > 0) {
+        LOG_DEBUG(
+            "Dropped levels of {} textures , streamed levels of {} textures in , {} textures waiting for the upload budget , {} of {} bytes resident",
+            droppedCount,
+            streamedInCount,
+            deferredCount,
+            m_residentSizeBytes,
+            m_budgetBytes
+        );
+    }
+}
\ No newline at end of file
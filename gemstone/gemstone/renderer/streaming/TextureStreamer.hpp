@@ -0,0 +1,83 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "gemstone/camera/Camera.hpp"
+#include "gemstone/object/Object.hpp"
+#include "gemstone/renderer/texture/Texture.hpp"
+
+namespace GEM {
+namespace Renderer {
+    class TextureStreamer;
+}
+}
+
+/**
+ * @brief A class that decides which mip levels of the streamable textures stay on the gpu. Each frame the finest
+ * level every visible object needs is estimated from how large it appears on screen, assuming its texture is
+ * stretched across it once. Needed levels which aren't resident are streamed back in, and while the resident
+ * levels don't fit in the budget the finest level which was needed the longest ago is dropped, one at a time,
+ * until they do. Levels which are no longer needed stay resident until the budget runs out, so looking away and
+ * back again doesn't stream anything. Levels are only streamed in while the UploadQueue has room in its budget
+ * for the frame
+ *
+ * @note Only streamable textures (see Texture::isStreamable) count against the budget, every other texture
+ * always keeps its full mip chain
+ */
+class GEM::Renderer::TextureStreamer {
+public: // public static variables
+    static const std::string LOGGER_NAME;
+
+    static const uint64_t DEFAULT_BUDGET_BYTES;
+
+public: // public member functions
+    TextureStreamer(const uint64_t budgetBytes = GEM::Renderer::TextureStreamer::DEFAULT_BUDGET_BYTES);
+    ~TextureStreamer();
+
+    TextureStreamer(const TextureStreamer& other) = delete;
+    void operator=(const TextureStreamer& other) = delete;
+
+    void update(const GEM::Camera& camera, const std::vector<std::shared_ptr<GEM::Object>>& visibleObjectPtrs);
+
+    uint64_t getBudgetBytes() const { return m_budgetBytes; }
+    void setBudgetBytes(const uint64_t budgetBytes) { m_budgetBytes = budgetBytes; }
+    uint64_t getResidentSizeBytes() const { return m_residentSizeBytes; }
+
+private: // private enums and classes
+    struct StreamedTexture {
+        // Held weakly so the streamer never keeps a texture alive after every object using it is gone
+        std::weak_ptr<const GEM::Renderer::Texture> p_texture;
+        std::vector<uint64_t> levelSizesBytes;
+        // The last frame each level was needed on, 0 if it never has been
+        std::vector<uint64_t> levelLastNeededFrames;
+        uint32_t targetLevel;
+    };
+
+private: // private static functions
+    static uint32_t getNeededLevel(
+        const GEM::Renderer::Texture& texture,
+        const GEM::Object& object,
+        const glm::mat4& viewMatrix,
+        const glm::mat4& projectionMatrix,
+        const float viewportHeightPixels
+    );
+    static uint64_t getSizeBytes(const GEM::Renderer::TextureStreamer::StreamedTexture& streamedTexture, const uint32_t firstLevel);
+
+private: // private member functions
+    void markNeededLevels(const std::shared_ptr<const GEM::Renderer::Texture>& p_texture, const uint32_t neededLevel);
+    void fitTargetLevelsInBudget();
+    void applyTargetLevels();
+
+private: // private member variables
+    uint64_t m_budgetBytes;
+    uint64_t m_residentSizeBytes;
+    uint64_t m_frameIndex;
+
+    // Keyed by the texture's source hash, so every texture sharing a gl texture is streamed together
+    std::map<size_t, GEM::Renderer::TextureStreamer::StreamedTexture> m_streamedTextures;
+};
\ No newline at end of file
@@ -0,0 +1,6 @@
+#pragma once
+
+/**
+ * @brief The name of the logger used by the streaming classes
+ */
+#define STREAMING_LOGGER_NAME "STREAMING"
\ No newline at end of file
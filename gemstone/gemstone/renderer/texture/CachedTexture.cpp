@@ -0,0 +1,351 @@
+#include "gemstone/renderer/texture/CachedTexture.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional> // std::hash
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "util/io/FileSystem.hpp"
+#include "util/io/MappedFile.hpp"
+#include "util/logger/Logger.hpp"
+
+#include "gemstone/renderer/texture/logger.hpp"
+#include "gemstone/renderer/texture/TextureCompressor.hpp"
+#include "gemstone/renderer/texture/TextureDecoder.hpp"
+
+// The header and levels are read straight out of the mapped file, so their layout must never change without
+// bumping the version
+static_assert(sizeof(GEM::Renderer::CachedTexture::Header) == 40, "Cached texture header must be 40 bytes");
+static_assert(sizeof(GEM::Renderer::CachedTexture::Level) == 24, "Cached texture level must be 24 bytes");
+
+/* ------------------------------ public static variables ------------------------------ */
+
+/**
+ * @brief The name of the logger the CachedTexture class uses
+ */
+const std::string GEM::Renderer::CachedTexture::LOGGER_NAME = TEXTURE_LOGGER_NAME;
+
+/**
+ * @brief The extension given to cached texture files
+ */
+const std::string GEM::Renderer::CachedTexture::FILE_EXTENSION = "gtexcache";
+
+/**
+ * @brief The version of the cached texture format. Files written with any other version are decoded again
+ */
+const uint32_t GEM::Renderer::CachedTexture::VERSION = 2;
+
+/**
+ * @brief The alignment in bytes of the start of each level's data
+ */
+const uint64_t GEM::Renderer::CachedTexture::SECTION_ALIGNMENT = 64;
+
+/**
+ * @brief The offset basis of the 64 bit FNV-1a hash the contents of image files are hashed with
+ */
+const uint64_t GEM::Renderer::CachedTexture::FNV_OFFSET_BASIS = 0xcbf29ce484222325;
+
+/**
+ * @brief The prime of the 64 bit FNV-1a hash the contents of image files are hashed with
+ */
+const uint64_t GEM::Renderer::CachedTexture::FNV_PRIME = 0x100000001b3;
+
+/* ------------------------------ private static variables ------------------------------ */
+
+/**
+ * @brief The full path to the directory the cached textures are kept in
+ */
+std::string GEM::Renderer::CachedTexture::directory = GEM::util::FileSystem::getFullPath(".cache/textures");
+
+/* ------------------------------ public static functions ------------------------------ */
+
+/**
+ * @brief Set the directory the cached textures are kept in. It is created when the first texture is written
+ *
+ * @note The TextureDecoder's worker threads read the directory, so it must only be set while they aren't running
+ *
+ * @param cacheDirectory The full path to the directory
+ */
+void GEM::Renderer::CachedTexture::setDirectory(const std::string& cacheDirectory) {
+    LOG_FUNCTION_CALL_INFO("directory {}", cacheDirectory);
+    GEM::Renderer::CachedTexture::directory = cacheDirectory;
+}
+
+/**
+ * @brief Hash the contents of an image file with 64 bit FNV-1a, which is what its cached texture is looked up by.
+ * Reading the file is much cheaper than decoding it, and unlike std::hash the hash is the same for every build,
+ * so a cache written by one build is found by another
+ *
+ * @param filename The full path to the image file
+ * @return size_t The hash of the file's contents, 0 if it can't be read
+ */
+size_t GEM::Renderer::CachedTexture::getContentHash(const std::string& filename) {
+    LOG_FUNCTION_ENTRY_TRACE("filename {}", filename);
+
+    try {
+        const GEM::util::MappedFile file(filename);
+        uint64_t contentHash = GEM::Renderer::CachedTexture::FNV_OFFSET_BASIS;
+        for (uint64_t i = 0; i < file.getSize(); i++) {
+            contentHash ^= static_cast<uint8_t>(file.getData()[i]);
+            contentHash *= GEM::Renderer::CachedTexture::FNV_PRIME;
+        }
+
+        return static_cast<size_t>(contentHash);
+    } catch (const std::exception& ex) {
+        LOG_DEBUG("Cannot hash the contents of {} , it won't be cached : {}", filename, ex.what());
+        return 0;
+    }
+}
+
+/**
+ * @brief Get the full path to the file the texture decoded from an image with the given contents is kept in
+ *
+ * @param contentHash The hash of the image file's contents
+ * @return std::string The full path to the file
+ */
+std::string GEM::Renderer::CachedTexture::getFilename(const size_t contentHash) {
+    std::ostringstream filename;
+    filename << GEM::Renderer::CachedTexture::directory << "/" << std::hex << std::setfill('0')
+        << std::setw(16) << contentHash
+        << "." << GEM::Renderer::CachedTexture::FILE_EXTENSION;
+    return filename.str();
+}
+
+/**
+ * @brief Generate every mip level of a decoded image and write them into the cache, so the next run loads them
+ * instead of decoding the image. The file is written next to the real one then moved over it, so nothing ever
+ * sees half of a file. Failing to write is not an error, the image is just decoded again next time. This runs
+ * on the TextureDecoder's worker threads so it must not log or throw
+ *
+ * @param contentHash The hash of the image file's contents
+ * @param image The decoded image, already flipped the way gl expects
+ * @return true The cached texture was written
+ * @return false The cached texture could not be written
+ */
+bool GEM::Renderer::CachedTexture::write(const size_t contentHash, const GEM::Renderer::TextureDecoder::Image& image) {
+    if (!image.p_pixels || image.width <= 0 || image.height <= 0 || image.channelCount < 1 || image.channelCount > 4) {
+        return false;
+    }
+
+    const uint64_t sourceSizeBytes = GEM::Renderer::CachedTexture::getSourceSize(image.filename);
+    if (sourceSizeBytes == 0) {
+        return false;
+    }
+
+    const uint32_t width = static_cast<uint32_t>(image.width);
+    const uint32_t height = static_cast<uint32_t>(image.height);
+    const std::vector<GEM::Renderer::TextureCompressor::MipLevel> mipLevels = GEM::Renderer::TextureCompressor::generateMipChain(
+        GEM::Renderer::TextureCompressor::convertToRGBA(image.p_pixels.get(), width, height, static_cast<uint32_t>(image.channelCount)),
+        width,
+        height
+    );
+
+    GEM::Renderer::CachedTexture::Header header;
+    std::memcpy(header.magic, "GTXC", 4);
+    header.version = GEM::Renderer::CachedTexture::VERSION;
+    header.contentHash = contentHash;
+    header.sourceSizeBytes = sourceSizeBytes;
+    header.width = width;
+    header.height = height;
+    header.levelCount = static_cast<uint32_t>(mipLevels.size());
+    header.padding = 0;
+
+    const uint64_t tableEnd = sizeof(header) + (mipLevels.size() * sizeof(GEM::Renderer::CachedTexture::Level));
+    std::vector<GEM::Renderer::CachedTexture::Level> levels(mipLevels.size());
+    uint64_t dataEnd = tableEnd;
+    for (size_t i = 0; i < levels.size(); i++) {
+        levels[i].dataOffset = GEM::Renderer::CachedTexture::alignOffset(dataEnd);
+        levels[i].dataSizeBytes = mipLevels[i].pixels.size();
+        levels[i].width = mipLevels[i].width;
+        levels[i].height = mipLevels[i].height;
+        dataEnd = levels[i].dataOffset + levels[i].dataSizeBytes;
+    }
+
+    std::error_code errorCode;
+    std::filesystem::create_directories(GEM::Renderer::CachedTexture::directory, errorCode);
+    if (errorCode) {
+        return false;
+    }
+
+    // Several worker threads can decode images with the same contents at once, so each writes its own file
+    const std::string filename = GEM::Renderer::CachedTexture::getFilename(contentHash);
+    const std::string temporaryFilename = filename + "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+    {
+        // Pad each level out to its aligned offset with zeroes
+        const std::vector<char> padding(GEM::Renderer::CachedTexture::SECTION_ALIGNMENT, 0);
+
+        std::ofstream file(temporaryFilename, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(levels.data()), levels.size() * sizeof(GEM::Renderer::CachedTexture::Level));
+        uint64_t writtenEnd = tableEnd;
+        for (size_t i = 0; i < levels.size(); i++) {
+            file.write(padding.data(), levels[i].dataOffset - writtenEnd);
+            file.write(reinterpret_cast<const char*>(mipLevels[i].pixels.data()), levels[i].dataSizeBytes);
+            writtenEnd = levels[i].dataOffset + levels[i].dataSizeBytes;
+        }
+
+        if (!file) {
+            file.close();
+            std::filesystem::remove(temporaryFilename, errorCode);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temporaryFilename, filename, errorCode);
+    if (errorCode) {
+        std::filesystem::remove(temporaryFilename, errorCode);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Remove a file from the cache, ignoring any failure since the image is decoded again either way
+ *
+ * @param filename The full path to the file
+ */
+void GEM::Renderer::CachedTexture::removeFile(const std::string& filename) {
+    LOG_FUNCTION_ENTRY_TRACE("filename {}", filename);
+
+    std::error_code errorCode;
+    std::filesystem::remove(filename, errorCode);
+}
+
+/* ------------------------------ private static functions ------------------------------ */
+
+/**
+ * @brief Round an offset up to the next multiple of SECTION_ALIGNMENT
+ *
+ * @param offset The offset in bytes to align
+ * @return uint64_t The aligned offset
+ */
+uint64_t GEM::Renderer::CachedTexture::alignOffset(const uint64_t offset) {
+    const uint64_t alignment = GEM::Renderer::CachedTexture::SECTION_ALIGNMENT;
+    return ((offset + alignment - 1) / alignment) * alignment;
+}
+
+/**
+ * @brief Get the size of an image file a texture is cached for. This must not log or throw, since it is used
+ * when writing the cache on the TextureDecoder's worker threads
+ *
+ * @param sourceFilename The full path to the image file
+ * @return uint64_t The size of the file in bytes, 0 if it can't be read
+ */
+uint64_t GEM::Renderer::CachedTexture::getSourceSize(const std::string& sourceFilename) {
+    std::error_code errorCode;
+    const uintmax_t sourceSizeBytes = std::filesystem::file_size(sourceFilename, errorCode);
+    if (errorCode) {
+        return 0;
+    }
+
+    return static_cast<uint64_t>(sourceSizeBytes);
+}
+
+/**
+ * @brief Make sure the mapped file is a cached texture we wrote for an image with these contents and size, and
+ * that every level it describes has the size its dimensions call for and actually lies within the file, so
+ * nothing read through the header can go out of bounds
+ *
+ * @note This function will throw if the file is not a valid cached texture
+ *
+ * @param file The mapped cached texture file
+ * @param contentHash The hash of the image file's contents
+ * @param sourceFilename The full path to the image file
+ * @return const GEM::Renderer::CachedTexture::Header* The header at the start of the file
+ */
+const GEM::Renderer::CachedTexture::Header* GEM::Renderer::CachedTexture::validateHeader(
+    const GEM::util::MappedFile& file,
+    const size_t contentHash,
+    const std::string& sourceFilename
+) {
+    LOG_FUNCTION_ENTRY_TRACE("filename {} , size {}", file.getFilename(), file.getSize());
+
+    const auto fail = [&file](const std::string& reason) {
+        const std::string errorMessage = "Invalid cached texture " + file.getFilename() + " : " + reason;
+        LOG_WARNING(errorMessage);
+        throw std::runtime_error(errorMessage);
+    };
+
+    if (file.getSize() < sizeof(GEM::Renderer::CachedTexture::Header)) {
+        fail("file is smaller than the header");
+    }
+
+    const GEM::Renderer::CachedTexture::Header* p_header = reinterpret_cast<const GEM::Renderer::CachedTexture::Header*>(file.getData());
+    if (std::memcmp(p_header->magic, "GTXC", 4) != 0) {
+        fail("bad magic");
+    }
+    if (p_header->version != GEM::Renderer::CachedTexture::VERSION) {
+        fail("version " + std::to_string(p_header->version) + " , expected " + std::to_string(GEM::Renderer::CachedTexture::VERSION));
+    }
+    if (p_header->contentHash != contentHash) {
+        fail("it was written for an image with other contents");
+    }
+    if (p_header->sourceSizeBytes != GEM::Renderer::CachedTexture::getSourceSize(sourceFilename)) {
+        fail("it was written for an image of " + std::to_string(p_header->sourceSizeBytes) + " bytes , whose contents only hash the same");
+    }
+    if (p_header->width == 0 || p_header->height == 0) {
+        fail("no pixels");
+    }
+    if (p_header->levelCount == 0 || p_header->levelCount > 32) {
+        fail(std::to_string(p_header->levelCount) + " levels");
+    }
+
+    const uint64_t tableEnd = sizeof(GEM::Renderer::CachedTexture::Header) + (static_cast<uint64_t>(p_header->levelCount) * sizeof(GEM::Renderer::CachedTexture::Level));
+    if (tableEnd > file.getSize()) {
+        fail("level table extends past the end of the file");
+    }
+
+    const GEM::Renderer::CachedTexture::Level* p_levels = reinterpret_cast<const GEM::Renderer::CachedTexture::Level*>(file.getData() + sizeof(GEM::Renderer::CachedTexture::Header));
+    for (uint32_t i = 0; i < p_header->levelCount; ++i) {
+        const GEM::Renderer::CachedTexture::Level& level = p_levels[i];
+        if (level.width != std::max<uint32_t>(p_header->width >> i, 1) || level.height != std::max<uint32_t>(p_header->height >> i, 1)) {
+            fail("level " + std::to_string(i) + " is " + std::to_string(level.width) + "x" + std::to_string(level.height));
+        }
+        if (level.dataSizeBytes != static_cast<uint64_t>(level.width) * level.height * 4) {
+            fail("level " + std::to_string(i) + " size does not match its dimensions");
+        }
+        if (level.dataOffset < tableEnd || level.dataOffset > file.getSize() || level.dataSizeBytes > file.getSize() - level.dataOffset) {
+            fail("level " + std::to_string(i) + " extends past the end of the file");
+        }
+    }
+
+    return p_header;
+}
+
+/* ------------------------------ public member functions ------------------------------ */
+
+/**
+ * @brief Construct a new GEM::Renderer::CachedTexture::CachedTexture object by mapping the cached file into memory
+ *
+ * @note This will throw if the file cannot be mapped or is not a valid cached texture for the contents
+ *
+ * @param filename The full path to the cached texture file
+ * @param contentHash The hash of the contents of the image file the texture is being loaded for
+ * @param sourceFilename The full path to the image file the texture is being loaded for
+ */
+GEM::Renderer::CachedTexture::CachedTexture(const std::string& filename, const size_t contentHash, const std::string& sourceFilename) :
+    m_file(filename),
+    mp_header(GEM::Renderer::CachedTexture::validateHeader(m_file, contentHash, sourceFilename)),
+    mp_levels(reinterpret_cast<const GEM::Renderer::CachedTexture::Level*>(m_file.getData() + sizeof(GEM::Renderer::CachedTexture::Header)))
+{
+    LOG_FUNCTION_CALL_TRACE("filename {} , width {} , height {} , level count {}", filename, mp_header->width, mp_header->height, mp_header->levelCount);
+}
+
+/**
+ * @brief Destroy the GEM::Renderer::CachedTexture::CachedTexture object, unmapping the file
+ */
+GEM::Renderer::CachedTexture::~CachedTexture() {
+    LOG_FUNCTION_CALL_TRACE("filename {}", m_file.getFilename());
+}
+
+/* ------------------------------ private member functions ------------------------------ */
\ No newline at end of file
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <string>
+
+#include "util/io/MappedFile.hpp"
+
+#include "gemstone/renderer/texture/TextureDecoder.hpp"
+
+namespace GEM {
+namespace Renderer {
+    class CachedTexture;
+}
+}
+
+/**
+ * @brief A texture decoded on a previous run, kept in a cache on disk so it never has to be decoded again. Each
+ * file holds the image already flipped the way gl expects, converted to rgba, and with every mip level generated,
+ * laid out like a CookedTexture as a header, a descriptor for each level, then each level's pixels starting on a
+ * SECTION_ALIGNMENT boundary. Loading one maps the file into memory and exposes pointers into the mapping which
+ * can be handed straight to gl
+ *
+ * Files are named after, and keyed by, a hash of the contents of the image file they were decoded from, so an
+ * edited image is decoded again and a renamed or copied one is not. The hash is 64 bit FNV-1a, which is the same
+ * for every build, and the size of the image file is kept alongside it so an image whose contents happen to hash
+ * the same as another's isn't given the other's pixels. Wrapping and filtering don't change the pixels, so
+ * textures loaded from the same image with any parameters share a file
+ *
+ * The mip levels are box filtered on the cpu when the file is written, while the texture uploaded on the run
+ * which decoded the image has its mipmaps generated by the driver. The two can differ slightly in their smaller
+ * levels, so a texture can look a little different on its first run than on every run after
+ *
+ * Files are only written by the TextureDecoder's worker threads, so images loaded while async loading isn't
+ * started are never cached, and decoding them doesn't also generate and write their mip levels on the render
+ * thread
+ *
+ * @note All values are stored little endian
+ */
+class GEM::Renderer::CachedTexture {
+public: // public classes and enums
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint64_t contentHash;
+        uint64_t sourceSizeBytes;
+        uint32_t width;
+        uint32_t height;
+        uint32_t levelCount;
+        uint32_t padding;
+    };
+
+    struct Level {
+        uint64_t dataOffset;
+        uint64_t dataSizeBytes;
+        uint32_t width;
+        uint32_t height;
+    };
+
+public: // public static variables
+    static const std::string LOGGER_NAME;
+    static const std::string FILE_EXTENSION;
+    static const uint32_t VERSION;
+    static const uint64_t SECTION_ALIGNMENT;
+    static const uint64_t FNV_OFFSET_BASIS;
+    static const uint64_t FNV_PRIME;
+
+public: // public static functions
+    static void setDirectory(const std::string& cacheDirectory);
+    static const std::string& getDirectory() { return directory; }
+
+    static size_t getContentHash(const std::string& filename);
+    static std::string getFilename(const size_t contentHash);
+    static bool write(const size_t contentHash, const GEM::Renderer::TextureDecoder::Image& image);
+    static void removeFile(const std::string& filename);
+
+public: // public member functions
+    CachedTexture(const std::string& filename, const size_t contentHash, const std::string& sourceFilename);
+    ~CachedTexture();
+
+    CachedTexture(const CachedTexture& other) = delete;
+    void operator=(const CachedTexture& other) = delete;
+
+    uint32_t getWidth() const { return mp_header->width; }
+    uint32_t getHeight() const { return mp_header->height; }
+    uint32_t getLevelCount() const { return mp_header->levelCount; }
+    const GEM::Renderer::CachedTexture::Level& getLevel(const uint32_t i) const { return mp_levels[i]; }
+    const void* getLevelData(const uint32_t i) const { return m_file.getData() + mp_levels[i].dataOffset; }
+
+private: // private static functions
+    static uint64_t alignOffset(const uint64_t offset);
+    static uint64_t getSourceSize(const std::string& sourceFilename);
+    static const GEM::Renderer::CachedTexture::Header* validateHeader(
+        const GEM::util::MappedFile& file,
+        const size_t contentHash,
+        const std::string& sourceFilename
+    );
+
+private: // private static variables
+    static std::string directory;
+
+private: // private member variables
+    const GEM::util::MappedFile m_file;
+    const GEM::Renderer::CachedTexture::Header* const mp_header;
+    const GEM::Renderer::CachedTexture::Level* const mp_levels;
+};
\ No newline at end of file
@@ -0,0 +1,256 @@
+#include "gemstone/renderer/texture/CookedTexture.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "util/io/MappedFile.hpp"
+#include "util/logger/Logger.hpp"
+
+#include "gemstone/renderer/texture/logger.hpp"
+#include "gemstone/renderer/texture/TextureCompressor.hpp"
+#include "gemstone/renderer/texture/TextureDecoder.hpp"
+
+// The header and levels are read straight out of the mapped file, so their layout must never change without
+// bumping the version
+static_assert(sizeof(GEM::Renderer::CookedTexture::Header) == 24, "Cooked texture header must be 24 bytes");
+static_assert(sizeof(GEM::Renderer::CookedTexture::Level) == 24, "Cooked texture level must be 24 bytes");
+
+/* ------------------------------ public static variables ------------------------------ */
+
+/**
+ * @brief The name of the logger the CookedTexture class uses
+ */
+const std::string GEM::Renderer::CookedTexture::LOGGER_NAME = TEXTURE_LOGGER_NAME;
+
+/**
+ * @brief The extension given to cooked texture files
+ */
+const std::string GEM::Renderer::CookedTexture::FILE_EXTENSION = "gtex";
+
+/**
+ * @brief The version of the cooked texture format. Files written with any other version are rejected
+ */
+const uint32_t GEM::Renderer::CookedTexture::VERSION = 1;
+
+/**
+ * @brief The alignment in bytes of the start of each level's data
+ */
+const uint64_t GEM::Renderer::CookedTexture::SECTION_ALIGNMENT = 64;
+
+/* ------------------------------ private static variables ------------------------------ */
+
+/* ------------------------------ public static functions ------------------------------ */
+
+/**
+ * @brief Generate the mip chain of a decoded image, compress every level, and write them into a cooked texture
+ * file so they can be uploaded straight to the gpu when it is loaded
+ *
+ * @note This function will throw if the image has no pixels or the file cannot be written
+ *
+ * @param image The decoded image, already flipped the way gl expects
+ * @param format The block compressed format to store the levels in
+ * @param filename The full path to the file to write
+ */
+void GEM::Renderer::CookedTexture::cook(
+    const GEM::Renderer::TextureDecoder::Image& image,
+    const GEM::Renderer::TextureCompressor::Format format,
+    const std::string& filename
+) {
+    LOG_FUNCTION_CALL_INFO("filename {} , width {} , height {} , channel count {}", filename, image.width, image.height, image.channelCount);
+
+    if (!image.p_pixels || image.width <= 0 || image.height <= 0) {
+        const std::string errorMessage = "Cannot cook texture without any pixels into " + filename;
+        LOG_CRITICAL(errorMessage);
+        throw std::invalid_argument(errorMessage);
+    }
+
+    // Do all of the expensive work here so loading the cooked texture is nothing but I/O
+    const uint32_t width = static_cast<uint32_t>(image.width);
+    const uint32_t height = static_cast<uint32_t>(image.height);
+    const std::vector<GEM::Renderer::TextureCompressor::MipLevel> mipLevels = GEM::Renderer::TextureCompressor::generateMipChain(
+        GEM::Renderer::TextureCompressor::convertToRGBA(image.p_pixels.get(), width, height, static_cast<uint32_t>(image.channelCount)),
+        width,
+        height
+    );
+
+    std::vector<std::vector<uint8_t>> compressedLevels;
+    compressedLevels.reserve(mipLevels.size());
+    for (const GEM::Renderer::TextureCompressor::MipLevel& mipLevel : mipLevels) {
+        compressedLevels.push_back(GEM::Renderer::TextureCompressor::compress(mipLevel, format));
+    }
+
+    GEM::Renderer::CookedTexture::Header header;
+    std::memcpy(header.magic, "GTEX", 4);
+    header.version = GEM::Renderer::CookedTexture::VERSION;
+    header.internalFormat = GEM::Renderer::TextureCompressor::getInternalFormat(format);
+    header.width = width;
+    header.height = height;
+    header.levelCount = static_cast<uint32_t>(mipLevels.size());
+
+    const uint64_t tableEnd = sizeof(header) + (mipLevels.size() * sizeof(GEM::Renderer::CookedTexture::Level));
+    std::vector<GEM::Renderer::CookedTexture::Level> levels(mipLevels.size());
+    uint64_t dataEnd = tableEnd;
+    for (size_t i = 0; i < levels.size(); i++) {
+        levels[i].dataOffset = GEM::Renderer::CookedTexture::alignOffset(dataEnd);
+        levels[i].dataSizeBytes = compressedLevels[i].size();
+        levels[i].width = mipLevels[i].width;
+        levels[i].height = mipLevels[i].height;
+        dataEnd = levels[i].dataOffset + levels[i].dataSizeBytes;
+    }
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        const std::string errorMessage = "Failed to open " + filename + " for writing";
+        LOG_CRITICAL(errorMessage);
+        throw std::runtime_error(errorMessage);
+    }
+
+    // Pad each level out to its aligned offset with zeroes
+    const std::vector<char> padding(GEM::Renderer::CookedTexture::SECTION_ALIGNMENT, 0);
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(levels.data()), levels.size() * sizeof(GEM::Renderer::CookedTexture::Level));
+    uint64_t writtenEnd = tableEnd;
+    for (size_t i = 0; i < levels.size(); i++) {
+        file.write(padding.data(), levels[i].dataOffset - writtenEnd);
+        file.write(reinterpret_cast<const char*>(compressedLevels[i].data()), levels[i].dataSizeBytes);
+        writtenEnd = levels[i].dataOffset + levels[i].dataSizeBytes;
+    }
+
+    if (!file) {
+        const std::string errorMessage = "Failed to write cooked texture to " + filename;
+        LOG_CRITICAL(errorMessage);
+        throw std::runtime_error(errorMessage);
+    }
+
+    LOG_DEBUG("Cooked texture into {} , {}x{} , {} levels , {} bytes", filename, header.width, header.height, header.levelCount, dataEnd);
+}
+
+/* ------------------------------ private static functions ------------------------------ */
+
+/**
+ * @brief Round an offset up to the next multiple of SECTION_ALIGNMENT
+ *
+ * @param offset The offset in bytes to align
+ * @return uint64_t The aligned offset
+ */
+uint64_t GEM::Renderer::CookedTexture::alignOffset(const uint64_t offset) {
+    const uint64_t alignment = GEM::Renderer::CookedTexture::SECTION_ALIGNMENT;
+    return ((offset + alignment - 1) / alignment) * alignment;
+}
+
+/**
+ * @brief Get the size of a 4x4 block in one of the formats textures are cooked into
+ *
+ * @param internalFormat The gl internal format of the texture
+ * @return uint64_t The size of a block in bytes, 0 if the format isn't one textures are cooked into
+ */
+uint64_t GEM::Renderer::CookedTexture::getBlockSizeBytes(const GLenum internalFormat) {
+    for (const GEM::Renderer::TextureCompressor::Format format : {
+        GEM::Renderer::TextureCompressor::Format::bc1,
+        GEM::Renderer::TextureCompressor::Format::bc3,
+        GEM::Renderer::TextureCompressor::Format::bc5
+    }) {
+        if (GEM::Renderer::TextureCompressor::getInternalFormat(format) == internalFormat) {
+            return GEM::Renderer::TextureCompressor::getBlockSizeBytes(format);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Make sure the mapped file is a cooked texture we understand and that every level it describes has the
+ * size its dimensions call for and actually lies within the file, so nothing read through the header can go out
+ * of bounds
+ *
+ * @note This function will throw if the file is not a valid cooked texture
+ *
+ * @param file The mapped cooked texture file
+ * @return const GEM::Renderer::CookedTexture::Header* The header at the start of the file
+ */
+const GEM::Renderer::CookedTexture::Header* GEM::Renderer::CookedTexture::validateHeader(const GEM::util::MappedFile& file) {
+    LOG_FUNCTION_ENTRY_TRACE("filename {} , size {}", file.getFilename(), file.getSize());
+
+    const auto fail = [&file](const std::string& reason) {
+        const std::string errorMessage = "Invalid cooked texture " + file.getFilename() + " : " + reason;
+        LOG_CRITICAL(errorMessage);
+        throw std::runtime_error(errorMessage);
+    };
+
+    if (file.getSize() < sizeof(GEM::Renderer::CookedTexture::Header)) {
+        fail("file is smaller than the header");
+    }
+
+    const GEM::Renderer::CookedTexture::Header* p_header = reinterpret_cast<const GEM::Renderer::CookedTexture::Header*>(file.getData());
+    if (std::memcmp(p_header->magic, "GTEX", 4) != 0) {
+        fail("bad magic");
+    }
+    if (p_header->version != GEM::Renderer::CookedTexture::VERSION) {
+        fail("version " + std::to_string(p_header->version) + " , expected " + std::to_string(GEM::Renderer::CookedTexture::VERSION));
+    }
+
+    const uint64_t blockSizeBytes = GEM::Renderer::CookedTexture::getBlockSizeBytes(p_header->internalFormat);
+    if (blockSizeBytes == 0) {
+        fail("unknown internal format " + std::to_string(p_header->internalFormat));
+    }
+    if (p_header->width == 0 || p_header->height == 0) {
+        fail("no pixels");
+    }
+    if (p_header->levelCount == 0 || p_header->levelCount > 32) {
+        fail(std::to_string(p_header->levelCount) + " levels");
+    }
+
+    const uint64_t tableEnd = sizeof(GEM::Renderer::CookedTexture::Header) + (static_cast<uint64_t>(p_header->levelCount) * sizeof(GEM::Renderer::CookedTexture::Level));
+    if (tableEnd > file.getSize()) {
+        fail("level table extends past the end of the file");
+    }
+
+    const GEM::Renderer::CookedTexture::Level* p_levels = reinterpret_cast<const GEM::Renderer::CookedTexture::Level*>(file.getData() + sizeof(GEM::Renderer::CookedTexture::Header));
+    for (uint32_t i = 0; i < p_header->levelCount; ++i) {
+        const GEM::Renderer::CookedTexture::Level& level = p_levels[i];
+        if (level.width != std::max<uint32_t>(p_header->width >> i, 1) || level.height != std::max<uint32_t>(p_header->height >> i, 1)) {
+            fail("level " + std::to_string(i) + " is " + std::to_string(level.width) + "x" + std::to_string(level.height));
+        }
+        if (level.dataSizeBytes != static_cast<uint64_t>((level.width + 3) / 4) * ((level.height + 3) / 4) * blockSizeBytes) {
+            fail("level " + std::to_string(i) + " size does not match its dimensions");
+        }
+        if (level.dataOffset < tableEnd || level.dataOffset > file.getSize() || level.dataSizeBytes > file.getSize() - level.dataOffset) {
+            fail("level " + std::to_string(i) + " extends past the end of the file");
+        }
+    }
+
+    return p_header;
+}
+
+/* ------------------------------ public member functions ------------------------------ */
+
+/**
+ * @brief Construct a new GEM::Renderer::CookedTexture::CookedTexture object by mapping the cooked file into memory
+ *
+ * @note This will throw if the file cannot be mapped or is not a valid cooked texture
+ *
+ * @param filename The full path to the cooked texture file
+ */
+GEM::Renderer::CookedTexture::CookedTexture(const std::string& filename) :
+    m_file(filename),
+    mp_header(GEM::Renderer::CookedTexture::validateHeader(m_file)),
+    mp_levels(reinterpret_cast<const GEM::Renderer::CookedTexture::Level*>(m_file.getData() + sizeof(GEM::Renderer::CookedTexture::Header)))
+{
+    LOG_FUNCTION_CALL_TRACE("filename {} , width {} , height {} , level count {}", filename, mp_header->width, mp_header->height, mp_header->levelCount);
+}
+
+/**
+ * @brief Destroy the GEM::Renderer::CookedTexture::CookedTexture object, unmapping the file
+ */
+GEM::Renderer::CookedTexture::~CookedTexture() {
+    LOG_FUNCTION_CALL_TRACE("filename {}", m_file.getFilename());
+}
+
+/* ------------------------------ private member functions ------------------------------ */
\ No newline at end of file
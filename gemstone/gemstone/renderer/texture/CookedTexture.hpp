@@ -0,0 +1,80 @@
+#pragma once
+
+#include <string>
+
+#include <glad/glad.h>
+
+#include "util/io/MappedFile.hpp"
+
+#include "gemstone/renderer/texture/TextureCompressor.hpp"
+#include "gemstone/renderer/texture/TextureDecoder.hpp"
+
+namespace GEM {
+namespace Renderer {
+    class CookedTexture;
+}
+}
+
+/**
+ * @brief A texture cooked offline into block compressed mip levels which can be handed straight to the gpu. The
+ * blob is laid out as a header, a descriptor for each mip level, then the compressed data of each level, each
+ * starting on a SECTION_ALIGNMENT boundary. Loading one maps the file into memory and exposes pointers into the
+ * mapping, so no decoding, compressing, or mip generation happens while the application runs
+ *
+ * @note All values are stored little endian
+ */
+class GEM::Renderer::CookedTexture {
+public: // public classes and enums
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint32_t internalFormat;
+        uint32_t width;
+        uint32_t height;
+        uint32_t levelCount;
+    };
+
+    struct Level {
+        uint64_t dataOffset;
+        uint64_t dataSizeBytes;
+        uint32_t width;
+        uint32_t height;
+    };
+
+public: // public static variables
+    static const std::string LOGGER_NAME;
+    static const std::string FILE_EXTENSION;
+    static const uint32_t VERSION;
+    static const uint64_t SECTION_ALIGNMENT;
+
+public: // public static functions
+    static void cook(
+        const GEM::Renderer::TextureDecoder::Image& image,
+        const GEM::Renderer::TextureCompressor::Format format,
+        const std::string& filename
+    );
+
+public: // public member functions
+    CookedTexture(const std::string& filename);
+    ~CookedTexture();
+
+    CookedTexture(const CookedTexture& other) = delete;
+    void operator=(const CookedTexture& other) = delete;
+
+    GLenum getInternalFormat() const { return mp_header->internalFormat; }
+    uint32_t getWidth() const { return mp_header->width; }
+    uint32_t getHeight() const { return mp_header->height; }
+    uint32_t getLevelCount() const { return mp_header->levelCount; }
+    const GEM::Renderer::CookedTexture::Level& getLevel(const uint32_t i) const { return mp_levels[i]; }
+    const void* getLevelData(const uint32_t i) const { return m_file.getData() + mp_levels[i].dataOffset; }
+
+private: // private static functions
+    static uint64_t alignOffset(const uint64_t offset);
+    static uint64_t getBlockSizeBytes(const GLenum internalFormat);
+    static const GEM::Renderer::CookedTexture::Header* validateHeader(const GEM::util::MappedFile& file);
+
+private: // private member variables
+    const GEM::util::MappedFile m_file;
+    const GEM::Renderer::CookedTexture::Header* const mp_header;
+    const GEM::Renderer::CookedTexture::Level* const mp_levels;
+};
\ No newline at end of file
@@ -1,13 +1,26 @@
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <functional> // std::hash
+#include <map>
+#include <stdexcept>
 #include <string>
+#include <tuple>
+#include <vector>
 
 #include <glad/glad.h>
 
-#include <stb/stb_image.h>
-
+#include "util/io/FileSystem.hpp"
 #include "util/logger/Logger.hpp"
 
+#include "gemstone/renderer/state/StateCache.hpp"
 #include "gemstone/renderer/texture/logger.hpp"
+#include "gemstone/renderer/texture/CachedTexture.hpp"
+#include "gemstone/renderer/texture/CookedTexture.hpp"
 #include "gemstone/renderer/texture/Texture.hpp"
+#include "gemstone/renderer/texture/TextureDecoder.hpp"
+#include "gemstone/renderer/upload/UploadQueue.hpp"
 
 /* ------------------------------ public static variables ------------------------------ */
 
@@ -16,128 +29,974 @@
  */
 const std::string GEM::Renderer::Texture::LOGGER_NAME = TEXTURE_LOGGER_NAME;
 
+/**
+ * @brief The parameters textures are loaded with unless they ask for others. Repeating, with trilinear filtering
+ */
+const GEM::Renderer::Texture::Parameters GEM::Renderer::Texture::DEFAULT_PARAMETERS = {
+    GL_REPEAT,
+    GL_REPEAT,
+    GL_LINEAR_MIPMAP_LINEAR,
+    GL_LINEAR
+};
+
+/**
+ * @brief The texture shown in place of textures which are still being decoded, relative to the project root
+ */
+const std::string GEM::Renderer::Texture::PLACEHOLDER_FILENAME = "application/assets/textures/missing_texture.png";
+
 /* ------------------------------ private static variables ------------------------------ */
 
+/**
+ * @brief Map of the texture's source file and parameters (hash) to the gl texture holding that texture.
+ * This allows us to prevent decoding and uploading the same image twice and instead just share the
+ * texture if the same file is loaded subsequent times with the same parameters.
+ * Each entry tracks its use count so we can delete the texture once it is decremented to 0
+ */
+std::map<size_t, GEM::Renderer::Texture::Info> GEM::Renderer::Texture::textureIDMap;
+
+/**
+ * @brief The hash of the placeholder texture's entry in the textureIDMap. Every texture showing the placeholder
+ * holds a use of it, as does async loading while it is started
+ */
+size_t GEM::Renderer::Texture::placeholderSourceHash = 0;
+
+/**
+ * @brief Map of the source hash of each texture still showing the placeholder to the texture its decoded image is
+ * being uploaded into, until the upload completes
+ */
+std::map<size_t, GEM::Renderer::Texture::PendingUpload> GEM::Renderer::Texture::pendingUploads;
+
+/**
+ * @brief The cached and cooked textures still showing the placeholder which don't need decoding, in the order they
+ * were loaded, waiting for room in the UploadQueue's budget to be uploaded
+ */
+std::deque<GEM::Renderer::Texture::PendingLoad> GEM::Renderer::Texture::pendingLoads;
+
+/**
+ * @brief Map of the id of each texture array made by packTextureArrays to the number of textures still packed
+ * into it, so the array is deleted once the last of them is
+ */
+std::map<uint32_t, uint32_t> GEM::Renderer::Texture::textureArrayLayerCounts;
+
+/**
+ * @brief Whether any texture which can be packed has been loaded since packTextureArrays last packed everything
+ */
+bool GEM::Renderer::Texture::unpackedTexturesLoaded = false;
+
 /* ------------------------------ public static functions ------------------------------ */
 
+/**
+ * @brief Start decoding new textures on worker threads. The placeholder texture is loaded right away, since
+ * it is what every texture shows until it is uploaded
+ *
+ * @param threadCount The number of worker threads, 0 to pick one from the number of hardware threads
+ */
+void GEM::Renderer::Texture::startAsyncLoading(const uint32_t threadCount) {
+    LOG_FUNCTION_CALL_INFO("thread count {}", threadCount);
+
+    if (GEM::Renderer::TextureDecoder::isRunning()) {
+        return;
+    }
+
+    // The decoder isn't running yet, so this loads the placeholder on this thread
+    const std::string placeholderFilename = GEM::Renderer::Texture::getCanonicalFilename(GEM::util::FileSystem::getFullPath(GEM::Renderer::Texture::PLACEHOLDER_FILENAME));
+    GEM::Renderer::Texture::loadTexture(placeholderFilename, GEM::Renderer::Texture::DEFAULT_PARAMETERS);
+    GEM::Renderer::Texture::placeholderSourceHash = GEM::Renderer::Texture::getHashFromSource(placeholderFilename, GEM::Renderer::Texture::DEFAULT_PARAMETERS);
+
+    GEM::Renderer::TextureDecoder::initialize(threadCount);
+}
+
+/**
+ * @brief Stop decoding textures on worker threads, so textures created afterwards are loaded right away again.
+ * Textures still being uploaded get their real texture right away, and textures which were never uploaded,
+ * whether they were still being decoded or waiting for room in the budget, keep showing the placeholder
+ */
+void GEM::Renderer::Texture::stopAsyncLoading() {
+    LOG_FUNCTION_CALL_INFO("{} textures pending", GEM::Renderer::TextureDecoder::getPendingCount());
+
+    if (!GEM::Renderer::TextureDecoder::isRunning()) {
+        return;
+    }
+
+    GEM::Renderer::TextureDecoder::shutdown();
+    GEM::Renderer::Texture::pendingLoads.clear();
+    GEM::Renderer::Texture::finishUploads(true);
+    GEM::Renderer::Texture::decrementTextureUseCount(GEM::Renderer::Texture::placeholderSourceHash);
+}
+
+/**
+ * @brief Upload the cached and cooked textures waiting for room, then the textures the worker threads have
+ * finished decoding, until the UploadQueue's budget for the frame runs out. The uploads are staged, so each
+ * texture keeps showing the placeholder until a later call sees its upload has completed and swaps its real
+ * texture in. This should be called once a frame, after UploadQueue::beginFrame, while async loading is started
+ * or textures are still being uploaded
+ *
+ * @return uint32_t The number of textures which stopped showing the placeholder
+ */
+uint32_t GEM::Renderer::Texture::uploadDecodedTextures() {
+    uint32_t stagedCount = 0;
+    while (
+        GEM::Renderer::TextureDecoder::isRunning() &&
+        GEM::Renderer::UploadQueue::canStage() &&
+        !GEM::Renderer::Texture::pendingLoads.empty()
+    ) {
+        const GEM::Renderer::Texture::PendingLoad pendingLoad = GEM::Renderer::Texture::pendingLoads.front();
+        GEM::Renderer::Texture::pendingLoads.pop_front();
+        if (GEM::Renderer::Texture::uploadPendingLoad(pendingLoad)) {
+            stagedCount += 1;
+        }
+    }
+
+    GEM::Renderer::TextureDecoder::Image image;
+    while (
+        GEM::Renderer::TextureDecoder::isRunning() &&
+        GEM::Renderer::UploadQueue::canStage() &&
+        GEM::Renderer::TextureDecoder::takeDecodedImage(image)
+    ) {
+        // Every texture using the image may have gone away while it was being decoded
+        const std::map<size_t, GEM::Renderer::Texture::Info>::iterator infoIterator = GEM::Renderer::Texture::textureIDMap.find(image.sourceHash);
+        if (
+            infoIterator == GEM::Renderer::Texture::textureIDMap.end() ||
+            infoIterator->second.loaded ||
+            GEM::Renderer::Texture::pendingUploads.count(image.sourceHash) > 0
+        ) {
+            LOG_TRACE("Dropping decoded texture at {} which nothing is waiting for", image.filename);
+            continue;
+        }
+
+        if (!image.p_pixels) {
+            LOG_WARNING("{} , showing the placeholder texture instead", image.errorMessage);
+            continue;
+        }
+
+        GEM::Renderer::Texture::PendingUpload pendingUpload;
+        pendingUpload.textureID = GEM::Renderer::Texture::createTexture(image, infoIterator->second.parameters, pendingUpload.uploadID);
+        pendingUpload.width = static_cast<uint32_t>(image.width);
+        pendingUpload.height = static_cast<uint32_t>(image.height);
+        GEM::Renderer::Texture::pendingUploads[image.sourceHash] = pendingUpload;
+
+        stagedCount += 1;
+    }
+
+    const uint32_t uploadedCount = GEM::Renderer::Texture::finishUploads(false);
+
+    if (stagedCount > 0 || uploadedCount > 0) {
+        LOG_DEBUG("Staged {} textures , {} finished uploading , {} still uploading", stagedCount, uploadedCount, GEM::Renderer::Texture::pendingUploads.size());
+    }
+
+    return uploadedCount;
+}
+
+/**
+ * @brief Make a streamable texture hold only its levels from firstLevel down to the smallest. The levels are read
+ * back out of the cooked file and uploaded through the UploadQueue into a new gl texture whose level 0 is
+ * firstLevel, and the old texture is deleted, so the memory of the dropped levels really is given back. Since
+ * texture coordinates are normalized, sampling the smaller texture looks the same as sampling the full one with
+ * its finest levels clamped away. Draws using the new texture wait for its upload, so callers restoring levels
+ * which can wait should check UploadQueue::canStage first
+ *
+ * @note This function will throw if the cooked file can no longer be loaded
+ *
+ * @param textureSourceHash The hash of the texture's source file and parameters
+ * @param firstLevel The finest level to keep resident, clamped to the smallest level
+ */
+void GEM::Renderer::Texture::setResidentLevel(const size_t textureSourceHash, const uint32_t firstLevel) {
+    LOG_FUNCTION_ENTRY_TRACE("hash {} , first level {}", textureSourceHash, firstLevel);
+
+    const std::map<size_t, GEM::Renderer::Texture::Info>::iterator infoIterator = GEM::Renderer::Texture::textureIDMap.find(textureSourceHash);
+    if (infoIterator == GEM::Renderer::Texture::textureIDMap.end() || infoIterator->second.levelSizesBytes.empty()) {
+        LOG_WARNING("Cannot set the resident level of texture with hash {} , it isn't loaded or isn't streamable", textureSourceHash);
+        return;
+    }
+
+    GEM::Renderer::Texture::Info& info = infoIterator->second;
+    const uint32_t residentLevel = std::min<uint32_t>(firstLevel, static_cast<uint32_t>(info.levelSizesBytes.size()) - 1);
+    if (residentLevel == info.residentLevel) {
+        return;
+    }
+
+    uint64_t uploadID;
+    const GEM::Renderer::CookedTexture cookedTexture(info.filename);
+    const uint32_t textureID = GEM::Renderer::Texture::createCookedTexture(info.filename, cookedTexture, info.parameters, residentLevel, uploadID);
+    GEM::Renderer::StateCache::deleteTexture(info.id);
+
+    LOG_DEBUG("Texture at {} now has levels {} and up resident in texture with id {} , was levels {} and up in texture with id {}", info.filename, residentLevel, textureID, info.residentLevel, info.id);
+
+    info.id = textureID;
+    info.unpackedID = textureID;
+    info.residentLevel = residentLevel;
+}
+
+/**
+ * @brief Pack the loaded textures which were decoded from an image and aren't packed yet into texture arrays, one
+ * for each size and set of parameters, so objects with different textures can be drawn together. Each texture's
+ * pixels are read back from the gpu into its layer and the array's mipmaps are generated. The texture itself is
+ * kept, since it is still sampled when the texture is paired with one which isn't packed. Textures still showing
+ * the placeholder show its layer instead
+ *
+ * Reading the pixels back waits for the gpu, so groups are only packed until budgetBytes have been read back,
+ * and the rest are left for the next call. At least one group is always packed. This is meant to be called
+ * whenever hasUnpackedTextures says there is something to pack and nothing is being uploaded, so each group is
+ * packed once all of its textures are loaded
+ *
+ * @note Textures decoded from images are always created as GL_RGB, so they can all share arrays
+ *
+ * @param budgetBytes The number of bytes to read back from the gpu before leaving the remaining groups
+ * @return uint32_t The number of textures packed
+ */
+uint32_t GEM::Renderer::Texture::packTextureArrays(const uint64_t budgetBytes) {
+    LOG_FUNCTION_CALL_INFO("{} textures , budget {} bytes", GEM::Renderer::Texture::textureIDMap.size(), budgetBytes);
+
+    // Every layer of an array has the same size, and the wrapping and filtering belong to the whole array
+    std::map<std::tuple<uint32_t, uint32_t, GLenum, GLenum, GLenum, GLenum>, std::vector<size_t>> textureSourceHashGroups;
+    for (const std::pair<const size_t, GEM::Renderer::Texture::Info>& infoPair : GEM::Renderer::Texture::textureIDMap) {
+        const GEM::Renderer::Texture::Info& info = infoPair.second;
+        if (!info.loaded || info.packed || !info.levelSizesBytes.empty()) {
+            continue;
+        }
+
+        textureSourceHashGroups[{
+            info.width,
+            info.height,
+            info.parameters.wrapS,
+            info.parameters.wrapT,
+            info.parameters.minFilter,
+            info.parameters.magFilter
+        }].push_back(infoPair.first);
+    }
+
+    int32_t maxLayerCount;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayerCount);
+
+    uint32_t packedCount = 0;
+    uint32_t unpackedCount = 0;
+    uint64_t readBackBytes = 0;
+    std::vector<uint8_t> pixels;
+    for (const std::pair<const std::tuple<uint32_t, uint32_t, GLenum, GLenum, GLenum, GLenum>, std::vector<size_t>>& textureSourceHashGroup : textureSourceHashGroups) {
+        const std::vector<size_t>& textureSourceHashes = textureSourceHashGroup.second;
+        const GEM::Renderer::Texture::Info& firstInfo = GEM::Renderer::Texture::textureIDMap[textureSourceHashes.front()];
+        const uint32_t width = firstInfo.width;
+        const uint32_t height = firstInfo.height;
+        const GEM::Renderer::Texture::Parameters parameters = firstInfo.parameters;
+
+        // Rows are padded out to the default pack and unpack alignment of 4 bytes
+        const uint64_t layerSizeBytes = static_cast<uint64_t>(((width * 3) + 3) / 4 * 4) * height;
+        const uint64_t groupSizeBytes = layerSizeBytes * textureSourceHashes.size();
+        if (readBackBytes > 0 && readBackBytes + groupSizeBytes > budgetBytes) {
+            unpackedCount += static_cast<uint32_t>(textureSourceHashes.size());
+            continue;
+        }
+        readBackBytes += groupSizeBytes;
+        pixels.resize(layerSizeBytes);
+
+        for (size_t firstTexture = 0; firstTexture < textureSourceHashes.size(); firstTexture += maxLayerCount) {
+            const uint32_t layerCount = static_cast<uint32_t>(std::min<size_t>(maxLayerCount, textureSourceHashes.size() - firstTexture));
+            const uint32_t textureArrayID = GEM::Renderer::Texture::createTextureArray(width, height, layerCount, parameters);
+
+            for (uint32_t layer = 0; layer < layerCount; layer++) {
+                GEM::Renderer::Texture::Info& info = GEM::Renderer::Texture::textureIDMap[textureSourceHashes[firstTexture + layer]];
+
+                GEM::Renderer::StateCache::bindTexture(GL_TEXTURE_2D, info.id);
+                glGetTexImage(GL_TEXTURE_2D, 0, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+                GEM::Renderer::StateCache::bindTexture(GL_TEXTURE_2D_ARRAY, textureArrayID);
+                glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, width, height, 1, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+
+                LOG_TRACE("Packed texture at {} with id {} into layer {} of texture array with id {}", info.filename, info.id, layer, textureArrayID);
+
+                info.id = textureArrayID;
+                info.packed = true;
+                info.layer = layer;
+            }
+
+            GEM::Renderer::StateCache::bindTexture(GL_TEXTURE_2D_ARRAY, textureArrayID);
+            glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+
+            GEM::Renderer::Texture::textureArrayLayerCounts[textureArrayID] = layerCount;
+            packedCount += layerCount;
+
+            LOG_DEBUG("Packed {} textures of {}x{} into texture array with id {}", layerCount, width, height, textureArrayID);
+        }
+    }
+
+    GEM::Renderer::Texture::unpackedTexturesLoaded = unpackedCount > 0;
+    if (unpackedCount > 0) {
+        LOG_DEBUG("Read back {} bytes packing {} textures , leaving {} textures to pack next call", readBackBytes, packedCount, unpackedCount);
+    }
+
+    // The textures still showing the placeholder aren't holding the layer, they just point at it
+    const std::map<size_t, GEM::Renderer::Texture::Info>::iterator placeholderIterator = GEM::Renderer::Texture::textureIDMap.find(GEM::Renderer::Texture::placeholderSourceHash);
+    if (placeholderIterator != GEM::Renderer::Texture::textureIDMap.end()) {
+        for (std::pair<const size_t, GEM::Renderer::Texture::Info>& infoPair : GEM::Renderer::Texture::textureIDMap) {
+            if (infoPair.second.loaded) {
+                continue;
+            }
+
+            infoPair.second.id = placeholderIterator->second.id;
+            infoPair.second.packed = placeholderIterator->second.packed;
+            infoPair.second.layer = placeholderIterator->second.layer;
+            infoPair.second.unpackedID = placeholderIterator->second.unpackedID;
+        }
+    }
+
+    return packedCount;
+}
+
 /* ------------------------------ private static functions ------------------------------ */
 
 /**
- * @brief Get the format of the input texture's pixels based on the file type
- * 
- * @param filename The filename of the texture we are loading
- * @return GLenum The input data format. GL_RGB if jpg image or GL_RGBA if png image
+ * @brief Upload a cached or cooked texture which was waiting for room in the UploadQueue's budget. It keeps
+ * showing the placeholder until finishUploads sees the upload has completed. A cached texture which can't be
+ * loaded any more is decoded instead, and a cooked texture which can't be used keeps showing the placeholder
+ *
+ * @param pendingLoad The texture waiting to be uploaded
+ * @return true The texture's upload was made
+ * @return false Nothing was uploaded
  */
-GLenum GEM::Renderer::Texture::getInputFormat(const std::string& filename) {
-    // Get the file extension (everything after the last .)
-    const std::string extension = filename.substr(
-        filename.find_last_of(".") + 1
-    );
+bool GEM::Renderer::Texture::uploadPendingLoad(const GEM::Renderer::Texture::PendingLoad& pendingLoad) {
+    LOG_FUNCTION_ENTRY_TRACE("hash {} , content hash {}", pendingLoad.sourceHash, pendingLoad.contentHash);
 
-    LOG_TRACE("Filename {} has extension {}", filename, extension);
+    // Every texture using the file may have gone away while it was waiting
+    const std::map<size_t, GEM::Renderer::Texture::Info>::iterator infoIterator = GEM::Renderer::Texture::textureIDMap.find(pendingLoad.sourceHash);
+    if (
+        infoIterator == GEM::Renderer::Texture::textureIDMap.end() ||
+        infoIterator->second.loaded ||
+        GEM::Renderer::Texture::pendingUploads.count(pendingLoad.sourceHash) > 0
+    ) {
+        LOG_TRACE("Dropping load of texture with hash {} which nothing is waiting for", pendingLoad.sourceHash);
+        return false;
+    }
 
-    if (extension == "jpg") {
-        return GL_RGB;
-    } else if (extension == "png") {
-        return GL_RGBA;
+    const GEM::Renderer::Texture::Info& info = infoIterator->second;
+    GEM::Renderer::Texture::PendingUpload pendingUpload;
+    if (pendingLoad.contentHash == 0) {
+        try {
+            const GEM::Renderer::CookedTexture cookedTexture(info.filename);
+            pendingUpload.textureID = GEM::Renderer::Texture::createCookedTexture(info.filename, cookedTexture, info.parameters, 0, pendingUpload.uploadID);
+            pendingUpload.width = cookedTexture.getWidth();
+            pendingUpload.height = cookedTexture.getHeight();
+            pendingUpload.levelSizesBytes = GEM::Renderer::Texture::getLevelSizesBytes(cookedTexture);
+        } catch (const std::exception& ex) {
+            LOG_WARNING("{} , showing the placeholder texture instead", ex.what());
+            return false;
+        }
+    } else {
+        const std::string cachedFilename = GEM::Renderer::CachedTexture::getFilename(pendingLoad.contentHash);
+        try {
+            const GEM::Renderer::CachedTexture cachedTexture(cachedFilename, pendingLoad.contentHash, info.filename);
+            pendingUpload.textureID = GEM::Renderer::Texture::createCachedTexture(info.filename, cachedTexture, info.parameters, pendingUpload.uploadID);
+            pendingUpload.width = cachedTexture.getWidth();
+            pendingUpload.height = cachedTexture.getHeight();
+        } catch (const std::exception& ex) {
+            LOG_WARNING("Discarding cached texture {} for {} , decoding it again : {}", cachedFilename, info.filename, ex.what());
+            GEM::Renderer::CachedTexture::removeFile(cachedFilename);
+            GEM::Renderer::TextureDecoder::submit(pendingLoad.sourceHash, info.filename, pendingLoad.contentHash);
+            return false;
+        }
     }
 
-    return GL_RGB;
+    GEM::Renderer::Texture::pendingUploads[pendingLoad.sourceHash] = pendingUpload;
+
+    return true;
+}
+
+/**
+ * @brief Swap the real texture in for the placeholder of every texture whose upload has completed. gl runs
+ * commands in the order they were made, so drawing with a texture whose upload is still in flight is correct
+ * too, it just makes the draw wait for the upload
+ *
+ * @param finishAll Whether to swap in every texture being uploaded instead of only those whose uploads completed
+ * @return uint32_t The number of textures which stopped showing the placeholder
+ */
+uint32_t GEM::Renderer::Texture::finishUploads(const bool finishAll) {
+    uint32_t finishedCount = 0;
+    std::map<size_t, GEM::Renderer::Texture::PendingUpload>::iterator pendingUploadIterator = GEM::Renderer::Texture::pendingUploads.begin();
+    while (pendingUploadIterator != GEM::Renderer::Texture::pendingUploads.end()) {
+        const GEM::Renderer::Texture::PendingUpload& pendingUpload = pendingUploadIterator->second;
+        if (!finishAll && !GEM::Renderer::UploadQueue::isComplete(pendingUpload.uploadID)) {
+            ++pendingUploadIterator;
+            continue;
+        }
+
+        // Every texture using the image may have gone away while it was being uploaded
+        const std::map<size_t, GEM::Renderer::Texture::Info>::iterator infoIterator = GEM::Renderer::Texture::textureIDMap.find(pendingUploadIterator->first);
+        if (infoIterator == GEM::Renderer::Texture::textureIDMap.end() || infoIterator->second.loaded) {
+            LOG_TRACE("Deleting uploaded texture with id {} which nothing is waiting for", pendingUpload.textureID);
+            GEM::Renderer::StateCache::deleteTexture(pendingUpload.textureID);
+        } else {
+            GEM::Renderer::Texture::Info& info = infoIterator->second;
+            info.id = pendingUpload.textureID;
+            info.loaded = true;
+            info.width = pendingUpload.width;
+            info.height = pendingUpload.height;
+            info.packed = false;
+            info.layer = 0;
+            info.unpackedID = pendingUpload.textureID;
+            info.residentLevel = 0;
+            info.levelSizesBytes = pendingUpload.levelSizesBytes;
+            GEM::Renderer::Texture::decrementTextureUseCount(GEM::Renderer::Texture::placeholderSourceHash);
+
+            // Streamable textures are never packed
+            if (info.levelSizesBytes.empty()) {
+                GEM::Renderer::Texture::unpackedTexturesLoaded = true;
+            }
+
+            finishedCount += 1;
+        }
+
+        pendingUploadIterator = GEM::Renderer::Texture::pendingUploads.erase(pendingUploadIterator);
+    }
+
+    return finishedCount;
+}
+
+/**
+ * @brief Add a newly loaded texture to the map so it can be found by subsequent loads of the same file
+ *
+ * @param textureSourceHash The hash of the texture's source file and parameters
+ * @param info The id of the gl texture, with a use count of 0
+ */
+void GEM::Renderer::Texture::addTextureToMap(const size_t textureSourceHash, const GEM::Renderer::Texture::Info& info) {
+    LOG_FUNCTION_ENTRY_TRACE("hash {} , id {} , loaded {}", textureSourceHash, info.id, info.loaded);
+
+    GEM::Renderer::Texture::textureIDMap.insert({textureSourceHash, info});
+
+    GEM::Renderer::Texture::incrementTextureUseCount(textureSourceHash);
 }
 
 /**
- * @brief Create an opengl texture and get its id
+ * @brief Increment the use count of the texture so we know how many things are using it
+ *
+ * @param textureSourceHash The hash of the texture's source file and parameters
+ */
+void GEM::Renderer::Texture::incrementTextureUseCount(const size_t textureSourceHash) {
+    LOG_FUNCTION_ENTRY_TRACE("hash {}", textureSourceHash);
+
+    GEM::Renderer::Texture::Info& info = GEM::Renderer::Texture::textureIDMap[textureSourceHash];
+    info.useCount += 1;
+
+    LOG_TRACE("Use count for texture with id {} and hash {} is now: {}", info.id, textureSourceHash, info.useCount);
+}
+
+/**
+ * @brief Decrement the use count of the texture so we know how many things are using it. If the count
+ * reaches 0 then we are going to remove it from the map and delete the gl texture, or give back its use of the
+ * placeholder if it never got one
+ *
+ * @param textureSourceHash The hash of the texture's source file and parameters
+ */
+void GEM::Renderer::Texture::decrementTextureUseCount(const size_t textureSourceHash) {
+    LOG_FUNCTION_ENTRY_TRACE("hash {}", textureSourceHash);
+
+    GEM::Renderer::Texture::Info& info = GEM::Renderer::Texture::textureIDMap[textureSourceHash];
+    info.useCount -= 1;
+
+    LOG_TRACE("Use count for texture with id {} and hash {} is now: {}", info.id, textureSourceHash, info.useCount);
+
+    if (info.useCount > 0) {
+        return;
+    }
+
+    const uint32_t textureID = info.id;
+    const uint32_t unpackedTextureID = info.unpackedID;
+    const bool loaded = info.loaded;
+    const bool packed = info.packed;
+
+    LOG_TRACE("Erasing texture with id {} and hash {}", textureID, textureSourceHash);
+    GEM::Renderer::Texture::textureIDMap.erase(textureSourceHash);
+
+    if (!loaded) {
+        GEM::Renderer::Texture::decrementTextureUseCount(GEM::Renderer::Texture::placeholderSourceHash);
+        return;
+    }
+
+    // Texture arrays are shared by every texture packed into them, so they are only deleted with the last one,
+    // while the plain texture each packed texture keeps is only its own
+    if (packed) {
+        GEM::Renderer::StateCache::deleteTexture(unpackedTextureID);
+
+        uint32_t& layerCount = GEM::Renderer::Texture::textureArrayLayerCounts[textureID];
+        layerCount -= 1;
+        if (layerCount > 0) {
+            return;
+        }
+
+        LOG_TRACE("Erasing texture array with id {}", textureID);
+        GEM::Renderer::Texture::textureArrayLayerCounts.erase(textureID);
+    }
+
+    GEM::Renderer::StateCache::deleteTexture(textureID);
+}
+
+/**
+ * @brief Determine if the texture in the given file has already been loaded with the same parameters and is
+ * being tracked
+ *
+ * @param textureSourceHash The hash of the texture's source file and parameters
+ * @return true The hash has an entry in the map
+ * @return false The hash does not have an entry in the map
+ */
+bool GEM::Renderer::Texture::textureIsLoaded(const size_t textureSourceHash) {
+    LOG_FUNCTION_ENTRY_TRACE("hash {}", textureSourceHash);
+
+    return GEM::Renderer::Texture::textureIDMap.count(textureSourceHash) > 0;
+}
+
+/**
+ * @brief Get the canonical path of a texture file, so the same file is found no matter how its path is spelled
+ *
+ * @param filename The path to the texture file
+ * @return std::string The canonical path, or the path as given if it can't be made canonical
+ */
+std::string GEM::Renderer::Texture::getCanonicalFilename(const std::string& filename) {
+    std::error_code errorCode;
+    const std::filesystem::path canonicalPath = std::filesystem::weakly_canonical(filename, errorCode);
+    if (errorCode) {
+        LOG_WARNING("Could not get the canonical path of {} : {}", filename, errorCode.message());
+        return filename;
+    }
+
+    return canonicalPath.string();
+}
+
+/**
+ * @brief Take the canonical filename of a texture and the parameters it is loaded with and determine their hash
+ * value. This is so we can look into the map of loaded textures
+ *
+ * @param canonicalFilename The canonical path to the texture file
+ * @param parameters The parameters the texture is loaded with
+ * @return size_t The hash of the filename and parameters
+ */
+size_t GEM::Renderer::Texture::getHashFromSource(const std::string& canonicalFilename, const GEM::Renderer::Texture::Parameters& parameters) {
+    const std::string source =
+        canonicalFilename + "\n" +
+        std::to_string(parameters.wrapS) + " " +
+        std::to_string(parameters.wrapT) + " " +
+        std::to_string(parameters.minFilter) + " " +
+        std::to_string(parameters.magFilter);
+
+    return std::hash<std::string>{}(source);
+}
+
+/**
+ * @brief Get the format of a decoded image's pixels from the number of channels the decoder gave it, since
+ * the file type doesn't say, a png can be grayscale or have no alpha
+ *
+ * @note Textures are always stored as GL_RGB, so the single channel of a grayscale image ends up in red only
  * 
- * @note This function will throw if the texture file cannot be loaded
+ * @param channelCount The number of channels in each of the image's pixels
+ * @return GLenum The input data format. GL_RED, GL_RG, GL_RGB, or GL_RGBA for 1 to 4 channels
+ */
+GLenum GEM::Renderer::Texture::getInputFormat(const int32_t channelCount) {
+    switch (channelCount) {
+        case 1:
+            return GL_RED;
+        case 2:
+            return GL_RG;
+        case 4:
+            return GL_RGBA;
+        default:
+            return GL_RGB;
+    }
+}
+
+/**
+ * @brief Load a texture onto the gpu given the file it is stored in. If the file has already been loaded with
+ * the same parameters then the existing texture is reused and its use count is incremented. While async loading
+ * is started the texture shows the placeholder until it is uploaded, with the file handed to the worker threads
+ * if it needs decoding, or left for uploadDecodedTextures to upload if it doesn't
+ *
+ * @note This function will throw if the texture file is loaded right away and cannot be decoded, or is a cooked
+ * texture which cannot be used
+ *
+ * @param canonicalFilename The canonical path to the texture file
+ * @param parameters The parameters to load the texture with
+ * @return const GEM::Renderer::Texture::Info* The texture's entry in the textureIDMap
+ */
+const GEM::Renderer::Texture::Info* GEM::Renderer::Texture::loadTexture(const std::string& canonicalFilename, const GEM::Renderer::Texture::Parameters& parameters) {
+    LOG_FUNCTION_ENTRY_TRACE("filename {}", canonicalFilename);
+
+    const size_t textureSourceHash = GEM::Renderer::Texture::getHashFromSource(canonicalFilename, parameters);
+    if (GEM::Renderer::Texture::textureIsLoaded(textureSourceHash)) {
+        GEM::Renderer::Texture::incrementTextureUseCount(textureSourceHash);
+
+        const GEM::Renderer::Texture::Info& info = GEM::Renderer::Texture::textureIDMap[textureSourceHash];
+        LOG_DEBUG("Successfully found loaded texture with id {} for {}", info.id, canonicalFilename);
+
+        return &info;
+    }
+
+    // Anything drawn with a texture loaded right away is drawn after its upload, so it can be used before the
+    // upload completes
+    uint64_t uploadID;
+
+    // Cooked textures have nothing to decode, so they only ever wait for room to be uploaded
+    const std::string extension = canonicalFilename.substr(canonicalFilename.find_last_of(".") + 1);
+    if (extension == GEM::Renderer::CookedTexture::FILE_EXTENSION) {
+        if (GEM::Renderer::TextureDecoder::isRunning()) {
+            GEM::Renderer::Texture::pendingLoads.push_back({textureSourceHash, 0});
+            LOG_DEBUG("Uploading cooked texture at {} once there is room in the budget", canonicalFilename);
+
+            return GEM::Renderer::Texture::addPlaceholderTexture(textureSourceHash, canonicalFilename, parameters);
+        }
+
+        const GEM::Renderer::CookedTexture cookedTexture(canonicalFilename);
+        const uint32_t textureID = GEM::Renderer::Texture::createCookedTexture(canonicalFilename, cookedTexture, parameters, 0, uploadID);
+
+        GEM::Renderer::Texture::addTextureToMap(textureSourceHash, {
+            textureID,
+            0,
+            true,
+            parameters,
+            canonicalFilename,
+            cookedTexture.getWidth(),
+            cookedTexture.getHeight(),
+            0,
+            GEM::Renderer::Texture::getLevelSizesBytes(cookedTexture),
+            false,
+            0,
+            textureID
+        });
+
+        return &GEM::Renderer::Texture::textureIDMap[textureSourceHash];
+    }
+
+    // Images decoded on a previous run are loaded out of the cache, so only new or edited images are decoded
+    const size_t contentHash = GEM::Renderer::CachedTexture::getContentHash(canonicalFilename);
+    const std::string cachedFilename = GEM::Renderer::CachedTexture::getFilename(contentHash);
+    if (contentHash != 0 && std::filesystem::exists(cachedFilename)) {
+        if (GEM::Renderer::TextureDecoder::isRunning()) {
+            GEM::Renderer::Texture::pendingLoads.push_back({textureSourceHash, contentHash});
+            LOG_DEBUG("Uploading cached texture {} for {} once there is room in the budget", cachedFilename, canonicalFilename);
+
+            return GEM::Renderer::Texture::addPlaceholderTexture(textureSourceHash, canonicalFilename, parameters);
+        }
+
+        try {
+            const GEM::Renderer::CachedTexture cachedTexture(cachedFilename, contentHash, canonicalFilename);
+            const uint32_t textureID = GEM::Renderer::Texture::createCachedTexture(canonicalFilename, cachedTexture, parameters, uploadID);
+
+            GEM::Renderer::Texture::addTextureToMap(textureSourceHash, {
+                textureID,
+                0,
+                true,
+                parameters,
+                canonicalFilename,
+                cachedTexture.getWidth(),
+                cachedTexture.getHeight(),
+                0,
+                {},
+                false,
+                0,
+                textureID
+            });
+
+            GEM::Renderer::Texture::unpackedTexturesLoaded = true;
+
+            return &GEM::Renderer::Texture::textureIDMap[textureSourceHash];
+        } catch (const std::exception& ex) {
+            LOG_WARNING("Discarding cached texture {} for {} , decoding it again : {}", cachedFilename, canonicalFilename, ex.what());
+            GEM::Renderer::CachedTexture::removeFile(cachedFilename);
+        }
+    }
+
+    if (GEM::Renderer::TextureDecoder::isRunning()) {
+        GEM::Renderer::TextureDecoder::submit(textureSourceHash, canonicalFilename, contentHash);
+        LOG_DEBUG("Decoding texture at {} in the background", canonicalFilename);
+
+        return GEM::Renderer::Texture::addPlaceholderTexture(textureSourceHash, canonicalFilename, parameters);
+    }
+
+    const GEM::Renderer::TextureDecoder::Image image = GEM::Renderer::TextureDecoder::decode(textureSourceHash, canonicalFilename);
+    if (!image.p_pixels) {
+        LOG_CRITICAL(image.errorMessage);
+        throw std::invalid_argument(image.errorMessage);
+    }
+
+    // The image isn't written into the cache, since generating and writing its mip levels would stall this
+    // thread too
+    const uint32_t textureID = GEM::Renderer::Texture::createTexture(image, parameters, uploadID);
+
+    GEM::Renderer::Texture::addTextureToMap(textureSourceHash, {
+        textureID,
+        0,
+        true,
+        parameters,
+        canonicalFilename,
+        static_cast<uint32_t>(image.width),
+        static_cast<uint32_t>(image.height),
+        0,
+        {},
+        false,
+        0,
+        textureID
+    });
+
+    GEM::Renderer::Texture::unpackedTexturesLoaded = true;
+
+    return &GEM::Renderer::Texture::textureIDMap[textureSourceHash];
+}
+
+/**
+ * @brief Add a texture which shows the placeholder until it is uploaded to the map, holding a use of the
+ * placeholder until then
+ *
+ * @param textureSourceHash The hash of the texture's source file and parameters
+ * @param canonicalFilename The canonical path to the texture file
+ * @param parameters The parameters the texture is loaded with
+ * @return const GEM::Renderer::Texture::Info* The texture's entry in the textureIDMap
+ */
+const GEM::Renderer::Texture::Info* GEM::Renderer::Texture::addPlaceholderTexture(
+    const size_t textureSourceHash,
+    const std::string& canonicalFilename,
+    const GEM::Renderer::Texture::Parameters& parameters
+) {
+    const GEM::Renderer::Texture::Info& placeholderInfo = GEM::Renderer::Texture::textureIDMap[GEM::Renderer::Texture::placeholderSourceHash];
+    GEM::Renderer::Texture::incrementTextureUseCount(GEM::Renderer::Texture::placeholderSourceHash);
+
+    GEM::Renderer::Texture::addTextureToMap(textureSourceHash, {
+        placeholderInfo.id,
+        0,
+        false,
+        parameters,
+        canonicalFilename,
+        0,
+        0,
+        0,
+        {},
+        placeholderInfo.packed,
+        placeholderInfo.layer,
+        placeholderInfo.unpackedID
+    });
+
+    LOG_DEBUG("Showing placeholder with id {} for {} until it is uploaded", placeholderInfo.id, canonicalFilename);
+
+    return &GEM::Renderer::Texture::textureIDMap[textureSourceHash];
+}
+
+/**
+ * @brief Get the size of each of a cooked texture's mip levels, which is what makes the texture streamable
+ *
+ * @param cookedTexture The mapped cooked texture file
+ * @return std::vector<uint64_t> The size of each level in bytes, from level 0 down to the smallest
+ */
+std::vector<uint64_t> GEM::Renderer::Texture::getLevelSizesBytes(const GEM::Renderer::CookedTexture& cookedTexture) {
+    std::vector<uint64_t> levelSizesBytes(cookedTexture.getLevelCount());
+    for (uint32_t i = 0; i < cookedTexture.getLevelCount(); i++) {
+        levelSizesBytes[i] = cookedTexture.getLevel(i).dataSizeBytes;
+    }
+
+    return levelSizesBytes;
+}
+
+/**
+ * @brief Create an opengl texture from a decoded image and get its id. The pixels are uploaded through the
+ * UploadQueue, and the mipmaps are generated from them behind the upload
  * 
- * @param filename The filename from which to load the texture
+ * @param image The decoded image
+ * @param parameters The wrapping and filtering to create the texture with
+ * @param uploadID Set to the id of the upload, which is complete once UploadQueue::isComplete says so
  * @return uint32_t The id of the newly created texture
  */
-uint32_t GEM::Renderer::Texture::createTexture(const std::string& filename) {
-    LOG_FUNCTION_CALL_INFO("filename {}", filename);
+uint32_t GEM::Renderer::Texture::createTexture(
+    const GEM::Renderer::TextureDecoder::Image& image,
+    const GEM::Renderer::Texture::Parameters& parameters,
+    uint64_t& uploadID
+) {
+    LOG_FUNCTION_CALL_INFO("filename {}", image.filename);
 
     // Create the texture in open gl and bind it so the subsequent configuration options affect it
     uint32_t textureID;
     glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
+    GEM::Renderer::StateCache::bindTexture(GL_TEXTURE_2D, textureID);
 
     // Set the texture wrapping method
     // Don't forget to set the border color with glTexParameterfv if we use GL_CLAMP_TO_BORDER for wrapping
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, parameters.wrapS);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, parameters.wrapT);
 
     // Set the texture filtering method (nearest or linear interpolation) for both magnifying (scaling up the
-    // texture) and minifying (scaling down the texture) operations
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-    // Create and use the mipmaps. This isn't importatnt for the mag filter because it only applies when upscaling
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // Load the texture
-    // For the issue with loading pngs:
-    // https://stackoverflow.com/questions/23150123/loading-png-with-stb-image-for-opengl-texture-gives-wrong-colors
-    int textureWidth;
-    int textureHeight;
-    int textureChannelCount;
-    stbi_set_flip_vertically_on_load(true);
-    uint8_t* p_textureData = stbi_load(filename.c_str(), &textureWidth, &textureHeight, &textureChannelCount, 0);
-    if (!p_textureData) {
-        const std::string errorMessage = "Failed to stbi_load texture at " + filename;
-        LOG_CRITICAL(errorMessage);
-        throw std::invalid_argument(errorMessage);
-    }
+    // texture) and minifying (scaling down the texture) operations. The mipmaps are always created, so any of
+    // the mipmap min filters can be used. This isn't important for the mag filter because it only applies when
+    // upscaling
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, parameters.minFilter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, parameters.magFilter);
 
-    glTexImage2D(
+    uploadID = GEM::Renderer::UploadQueue::uploadTexture(
         GL_TEXTURE_2D,                          // The texture target (we are bound to 2d due to the glBindTexture call)
         0,                                      // The mipmap level for which we want to create a texture for
         GL_RGB,                                 // What kind of format we want to store the texture
-        textureWidth,                           // Set the width of the resulting texture
-        textureHeight,                          // Set the height of the resulting texture
-        0,                                      // Should always be 0 -- legacy stuff
-        GEM::Renderer::Texture::getInputFormat(filename), // Format of the source image (include alpha for png images)
-        GL_UNSIGNED_BYTE,                       // Data type of the source image
-        p_textureData                           // The actual image data
+        static_cast<uint32_t>(image.width),     // Set the width of the resulting texture
+        static_cast<uint32_t>(image.height),    // Set the height of the resulting texture
+        GEM::Renderer::Texture::getInputFormat(image.channelCount), // Format of the source image's channels
+        image.p_pixels.get(),                   // The actual image data
+        static_cast<uint64_t>(image.width) * image.height * image.channelCount // The size of the image data
     );
     glGenerateMipmap(GL_TEXTURE_2D);
 
-    // Free the image memory now that we have generated the texture
-    stbi_image_free(p_textureData);
-
     LOG_DEBUG("Successfully created texture with id {}", textureID);
 
     return textureID;
 }
 
+/**
+ * @brief Create an empty opengl texture array to pack textures into, with room for every one of its mip levels
+ *
+ * @param width The width of every layer
+ * @param height The height of every layer
+ * @param layerCount The number of layers
+ * @param parameters The wrapping and filtering to create the texture array with
+ * @return uint32_t The id of the newly created texture array
+ */
+uint32_t GEM::Renderer::Texture::createTextureArray(const uint32_t width, const uint32_t height, const uint32_t layerCount, const GEM::Renderer::Texture::Parameters& parameters) {
+    LOG_FUNCTION_CALL_INFO("{}x{} , {} layers", width, height, layerCount);
+
+    uint32_t textureArrayID;
+    glGenTextures(1, &textureArrayID);
+    GEM::Renderer::StateCache::bindTexture(GL_TEXTURE_2D_ARRAY, textureArrayID);
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, parameters.wrapS);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, parameters.wrapT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, parameters.minFilter);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, parameters.magFilter);
+
+    // Only level 0 is given here, the rest are allocated when the mipmaps are generated
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGB, width, height, layerCount, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+
+    return textureArrayID;
+}
+
+/**
+ * @brief Create an opengl texture from a cached texture file, uploading every one of its mip levels as is through
+ * the UploadQueue
+ *
+ * @param filename The full path to the image file the texture was cached for
+ * @param cachedTexture The mapped cached texture file
+ * @param parameters The wrapping and filtering to create the texture with
+ * @param uploadID Set to the id of the upload, which is complete once UploadQueue::isComplete says so
+ * @return uint32_t The id of the newly created texture
+ */
+uint32_t GEM::Renderer::Texture::createCachedTexture(
+    const std::string& filename,
+    const GEM::Renderer::CachedTexture& cachedTexture,
+    const GEM::Renderer::Texture::Parameters& parameters,
+    uint64_t& uploadID
+) {
+    LOG_FUNCTION_CALL_INFO("filename {}", filename);
+
+    uint32_t textureID;
+    glGenTextures(1, &textureID);
+    GEM::Renderer::StateCache::bindTexture(GL_TEXTURE_2D, textureID);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, parameters.wrapS);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, parameters.wrapT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, parameters.minFilter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, parameters.magFilter);
+
+    // The mip levels were filtered when the texture was cached, so nothing is generated here. They are stored
+    // as rgba but kept as rgb like every other decoded texture, so cached ones can still be packed with them
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, cachedTexture.getLevelCount() - 1);
+    std::vector<GEM::Renderer::UploadQueue::TextureLevel> levels;
+    for (uint32_t i = 0; i < cachedTexture.getLevelCount(); i++) {
+        const GEM::Renderer::CachedTexture::Level& level = cachedTexture.getLevel(i);
+        levels.push_back({level.width, level.height, cachedTexture.getLevelData(i), level.dataSizeBytes});
+    }
+    uploadID = GEM::Renderer::UploadQueue::uploadTextureLevels(GL_TEXTURE_2D, GL_RGB, GL_RGBA, levels);
+
+    LOG_DEBUG("Successfully created texture with id {} from {} cached levels", textureID, cachedTexture.getLevelCount());
+
+    return textureID;
+}
+
+/**
+ * @brief Create an opengl texture from a cooked texture file, uploading its compressed mip levels as is from the
+ * given level down to the smallest through the UploadQueue
+ *
+ * @note This function will throw if the driver can't sample the cooked texture's format
+ *
+ * @param filename The full path to the cooked texture file
+ * @param cookedTexture The mapped cooked texture file
+ * @param parameters The wrapping and filtering to create the texture with
+ * @param firstLevel The cooked level to upload as the texture's level 0
+ * @param uploadID Set to the id of the upload, which is complete once UploadQueue::isComplete says so
+ * @return uint32_t The id of the newly created texture
+ */
+uint32_t GEM::Renderer::Texture::createCookedTexture(
+    const std::string& filename,
+    const GEM::Renderer::CookedTexture& cookedTexture,
+    const GEM::Renderer::Texture::Parameters& parameters,
+    const uint32_t firstLevel,
+    uint64_t& uploadID
+) {
+    LOG_FUNCTION_CALL_INFO("filename {} , first level {}", filename, firstLevel);
+
+    // Rgtc is core, but the s3tc formats are only an extension, albeit one every desktop driver has
+    if (cookedTexture.getInternalFormat() != GL_COMPRESSED_RG_RGTC2 && !GEM::Renderer::StateCache::isExtensionSupported("GL_EXT_texture_compression_s3tc")) {
+        const std::string errorMessage = "Cannot load cooked texture " + filename + " , the driver doesn't support GL_EXT_texture_compression_s3tc";
+        LOG_CRITICAL(errorMessage);
+        throw std::runtime_error(errorMessage);
+    }
+
+    uint32_t textureID;
+    glGenTextures(1, &textureID);
+    GEM::Renderer::StateCache::bindTexture(GL_TEXTURE_2D, textureID);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, parameters.wrapS);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, parameters.wrapT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, parameters.minFilter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, parameters.magFilter);
+
+    // The mip levels were filtered when the texture was cooked, so nothing is generated here
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, cookedTexture.getLevelCount() - 1 - firstLevel);
+    std::vector<GEM::Renderer::UploadQueue::TextureLevel> levels;
+    for (uint32_t i = firstLevel; i < cookedTexture.getLevelCount(); i++) {
+        const GEM::Renderer::CookedTexture::Level& level = cookedTexture.getLevel(i);
+        levels.push_back({level.width, level.height, cookedTexture.getLevelData(i), level.dataSizeBytes});
+    }
+    uploadID = GEM::Renderer::UploadQueue::uploadCompressedTextureLevels(GL_TEXTURE_2D, cookedTexture.getInternalFormat(), levels);
+
+    LOG_DEBUG("Successfully created texture with id {} from {} cooked levels", textureID, cookedTexture.getLevelCount() - firstLevel);
+
+    return textureID;
+}
+
 /* ------------------------------ public member functions ------------------------------ */
 
 /**
  * @brief Construct a new GEM::Renderer::Texture::Texture object given a filename and the specified
- * parameters
+ * parameters. The gl texture is only created if no other texture has already loaded the same file with the
+ * same parameters, and while async loading is started it shows the placeholder until it is uploaded
  * 
  * @param filename The filename of the texture to load
  * @param index The index we are assigning this texture to
+ * @param parameters The wrapping and filtering to load the texture with
  */
-GEM::Renderer::Texture::Texture(const std::string& filename, const uint32_t index) :
-    m_id(GEM::Renderer::Texture::createTexture(filename)),
+GEM::Renderer::Texture::Texture(const std::string& filename, const uint32_t index, const GEM::Renderer::Texture::Parameters& parameters) :
+    m_filename(GEM::Renderer::Texture::getCanonicalFilename(filename)),
+    m_sourceHash(GEM::Renderer::Texture::getHashFromSource(m_filename, parameters)),
+    mp_info(GEM::Renderer::Texture::loadTexture(m_filename, parameters)),
     m_index(index)
 {}
 
 /**
- * @brief Destroy the GEM::Renderer::Texture::Texture object by deleting the opengl texture
+ * @brief Decrement the use count for this texture. If the use count falls to 0 then we delete the opengl texture
  */
 GEM::Renderer::Texture::~Texture() {
-    LOG_FUNCTION_CALL_TRACE("id {}", m_id);
-    glDeleteTextures(1, &m_id);
+    LOG_FUNCTION_CALL_TRACE("filename {} , id {}", m_filename, mp_info->id);
+    GEM::Renderer::Texture::decrementTextureUseCount(m_sourceHash);
 }
 
 /**
- * @brief Make this texture active and use it
+ * @brief Make this texture active and use it. Nothing reaches gl if it is already bound to its texture unit. A
+ * packed texture binds its plain texture too, so shaders using either sampler2D or sampler2DArray can sample it
  */
 void GEM::Renderer::Texture::activate() const {
-    glActiveTexture(GL_TEXTURE0 + m_index);
-    glBindTexture(GL_TEXTURE_2D, m_id);
+    GEM::Renderer::StateCache::activeTexture(m_index);
+    if (mp_info->packed) {
+        GEM::Renderer::StateCache::bindTexture(GL_TEXTURE_2D, mp_info->unpackedID);
+    }
+    GEM::Renderer::StateCache::bindTexture(getTarget(), mp_info->id);
 }
 
 /* ------------------------------ private member functions ------------------------------ */
@@ -1,34 +1,191 @@
 #pragma once
 
+#include <deque>
+#include <map>
 #include <string>
+#include <vector>
 
 #include <glad/glad.h>
 
+#include "gemstone/renderer/texture/CachedTexture.hpp"
+#include "gemstone/renderer/texture/CookedTexture.hpp"
+#include "gemstone/renderer/texture/TextureDecoder.hpp"
+
 namespace GEM {
 namespace Renderer {
     class Texture;
 }
 }
 
+/**
+ * @brief A class representing a texture loaded onto the gpu. Textures loaded from the same file with the same
+ * parameters share a single gl texture, no matter which texture unit each of them is activated on. When the
+ * use count for a file and its parameters hits 0 the texture is deleted and removed from the textureIDMap
+ *
+ * Files are told apart by their canonical path, so different spellings of the same path are still shared
+ *
+ * Every texture is uploaded through the UploadQueue. Between startAsyncLoading and stopAsyncLoading, new textures
+ * are decoded on the TextureDecoder's worker threads instead of right away, and new textures which don't need
+ * decoding wait to be uploaded as well. uploadDecodedTextures stages them within the UploadQueue's per frame
+ * budget, and until their uploads complete they show the placeholder texture, so getID can change once over the
+ * life of a texture and shouldn't be held on to across frames
+ *
+ * Every other file decoded on the worker threads is written into the CachedTexture cache, keyed by the file's
+ * contents, so later loads of it, in this run or any after, upload its mip levels straight out of the cache
+ * without decoding
+ *
+ * Files with the CookedTexture extension hold block compressed mip levels made by the cooker, and are uploaded
+ * without decoding or generating any mipmaps. Since their levels can be read back out of the file at any time
+ * they are also streamable, and setResidentLevel drops or restores their finest levels (see TextureStreamer),
+ * which changes getID as well
+ *
+ * packTextureArrays moves loaded textures decoded from an image into a GL_TEXTURE_2D_ARRAY shared with the
+ * other textures of the same size and parameters loaded since it was last called, after which the texture is a
+ * layer of that array (see getLayer) and activate binds the array. hasUnpackedTextures says when textures have
+ * been loaded which it hasn't packed yet. Each packed texture keeps its own GL_TEXTURE_2D as well (see
+ * getUnpackedID), which activate binds alongside the array, so objects pairing a packed texture with one which
+ * isn't, like a streamable texture or one uploaded after packing, can still be drawn with a sampler2D shader
+ * variant. This costs the memory of holding each packed texture twice
+ */
 class GEM::Renderer::Texture {
+public: // public classes and enums
+    struct Parameters {
+        GLenum wrapS;
+        GLenum wrapT;
+        GLenum minFilter;
+        GLenum magFilter;
+    };
+
 public: // public static variables
     static const std::string LOGGER_NAME;
 
+    static const GEM::Renderer::Texture::Parameters DEFAULT_PARAMETERS;
+    static const std::string PLACEHOLDER_FILENAME;
+
+public: // public static functions
+    static void startAsyncLoading(const uint32_t threadCount = 0);
+    static void stopAsyncLoading();
+    static uint32_t uploadDecodedTextures();
+    static void setResidentLevel(const size_t textureSourceHash, const uint32_t firstLevel);
+    static uint32_t packTextureArrays(const uint64_t budgetBytes);
+    static bool hasUnpackedTextures() { return unpackedTexturesLoaded; }
+
 public: // public member functions
-    Texture(const std::string& filename, const uint32_t index);
+    Texture(
+        const std::string& filename,
+        const uint32_t index,
+        const GEM::Renderer::Texture::Parameters& parameters = GEM::Renderer::Texture::DEFAULT_PARAMETERS
+    );
     ~Texture();
 
+    Texture(const Texture& other) = delete;
+    void operator=(const Texture& other) = delete;
+
     void activate() const;
 
-    uint32_t getID() const { return m_id; }
+    size_t getSourceHash() const { return m_sourceHash; }
+    uint32_t getID() const { return mp_info->id; }
+    uint32_t getUnpackedID() const { return mp_info->unpackedID; }
     uint32_t getIndex() const { return m_index; }
+    bool isLoaded() const { return mp_info->loaded; }
+    bool isPacked() const { return mp_info->packed; }
+    uint32_t getLayer() const { return mp_info->layer; }
+    GLenum getTarget() const { return mp_info->packed ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D; }
+    bool isStreamable() const { return !mp_info->levelSizesBytes.empty(); }
+    uint32_t getWidth() const { return mp_info->width; }
+    uint32_t getHeight() const { return mp_info->height; }
+    uint32_t getResidentLevel() const { return mp_info->residentLevel; }
+    const std::vector<uint64_t>& getLevelSizesBytes() const { return mp_info->levelSizesBytes; }
+
+private: // private static enums and classes
+    struct Info {
+        uint32_t id;
+        uint32_t useCount;
+        bool loaded;
+        GEM::Renderer::Texture::Parameters parameters;
+        std::string filename;
+
+        // The size of the full resolution image, 0 while the placeholder is shown
+        uint32_t width;
+        uint32_t height;
+
+        // Only streamable textures have their level sizes, and only they can have a resident level other than 0
+        uint32_t residentLevel;
+        std::vector<uint64_t> levelSizesBytes;
+
+        // Packed textures are a layer of a texture array, whose id is the id
+        bool packed;
+        uint32_t layer;
+
+        // The id of the GL_TEXTURE_2D holding the texture, the same as the id until it is packed
+        uint32_t unpackedID;
+    };
+
+    struct PendingUpload {
+        uint64_t uploadID;
+        uint32_t textureID;
+        uint32_t width;
+        uint32_t height;
+        std::vector<uint64_t> levelSizesBytes;
+    };
+
+    struct PendingLoad {
+        size_t sourceHash;
+        // The hash of the contents of the image the cached texture was decoded from, 0 for cooked textures
+        size_t contentHash;
+    };
 
 private: // private static functions
-    static GLenum getInputFormat(const std::string& filename);
+    static bool uploadPendingLoad(const GEM::Renderer::Texture::PendingLoad& pendingLoad);
+    static uint32_t finishUploads(const bool finishAll);
+    static void addTextureToMap(const size_t textureSourceHash, const GEM::Renderer::Texture::Info& info);
+    static void incrementTextureUseCount(const size_t textureSourceHash);
+    static void decrementTextureUseCount(const size_t textureSourceHash);
+    static bool textureIsLoaded(const size_t textureSourceHash);
+
+    static std::string getCanonicalFilename(const std::string& filename);
+    static size_t getHashFromSource(const std::string& canonicalFilename, const GEM::Renderer::Texture::Parameters& parameters);
+    static GLenum getInputFormat(const int32_t channelCount);
+
+    static const GEM::Renderer::Texture::Info* loadTexture(const std::string& canonicalFilename, const GEM::Renderer::Texture::Parameters& parameters);
+    static const GEM::Renderer::Texture::Info* addPlaceholderTexture(
+        const size_t textureSourceHash,
+        const std::string& canonicalFilename,
+        const GEM::Renderer::Texture::Parameters& parameters
+    );
+    static std::vector<uint64_t> getLevelSizesBytes(const GEM::Renderer::CookedTexture& cookedTexture);
+    static uint32_t createTexture(
+        const GEM::Renderer::TextureDecoder::Image& image,
+        const GEM::Renderer::Texture::Parameters& parameters,
+        uint64_t& uploadID
+    );
+    static uint32_t createTextureArray(const uint32_t width, const uint32_t height, const uint32_t layerCount, const GEM::Renderer::Texture::Parameters& parameters);
+    static uint32_t createCachedTexture(
+        const std::string& filename,
+        const GEM::Renderer::CachedTexture& cachedTexture,
+        const GEM::Renderer::Texture::Parameters& parameters,
+        uint64_t& uploadID
+    );
+    static uint32_t createCookedTexture(
+        const std::string& filename,
+        const GEM::Renderer::CookedTexture& cookedTexture,
+        const GEM::Renderer::Texture::Parameters& parameters,
+        const uint32_t firstLevel,
+        uint64_t& uploadID
+    );
 
-    static uint32_t createTexture(const std::string& filename);
+private: // private static variables
+    static std::map<size_t, GEM::Renderer::Texture::Info> textureIDMap;
+    static size_t placeholderSourceHash;
+    static std::map<size_t, GEM::Renderer::Texture::PendingUpload> pendingUploads;
+    static std::deque<GEM::Renderer::Texture::PendingLoad> pendingLoads;
+    static std::map<uint32_t, uint32_t> textureArrayLayerCounts;
+    static bool unpackedTexturesLoaded;
 
 private: // private member variables
-    const uint32_t m_id;
+    const std::string m_filename;
+    const size_t m_sourceHash;
+    // Points into the textureIDMap, whose entries don't move and outlive every texture using them
+    const GEM::Renderer::Texture::Info* const mp_info;
     const uint32_t m_index;
 };
\ No newline at end of file
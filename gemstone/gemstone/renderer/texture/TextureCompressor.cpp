@@ -0,0 +1,440 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility> // std::swap
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "util/logger/Logger.hpp"
+
+#include "gemstone/renderer/texture/logger.hpp"
+#include "gemstone/renderer/texture/TextureCompressor.hpp"
+
+// GL_EXT_texture_compression_s3tc, which glad is not generated with
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+/* ------------------------------ public static variables ------------------------------ */
+
+/**
+ * @brief The name of the logger the TextureCompressor class uses
+ */
+const std::string GEM::Renderer::TextureCompressor::LOGGER_NAME = TEXTURE_LOGGER_NAME;
+
+/* ------------------------------ private static variables ------------------------------ */
+
+/* ------------------------------ public static functions ------------------------------ */
+
+/**
+ * @brief Get the format with the given name
+ *
+ * @note This function will throw if the name isn't one of the formats
+ *
+ * @param formatName The name of the format, bc1, bc3, or bc5
+ * @return GEM::Renderer::TextureCompressor::Format The format
+ */
+GEM::Renderer::TextureCompressor::Format GEM::Renderer::TextureCompressor::getFormatFromName(const std::string& formatName) {
+    if (formatName == "bc1") {
+        return GEM::Renderer::TextureCompressor::Format::bc1;
+    } else if (formatName == "bc3") {
+        return GEM::Renderer::TextureCompressor::Format::bc3;
+    } else if (formatName == "bc5") {
+        return GEM::Renderer::TextureCompressor::Format::bc5;
+    }
+
+    const std::string errorMessage = "Unknown texture compression format " + formatName + " , expected bc1, bc3, or bc5";
+    LOG_CRITICAL(errorMessage);
+    throw std::invalid_argument(errorMessage);
+}
+
+/**
+ * @brief Get the gl internal format textures in the given format are uploaded with
+ *
+ * @param format The compressed format
+ * @return GLenum The gl internal format
+ */
+GLenum GEM::Renderer::TextureCompressor::getInternalFormat(const GEM::Renderer::TextureCompressor::Format format) {
+    switch (format) {
+        case GEM::Renderer::TextureCompressor::Format::bc1:
+            return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        case GEM::Renderer::TextureCompressor::Format::bc3:
+            return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case GEM::Renderer::TextureCompressor::Format::bc5:
+            return GL_COMPRESSED_RG_RGTC2;
+    }
+
+    return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+}
+
+/**
+ * @brief Get the number of bytes each 4x4 block of pixels is compressed into
+ *
+ * @param format The compressed format
+ * @return uint32_t The size of a block in bytes
+ */
+uint32_t GEM::Renderer::TextureCompressor::getBlockSizeBytes(const GEM::Renderer::TextureCompressor::Format format) {
+    return format == GEM::Renderer::TextureCompressor::Format::bc1 ? 8 : 16;
+}
+
+/**
+ * @brief Get the size of an image once it is compressed. Partial blocks along the right and top edges take up a
+ * whole block
+ *
+ * @param format The compressed format
+ * @param width The width of the image in pixels
+ * @param height The height of the image in pixels
+ * @return uint64_t The size of the compressed image in bytes
+ */
+uint64_t GEM::Renderer::TextureCompressor::getCompressedSizeBytes(const GEM::Renderer::TextureCompressor::Format format, const uint32_t width, const uint32_t height) {
+    const uint64_t blockCount = static_cast<uint64_t>((width + 3) / 4) * ((height + 3) / 4);
+    return blockCount * GEM::Renderer::TextureCompressor::getBlockSizeBytes(format);
+}
+
+/**
+ * @brief Expand decoded pixels with any number of channels into rgba, so everything after this only deals with
+ * one layout. Grey is copied into red, green, and blue, and missing alpha is opaque
+ *
+ * @note This function will throw if there are not 1 to 4 channels. Otherwise it doesn't log, so the
+ * TextureDecoder's worker threads can call it with the pixels they decode
+ *
+ * @param p_pixels The decoded pixels
+ * @param width The width of the image in pixels
+ * @param height The height of the image in pixels
+ * @param channelCount The number of channels each pixel has
+ * @return std::vector<uint8_t> The rgba pixels
+ */
+std::vector<uint8_t> GEM::Renderer::TextureCompressor::convertToRGBA(const uint8_t* p_pixels, const uint32_t width, const uint32_t height, const uint32_t channelCount) {
+    if (channelCount < 1 || channelCount > 4) {
+        const std::string errorMessage = "Cannot convert pixels with " + std::to_string(channelCount) + " channels to rgba";
+        LOG_CRITICAL(errorMessage);
+        throw std::invalid_argument(errorMessage);
+    }
+
+    const uint64_t pixelCount = static_cast<uint64_t>(width) * height;
+    std::vector<uint8_t> rgbaPixels(pixelCount * 4);
+    for (uint64_t i = 0; i < pixelCount; i++) {
+        const uint8_t* p_pixel = p_pixels + (i * channelCount);
+        uint8_t* p_rgbaPixel = rgbaPixels.data() + (i * 4);
+
+        if (channelCount < 3) {
+            p_rgbaPixel[0] = p_pixel[0];
+            p_rgbaPixel[1] = p_pixel[0];
+            p_rgbaPixel[2] = p_pixel[0];
+            p_rgbaPixel[3] = channelCount == 2 ? p_pixel[1] : 255;
+        } else {
+            p_rgbaPixel[0] = p_pixel[0];
+            p_rgbaPixel[1] = p_pixel[1];
+            p_rgbaPixel[2] = p_pixel[2];
+            p_rgbaPixel[3] = channelCount == 4 ? p_pixel[3] : 255;
+        }
+    }
+
+    return rgbaPixels;
+}
+
+/**
+ * @brief Generate every mip level of an image down to 1x1, each level averaging 2x2 pixels of the one above it.
+ * Odd sized levels repeat their last row or column. This doesn't log, so the TextureDecoder's worker threads can
+ * call it
+ *
+ * @param pixels The rgba pixels of the full size image
+ * @param width The width of the image in pixels
+ * @param height The height of the image in pixels
+ * @return std::vector<GEM::Renderer::TextureCompressor::MipLevel> The levels, starting with the full size image
+ */
+std::vector<GEM::Renderer::TextureCompressor::MipLevel> GEM::Renderer::TextureCompressor::generateMipChain(std::vector<uint8_t> pixels, const uint32_t width, const uint32_t height) {
+    std::vector<GEM::Renderer::TextureCompressor::MipLevel> levels;
+    levels.push_back({width, height, std::move(pixels)});
+
+    while (levels.back().width > 1 || levels.back().height > 1) {
+        const GEM::Renderer::TextureCompressor::MipLevel& previousLevel = levels.back();
+        GEM::Renderer::TextureCompressor::MipLevel level;
+        level.width = std::max<uint32_t>(previousLevel.width / 2, 1);
+        level.height = std::max<uint32_t>(previousLevel.height / 2, 1);
+        level.pixels.resize(static_cast<uint64_t>(level.width) * level.height * 4);
+
+        for (uint32_t y = 0; y < level.height; y++) {
+            const uint32_t y0 = std::min(y * 2, previousLevel.height - 1);
+            const uint32_t y1 = std::min(y * 2 + 1, previousLevel.height - 1);
+            for (uint32_t x = 0; x < level.width; x++) {
+                const uint32_t x0 = std::min(x * 2, previousLevel.width - 1);
+                const uint32_t x1 = std::min(x * 2 + 1, previousLevel.width - 1);
+                for (uint32_t channel = 0; channel < 4; channel++) {
+                    const uint32_t sum =
+                        previousLevel.pixels[((static_cast<uint64_t>(y0) * previousLevel.width + x0) * 4) + channel] +
+                        previousLevel.pixels[((static_cast<uint64_t>(y0) * previousLevel.width + x1) * 4) + channel] +
+                        previousLevel.pixels[((static_cast<uint64_t>(y1) * previousLevel.width + x0) * 4) + channel] +
+                        previousLevel.pixels[((static_cast<uint64_t>(y1) * previousLevel.width + x1) * 4) + channel];
+                    level.pixels[((static_cast<uint64_t>(y) * level.width + x) * 4) + channel] = static_cast<uint8_t>((sum + 2) / 4);
+                }
+            }
+        }
+
+        levels.push_back(std::move(level));
+    }
+
+    return levels;
+}
+
+/**
+ * @brief Compress a mip level into the given format
+ *
+ * @param level The rgba pixels of the level
+ * @param format The format to compress into
+ * @return std::vector<uint8_t> The compressed blocks, a row of blocks at a time from the first row of pixels
+ */
+std::vector<uint8_t> GEM::Renderer::TextureCompressor::compress(const GEM::Renderer::TextureCompressor::MipLevel& level, const GEM::Renderer::TextureCompressor::Format format) {
+    LOG_FUNCTION_ENTRY_TRACE("width {} , height {}", level.width, level.height);
+
+    const uint32_t blockCountX = (level.width + 3) / 4;
+    const uint32_t blockCountY = (level.height + 3) / 4;
+    const uint32_t blockSizeBytes = GEM::Renderer::TextureCompressor::getBlockSizeBytes(format);
+    std::vector<uint8_t> compressedBlocks(GEM::Renderer::TextureCompressor::getCompressedSizeBytes(format, level.width, level.height));
+
+    uint8_t block[16 * 4];
+    for (uint32_t blockY = 0; blockY < blockCountY; blockY++) {
+        for (uint32_t blockX = 0; blockX < blockCountX; blockX++) {
+            GEM::Renderer::TextureCompressor::loadBlock(level, blockX, blockY, block);
+
+            uint8_t* p_output = compressedBlocks.data() + ((static_cast<uint64_t>(blockY) * blockCountX + blockX) * blockSizeBytes);
+            switch (format) {
+                case GEM::Renderer::TextureCompressor::Format::bc1:
+                    GEM::Renderer::TextureCompressor::compressColorBlock(block, p_output);
+                    break;
+                case GEM::Renderer::TextureCompressor::Format::bc3:
+                    GEM::Renderer::TextureCompressor::compressChannelBlock(block, 3, p_output);
+                    GEM::Renderer::TextureCompressor::compressColorBlock(block, p_output + 8);
+                    break;
+                case GEM::Renderer::TextureCompressor::Format::bc5:
+                    GEM::Renderer::TextureCompressor::compressChannelBlock(block, 0, p_output);
+                    GEM::Renderer::TextureCompressor::compressChannelBlock(block, 1, p_output + 8);
+                    break;
+            }
+        }
+    }
+
+    return compressedBlocks;
+}
+
+/* ------------------------------ private static functions ------------------------------ */
+
+/**
+ * @brief Copy a 4x4 block of pixels out of a level. Blocks hanging off the edge of the level repeat its last
+ * row or column
+ *
+ * @param level The rgba pixels of the level
+ * @param blockX The column of the block
+ * @param blockY The row of the block
+ * @param p_block Filled with the 16 rgba pixels of the block, a row at a time
+ */
+void GEM::Renderer::TextureCompressor::loadBlock(const GEM::Renderer::TextureCompressor::MipLevel& level, const uint32_t blockX, const uint32_t blockY, uint8_t* p_block) {
+    for (uint32_t y = 0; y < 4; y++) {
+        const uint32_t pixelY = std::min(blockY * 4 + y, level.height - 1);
+        for (uint32_t x = 0; x < 4; x++) {
+            const uint32_t pixelX = std::min(blockX * 4 + x, level.width - 1);
+            const uint8_t* p_pixel = level.pixels.data() + ((static_cast<uint64_t>(pixelY) * level.width + pixelX) * 4);
+            std::copy(p_pixel, p_pixel + 4, p_block + ((y * 4 + x) * 4));
+        }
+    }
+}
+
+/**
+ * @brief Quantize a color to 5 bits of red, 6 bits of green, and 5 bits of blue
+ *
+ * @param p_color The red, green, and blue of the color, from 0 to 255
+ * @return uint16_t The packed color
+ */
+uint16_t GEM::Renderer::TextureCompressor::packRGB565(const float* p_color) {
+    const uint16_t red = static_cast<uint16_t>(std::lround(std::clamp(p_color[0], 0.0f, 255.0f) * 31.0f / 255.0f));
+    const uint16_t green = static_cast<uint16_t>(std::lround(std::clamp(p_color[1], 0.0f, 255.0f) * 63.0f / 255.0f));
+    const uint16_t blue = static_cast<uint16_t>(std::lround(std::clamp(p_color[2], 0.0f, 255.0f) * 31.0f / 255.0f));
+    return static_cast<uint16_t>((red << 11) | (green << 5) | blue);
+}
+
+/**
+ * @brief Expand a 5:6:5 color back out the way the gpu does
+ *
+ * @param packedColor The packed color
+ * @param p_color Set to the red, green, and blue of the color, from 0 to 255
+ */
+void GEM::Renderer::TextureCompressor::unpackRGB565(const uint16_t packedColor, float* p_color) {
+    const uint32_t red = (packedColor >> 11) & 0x1F;
+    const uint32_t green = (packedColor >> 5) & 0x3F;
+    const uint32_t blue = packedColor & 0x1F;
+    p_color[0] = static_cast<float>((red << 3) | (red >> 2));
+    p_color[1] = static_cast<float>((green << 2) | (green >> 4));
+    p_color[2] = static_cast<float>((blue << 3) | (blue >> 2));
+}
+
+/**
+ * @brief Compress the rgb of a block into 8 bytes of two 5:6:5 endpoints and a 2 bit index per pixel. The
+ * endpoints are the pixels furthest along the principal axis of the block's colors, found by power iteration
+ * on their covariance
+ *
+ * @param p_block The 16 rgba pixels of the block
+ * @param p_output Filled with the 8 byte compressed block
+ */
+void GEM::Renderer::TextureCompressor::compressColorBlock(const uint8_t* p_block, uint8_t* p_output) {
+    float mean[3] = {0.0f, 0.0f, 0.0f};
+    for (uint32_t i = 0; i < 16; i++) {
+        for (uint32_t channel = 0; channel < 3; channel++) {
+            mean[channel] += p_block[i * 4 + channel] / 16.0f;
+        }
+    }
+
+    // The covariance is symmetric, so only xx, xy, xz, yy, yz, and zz are kept
+    float covariance[6] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    for (uint32_t i = 0; i < 16; i++) {
+        const float r = p_block[i * 4 + 0] - mean[0];
+        const float g = p_block[i * 4 + 1] - mean[1];
+        const float b = p_block[i * 4 + 2] - mean[2];
+        covariance[0] += r * r;
+        covariance[1] += r * g;
+        covariance[2] += r * b;
+        covariance[3] += g * g;
+        covariance[4] += g * b;
+        covariance[5] += b * b;
+    }
+
+    float axis[3] = {1.0f, 1.0f, 1.0f};
+    for (uint32_t iteration = 0; iteration < 8; iteration++) {
+        const float x = covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2];
+        const float y = covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2];
+        const float z = covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2];
+        const float length = std::max({std::abs(x), std::abs(y), std::abs(z)});
+        if (length < 1e-6f) {
+            break;
+        }
+        axis[0] = x / length;
+        axis[1] = y / length;
+        axis[2] = z / length;
+    }
+
+    uint32_t minIndex = 0;
+    uint32_t maxIndex = 0;
+    float minProjection = 0.0f;
+    float maxProjection = 0.0f;
+    for (uint32_t i = 0; i < 16; i++) {
+        const float projection =
+            (p_block[i * 4 + 0] - mean[0]) * axis[0] +
+            (p_block[i * 4 + 1] - mean[1]) * axis[1] +
+            (p_block[i * 4 + 2] - mean[2]) * axis[2];
+        if (i == 0 || projection < minProjection) {
+            minProjection = projection;
+            minIndex = i;
+        }
+        if (i == 0 || projection > maxProjection) {
+            maxProjection = projection;
+            maxIndex = i;
+        }
+    }
+
+    const float maxColor[3] = {
+        static_cast<float>(p_block[maxIndex * 4 + 0]),
+        static_cast<float>(p_block[maxIndex * 4 + 1]),
+        static_cast<float>(p_block[maxIndex * 4 + 2])
+    };
+    const float minColor[3] = {
+        static_cast<float>(p_block[minIndex * 4 + 0]),
+        static_cast<float>(p_block[minIndex * 4 + 1]),
+        static_cast<float>(p_block[minIndex * 4 + 2])
+    };
+    uint16_t endpoint0 = GEM::Renderer::TextureCompressor::packRGB565(maxColor);
+    uint16_t endpoint1 = GEM::Renderer::TextureCompressor::packRGB565(minColor);
+
+    // The first endpoint must be the larger one, otherwise the block is decoded with 3 colors and transparency
+    if (endpoint0 < endpoint1) {
+        std::swap(endpoint0, endpoint1);
+    }
+
+    uint32_t indices = 0;
+    if (endpoint0 != endpoint1) {
+        float palette[4][3];
+        GEM::Renderer::TextureCompressor::unpackRGB565(endpoint0, palette[0]);
+        GEM::Renderer::TextureCompressor::unpackRGB565(endpoint1, palette[1]);
+        for (uint32_t channel = 0; channel < 3; channel++) {
+            palette[2][channel] = (2.0f * palette[0][channel] + palette[1][channel]) / 3.0f;
+            palette[3][channel] = (palette[0][channel] + 2.0f * palette[1][channel]) / 3.0f;
+        }
+
+        for (uint32_t i = 0; i < 16; i++) {
+            uint32_t bestIndex = 0;
+            float bestDistance = 0.0f;
+            for (uint32_t paletteIndex = 0; paletteIndex < 4; paletteIndex++) {
+                float distance = 0.0f;
+                for (uint32_t channel = 0; channel < 3; channel++) {
+                    const float difference = p_block[i * 4 + channel] - palette[paletteIndex][channel];
+                    distance += difference * difference;
+                }
+                if (paletteIndex == 0 || distance < bestDistance) {
+                    bestDistance = distance;
+                    bestIndex = paletteIndex;
+                }
+            }
+            indices |= bestIndex << (i * 2);
+        }
+    }
+
+    p_output[0] = static_cast<uint8_t>(endpoint0 & 0xFF);
+    p_output[1] = static_cast<uint8_t>(endpoint0 >> 8);
+    p_output[2] = static_cast<uint8_t>(endpoint1 & 0xFF);
+    p_output[3] = static_cast<uint8_t>(endpoint1 >> 8);
+    for (uint32_t i = 0; i < 4; i++) {
+        p_output[4 + i] = static_cast<uint8_t>((indices >> (i * 8)) & 0xFF);
+    }
+}
+
+/**
+ * @brief Compress one channel of a block into 8 bytes of two endpoints and a 3 bit index per pixel. This is the
+ * alpha of bc3, and each of the two channels of bc5. The endpoints are the channel's largest and smallest values,
+ * with the 6 values between them spread evenly
+ *
+ * @param p_block The 16 rgba pixels of the block
+ * @param channel The channel to compress, 0 for red through 3 for alpha
+ * @param p_output Filled with the 8 byte compressed block
+ */
+void GEM::Renderer::TextureCompressor::compressChannelBlock(const uint8_t* p_block, const uint32_t channel, uint8_t* p_output) {
+    uint8_t maxValue = p_block[channel];
+    uint8_t minValue = p_block[channel];
+    for (uint32_t i = 1; i < 16; i++) {
+        maxValue = std::max(maxValue, p_block[i * 4 + channel]);
+        minValue = std::min(minValue, p_block[i * 4 + channel]);
+    }
+
+    // With the first endpoint larger the block is decoded with 8 values, when they are equal every index picks it
+    uint64_t indices = 0;
+    if (maxValue != minValue) {
+        uint32_t palette[8];
+        palette[0] = maxValue;
+        palette[1] = minValue;
+        for (uint32_t i = 1; i < 7; i++) {
+            palette[i + 1] = ((7 - i) * maxValue + i * minValue + 3) / 7;
+        }
+
+        for (uint32_t i = 0; i < 16; i++) {
+            const int32_t value = p_block[i * 4 + channel];
+            uint64_t bestIndex = 0;
+            int32_t bestDistance = 256;
+            for (uint32_t paletteIndex = 0; paletteIndex < 8; paletteIndex++) {
+                const int32_t distance = std::abs(value - static_cast<int32_t>(palette[paletteIndex]));
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    bestIndex = paletteIndex;
+                }
+            }
+            indices |= bestIndex << (i * 3);
+        }
+    }
+
+    p_output[0] = maxValue;
+    p_output[1] = minValue;
+    for (uint32_t i = 0; i < 6; i++) {
+        p_output[2 + i] = static_cast<uint8_t>((indices >> (i * 8)) & 0xFF);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+namespace GEM {
+namespace Renderer {
+    class TextureCompressor;
+}
+}
+
+/**
+ * @brief Functions for turning decoded pixels into the block compressed formats gpus sample from directly. These
+ * are slow enough that they are meant to be run offline by the cooker, never while the application is running
+ *
+ * Every format works on 4x4 blocks of pixels. Each block is fit independently with the endpoints at the ends of
+ * its pixels' principal axis, which is quick and good enough for the textures we have, but nowhere near what a
+ * dedicated encoder gets out of the formats
+ *  - bc1 stores rgb in 8 bytes per block, and has no alpha
+ *  - bc3 stores rgba in 16 bytes per block, with the alpha fit separately from the color
+ *  - bc5 stores only red and green in 16 bytes per block, each fit separately, for normal maps and the like
+ */
+class GEM::Renderer::TextureCompressor {
+public: // public classes and enums
+    enum class Format {
+        bc1,
+        bc3,
+        bc5
+    };
+
+    struct MipLevel {
+        uint32_t width;
+        uint32_t height;
+        std::vector<uint8_t> pixels;
+    };
+
+public: // public static variables
+    static const std::string LOGGER_NAME;
+
+public: // public static functions
+    static GEM::Renderer::TextureCompressor::Format getFormatFromName(const std::string& formatName);
+    static GLenum getInternalFormat(const GEM::Renderer::TextureCompressor::Format format);
+    static uint32_t getBlockSizeBytes(const GEM::Renderer::TextureCompressor::Format format);
+    static uint64_t getCompressedSizeBytes(const GEM::Renderer::TextureCompressor::Format format, const uint32_t width, const uint32_t height);
+
+    static std::vector<uint8_t> convertToRGBA(const uint8_t* p_pixels, const uint32_t width, const uint32_t height, const uint32_t channelCount);
+    static std::vector<GEM::Renderer::TextureCompressor::MipLevel> generateMipChain(std::vector<uint8_t> pixels, const uint32_t width, const uint32_t height);
+    static std::vector<uint8_t> compress(const GEM::Renderer::TextureCompressor::MipLevel& level, const GEM::Renderer::TextureCompressor::Format format);
+
+public: // public member functions
+    TextureCompressor() = delete;
+
+private: // private static functions
+    static void loadBlock(const GEM::Renderer::TextureCompressor::MipLevel& level, const uint32_t blockX, const uint32_t blockY, uint8_t* p_block);
+    static uint16_t packRGB565(const float* p_color);
+    static void unpackRGB565(const uint16_t packedColor, float* p_color);
+    static void compressColorBlock(const uint8_t* p_block, uint8_t* p_output);
+    static void compressChannelBlock(const uint8_t* p_block, const uint32_t channel, uint8_t* p_output);
+};
\ No newline at end of file
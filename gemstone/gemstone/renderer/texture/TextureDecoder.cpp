@@ -0,0 +1,246 @@
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <stb/stb_image.h>
+
+#include "util/logger/Logger.hpp"
+
+#include "gemstone/renderer/texture/logger.hpp"
+#include "gemstone/renderer/texture/CachedTexture.hpp"
+#include "gemstone/renderer/texture/TextureDecoder.hpp"
+
+/* ------------------------------ public static variables ------------------------------ */
+
+/**
+ * @brief The name of the logger the TextureDecoder class uses
+ */
+const std::string GEM::Renderer::TextureDecoder::LOGGER_NAME = TEXTURE_LOGGER_NAME;
+
+/* ------------------------------ private static variables ------------------------------ */
+
+/**
+ * @brief Whether or not the worker threads have been started
+ */
+bool GEM::Renderer::TextureDecoder::running = false;
+
+/**
+ * @brief Set when shutting down so the worker threads stop waiting for jobs
+ */
+bool GEM::Renderer::TextureDecoder::stopping = false;
+
+/**
+ * @brief The lock for the jobs, the decoded images, and the count of images being decoded
+ */
+std::mutex GEM::Renderer::TextureDecoder::mutex;
+
+/**
+ * @brief Signalled whenever a job is submitted or the worker threads should stop
+ */
+std::condition_variable GEM::Renderer::TextureDecoder::jobAvailable;
+
+/**
+ * @brief The files waiting for a worker thread to decode them, in the order they were submitted
+ */
+std::deque<GEM::Renderer::TextureDecoder::Job> GEM::Renderer::TextureDecoder::jobs;
+
+/**
+ * @brief The images the worker threads have finished decoding, waiting to be taken by the render thread
+ */
+std::deque<GEM::Renderer::TextureDecoder::Image> GEM::Renderer::TextureDecoder::decodedImages;
+
+/**
+ * @brief The number of images being decoded by a worker thread right now
+ */
+uint32_t GEM::Renderer::TextureDecoder::decodingCount = 0;
+
+/**
+ * @brief The worker threads
+ */
+std::vector<std::thread> GEM::Renderer::TextureDecoder::workerThreads;
+
+/* ------------------------------ public static functions ------------------------------ */
+
+/**
+ * @brief Start the worker threads. Does nothing if they are already running
+ *
+ * @param threadCount The number of worker threads, 0 to use one less than the number of hardware threads so the
+ * render thread keeps a core to itself
+ */
+void GEM::Renderer::TextureDecoder::initialize(const uint32_t threadCount) {
+    if (GEM::Renderer::TextureDecoder::running) {
+        return;
+    }
+
+    const uint32_t hardwareThreadCount = std::max<uint32_t>(std::thread::hardware_concurrency(), 2);
+    const uint32_t workerThreadCount = threadCount > 0 ? threadCount : hardwareThreadCount - 1;
+    LOG_FUNCTION_CALL_INFO("{} worker threads", workerThreadCount);
+
+    GEM::Renderer::TextureDecoder::stopping = false;
+    GEM::Renderer::TextureDecoder::workerThreads.reserve(workerThreadCount);
+    for (uint32_t i = 0; i < workerThreadCount; i++) {
+        GEM::Renderer::TextureDecoder::workerThreads.emplace_back(GEM::Renderer::TextureDecoder::decodeJobs);
+    }
+
+    GEM::Renderer::TextureDecoder::running = true;
+}
+
+/**
+ * @brief Stop and join the worker threads. Images being decoded are finished, but jobs which haven't been
+ * started and images which haven't been taken are thrown away
+ */
+void GEM::Renderer::TextureDecoder::shutdown() {
+    if (!GEM::Renderer::TextureDecoder::running) {
+        return;
+    }
+
+    LOG_FUNCTION_CALL_INFO("{} worker threads", GEM::Renderer::TextureDecoder::workerThreads.size());
+
+    {
+        std::lock_guard<std::mutex> lock(GEM::Renderer::TextureDecoder::mutex);
+        GEM::Renderer::TextureDecoder::stopping = true;
+        LOG_DEBUG("Dropping {} jobs which were never started", GEM::Renderer::TextureDecoder::jobs.size());
+        GEM::Renderer::TextureDecoder::jobs.clear();
+    }
+    GEM::Renderer::TextureDecoder::jobAvailable.notify_all();
+
+    for (std::thread& workerThread : GEM::Renderer::TextureDecoder::workerThreads) {
+        workerThread.join();
+    }
+    GEM::Renderer::TextureDecoder::workerThreads.clear();
+
+    GEM::Renderer::TextureDecoder::decodedImages.clear();
+    GEM::Renderer::TextureDecoder::running = false;
+}
+
+/**
+ * @brief Get the number of images submitted which haven't been taken yet
+ *
+ * @return uint32_t The number of images waiting to be decoded, being decoded, or waiting to be taken
+ */
+uint32_t GEM::Renderer::TextureDecoder::getPendingCount() {
+    std::lock_guard<std::mutex> lock(GEM::Renderer::TextureDecoder::mutex);
+    return static_cast<uint32_t>(
+        GEM::Renderer::TextureDecoder::jobs.size() +
+        GEM::Renderer::TextureDecoder::decodedImages.size()
+    ) + GEM::Renderer::TextureDecoder::decodingCount;
+}
+
+/**
+ * @brief Hand a file to the worker threads to decode, and optionally to write into the texture cache once it is
+ * decoded so the next run doesn't have to decode it again
+ *
+ * @param sourceHash The hash identifying what the image is for, given back with the decoded image
+ * @param filename The full path to the image file
+ * @param cacheContentHash The hash of the file's contents to cache the decoded image under, 0 to not cache it
+ */
+void GEM::Renderer::TextureDecoder::submit(const size_t sourceHash, const std::string& filename, const size_t cacheContentHash) {
+    LOG_FUNCTION_ENTRY_TRACE("hash {} , filename {} , cache content hash {}", sourceHash, filename, cacheContentHash);
+
+    if (!GEM::Renderer::TextureDecoder::running) {
+        const std::string errorMessage = "Cannot submit " + filename + " to be decoded before the texture decoder is initialized";
+        LOG_CRITICAL(errorMessage);
+        throw std::runtime_error(errorMessage);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(GEM::Renderer::TextureDecoder::mutex);
+        GEM::Renderer::TextureDecoder::jobs.push_back({sourceHash, filename, cacheContentHash});
+    }
+    GEM::Renderer::TextureDecoder::jobAvailable.notify_one();
+}
+
+/**
+ * @brief Take the oldest image the worker threads have finished decoding
+ *
+ * @param image Set to the decoded image, whose error message is set instead of its pixels if it failed to decode
+ * @return true An image was taken
+ * @return false No image has finished decoding
+ */
+bool GEM::Renderer::TextureDecoder::takeDecodedImage(GEM::Renderer::TextureDecoder::Image& image) {
+    std::lock_guard<std::mutex> lock(GEM::Renderer::TextureDecoder::mutex);
+    if (GEM::Renderer::TextureDecoder::decodedImages.empty()) {
+        return false;
+    }
+
+    image = std::move(GEM::Renderer::TextureDecoder::decodedImages.front());
+    GEM::Renderer::TextureDecoder::decodedImages.pop_front();
+
+    return true;
+}
+
+/**
+ * @brief Decode an image file into pixels on the calling thread. The rows are flipped so the first one is the
+ * bottom of the image, like gl expects. This runs on the worker threads so it must not log or throw
+ *
+ * @param sourceHash The hash identifying what the image is for
+ * @param filename The full path to the image file
+ * @return GEM::Renderer::TextureDecoder::Image The decoded image, whose error message is set instead of its
+ * pixels if it failed to decode
+ */
+GEM::Renderer::TextureDecoder::Image GEM::Renderer::TextureDecoder::decode(const size_t sourceHash, const std::string& filename) {
+    GEM::Renderer::TextureDecoder::Image image = {sourceHash, filename, 0, 0, 0, nullptr, ""};
+
+    // For the issue with loading pngs:
+    // https://stackoverflow.com/questions/23150123/loading-png-with-stb-image-for-opengl-texture-gives-wrong-colors
+    // The flip is set per thread, so decoding on several threads at once is fine
+    stbi_set_flip_vertically_on_load_thread(true);
+
+    int width;
+    int height;
+    int channelCount;
+    uint8_t* p_pixels = stbi_load(filename.c_str(), &width, &height, &channelCount, 0);
+    if (!p_pixels) {
+        image.errorMessage = "Failed to stbi_load texture at " + filename + " : " + stbi_failure_reason();
+        return image;
+    }
+
+    image.width = width;
+    image.height = height;
+    image.channelCount = channelCount;
+    image.p_pixels = std::shared_ptr<uint8_t>(p_pixels, stbi_image_free);
+
+    return image;
+}
+
+/* ------------------------------ private static functions ------------------------------ */
+
+/**
+ * @brief The loop each worker thread runs, decoding jobs until the decoder shuts down. This must not log or throw
+ */
+void GEM::Renderer::TextureDecoder::decodeJobs() {
+    while (true) {
+        GEM::Renderer::TextureDecoder::Job job;
+        {
+            std::unique_lock<std::mutex> lock(GEM::Renderer::TextureDecoder::mutex);
+            GEM::Renderer::TextureDecoder::jobAvailable.wait(lock, []() {
+                return GEM::Renderer::TextureDecoder::stopping || !GEM::Renderer::TextureDecoder::jobs.empty();
+            });
+            if (GEM::Renderer::TextureDecoder::stopping) {
+                return;
+            }
+
+            job = std::move(GEM::Renderer::TextureDecoder::jobs.front());
+            GEM::Renderer::TextureDecoder::jobs.pop_front();
+            GEM::Renderer::TextureDecoder::decodingCount += 1;
+        }
+
+        GEM::Renderer::TextureDecoder::Image image = GEM::Renderer::TextureDecoder::decode(job.sourceHash, job.filename);
+        if (job.cacheContentHash != 0 && image.p_pixels) {
+            // Failing to cache the image only means it is decoded again next run
+            GEM::Renderer::CachedTexture::write(job.cacheContentHash, image);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(GEM::Renderer::TextureDecoder::mutex);
+            GEM::Renderer::TextureDecoder::decodedImages.push_back(std::move(image));
+            GEM::Renderer::TextureDecoder::decodingCount -= 1;
+        }
+    }
+}
\ No newline at end of file
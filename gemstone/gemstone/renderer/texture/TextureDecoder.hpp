@@ -0,0 +1,78 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace GEM {
+namespace Renderer {
+    class TextureDecoder;
+}
+}
+
+/**
+ * @brief A pool of worker threads decoding image files into pixels, so textures can be decoded on every core
+ * while the render thread keeps drawing. Nothing here touches gl, the decoded images are taken back on the
+ * render thread and uploaded there
+ *
+ * Without initialize being called no threads exist, and images can still be decoded on the calling thread with
+ * decode
+ */
+class GEM::Renderer::TextureDecoder {
+public: // public classes and enums
+    struct Image {
+        size_t sourceHash;
+        std::string filename;
+        int32_t width;
+        int32_t height;
+        int32_t channelCount;
+        std::shared_ptr<uint8_t> p_pixels;
+        std::string errorMessage;
+    };
+
+public: // public static variables
+    static const std::string LOGGER_NAME;
+
+public: // public static functions
+    static void initialize(const uint32_t threadCount);
+    static void shutdown();
+
+    static bool isRunning() { return running; }
+    static uint32_t getPendingCount();
+
+    static void submit(const size_t sourceHash, const std::string& filename, const size_t cacheContentHash = 0);
+    static bool takeDecodedImage(GEM::Renderer::TextureDecoder::Image& image);
+
+    static GEM::Renderer::TextureDecoder::Image decode(const size_t sourceHash, const std::string& filename);
+
+public: // public member functions
+    TextureDecoder() = delete;
+
+private: // private classes and enums
+    struct Job {
+        size_t sourceHash;
+        std::string filename;
+        // The hash of the file's contents to write the decoded image into the cache under, 0 to not cache it
+        size_t cacheContentHash;
+    };
+
+private: // private static functions
+    static void decodeJobs();
+
+private: // private static variables
+    static bool running;
+    static bool stopping;
+
+    // Guards everything below, which is shared with the worker threads
+    static std::mutex mutex;
+    static std::condition_variable jobAvailable;
+    static std::deque<GEM::Renderer::TextureDecoder::Job> jobs;
+    static std::deque<GEM::Renderer::TextureDecoder::Image> decodedImages;
+    static uint32_t decodingCount;
+
+    static std::vector<std::thread> workerThreads;
+};
\ No newline at end of file
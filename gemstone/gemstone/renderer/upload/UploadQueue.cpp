@@ -0,0 +1,477 @@
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "util/logger/Logger.hpp"
+
+#include "gemstone/renderer/state/StateCache.hpp"
+#include "gemstone/renderer/upload/logger.hpp"
+#include "gemstone/renderer/upload/UploadQueue.hpp"
+
+/* ------------------------------ public static variables ------------------------------ */
+
+/**
+ * @brief The name of the logger the UploadQueue class uses
+ */
+const std::string GEM::Renderer::UploadQueue::LOGGER_NAME = UPLOAD_LOGGER_NAME;
+
+/**
+ * @brief The number of staging buffers in the ring, and so the number of uploads which can be in flight at once
+ */
+const uint32_t GEM::Renderer::UploadQueue::DEFAULT_STAGING_BUFFER_COUNT = 8;
+
+/**
+ * @brief The number of bytes which can be uploaded each frame before canStage says to wait for the next one
+ */
+const uint64_t GEM::Renderer::UploadQueue::DEFAULT_FRAME_BUDGET_BYTES = 8 * 1024 * 1024;
+
+/* ------------------------------ private static variables ------------------------------ */
+
+/**
+ * @brief Whether or not the staging buffers have been created
+ */
+bool GEM::Renderer::UploadQueue::running = false;
+
+/**
+ * @brief The number of bytes which can be uploaded each frame
+ */
+uint64_t GEM::Renderer::UploadQueue::frameBudgetBytes = GEM::Renderer::UploadQueue::DEFAULT_FRAME_BUDGET_BYTES;
+
+/**
+ * @brief The number of bytes uploaded since beginFrame was last called, whether or not they were staged
+ */
+uint64_t GEM::Renderer::UploadQueue::frameUploadedBytes = 0;
+
+/**
+ * @brief The ring of staging buffers
+ */
+std::vector<GEM::Renderer::UploadQueue::StagingBuffer> GEM::Renderer::UploadQueue::stagingBuffers;
+
+/**
+ * @brief The index of the staging buffer the next upload is staged in
+ */
+uint32_t GEM::Renderer::UploadQueue::nextStagingBufferIndex = 0;
+
+/**
+ * @brief The index of the staging buffer holding the oldest upload which isn't complete yet
+ */
+uint32_t GEM::Renderer::UploadQueue::oldestStagingBufferIndex = 0;
+
+/**
+ * @brief The number of staged uploads which aren't complete yet
+ */
+uint32_t GEM::Renderer::UploadQueue::inFlightCount = 0;
+
+/**
+ * @brief The id given to the next staged upload. 0 is never given out, so it is always complete
+ */
+uint64_t GEM::Renderer::UploadQueue::nextUploadID = 1;
+
+/**
+ * @brief The id of the newest upload which is complete. Every upload with a smaller id is complete as well
+ */
+uint64_t GEM::Renderer::UploadQueue::completedUploadID = 0;
+
+/* ------------------------------ public static functions ------------------------------ */
+
+/**
+ * @brief Create the staging buffers. Does nothing if they have already been created. Their storage is only
+ * given to them when something is staged, sized to fit it
+ *
+ * @param stagingBufferCount The number of staging buffers in the ring
+ * @param frameBudgetBytes The number of bytes which can be uploaded each frame
+ */
+void GEM::Renderer::UploadQueue::initialize(const uint32_t stagingBufferCount, const uint64_t frameBudgetBytes) {
+    LOG_FUNCTION_CALL_INFO("{} staging buffers , {} bytes per frame", stagingBufferCount, frameBudgetBytes);
+
+    if (GEM::Renderer::UploadQueue::running || stagingBufferCount == 0) {
+        return;
+    }
+
+    GEM::Renderer::UploadQueue::stagingBuffers.resize(stagingBufferCount);
+    for (GEM::Renderer::UploadQueue::StagingBuffer& stagingBuffer : GEM::Renderer::UploadQueue::stagingBuffers) {
+        glGenBuffers(1, &stagingBuffer.bufferID);
+        stagingBuffer.fence = nullptr;
+        stagingBuffer.uploadID = 0;
+    }
+
+    GEM::Renderer::UploadQueue::frameBudgetBytes = frameBudgetBytes;
+    GEM::Renderer::UploadQueue::nextStagingBufferIndex = 0;
+    GEM::Renderer::UploadQueue::oldestStagingBufferIndex = 0;
+    GEM::Renderer::UploadQueue::inFlightCount = 0;
+    GEM::Renderer::UploadQueue::running = true;
+}
+
+/**
+ * @brief Delete the staging buffers. gl runs commands in the order they were made, so anything drawn after this
+ * sees the uploads still in flight as if they had completed, and they are all considered complete
+ */
+void GEM::Renderer::UploadQueue::shutdown() {
+    if (!GEM::Renderer::UploadQueue::running) {
+        return;
+    }
+
+    LOG_FUNCTION_CALL_INFO("{} uploads in flight", GEM::Renderer::UploadQueue::inFlightCount);
+
+    for (GEM::Renderer::UploadQueue::StagingBuffer& stagingBuffer : GEM::Renderer::UploadQueue::stagingBuffers) {
+        if (stagingBuffer.fence) {
+            glDeleteSync(stagingBuffer.fence);
+        }
+        GEM::Renderer::StateCache::deleteBuffer(stagingBuffer.bufferID);
+    }
+    GEM::Renderer::UploadQueue::stagingBuffers.clear();
+
+    GEM::Renderer::UploadQueue::completedUploadID = GEM::Renderer::UploadQueue::nextUploadID - 1;
+    GEM::Renderer::UploadQueue::inFlightCount = 0;
+    GEM::Renderer::UploadQueue::running = false;
+}
+
+/**
+ * @brief Start counting a new frame's uploads against the budget, and retire whichever uploads have completed
+ * since the last frame. This should be called once a frame before anything is uploaded
+ */
+void GEM::Renderer::UploadQueue::beginFrame() {
+    if (GEM::Renderer::UploadQueue::frameUploadedBytes > 0) {
+        LOG_DEBUG("Uploaded {} bytes last frame , {} uploads in flight", GEM::Renderer::UploadQueue::frameUploadedBytes, GEM::Renderer::UploadQueue::inFlightCount);
+    }
+
+    GEM::Renderer::UploadQueue::frameUploadedBytes = 0;
+    GEM::Renderer::UploadQueue::retireCompletedUploads();
+}
+
+/**
+ * @brief Determine if something should be uploaded this frame, which it should while the frame's budget isn't
+ * used up and a staging buffer is free. The upload which crosses the budget is still made, so data larger than
+ * the whole budget is uploaded on a frame of its own instead of never
+ *
+ * @return true There is room to upload something this frame
+ * @return false Uploads which can wait should wait for a later frame
+ */
+bool GEM::Renderer::UploadQueue::canStage() {
+    if (GEM::Renderer::UploadQueue::frameUploadedBytes >= GEM::Renderer::UploadQueue::frameBudgetBytes) {
+        return false;
+    }
+
+    // Without the staging buffers everything is uploaded from client memory, so only the budget applies
+    if (!GEM::Renderer::UploadQueue::running) {
+        return true;
+    }
+
+    GEM::Renderer::UploadQueue::retireCompletedUploads();
+
+    return GEM::Renderer::UploadQueue::inFlightCount < GEM::Renderer::UploadQueue::stagingBuffers.size();
+}
+
+/**
+ * @brief Upload tightly packed, unsigned byte pixels into a level of the texture bound to the target, through a
+ * staging buffer if one is free
+ *
+ * @param target The texture target the texture is bound to, such as GL_TEXTURE_2D
+ * @param level The mip level to upload
+ * @param internalFormat The format gl should store the pixels in
+ * @param width The width of the level in pixels
+ * @param height The height of the level in pixels
+ * @param format The format of the pixels being uploaded
+ * @param p_pixels The pixels
+ * @param sizeBytes The size of the pixels in bytes
+ * @return uint64_t The id of the upload, for isComplete
+ */
+uint64_t GEM::Renderer::UploadQueue::uploadTexture(
+    const GLenum target,
+    const uint32_t level,
+    const GLenum internalFormat,
+    const uint32_t width,
+    const uint32_t height,
+    const GLenum format,
+    const void* p_pixels,
+    const uint64_t sizeBytes
+) {
+    LOG_FUNCTION_ENTRY_TRACE("{}x{} , level {} , {} bytes", width, height, level, sizeBytes);
+
+    GEM::Renderer::UploadQueue::frameUploadedBytes += sizeBytes;
+
+    // The rows are tightly packed, so gl mustn't expect them to be padded out to the default of 4 bytes
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    const bool staged = GEM::Renderer::UploadQueue::stage(GL_PIXEL_UNPACK_BUFFER, p_pixels, sizeBytes);
+    if (staged) {
+        // With a pixel unpack buffer bound the pointer is an offset into it
+        glTexImage2D(target, level, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, nullptr);
+
+        // Anything uploaded from client memory afterwards would be read out of the staging buffer instead
+        GEM::Renderer::StateCache::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    } else {
+        glTexImage2D(target, level, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, p_pixels);
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    return staged ? GEM::Renderer::UploadQueue::submit() : GEM::Renderer::UploadQueue::completedUploadID;
+}
+
+/**
+ * @brief Upload every mip level of the texture bound to the target from tightly packed, unsigned byte pixels,
+ * through a single staging buffer if one is free. The texture should have its max level set to the last level,
+ * since the levels uploaded are all it gets
+ *
+ * @param target The texture target the texture is bound to, such as GL_TEXTURE_2D
+ * @param internalFormat The format gl should store the pixels in
+ * @param format The format of the pixels being uploaded
+ * @param levels Each mip level's size and pixels, from level 0 down to the smallest
+ * @return uint64_t The id of the upload, for isComplete
+ */
+uint64_t GEM::Renderer::UploadQueue::uploadTextureLevels(
+    const GLenum target,
+    const GLenum internalFormat,
+    const GLenum format,
+    const std::vector<GEM::Renderer::UploadQueue::TextureLevel>& levels
+) {
+    LOG_FUNCTION_ENTRY_TRACE("{} levels", levels.size());
+
+    return GEM::Renderer::UploadQueue::uploadLevels(target, internalFormat, format, levels, false);
+}
+
+/**
+ * @brief Upload every mip level of the texture bound to the target from block compressed data, through a single
+ * staging buffer if one is free. The texture should have its max level set to the last level, since the levels
+ * uploaded are all it gets
+ *
+ * @param target The texture target the texture is bound to, such as GL_TEXTURE_2D
+ * @param internalFormat The compressed format of the data, which gl stores it in as is
+ * @param levels Each mip level's size and compressed data, from level 0 down to the smallest
+ * @return uint64_t The id of the upload, for isComplete
+ */
+uint64_t GEM::Renderer::UploadQueue::uploadCompressedTextureLevels(
+    const GLenum target,
+    const GLenum internalFormat,
+    const std::vector<GEM::Renderer::UploadQueue::TextureLevel>& levels
+) {
+    LOG_FUNCTION_ENTRY_TRACE("{} levels", levels.size());
+
+    return GEM::Renderer::UploadQueue::uploadLevels(target, internalFormat, 0, levels, true);
+}
+
+/**
+ * @brief Upload data into the start of the buffer bound to the target, through a staging buffer if one is free.
+ * The buffer's storage must already be at least the size of the data
+ *
+ * @param target The buffer target the buffer is bound to, such as GL_ARRAY_BUFFER
+ * @param p_data The data
+ * @param sizeBytes The size of the data in bytes
+ * @return uint64_t The id of the upload, for isComplete
+ */
+uint64_t GEM::Renderer::UploadQueue::uploadBuffer(const GLenum target, const void* p_data, const uint64_t sizeBytes) {
+    LOG_FUNCTION_ENTRY_TRACE("{} bytes", sizeBytes);
+
+    GEM::Renderer::UploadQueue::frameUploadedBytes += sizeBytes;
+
+    if (!GEM::Renderer::UploadQueue::stage(GL_COPY_READ_BUFFER, p_data, sizeBytes)) {
+        glBufferSubData(target, 0, sizeBytes, p_data);
+        return GEM::Renderer::UploadQueue::completedUploadID;
+    }
+
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, target, 0, 0, sizeBytes);
+
+    return GEM::Renderer::UploadQueue::submit();
+}
+
+/* ------------------------------ private static functions ------------------------------ */
+
+/**
+ * @brief Free the staging buffers whose uploads have completed, oldest first. A fence which hasn't signaled means
+ * every upload after it hasn't completed either, so checking stops there and nothing ever waits
+ */
+void GEM::Renderer::UploadQueue::retireCompletedUploads() {
+    while (GEM::Renderer::UploadQueue::inFlightCount > 0) {
+        GEM::Renderer::UploadQueue::StagingBuffer& stagingBuffer = GEM::Renderer::UploadQueue::stagingBuffers[GEM::Renderer::UploadQueue::oldestStagingBufferIndex];
+
+        const GLenum status = glClientWaitSync(stagingBuffer.fence, 0, 0);
+        if (status == GL_TIMEOUT_EXPIRED) {
+            return;
+        }
+        if (status == GL_WAIT_FAILED) {
+            LOG_WARNING("Failed to wait on the fence for upload {} , treating it as complete", stagingBuffer.uploadID);
+        }
+
+        glDeleteSync(stagingBuffer.fence);
+        stagingBuffer.fence = nullptr;
+        GEM::Renderer::UploadQueue::completedUploadID = stagingBuffer.uploadID;
+
+        GEM::Renderer::UploadQueue::oldestStagingBufferIndex = (GEM::Renderer::UploadQueue::oldestStagingBufferIndex + 1) % GEM::Renderer::UploadQueue::stagingBuffers.size();
+        GEM::Renderer::UploadQueue::inFlightCount -= 1;
+    }
+}
+
+/**
+ * @brief Upload mip levels into the texture bound to the target, all staged together in one staging buffer if
+ * one is free, one after the other
+ *
+ * @param target The texture target the texture is bound to, such as GL_TEXTURE_2D
+ * @param internalFormat The format gl should store the levels in
+ * @param format The format of the pixels being uploaded, unused for compressed levels
+ * @param levels Each mip level's size and data, from level 0 down to the smallest
+ * @param compressed Whether the levels are block compressed in the internal format
+ * @return uint64_t The id of the upload, for isComplete
+ */
+uint64_t GEM::Renderer::UploadQueue::uploadLevels(
+    const GLenum target,
+    const GLenum internalFormat,
+    const GLenum format,
+    const std::vector<GEM::Renderer::UploadQueue::TextureLevel>& levels,
+    const bool compressed
+) {
+    for (const GEM::Renderer::UploadQueue::TextureLevel& level : levels) {
+        GEM::Renderer::UploadQueue::frameUploadedBytes += level.sizeBytes;
+    }
+
+    // The rows are tightly packed, so gl mustn't expect them to be padded out to the default of 4 bytes
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    const bool staged = GEM::Renderer::UploadQueue::stageLevels(GL_PIXEL_UNPACK_BUFFER, levels);
+    uint64_t offset = 0;
+    for (uint32_t i = 0; i < levels.size(); i++) {
+        const GEM::Renderer::UploadQueue::TextureLevel& level = levels[i];
+
+        // With a pixel unpack buffer bound the pointer is an offset into it
+        const void* p_levelData = staged ? reinterpret_cast<const void*>(static_cast<uintptr_t>(offset)) : level.p_data;
+        if (compressed) {
+            glCompressedTexImage2D(target, i, internalFormat, level.width, level.height, 0, static_cast<GLsizei>(level.sizeBytes), p_levelData);
+        } else {
+            glTexImage2D(target, i, internalFormat, level.width, level.height, 0, format, GL_UNSIGNED_BYTE, p_levelData);
+        }
+        offset += level.sizeBytes;
+    }
+
+    // Anything uploaded from client memory afterwards would be read out of the staging buffer instead
+    if (staged) {
+        GEM::Renderer::StateCache::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    return staged ? GEM::Renderer::UploadQueue::submit() : GEM::Renderer::UploadQueue::completedUploadID;
+}
+
+/**
+ * @brief Copy data into the next staging buffer and leave it bound to the target, so the upload can be made from
+ * it
+ *
+ * @param target The buffer target to bind the staging buffer to
+ * @param p_data The data to stage
+ * @param sizeBytes The size of the data in bytes
+ * @return true The data was staged
+ * @return false Nothing was staged, and the data should be uploaded straight from client memory
+ */
+bool GEM::Renderer::UploadQueue::stage(const GLenum target, const void* p_data, const uint64_t sizeBytes) {
+    void* p_stagingData = GEM::Renderer::UploadQueue::beginStaging(target, sizeBytes);
+    if (!p_stagingData) {
+        return false;
+    }
+
+    std::memcpy(p_stagingData, p_data, sizeBytes);
+
+    return GEM::Renderer::UploadQueue::endStaging(target);
+}
+
+/**
+ * @brief Copy mip levels one after the other into the next staging buffer and leave it bound to the target, so
+ * the upload can be made from it
+ *
+ * @param target The buffer target to bind the staging buffer to
+ * @param levels The mip levels whose data to stage
+ * @return true The levels were staged
+ * @return false Nothing was staged, and the levels should be uploaded straight from client memory
+ */
+bool GEM::Renderer::UploadQueue::stageLevels(const GLenum target, const std::vector<GEM::Renderer::UploadQueue::TextureLevel>& levels) {
+    uint64_t sizeBytes = 0;
+    for (const GEM::Renderer::UploadQueue::TextureLevel& level : levels) {
+        sizeBytes += level.sizeBytes;
+    }
+
+    uint8_t* p_stagingData = static_cast<uint8_t*>(GEM::Renderer::UploadQueue::beginStaging(target, sizeBytes));
+    if (!p_stagingData) {
+        return false;
+    }
+
+    for (const GEM::Renderer::UploadQueue::TextureLevel& level : levels) {
+        std::memcpy(p_stagingData, level.p_data, level.sizeBytes);
+        p_stagingData += level.sizeBytes;
+    }
+
+    return GEM::Renderer::UploadQueue::endStaging(target);
+}
+
+/**
+ * @brief Bind the next staging buffer to the target and map it to be written. The buffer's old storage is
+ * orphaned rather than reused, so gl never has to wait for an old upload out of it to finish before it can be
+ * written, and it is sized to fit whatever is staged in it
+ *
+ * @param target The buffer target to bind the staging buffer to
+ * @param sizeBytes The size of the data to stage in bytes
+ * @return void* Where to write the data, or nullptr if the queue isn't running, every staging buffer is in
+ * flight, or the staging buffer couldn't be mapped
+ */
+void* GEM::Renderer::UploadQueue::beginStaging(const GLenum target, const uint64_t sizeBytes) {
+    if (!GEM::Renderer::UploadQueue::running || sizeBytes == 0) {
+        return nullptr;
+    }
+
+    GEM::Renderer::UploadQueue::retireCompletedUploads();
+    if (GEM::Renderer::UploadQueue::inFlightCount == GEM::Renderer::UploadQueue::stagingBuffers.size()) {
+        LOG_TRACE("Every staging buffer is in flight , uploading {} bytes from client memory", sizeBytes);
+        return nullptr;
+    }
+
+    const GEM::Renderer::UploadQueue::StagingBuffer& stagingBuffer = GEM::Renderer::UploadQueue::stagingBuffers[GEM::Renderer::UploadQueue::nextStagingBufferIndex];
+    GEM::Renderer::StateCache::bindBuffer(target, stagingBuffer.bufferID);
+    glBufferData(target, sizeBytes, nullptr, GL_STREAM_DRAW);
+
+    void* p_stagingData = glMapBufferRange(target, 0, sizeBytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (!p_stagingData) {
+        LOG_WARNING("Failed to map staging buffer {} , uploading {} bytes from client memory", stagingBuffer.bufferID, sizeBytes);
+        GEM::Renderer::StateCache::bindBuffer(target, 0);
+    }
+
+    return p_stagingData;
+}
+
+/**
+ * @brief Unmap the staging buffer bound to the target once the data has been written into it
+ *
+ * @param target The buffer target the staging buffer is bound to
+ * @return true The data is in the staging buffer
+ * @return false The staging buffer's contents were lost while it was mapped, and the data should be uploaded
+ * straight from client memory
+ */
+bool GEM::Renderer::UploadQueue::endStaging(const GLenum target) {
+    if (glUnmapBuffer(target) == GL_FALSE) {
+        LOG_WARNING("Lost the contents of staging buffer {} while writing them , uploading from client memory", GEM::Renderer::UploadQueue::stagingBuffers[GEM::Renderer::UploadQueue::nextStagingBufferIndex].bufferID);
+        GEM::Renderer::StateCache::bindBuffer(target, 0);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Insert a fence behind the upload just made out of the next staging buffer, and move on to the one after
+ *
+ * @return uint64_t The id of the upload
+ */
+uint64_t GEM::Renderer::UploadQueue::submit() {
+    GEM::Renderer::UploadQueue::StagingBuffer& stagingBuffer = GEM::Renderer::UploadQueue::stagingBuffers[GEM::Renderer::UploadQueue::nextStagingBufferIndex];
+    stagingBuffer.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    stagingBuffer.uploadID = GEM::Renderer::UploadQueue::nextUploadID;
+
+    GEM::Renderer::UploadQueue::nextUploadID += 1;
+    GEM::Renderer::UploadQueue::nextStagingBufferIndex = (GEM::Renderer::UploadQueue::nextStagingBufferIndex + 1) % GEM::Renderer::UploadQueue::stagingBuffers.size();
+    GEM::Renderer::UploadQueue::inFlightCount += 1;
+
+    return stagingBuffer.uploadID;
+}
+
+/* ------------------------------ public member functions ------------------------------ */
+
+/* ------------------------------ private member functions ------------------------------ */
\ No newline at end of file
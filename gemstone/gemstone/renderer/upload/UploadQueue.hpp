@@ -0,0 +1,130 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+namespace GEM {
+namespace Renderer {
+    class UploadQueue;
+}
+}
+
+/**
+ * @brief A class staging texture and buffer uploads through a ring of unpack buffers, so copying new assets to
+ * the gpu doesn't stall the frame. Data is copied into the next staging buffer, gl is told to upload it from
+ * there, and a fence is inserted behind the upload. Once the fence signals the upload is complete and the staging
+ * buffer can be used again. Uploads complete in the order they were made, so each is identified by an
+ * increasing upload id and isComplete only has to compare it to the newest complete one
+ *
+ * Every upload counts against a per frame budget of bytes. Callers which can wait, like textures showing the
+ * placeholder until theirs is uploaded, check canStage before each upload so a burst of new assets is spread over
+ * several frames. Callers which can't, like meshes drawn the frame they are created, upload right away and only
+ * use up the budget
+ *
+ * Whole mip chains, compressed or not, are uploaded with uploadTextureLevels and uploadCompressedTextureLevels,
+ * which stage every level in the same staging buffer so they take up a single upload
+ *
+ * Without initialize being called, or while every staging buffer is in flight, data is uploaded straight from
+ * client memory instead, and the upload is complete as soon as it is made
+ *
+ * @note There is only one gl context, so all of the state is static
+ */
+class GEM::Renderer::UploadQueue {
+public: // public classes and enums
+    struct TextureLevel {
+        uint32_t width;
+        uint32_t height;
+        const void* p_data;
+        uint64_t sizeBytes;
+    };
+
+public: // public static variables
+    static const std::string LOGGER_NAME;
+
+    static const uint32_t DEFAULT_STAGING_BUFFER_COUNT;
+    static const uint64_t DEFAULT_FRAME_BUDGET_BYTES;
+
+public: // public static functions
+    static void initialize(
+        const uint32_t stagingBufferCount = GEM::Renderer::UploadQueue::DEFAULT_STAGING_BUFFER_COUNT,
+        const uint64_t frameBudgetBytes = GEM::Renderer::UploadQueue::DEFAULT_FRAME_BUDGET_BYTES
+    );
+    static void shutdown();
+
+    static bool isRunning() { return running; }
+    static void beginFrame();
+    static bool canStage();
+
+    static uint64_t uploadTexture(
+        const GLenum target,
+        const uint32_t level,
+        const GLenum internalFormat,
+        const uint32_t width,
+        const uint32_t height,
+        const GLenum format,
+        const void* p_pixels,
+        const uint64_t sizeBytes
+    );
+    static uint64_t uploadTextureLevels(
+        const GLenum target,
+        const GLenum internalFormat,
+        const GLenum format,
+        const std::vector<GEM::Renderer::UploadQueue::TextureLevel>& levels
+    );
+    static uint64_t uploadCompressedTextureLevels(
+        const GLenum target,
+        const GLenum internalFormat,
+        const std::vector<GEM::Renderer::UploadQueue::TextureLevel>& levels
+    );
+    static uint64_t uploadBuffer(const GLenum target, const void* p_data, const uint64_t sizeBytes);
+
+    static bool isComplete(const uint64_t uploadID) { return uploadID <= completedUploadID; }
+    static uint32_t getPendingCount() { return inFlightCount; }
+
+    static uint64_t getFrameBudgetBytes() { return frameBudgetBytes; }
+    static void setFrameBudgetBytes(const uint64_t budgetBytes) { frameBudgetBytes = budgetBytes; }
+    static uint64_t getFrameUploadedBytes() { return frameUploadedBytes; }
+
+public: // public member functions
+    UploadQueue() = delete;
+
+private: // private classes and enums
+    struct StagingBuffer {
+        uint32_t bufferID;
+        // Signals once the upload staged in the buffer is complete, nullptr while the buffer is free
+        GLsync fence;
+        uint64_t uploadID;
+    };
+
+private: // private static functions
+    static void retireCompletedUploads();
+    static uint64_t uploadLevels(
+        const GLenum target,
+        const GLenum internalFormat,
+        const GLenum format,
+        const std::vector<GEM::Renderer::UploadQueue::TextureLevel>& levels,
+        const bool compressed
+    );
+    static bool stage(const GLenum target, const void* p_data, const uint64_t sizeBytes);
+    static bool stageLevels(const GLenum target, const std::vector<GEM::Renderer::UploadQueue::TextureLevel>& levels);
+    static void* beginStaging(const GLenum target, const uint64_t sizeBytes);
+    static bool endStaging(const GLenum target);
+    static uint64_t submit();
+
+private: // private static variables
+    static bool running;
+
+    static uint64_t frameBudgetBytes;
+    static uint64_t frameUploadedBytes;
+
+    static std::vector<GEM::Renderer::UploadQueue::StagingBuffer> stagingBuffers;
+    // The buffer the next upload is staged in, and the buffer staging the oldest upload still in flight
+    static uint32_t nextStagingBufferIndex;
+    static uint32_t oldestStagingBufferIndex;
+    static uint32_t inFlightCount;
+
+    static uint64_t nextUploadID;
+    static uint64_t completedUploadID;
+};
\ No newline at end of file
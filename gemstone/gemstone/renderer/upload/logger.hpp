@@ -0,0 +1,6 @@
+#pragma once
+
+/**
+ * @brief The name of the logger used by the upload classes
+ */
+#define UPLOAD_LOGGER_NAME "UPLOAD"
\ No newline at end of file
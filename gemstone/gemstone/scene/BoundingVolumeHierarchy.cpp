@@ -0,0 +1,630 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "util/logger/Logger.hpp"
+
+#include "gemstone/scene/logger.hpp"
+#include "gemstone/scene/BoundingVolumeHierarchy.hpp"
+
+/* ------------------------------ public static variables ------------------------------ */
+
+/**
+ * @brief The name of the logger the BoundingVolumeHierarchy class uses
+ */
+const std::string GEM::BoundingVolumeHierarchy::LOGGER_NAME = SCENE_LOGGER_NAME;
+
+/**
+ * @brief The index a raycast hit has when the ray did not hit anything
+ */
+const uint32_t GEM::BoundingVolumeHierarchy::INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+/**
+ * @brief The number of bins the centroids are sorted into along each axis when looking for the cheapest split.
+ * More bins find slightly better splits at the cost of a slower build
+ */
+const uint32_t GEM::BoundingVolumeHierarchy::SAH_BIN_COUNT = 12;
+
+/**
+ * @brief How much more expensive than when it was built the tree may become through refitting before it is
+ * rebuilt from scratch
+ */
+const float GEM::BoundingVolumeHierarchy::REBUILD_COST_RATIO = 1.5f;
+
+/* ------------------------------ private static variables ------------------------------ */
+
+/* ------------------------------ public static functions ------------------------------ */
+
+/* ------------------------------ private static functions ------------------------------ */
+
+/**
+ * @brief Get the surface area of a bounding box
+ *
+ * @param boundsMin The minimum corner of the box
+ * @param boundsMax The maximum corner of the box
+ * @return float The surface area
+ */
+float GEM::BoundingVolumeHierarchy::getSurfaceArea(const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+    const glm::vec3 extent = boundsMax - boundsMin;
+    return 2.0f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+}
+
+/**
+ * @brief Determine whether two bounding boxes overlap. Boxes which only touch count as overlapping
+ *
+ * @param aMin The minimum corner of the first box
+ * @param aMax The maximum corner of the first box
+ * @param bMin The minimum corner of the second box
+ * @param bMax The maximum corner of the second box
+ * @return true If the boxes overlap
+ * @return false If they do not
+ */
+bool GEM::BoundingVolumeHierarchy::boundsOverlap(const glm::vec3& aMin, const glm::vec3& aMax, const glm::vec3& bMin, const glm::vec3& bMax) {
+    return aMin.x <= bMax.x && aMax.x >= bMin.x &&
+           aMin.y <= bMax.y && aMax.y >= bMin.y &&
+           aMin.z <= bMax.z && aMax.z >= bMin.z;
+}
+
+/**
+ * @brief Intersect a ray with a bounding box using the slab method
+ *
+ * @param origin The origin of the ray
+ * @param inverseDirection The reciprocal of each component of the ray's direction
+ * @param boundsMin The minimum corner of the box
+ * @param boundsMax The maximum corner of the box
+ * @param maxDistance The distance along the ray past which hits are ignored
+ * @return float The distance along the ray at which it enters the box, 0 if it starts inside the box, or the
+ * largest float if it misses the box
+ */
+float GEM::BoundingVolumeHierarchy::intersectRay(
+    const glm::vec3& origin,
+    const glm::vec3& inverseDirection,
+    const glm::vec3& boundsMin,
+    const glm::vec3& boundsMax,
+    const float maxDistance
+) {
+    const float miss = std::numeric_limits<float>::max();
+
+    float entry = 0.0f;
+    float exit = maxDistance;
+    for (int32_t axis = 0; axis < 3; ++axis) {
+        // A ray parallel to an axis never crosses its slab, so it is either between the planes for its whole
+        // length or never. Its inverse direction is infinite, which would make the distances nan whenever the
+        // origin lies on one of the planes
+        if (std::isinf(inverseDirection[axis])) {
+            if (origin[axis] < boundsMin[axis] || origin[axis] > boundsMax[axis]) {
+                return miss;
+            }
+            continue;
+        }
+
+        const float t0 = (boundsMin[axis] - origin[axis]) * inverseDirection[axis];
+        const float t1 = (boundsMax[axis] - origin[axis]) * inverseDirection[axis];
+        entry = std::max(entry, std::min(t0, t1));
+        exit = std::min(exit, std::max(t0, t1));
+    }
+
+    return entry <= exit ? entry : miss;
+}
+
+/* ------------------------------ public member functions ------------------------------ */
+
+/**
+ * @brief Construct a new GEM::BoundingVolumeHierarchy::BoundingVolumeHierarchy object with nothing in it
+ */
+GEM::BoundingVolumeHierarchy::BoundingVolumeHierarchy() :
+    m_nodes(),
+    m_primitiveIndices(),
+    m_primitiveBoundsMins(),
+    m_primitiveBoundsMaxs(),
+    m_builtCost(0.0f)
+{
+    LOG_FUNCTION_CALL_TRACE("this ptr {}", static_cast<void*>(this));
+}
+
+/**
+ * @brief Destroy the GEM::BoundingVolumeHierarchy::BoundingVolumeHierarchy object
+ */
+GEM::BoundingVolumeHierarchy::~BoundingVolumeHierarchy() {
+    LOG_FUNCTION_CALL_TRACE("this ptr {}", static_cast<void*>(this));
+}
+
+/**
+ * @brief Build the tree from scratch over the given bounding boxes. Primitive i is the box made of
+ * boundsMins[i] and boundsMaxs[i]
+ *
+ * @param boundsMins The minimum corner of each primitive's bounding box
+ * @param boundsMaxs The maximum corner of each primitive's bounding box
+ * @note This function will throw an exception if the two vectors are not the same size
+ */
+void GEM::BoundingVolumeHierarchy::build(const std::vector<glm::vec3>& boundsMins, const std::vector<glm::vec3>& boundsMaxs) {
+    LOG_FUNCTION_CALL_TRACE("primitive count {}", boundsMins.size());
+
+    if (boundsMins.size() != boundsMaxs.size()) {
+        const std::string errorMessage = "Bounding volume hierarchy given " + std::to_string(boundsMins.size()) + " minimum corners but " + std::to_string(boundsMaxs.size()) + " maximum corners";
+        LOG_CRITICAL(errorMessage);
+        throw std::invalid_argument(errorMessage);
+    }
+
+    m_primitiveBoundsMins = boundsMins;
+    m_primitiveBoundsMaxs = boundsMaxs;
+
+    const uint32_t primitiveCount = static_cast<uint32_t>(m_primitiveBoundsMins.size());
+    m_primitiveIndices.resize(primitiveCount);
+    for (uint32_t i = 0; i < primitiveCount; ++i) {
+        m_primitiveIndices[i] = i;
+    }
+
+    // A binary tree with one primitive per leaf has 2n - 1 nodes, and we never make more than that
+    m_nodes.clear();
+    m_nodes.reserve(std::max(2 * primitiveCount, 1u) - 1);
+    m_builtCost = 0.0f;
+    if (primitiveCount == 0) {
+        return;
+    }
+
+    m_nodes.push_back({glm::vec3(0.0f), glm::vec3(0.0f), 0, primitiveCount});
+    updateNodeBounds(0);
+    subdivide(0);
+
+    m_builtCost = getCost();
+    LOG_DEBUG("Built bounding volume hierarchy with {} primitives , {} nodes , cost {}", primitiveCount, m_nodes.size(), m_builtCost);
+}
+
+/**
+ * @brief Bring the tree up to date with the primitives' new bounding boxes. If no box moved this does nothing.
+ * Otherwise the nodes are refit bottom up, keeping the tree's shape, and only if that leaves the tree much
+ * looser than when it was built is it rebuilt. Adding or removing primitives always rebuilds
+ *
+ * @param boundsMins The minimum corner of each primitive's bounding box
+ * @param boundsMaxs The maximum corner of each primitive's bounding box
+ * @note This function will throw an exception if the two vectors are not the same size
+ */
+void GEM::BoundingVolumeHierarchy::refit(const std::vector<glm::vec3>& boundsMins, const std::vector<glm::vec3>& boundsMaxs) {
+    if (boundsMins.size() != m_primitiveBoundsMins.size() || boundsMaxs.size() != m_primitiveBoundsMaxs.size()) {
+        build(boundsMins, boundsMaxs);
+        return;
+    }
+
+    bool boundsChanged = false;
+    for (size_t i = 0; i < boundsMins.size(); ++i) {
+        if (boundsMins[i] != m_primitiveBoundsMins[i] || boundsMaxs[i] != m_primitiveBoundsMaxs[i]) {
+            m_primitiveBoundsMins[i] = boundsMins[i];
+            m_primitiveBoundsMaxs[i] = boundsMaxs[i];
+            boundsChanged = true;
+        }
+    }
+    if (!boundsChanged) {
+        return;
+    }
+
+    refitNodes();
+
+    const float cost = getCost();
+    if (cost > m_builtCost * GEM::BoundingVolumeHierarchy::REBUILD_COST_RATIO) {
+        LOG_DEBUG("Rebuilding bounding volume hierarchy , refit cost {} , built cost {}", cost, m_builtCost);
+        build(boundsMins, boundsMaxs);
+    }
+}
+
+/**
+ * @brief Find every primitive whose bounding box is at least partly inside the frustum. Nodes entirely inside
+ * the frustum have their whole subtree added without testing any more planes
+ *
+ * @param frustumPlanes The six inward facing, normalized planes of the frustum
+ * @param indices The vector the indices of the primitives are appended to
+ */
+void GEM::BoundingVolumeHierarchy::queryFrustum(const std::array<glm::vec4, 6>& frustumPlanes, std::vector<uint32_t>& indices) const {
+    if (m_nodes.empty()) {
+        return;
+    }
+
+    // Classify a box against the frustum : -1 when outside, 1 when inside, and 0 when it straddles a plane
+    const auto classify = [&frustumPlanes](const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+        const glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+        const glm::vec3 extent = (boundsMax - boundsMin) * 0.5f;
+
+        int32_t result = 1;
+        for (const glm::vec4& plane : frustumPlanes) {
+            const float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+            const float radius = std::abs(plane.x) * extent.x + std::abs(plane.y) * extent.y + std::abs(plane.z) * extent.z;
+            if (distance + radius < 0.0f) {
+                return -1;
+            }
+            if (distance - radius < 0.0f) {
+                result = 0;
+            }
+        }
+        return result;
+    };
+
+    std::vector<uint32_t> nodeStack = {0};
+    while (!nodeStack.empty()) {
+        const uint32_t nodeIndex = nodeStack.back();
+        nodeStack.pop_back();
+        const GEM::BoundingVolumeHierarchy::Node& node = m_nodes[nodeIndex];
+
+        const int32_t classification = classify(node.boundsMin, node.boundsMax);
+        if (classification < 0) {
+            continue;
+        }
+        if (classification > 0) {
+            collectPrimitives(nodeIndex, indices);
+            continue;
+        }
+
+        if (node.count > 0) {
+            for (uint32_t i = node.firstChildOrPrimitive; i < node.firstChildOrPrimitive + node.count; ++i) {
+                const uint32_t primitiveIndex = m_primitiveIndices[i];
+                if (classify(m_primitiveBoundsMins[primitiveIndex], m_primitiveBoundsMaxs[primitiveIndex]) >= 0) {
+                    indices.push_back(primitiveIndex);
+                }
+            }
+            continue;
+        }
+
+        nodeStack.push_back(node.firstChildOrPrimitive);
+        nodeStack.push_back(node.firstChildOrPrimitive + 1);
+    }
+}
+
+/**
+ * @brief Find every primitive whose bounding box overlaps the given box
+ *
+ * @param boundsMin The minimum corner of the box
+ * @param boundsMax The maximum corner of the box
+ * @param indices The vector the indices of the primitives are appended to
+ */
+void GEM::BoundingVolumeHierarchy::queryOverlap(const glm::vec3& boundsMin, const glm::vec3& boundsMax, std::vector<uint32_t>& indices) const {
+    if (m_nodes.empty()) {
+        return;
+    }
+
+    std::vector<uint32_t> nodeStack = {0};
+    while (!nodeStack.empty()) {
+        const GEM::BoundingVolumeHierarchy::Node& node = m_nodes[nodeStack.back()];
+        nodeStack.pop_back();
+
+        if (!GEM::BoundingVolumeHierarchy::boundsOverlap(node.boundsMin, node.boundsMax, boundsMin, boundsMax)) {
+            continue;
+        }
+
+        if (node.count > 0) {
+            for (uint32_t i = node.firstChildOrPrimitive; i < node.firstChildOrPrimitive + node.count; ++i) {
+                const uint32_t primitiveIndex = m_primitiveIndices[i];
+                if (GEM::BoundingVolumeHierarchy::boundsOverlap(m_primitiveBoundsMins[primitiveIndex], m_primitiveBoundsMaxs[primitiveIndex], boundsMin, boundsMax)) {
+                    indices.push_back(primitiveIndex);
+                }
+            }
+            continue;
+        }
+
+        nodeStack.push_back(node.firstChildOrPrimitive);
+        nodeStack.push_back(node.firstChildOrPrimitive + 1);
+    }
+}
+
+/**
+ * @brief Find every primitive whose bounding box overlaps the given sphere
+ *
+ * @param center The center of the sphere
+ * @param radius The radius of the sphere
+ * @param indices The vector the indices of the primitives are appended to
+ */
+void GEM::BoundingVolumeHierarchy::queryRadius(const glm::vec3& center, const float radius, std::vector<uint32_t>& indices) const {
+    if (m_nodes.empty()) {
+        return;
+    }
+
+    // A box overlaps the sphere when the point of the box closest to the center is within the radius
+    const float radiusSquared = radius * radius;
+    const auto overlapsSphere = [&center, radiusSquared](const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+        const glm::vec3 offset = glm::max(boundsMin - center, glm::vec3(0.0f)) + glm::max(center - boundsMax, glm::vec3(0.0f));
+        return glm::dot(offset, offset) <= radiusSquared;
+    };
+
+    std::vector<uint32_t> nodeStack = {0};
+    while (!nodeStack.empty()) {
+        const GEM::BoundingVolumeHierarchy::Node& node = m_nodes[nodeStack.back()];
+        nodeStack.pop_back();
+
+        if (!overlapsSphere(node.boundsMin, node.boundsMax)) {
+            continue;
+        }
+
+        if (node.count > 0) {
+            for (uint32_t i = node.firstChildOrPrimitive; i < node.firstChildOrPrimitive + node.count; ++i) {
+                const uint32_t primitiveIndex = m_primitiveIndices[i];
+                if (overlapsSphere(m_primitiveBoundsMins[primitiveIndex], m_primitiveBoundsMaxs[primitiveIndex])) {
+                    indices.push_back(primitiveIndex);
+                }
+            }
+            continue;
+        }
+
+        nodeStack.push_back(node.firstChildOrPrimitive);
+        nodeStack.push_back(node.firstChildOrPrimitive + 1);
+    }
+}
+
+/**
+ * @brief Find the primitive whose bounding box the ray enters first. Children are visited nearest first, and
+ * any node farther away than the best hit so far is skipped
+ *
+ * @param origin The origin of the ray
+ * @param direction The direction of the ray. This does not need to be normalized, but distances are measured
+ * in multiples of its length
+ * @param maxDistance The distance along the ray past which hits are ignored
+ * @return GEM::BoundingVolumeHierarchy::RaycastHit The index of the primitive hit and the distance to it, or
+ * INVALID_INDEX if nothing was hit
+ */
+GEM::BoundingVolumeHierarchy::RaycastHit GEM::BoundingVolumeHierarchy::raycast(
+    const glm::vec3& origin,
+    const glm::vec3& direction,
+    const float maxDistance
+) const {
+    GEM::BoundingVolumeHierarchy::RaycastHit closestHit = {GEM::BoundingVolumeHierarchy::INVALID_INDEX, maxDistance};
+    if (m_nodes.empty()) {
+        return closestHit;
+    }
+
+    // Components of the direction which are 0 give infinite inverses, which intersectRay treats as parallel
+    const glm::vec3 inverseDirection = 1.0f / direction;
+    const float miss = std::numeric_limits<float>::max();
+
+    std::vector<uint32_t> nodeStack;
+    if (GEM::BoundingVolumeHierarchy::intersectRay(origin, inverseDirection, m_nodes[0].boundsMin, m_nodes[0].boundsMax, closestHit.distance) != miss) {
+        nodeStack.push_back(0);
+    }
+
+    while (!nodeStack.empty()) {
+        const GEM::BoundingVolumeHierarchy::Node& node = m_nodes[nodeStack.back()];
+        nodeStack.pop_back();
+
+        // A closer hit may have been found since this node was pushed
+        if (GEM::BoundingVolumeHierarchy::intersectRay(origin, inverseDirection, node.boundsMin, node.boundsMax, closestHit.distance) == miss) {
+            continue;
+        }
+
+        if (node.count > 0) {
+            for (uint32_t i = node.firstChildOrPrimitive; i < node.firstChildOrPrimitive + node.count; ++i) {
+                const uint32_t primitiveIndex = m_primitiveIndices[i];
+                const float distance = GEM::BoundingVolumeHierarchy::intersectRay(origin, inverseDirection, m_primitiveBoundsMins[primitiveIndex], m_primitiveBoundsMaxs[primitiveIndex], closestHit.distance);
+                if (distance != miss && (closestHit.index == GEM::BoundingVolumeHierarchy::INVALID_INDEX || distance < closestHit.distance)) {
+                    closestHit = {primitiveIndex, distance};
+                }
+            }
+            continue;
+        }
+
+        // Push the farther child first so the nearer one is visited first
+        uint32_t nearChild = node.firstChildOrPrimitive;
+        uint32_t farChild = node.firstChildOrPrimitive + 1;
+        float nearDistance = GEM::BoundingVolumeHierarchy::intersectRay(origin, inverseDirection, m_nodes[nearChild].boundsMin, m_nodes[nearChild].boundsMax, closestHit.distance);
+        float farDistance = GEM::BoundingVolumeHierarchy::intersectRay(origin, inverseDirection, m_nodes[farChild].boundsMin, m_nodes[farChild].boundsMax, closestHit.distance);
+        if (farDistance < nearDistance) {
+            std::swap(nearChild, farChild);
+            std::swap(nearDistance, farDistance);
+        }
+
+        if (farDistance != miss) {
+            nodeStack.push_back(farChild);
+        }
+        if (nearDistance != miss) {
+            nodeStack.push_back(nearChild);
+        }
+    }
+
+    return closestHit;
+}
+
+/* ------------------------------ private member functions ------------------------------ */
+
+/**
+ * @brief Set a leaf node's bounds to the union of its primitives' bounds
+ *
+ * @param nodeIndex The index of the leaf node
+ */
+void GEM::BoundingVolumeHierarchy::updateNodeBounds(const uint32_t nodeIndex) {
+    GEM::BoundingVolumeHierarchy::Node& node = m_nodes[nodeIndex];
+    node.boundsMin = glm::vec3(std::numeric_limits<float>::max());
+    node.boundsMax = glm::vec3(std::numeric_limits<float>::lowest());
+    for (uint32_t i = node.firstChildOrPrimitive; i < node.firstChildOrPrimitive + node.count; ++i) {
+        const uint32_t primitiveIndex = m_primitiveIndices[i];
+        node.boundsMin = glm::min(node.boundsMin, m_primitiveBoundsMins[primitiveIndex]);
+        node.boundsMax = glm::max(node.boundsMax, m_primitiveBoundsMaxs[primitiveIndex]);
+    }
+}
+
+/**
+ * @brief Split a leaf node and its descendants until splitting no longer lowers the surface area heuristic
+ * cost. The centroids of each node's primitives are sorted into bins along each axis, and the cheapest split
+ * between two bins is taken
+ *
+ * @param rootNodeIndex The index of the leaf node to split
+ */
+void GEM::BoundingVolumeHierarchy::subdivide(const uint32_t rootNodeIndex) {
+    struct Bin {
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+        uint32_t count;
+    };
+    const uint32_t binCount = GEM::BoundingVolumeHierarchy::SAH_BIN_COUNT;
+    std::vector<Bin> bins(binCount);
+    std::vector<float> rightCosts(binCount);
+
+    std::vector<uint32_t> nodeStack = {rootNodeIndex};
+    while (!nodeStack.empty()) {
+        const uint32_t nodeIndex = nodeStack.back();
+        nodeStack.pop_back();
+
+        const uint32_t first = m_nodes[nodeIndex].firstChildOrPrimitive;
+        const uint32_t count = m_nodes[nodeIndex].count;
+        if (count <= 1) {
+            continue;
+        }
+
+        glm::vec3 centroidMin = glm::vec3(std::numeric_limits<float>::max());
+        glm::vec3 centroidMax = glm::vec3(std::numeric_limits<float>::lowest());
+        for (uint32_t i = first; i < first + count; ++i) {
+            const uint32_t primitiveIndex = m_primitiveIndices[i];
+            const glm::vec3 centroid = (m_primitiveBoundsMins[primitiveIndex] + m_primitiveBoundsMaxs[primitiveIndex]) * 0.5f;
+            centroidMin = glm::min(centroidMin, centroid);
+            centroidMax = glm::max(centroidMax, centroid);
+        }
+
+        // Find the cheapest split plane along any axis
+        float bestCost = static_cast<float>(count) * GEM::BoundingVolumeHierarchy::getSurfaceArea(m_nodes[nodeIndex].boundsMin, m_nodes[nodeIndex].boundsMax);
+        int32_t bestAxis = -1;
+        uint32_t bestSplit = 0;
+        for (int32_t axis = 0; axis < 3; ++axis) {
+            const float axisExtent = centroidMax[axis] - centroidMin[axis];
+            if (axisExtent <= 0.0f) {
+                continue;
+            }
+            const float binScale = static_cast<float>(binCount) / axisExtent;
+
+            for (Bin& bin : bins) {
+                bin = {glm::vec3(std::numeric_limits<float>::max()), glm::vec3(std::numeric_limits<float>::lowest()), 0};
+            }
+            for (uint32_t i = first; i < first + count; ++i) {
+                const uint32_t primitiveIndex = m_primitiveIndices[i];
+                const float centroid = (m_primitiveBoundsMins[primitiveIndex][axis] + m_primitiveBoundsMaxs[primitiveIndex][axis]) * 0.5f;
+                const uint32_t binIndex = std::min(binCount - 1, static_cast<uint32_t>((centroid - centroidMin[axis]) * binScale));
+                bins[binIndex].boundsMin = glm::min(bins[binIndex].boundsMin, m_primitiveBoundsMins[primitiveIndex]);
+                bins[binIndex].boundsMax = glm::max(bins[binIndex].boundsMax, m_primitiveBoundsMaxs[primitiveIndex]);
+                bins[binIndex].count++;
+            }
+
+            // Sweep from the right to get the cost of everything right of each split, then from the left
+            glm::vec3 sweepMin = glm::vec3(std::numeric_limits<float>::max());
+            glm::vec3 sweepMax = glm::vec3(std::numeric_limits<float>::lowest());
+            uint32_t sweepCount = 0;
+            for (uint32_t b = binCount - 1; b > 0; --b) {
+                sweepMin = glm::min(sweepMin, bins[b].boundsMin);
+                sweepMax = glm::max(sweepMax, bins[b].boundsMax);
+                sweepCount += bins[b].count;
+                rightCosts[b] = sweepCount > 0 ? static_cast<float>(sweepCount) * GEM::BoundingVolumeHierarchy::getSurfaceArea(sweepMin, sweepMax) : 0.0f;
+            }
+
+            sweepMin = glm::vec3(std::numeric_limits<float>::max());
+            sweepMax = glm::vec3(std::numeric_limits<float>::lowest());
+            sweepCount = 0;
+            for (uint32_t split = 1; split < binCount; ++split) {
+                sweepMin = glm::min(sweepMin, bins[split - 1].boundsMin);
+                sweepMax = glm::max(sweepMax, bins[split - 1].boundsMax);
+                sweepCount += bins[split - 1].count;
+                if (sweepCount == 0 || sweepCount == count) {
+                    continue;
+                }
+
+                const float cost = static_cast<float>(sweepCount) * GEM::BoundingVolumeHierarchy::getSurfaceArea(sweepMin, sweepMax) + rightCosts[split];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = split;
+                }
+            }
+        }
+
+        // Splitting would not make the tree any cheaper to traverse, so this stays a leaf
+        if (bestAxis < 0) {
+            continue;
+        }
+
+        const float binScale = static_cast<float>(binCount) / (centroidMax[bestAxis] - centroidMin[bestAxis]);
+        const auto isLeft = [&](const uint32_t primitiveIndex) {
+            const float centroid = (m_primitiveBoundsMins[primitiveIndex][bestAxis] + m_primitiveBoundsMaxs[primitiveIndex][bestAxis]) * 0.5f;
+            return std::min(binCount - 1, static_cast<uint32_t>((centroid - centroidMin[bestAxis]) * binScale)) < bestSplit;
+        };
+        const uint32_t leftCount = static_cast<uint32_t>(
+            std::partition(m_primitiveIndices.begin() + first, m_primitiveIndices.begin() + first + count, isLeft) - (m_primitiveIndices.begin() + first)
+        );
+
+        const uint32_t leftChildIndex = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.push_back({glm::vec3(0.0f), glm::vec3(0.0f), first, leftCount});
+        m_nodes.push_back({glm::vec3(0.0f), glm::vec3(0.0f), first + leftCount, count - leftCount});
+        m_nodes[nodeIndex].firstChildOrPrimitive = leftChildIndex;
+        m_nodes[nodeIndex].count = 0;
+
+        updateNodeBounds(leftChildIndex);
+        updateNodeBounds(leftChildIndex + 1);
+        nodeStack.push_back(leftChildIndex);
+        nodeStack.push_back(leftChildIndex + 1);
+    }
+}
+
+/**
+ * @brief Recompute every node's bounds from the primitives' current bounds without changing the shape of the
+ * tree. Children are always stored after their parents, so walking the nodes backwards visits every child
+ * before its parent
+ */
+void GEM::BoundingVolumeHierarchy::refitNodes() {
+    for (size_t i = m_nodes.size(); i-- > 0;) {
+        GEM::BoundingVolumeHierarchy::Node& node = m_nodes[i];
+        if (node.count > 0) {
+            updateNodeBounds(static_cast<uint32_t>(i));
+            continue;
+        }
+
+        const GEM::BoundingVolumeHierarchy::Node& leftChild = m_nodes[node.firstChildOrPrimitive];
+        const GEM::BoundingVolumeHierarchy::Node& rightChild = m_nodes[node.firstChildOrPrimitive + 1];
+        node.boundsMin = glm::min(leftChild.boundsMin, rightChild.boundsMin);
+        node.boundsMax = glm::max(leftChild.boundsMax, rightChild.boundsMax);
+    }
+}
+
+/**
+ * @brief Get the surface area heuristic cost of the tree : the expected number of nodes visited and primitives
+ * tested by a random ray hitting the root. Refitting moving primitives makes this grow, which is how we know
+ * when to rebuild
+ *
+ * @return float The cost of the tree
+ */
+float GEM::BoundingVolumeHierarchy::getCost() const {
+    if (m_nodes.empty()) {
+        return 0.0f;
+    }
+
+    const float rootArea = GEM::BoundingVolumeHierarchy::getSurfaceArea(m_nodes[0].boundsMin, m_nodes[0].boundsMax);
+    if (rootArea <= 0.0f) {
+        return static_cast<float>(m_primitiveIndices.size());
+    }
+
+    float cost = 0.0f;
+    for (const GEM::BoundingVolumeHierarchy::Node& node : m_nodes) {
+        const float area = GEM::BoundingVolumeHierarchy::getSurfaceArea(node.boundsMin, node.boundsMax);
+        cost += area * (node.count > 0 ? static_cast<float>(node.count) : 1.0f);
+    }
+
+    return cost / rootArea;
+}
+
+/**
+ * @brief Append every primitive below a node without testing them
+ *
+ * @param nodeIndex The index of the node
+ * @param indices The vector the indices of the primitives are appended to
+ */
+void GEM::BoundingVolumeHierarchy::collectPrimitives(const uint32_t nodeIndex, std::vector<uint32_t>& indices) const {
+    std::vector<uint32_t> nodeStack = {nodeIndex};
+    while (!nodeStack.empty()) {
+        const GEM::BoundingVolumeHierarchy::Node& node = m_nodes[nodeStack.back()];
+        nodeStack.pop_back();
+
+        if (node.count > 0) {
+            indices.insert(indices.end(), m_primitiveIndices.begin() + node.firstChildOrPrimitive, m_primitiveIndices.begin() + node.firstChildOrPrimitive + node.count);
+            continue;
+        }
+
+        nodeStack.push_back(node.firstChildOrPrimitive);
+        nodeStack.push_back(node.firstChildOrPrimitive + 1);
+    }
+}
\ No newline at end of file
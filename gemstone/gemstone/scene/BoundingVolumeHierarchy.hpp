@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace GEM {
+    class BoundingVolumeHierarchy;
+}
+
+/**
+ * @brief A tree of axis aligned bounding boxes over a set of primitives, each identified by its index in the
+ * bounds it was built from. The tree is built top down with the binned surface area heuristic, and when the
+ * primitives move it is refit bottom up instead of being rebuilt. Once refitting has made the tree too loose
+ * it is rebuilt from scratch
+ * 
+ * Frustum, ray, box, and sphere queries only visit the parts of the tree that can contain results, so they
+ * are logarithmic in the number of primitives rather than linear
+ */
+class GEM::BoundingVolumeHierarchy {
+public: // public classes and enums
+    struct RaycastHit {
+        uint32_t index;
+        float distance;
+    };
+
+public: // public static variables
+    static const std::string LOGGER_NAME;
+
+    static const uint32_t INVALID_INDEX;
+    static const uint32_t SAH_BIN_COUNT;
+    static const float REBUILD_COST_RATIO;
+
+public: // public member functions
+    BoundingVolumeHierarchy();
+    ~BoundingVolumeHierarchy();
+
+    void build(const std::vector<glm::vec3>& boundsMins, const std::vector<glm::vec3>& boundsMaxs);
+    void refit(const std::vector<glm::vec3>& boundsMins, const std::vector<glm::vec3>& boundsMaxs);
+
+    void queryFrustum(const std::array<glm::vec4, 6>& frustumPlanes, std::vector<uint32_t>& indices) const;
+    void queryOverlap(const glm::vec3& boundsMin, const glm::vec3& boundsMax, std::vector<uint32_t>& indices) const;
+    void queryRadius(const glm::vec3& center, const float radius, std::vector<uint32_t>& indices) const;
+    GEM::BoundingVolumeHierarchy::RaycastHit raycast(
+        const glm::vec3& origin,
+        const glm::vec3& direction,
+        const float maxDistance = std::numeric_limits<float>::max()
+    ) const;
+
+    uint32_t getPrimitiveCount() const { return static_cast<uint32_t>(m_primitiveIndices.size()); }
+    uint32_t getNodeCount() const { return static_cast<uint32_t>(m_nodes.size()); }
+
+private: // private classes and enums
+    /**
+     * @brief A node of the tree. Interior nodes have a count of 0 and their children are stored next to each
+     * other starting at firstChildOrPrimitive. Leaves hold count primitives from m_primitiveIndices starting
+     * at firstChildOrPrimitive
+     */
+    struct Node {
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+        uint32_t firstChildOrPrimitive;
+        uint32_t count;
+    };
+
+private: // private static functions
+    static float getSurfaceArea(const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+    static bool boundsOverlap(const glm::vec3& aMin, const glm::vec3& aMax, const glm::vec3& bMin, const glm::vec3& bMax);
+    static float intersectRay(
+        const glm::vec3& origin,
+        const glm::vec3& inverseDirection,
+        const glm::vec3& boundsMin,
+        const glm::vec3& boundsMax,
+        const float maxDistance
+    );
+
+private: // private member functions
+    void updateNodeBounds(const uint32_t nodeIndex);
+    void subdivide(const uint32_t rootNodeIndex);
+    void refitNodes();
+    float getCost() const;
+    void collectPrimitives(const uint32_t nodeIndex, std::vector<uint32_t>& indices) const;
+
+private: // private member variables
+    std::vector<GEM::BoundingVolumeHierarchy::Node> m_nodes;
+    std::vector<uint32_t> m_primitiveIndices;
+    std::vector<glm::vec3> m_primitiveBoundsMins;
+    std::vector<glm::vec3> m_primitiveBoundsMaxs;
+
+    // The surface area heuristic cost of the tree when it was last built
+    float m_builtCost;
+};
\ No newline at end of file
@@ -1,3 +1,5 @@
+#include <array>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -8,6 +10,7 @@
 
 #include "gemstone/object/Object.hpp"
 #include "gemstone/renderer/mesh/Mesh.hpp"
+#include "gemstone/scene/BoundingVolumeHierarchy.hpp"
 #include "gemstone/scene/logger.hpp"
 #include "gemstone/scene/Scene.hpp"
 
@@ -106,6 +109,25 @@ std::vector<std::shared_ptr<GEM::Object>> GEM::Scene::loadObjects(const std::str
     return objectPtrs;
 }
 
+/**
+ * @brief Load which of the scene's objects are big and solid enough to hide the objects behind them
+ * 
+ * @param filename The filename representing the scene
+ * @param objectPtrs The objects in the scene
+ * @return std::vector<std::shared_ptr<GEM::Object>> The objects to use as occluders
+ */
+std::vector<std::shared_ptr<GEM::Object>> GEM::Scene::loadOccluders(const std::string& filename, const std::vector<std::shared_ptr<GEM::Object>>& objectPtrs) {
+    LOG_FUNCTION_CALL_TRACE("filename {} , object count {}", filename, objectPtrs.size());
+
+    // The cube right in front of the camera hides a good chunk of what is behind it
+    std::vector<std::shared_ptr<GEM::Object>> occluderPtrs;
+    if (!objectPtrs.empty()) {
+        occluderPtrs.push_back(objectPtrs[0]);
+    }
+
+    return occluderPtrs;
+}
+
 /* ------------------------------ public member functions ------------------------------ */
 
 /**
@@ -126,7 +148,11 @@ GEM::Scene::Scene(
     mp_context(p_context),
     mp_inputManager(p_inputManager),
     mp_camera(GEM::Scene::loadCamera(mp_context, mp_inputManager, m_filename)),
-    m_objectPtrs(GEM::Scene::loadObjects(m_filename))
+    m_objectPtrs(GEM::Scene::loadObjects(m_filename)),
+    m_occluderPtrs(GEM::Scene::loadOccluders(m_filename, m_objectPtrs)),
+    m_boundingVolumeHierarchy(),
+    m_objectBoundsMins(),
+    m_objectBoundsMaxs()
 {
     LOG_FUNCTION_CALL_INFO(
         "id {} , filename {} , name {} , camera id {} , object count {}",
@@ -136,6 +162,8 @@ GEM::Scene::Scene(
         mp_camera->getID(),
         m_objectPtrs.size()
     );
+
+    updateBoundingVolumeHierarchy();
 }
 
 /**
@@ -156,7 +184,97 @@ void GEM::Scene::update() {
     for (size_t i = 0; i < m_objectPtrs.size(); ++i) {
         m_objectPtrs[i]->update();
     }
+
+    // Refit the spatial index around wherever the objects moved to
+    updateBoundingVolumeHierarchy();
+}
+
+/**
+ * @brief Find every object in the scene whose bounds are at least partly inside a frustum
+ * 
+ * @param frustumPlanes The six inward facing, normalized planes of the frustum, such as from GEM::Camera::getFrustumPlanes
+ * @return std::vector<std::shared_ptr<GEM::Object>> The objects inside the frustum
+ */
+std::vector<std::shared_ptr<GEM::Object>> GEM::Scene::queryFrustum(const std::array<glm::vec4, 6>& frustumPlanes) const {
+    std::vector<uint32_t> indices;
+    m_boundingVolumeHierarchy.queryFrustum(frustumPlanes, indices);
+    return getObjectPtrsFromIndices(indices);
+}
+
+/**
+ * @brief Find every object in the scene whose bounds overlap a box
+ * 
+ * @param boundsMin The minimum corner of the box in world space
+ * @param boundsMax The maximum corner of the box in world space
+ * @return std::vector<std::shared_ptr<GEM::Object>> The objects overlapping the box
+ */
+std::vector<std::shared_ptr<GEM::Object>> GEM::Scene::queryOverlap(const glm::vec3& boundsMin, const glm::vec3& boundsMax) const {
+    std::vector<uint32_t> indices;
+    m_boundingVolumeHierarchy.queryOverlap(boundsMin, boundsMax, indices);
+    return getObjectPtrsFromIndices(indices);
+}
+
+/**
+ * @brief Find every object in the scene whose bounds are within a distance of a point
+ * 
+ * @param center The point in world space
+ * @param radius The distance from the point
+ * @return std::vector<std::shared_ptr<GEM::Object>> The objects within the radius
+ */
+std::vector<std::shared_ptr<GEM::Object>> GEM::Scene::queryRadius(const glm::vec3& center, const float radius) const {
+    std::vector<uint32_t> indices;
+    m_boundingVolumeHierarchy.queryRadius(center, radius, indices);
+    return getObjectPtrsFromIndices(indices);
+}
+
+/**
+ * @brief Find the first object whose bounds a ray hits. This is what picking objects with the cursor uses
+ * 
+ * @param origin The origin of the ray in world space
+ * @param direction The direction of the ray in world space
+ * @param distance Set to the distance along the ray to the object that was hit, in multiples of the direction's length
+ * @return std::shared_ptr<GEM::Object> The object which was hit, or nullptr if the ray did not hit anything
+ */
+std::shared_ptr<GEM::Object> GEM::Scene::raycast(const glm::vec3& origin, const glm::vec3& direction, float& distance) const {
+    const GEM::BoundingVolumeHierarchy::RaycastHit hit = m_boundingVolumeHierarchy.raycast(origin, direction);
+    if (hit.index == GEM::BoundingVolumeHierarchy::INVALID_INDEX) {
+        return nullptr;
+    }
+
+    distance = hit.distance;
+    return m_objectPtrs[hit.index];
 }
 
 /* ------------------------------ private member functions ------------------------------ */
 
+/**
+ * @brief Gather the world space bounds of every object and bring the bounding volume hierarchy up to date with
+ * them. The hierarchy is only refit when objects moved, and only rebuilt when objects are added or removed or
+ * refitting has made it too loose
+ */
+void GEM::Scene::updateBoundingVolumeHierarchy() {
+    m_objectBoundsMins.resize(m_objectPtrs.size());
+    m_objectBoundsMaxs.resize(m_objectPtrs.size());
+    for (size_t i = 0; i < m_objectPtrs.size(); ++i) {
+        m_objectBoundsMins[i] = m_objectPtrs[i]->getWorldBoundsMin();
+        m_objectBoundsMaxs[i] = m_objectPtrs[i]->getWorldBoundsMax();
+    }
+
+    m_boundingVolumeHierarchy.refit(m_objectBoundsMins, m_objectBoundsMaxs);
+}
+
+/**
+ * @brief Turn the primitive indices a bounding volume hierarchy query returned into the objects they stand for
+ * 
+ * @param indices The indices of the objects in m_objectPtrs
+ * @return std::vector<std::shared_ptr<GEM::Object>> The objects
+ */
+std::vector<std::shared_ptr<GEM::Object>> GEM::Scene::getObjectPtrsFromIndices(const std::vector<uint32_t>& indices) const {
+    std::vector<std::shared_ptr<GEM::Object>> objectPtrs;
+    objectPtrs.reserve(indices.size());
+    for (const uint32_t index : indices) {
+        objectPtrs.push_back(m_objectPtrs[index]);
+    }
+
+    return objectPtrs;
+}
@@ -1,14 +1,18 @@
 #pragma once
 
+#include <array>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include <glm/glm.hpp>
+
 #include "gemstone/camera/Camera.hpp"
 #include "gemstone/object/Object.hpp"
 #include "gemstone/managers/input/InputManager.hpp"
 #include "gemstone/renderer/context/Context.hpp"
 #include "gemstone/renderer/mesh/Mesh.hpp"
+#include "gemstone/scene/BoundingVolumeHierarchy.hpp"
 
 namespace GEM {
     class Scene;
@@ -32,6 +36,13 @@ public: // public member functions
 
     std::shared_ptr<const GEM::Camera> getCameraPtr() const { return mp_camera; }
     const std::vector<std::shared_ptr<GEM::Object>>& getObjectPtrs() const { return m_objectPtrs; }
+    const std::vector<std::shared_ptr<GEM::Object>>& getOccluderPtrs() const { return m_occluderPtrs; }
+    const GEM::BoundingVolumeHierarchy& getBoundingVolumeHierarchy() const { return m_boundingVolumeHierarchy; }
+
+    std::vector<std::shared_ptr<GEM::Object>> queryFrustum(const std::array<glm::vec4, 6>& frustumPlanes) const;
+    std::vector<std::shared_ptr<GEM::Object>> queryOverlap(const glm::vec3& boundsMin, const glm::vec3& boundsMax) const;
+    std::vector<std::shared_ptr<GEM::Object>> queryRadius(const glm::vec3& center, const float radius) const;
+    std::shared_ptr<GEM::Object> raycast(const glm::vec3& origin, const glm::vec3& direction, float& distance) const;
 
     void update();
 
@@ -43,6 +54,11 @@ private: // private static functions
         const std::string& filename
     );
     std::vector<std::shared_ptr<GEM::Object>> loadObjects(const std::string& filename);
+    std::vector<std::shared_ptr<GEM::Object>> loadOccluders(const std::string& filename, const std::vector<std::shared_ptr<GEM::Object>>& objectPtrs);
+
+private: // private member functions
+    void updateBoundingVolumeHierarchy();
+    std::vector<std::shared_ptr<GEM::Object>> getObjectPtrsFromIndices(const std::vector<uint32_t>& indices) const;
 
 private: // private static variables
     static uint32_t sceneCount;
@@ -57,4 +73,10 @@ private: // private member variables
     
     std::shared_ptr<GEM::Camera> mp_camera;
     std::vector<std::shared_ptr<GEM::Object>> m_objectPtrs;
+    std::vector<std::shared_ptr<GEM::Object>> m_occluderPtrs;
+
+    // The spatial index over the objects' world space bounds, kept up to date every update
+    GEM::BoundingVolumeHierarchy m_boundingVolumeHierarchy;
+    std::vector<glm::vec3> m_objectBoundsMins;
+    std::vector<glm::vec3> m_objectBoundsMaxs;
 };
\ No newline at end of file
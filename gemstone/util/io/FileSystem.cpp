@@ -1,3 +1,4 @@
+#include <filesystem>
 #include <string>
 
 #include "util/platform.hpp"
@@ -28,6 +29,18 @@ std::string GEM::util::FileSystem::getFullPath(const std::string& path) {
     return std::string(PROJECT_ROOT_DIR) + std::string("/") + path;
 }
 
+/**
+ * @brief Determine whether or not a regular file exists at the given path
+ * 
+ * @param path The full path to the file
+ * @return true There is a regular file at the path
+ * @return false There is nothing at the path, or it is not a regular file
+ */
+bool GEM::util::FileSystem::fileExists(const std::string& path) {
+    std::error_code errorCode;
+    return std::filesystem::is_regular_file(path, errorCode);
+}
+
 /* ------------------------------ private static functions ------------------------------ */
 
 /* ------------------------------ public member functions ------------------------------ */
@@ -14,6 +14,7 @@ public: // public static variables
 
 public: // public static functions
     static std::string getFullPath(const std::string& path);
+    static bool fileExists(const std::string& path);
 
 public: // public member functions
     FileSystem() = delete;
@@ -0,0 +1,129 @@
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "util/io/logger.hpp"
+#include "util/io/MappedFile.hpp"
+#include "util/logger/Logger.hpp"
+
+/* ------------------------------ public static variables ------------------------------ */
+
+/**
+ * @brief The name of the logger the MappedFile class uses
+ */
+const std::string GEM::util::MappedFile::LOGGER_NAME = IO_LOGGER_NAME;
+
+/* ------------------------------ private static variables ------------------------------ */
+
+/* ------------------------------ public static functions ------------------------------ */
+
+/* ------------------------------ private static functions ------------------------------ */
+
+/**
+ * @brief Open the file for reading
+ *
+ * @note This function will throw if the file cannot be opened
+ *
+ * @param filename The full path to the file
+ * @return int The file descriptor of the opened file
+ */
+int GEM::util::MappedFile::openFile(const std::string& filename) {
+    LOG_FUNCTION_ENTRY_TRACE("filename {}", filename);
+
+    const int fileDescriptor = open(filename.c_str(), O_RDONLY);
+    if (fileDescriptor == -1) {
+        const std::string errorMessage = "Failed to open file at " + filename;
+        LOG_CRITICAL(errorMessage);
+        throw std::invalid_argument(errorMessage);
+    }
+
+    return fileDescriptor;
+}
+
+/**
+ * @brief Get the size of an opened file
+ *
+ * @note This function will close the file and throw if the size cannot be determined
+ *
+ * @param fileDescriptor The file descriptor of the opened file
+ * @param filename The full path to the file, for error messages
+ * @return size_t The size of the file in bytes
+ */
+size_t GEM::util::MappedFile::getFileSize(const int fileDescriptor, const std::string& filename) {
+    LOG_FUNCTION_ENTRY_TRACE("file descriptor {} , filename {}", fileDescriptor, filename);
+
+    struct stat fileStatus;
+    if (fstat(fileDescriptor, &fileStatus) == -1) {
+        close(fileDescriptor);
+
+        const std::string errorMessage = "Failed to get the size of file at " + filename;
+        LOG_CRITICAL(errorMessage);
+        throw std::runtime_error(errorMessage);
+    }
+
+    return static_cast<size_t>(fileStatus.st_size);
+}
+
+/**
+ * @brief Map the whole of an opened file into memory as read only
+ *
+ * @note This function will close the file and throw if the file cannot be mapped
+ *
+ * @param fileDescriptor The file descriptor of the opened file
+ * @param size The size of the file in bytes
+ * @param filename The full path to the file, for error messages
+ * @return const char* The start of the mapped file, nullptr if the file is empty
+ */
+const char* GEM::util::MappedFile::mapFile(const int fileDescriptor, const size_t size, const std::string& filename) {
+    LOG_FUNCTION_ENTRY_TRACE("file descriptor {} , size {} , filename {}", fileDescriptor, size, filename);
+
+    // Mapping 0 bytes is an error, but an empty file is perfectly fine to read
+    if (size == 0) {
+        return nullptr;
+    }
+
+    void* p_data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    if (p_data == MAP_FAILED) {
+        close(fileDescriptor);
+
+        const std::string errorMessage = "Failed to mmap file at " + filename;
+        LOG_CRITICAL(errorMessage);
+        throw std::runtime_error(errorMessage);
+    }
+
+    return static_cast<const char*>(p_data);
+}
+
+/* ------------------------------ public member functions ------------------------------ */
+
+/**
+ * @brief Construct a new GEM::util::MappedFile::MappedFile object by mapping the whole file into memory
+ *
+ * @param filename The full path to the file to map
+ */
+GEM::util::MappedFile::MappedFile(const std::string& filename) :
+    m_filename(filename),
+    m_fileDescriptor(GEM::util::MappedFile::openFile(filename)),
+    m_size(GEM::util::MappedFile::getFileSize(m_fileDescriptor, filename)),
+    mp_data(GEM::util::MappedFile::mapFile(m_fileDescriptor, m_size, filename))
+{
+    LOG_FUNCTION_CALL_TRACE("filename {} , size {}", m_filename, m_size);
+}
+
+/**
+ * @brief Destroy the GEM::util::MappedFile::MappedFile object by unmapping and closing the file
+ */
+GEM::util::MappedFile::~MappedFile() {
+    LOG_FUNCTION_CALL_TRACE("filename {}", m_filename);
+
+    if (mp_data) {
+        munmap(const_cast<char*>(mp_data), m_size);
+    }
+    close(m_fileDescriptor);
+}
+
+/* ------------------------------ private member functions ------------------------------ */
\ No newline at end of file
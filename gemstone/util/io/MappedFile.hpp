@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+
+namespace GEM {
+namespace util {
+    class MappedFile;
+}
+}
+
+/**
+ * @brief A read only view of a file's contents mapped into memory. The file is mapped on construction
+ * and unmapped on destruction, so the data is only valid for as long as the MappedFile is alive
+ * 
+ * @note The constructor will throw if the file cannot be opened or mapped
+ */
+class GEM::util::MappedFile {
+public: // public static variables
+    const static std::string LOGGER_NAME;
+
+public: // public member functions
+    MappedFile(const std::string& filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile& other) = delete;
+    void operator=(const MappedFile& other) = delete;
+
+    std::string getFilename() const { return m_filename; }
+    const char* getData() const { return mp_data; }
+    size_t getSize() const { return m_size; }
+
+private: // private static functions
+    static int openFile(const std::string& filename);
+    static size_t getFileSize(const int fileDescriptor, const std::string& filename);
+    static const char* mapFile(const int fileDescriptor, const size_t size, const std::string& filename);
+
+private: // private member variables
+    const std::string m_filename;
+    const int m_fileDescriptor;
+    const size_t m_size;
+    const char* const mp_data;
+};
\ No newline at end of file